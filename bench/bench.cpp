@@ -0,0 +1,696 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Headless benchmarks.
+ *
+ * Scenes are drawn to a detail::MemoryScreen so results do not depend on a
+ * display, and are comparable between hosts and releases.  Each scene is
+ * updated and drawn for a number of frames, timing the update and draw phases
+ * of every frame separately.  A set of microbenchmarks then times the
+ * building blocks used by drawing.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <egt/detail/image.h>
+#include <egt/detail/imagecache.h>
+#include <egt/ui>
+#include <egt/version.h>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_us(const Clock::time_point& start, const Clock::time_point& end)
+{
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+/// Summary of a set of samples, in microseconds.
+struct Stats
+{
+    double mean{};
+    double p50{};
+    double p95{};
+    double max{};
+};
+
+static Stats summarize(std::vector<double> samples)
+{
+    Stats stats;
+    if (samples.empty())
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (auto s : samples)
+        total += s;
+
+    auto percentile = [&samples](double p)
+    {
+        auto index = static_cast<size_t>(std::ceil(p * samples.size())) - 1;
+        return samples[std::min(index, samples.size() - 1)];
+    };
+
+    stats.mean = total / samples.size();
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.max = samples.back();
+    return stats;
+}
+
+/**
+ * A scene is a set of widgets in a window, and a function to change them
+ * each frame.
+ */
+class Scene
+{
+public:
+
+    explicit Scene(std::string name)
+        : m_name(std::move(name))
+    {
+        m_win.color(egt::Palette::ColorId::bg, egt::Palette::black);
+    }
+
+    const std::string& name() const { return m_name; }
+
+    egt::Window& window() { return m_win; }
+
+    /// Change the scene for the specified frame.
+    virtual void update(size_t frame) = 0;
+
+    virtual ~Scene() = default;
+
+protected:
+    std::string m_name;
+    egt::TopWindow m_win;
+};
+
+/// A grid of buttons, a quarter of which change state every frame.
+class ButtonsScene : public Scene
+{
+public:
+    explicit ButtonsScene(size_t count)
+        : Scene("buttons" + std::to_string(count)),
+          m_grid(egt::StaticGrid::GridSize(10, (count + 9) / 10))
+    {
+        m_win.add(expand(m_grid));
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto button = std::make_shared<egt::Button>(std::to_string(i));
+            m_grid.add(expand(button));
+            m_buttons.push_back(button);
+        }
+    }
+
+    void update(size_t frame) override
+    {
+        for (auto i = frame % 4; i < m_buttons.size(); i += 4)
+            m_buttons[i]->checked(!m_buttons[i]->checked());
+    }
+
+private:
+    egt::StaticGrid m_grid;
+    std::vector<std::shared_ptr<egt::Button>> m_buttons;
+};
+
+/// Sliders that all move every frame.
+class SlidersScene : public Scene
+{
+public:
+    SlidersScene()
+        : Scene("sliders"),
+          m_sizer(egt::Orientation::vertical)
+    {
+        m_win.add(expand(m_sizer));
+        for (auto i = 0; i < 8; ++i)
+        {
+            auto slider = std::make_shared<egt::Slider>(egt::Rect(0, 0, 700, 50));
+            slider->slider_flags().set(egt::Slider::SliderFlag::round_handle);
+            m_sizer.add(slider);
+            m_sliders.push_back(slider);
+        }
+    }
+
+    void update(size_t frame) override
+    {
+        for (size_t i = 0; i < m_sliders.size(); ++i)
+        {
+            auto t = (frame + i * 8) * 0.05;
+            m_sliders[i]->value(50 + static_cast<int>(50 * std::sin(t)));
+        }
+    }
+
+private:
+    egt::BoxSizer m_sizer;
+    std::vector<std::shared_ptr<egt::Slider>> m_sliders;
+};
+
+/// A long ListBox scrolled a few pixels every frame.
+class ListBoxScene : public Scene
+{
+public:
+    ListBoxScene()
+        : Scene("listbox_scroll"),
+          m_list(egt::Rect(0, 0, 400, 480))
+    {
+        m_win.add(center(m_list));
+        for (auto i = 0; i < 500; ++i)
+            m_list.add_item(std::make_shared<egt::StringItem>("Item " + std::to_string(i)));
+    }
+
+    void update(size_t frame) override
+    {
+        m_list.scroll(frame);
+    }
+
+private:
+
+    class List : public egt::ListBox
+    {
+    public:
+        using egt::ListBox::ListBox;
+
+        void scroll(size_t frame)
+        {
+            auto range = m_view.offset_max().y();
+            if (range < 0)
+                m_view.voffset(-static_cast<int>((frame * 8) % -range));
+        }
+    };
+
+    List m_list;
+};
+
+/// Labels full of text, all of which change every frame.
+class LabelsScene : public Scene
+{
+public:
+    LabelsScene()
+        : Scene("labels"),
+          m_grid(egt::StaticGrid::GridSize(3, 20))
+    {
+        m_win.add(expand(m_grid));
+        for (auto i = 0; i < 60; ++i)
+        {
+            auto label = std::make_shared<egt::Label>();
+            label->font(egt::Font(14));
+            m_grid.add(expand(label));
+            m_labels.push_back(label);
+        }
+    }
+
+    void update(size_t frame) override
+    {
+        for (size_t i = 0; i < m_labels.size(); ++i)
+            m_labels[i]->text("The quick brown fox " + std::to_string(frame + i));
+    }
+
+private:
+    egt::StaticGrid m_grid;
+    std::vector<std::shared_ptr<egt::Label>> m_labels;
+};
+
+/// Analog and level meters, all of which change every frame.
+class GaugesScene : public Scene
+{
+public:
+    GaugesScene()
+        : Scene("gauges"),
+          m_grid(egt::StaticGrid::GridSize(4, 2))
+    {
+        m_win.add(expand(m_grid));
+        for (auto i = 0; i < 4; ++i)
+        {
+            auto meter = std::make_shared<egt::AnalogMeter>();
+            m_grid.add(expand(meter));
+            m_meters.push_back(meter);
+        }
+        for (auto i = 0; i < 4; ++i)
+        {
+            auto level = std::make_shared<egt::LevelMeter>();
+            m_grid.add(expand(level));
+            m_levels.push_back(level);
+        }
+    }
+
+    void update(size_t frame) override
+    {
+        for (size_t i = 0; i < m_meters.size(); ++i)
+        {
+            auto value = 50 + static_cast<int>(50 * std::sin((frame + i * 10) * 0.05));
+            m_meters[i]->value(value);
+            m_levels[i]->value(value);
+        }
+    }
+
+private:
+    egt::StaticGrid m_grid;
+    std::vector<std::shared_ptr<egt::AnalogMeter>> m_meters;
+    std::vector<std::shared_ptr<egt::LevelMeter>> m_levels;
+};
+
+#ifdef EGT_HAS_CHART
+/// A line chart that has a point added and removed every frame.
+class ChartScene : public Scene
+{
+public:
+    ChartScene()
+        : Scene("chart")
+    {
+        m_win.add(expand(m_chart));
+        egt::LineChart::DataArray data;
+        for (auto i = 0; i < 200; ++i)
+            data.push_back(std::make_pair(i, std::sin(i * 0.1)));
+        m_chart.data(data);
+    }
+
+    void update(size_t frame) override
+    {
+        auto x = 200 + frame;
+        m_chart.remove_data(1);
+        m_chart.add_data({std::make_pair(x, std::sin(x * 0.1))});
+    }
+
+private:
+    egt::LineChart m_chart;
+};
+#endif
+
+/// An alpha blended popup moving over a window of buttons.
+class PopupScene : public Scene
+{
+public:
+    PopupScene()
+        : Scene("alpha_popup"),
+          m_grid(egt::StaticGrid::GridSize(8, 6)),
+          m_popup(egt::Size(300, 200))
+    {
+        m_win.add(expand(m_grid));
+        for (auto i = 0; i < 48; ++i)
+            m_grid.add(expand(std::make_shared<egt::Button>(std::to_string(i))));
+
+        m_popup.alpha(0.7);
+        m_popup.add(center(std::make_shared<egt::Label>("Popup")));
+        m_win.add(m_popup);
+        m_popup.show();
+    }
+
+    void update(size_t frame) override
+    {
+        auto range = m_win.width() - m_popup.width();
+        auto x = static_cast<int>(frame * 4 % (range * 2));
+        if (x > range)
+            x = range * 2 - x;
+        m_popup.x(x);
+    }
+
+private:
+    egt::StaticGrid m_grid;
+    egt::Popup m_popup;
+};
+
+/// Timing results for one scene.
+struct SceneResult
+{
+    std::string name;
+    size_t frames{};
+    double fps{};
+    Stats update;
+    Stats draw;
+};
+
+static SceneResult run_scene(egt::Application& app, Scene& scene,
+                             size_t warmup, size_t frames)
+{
+    scene.window().show();
+
+    for (size_t i = 0; i < warmup; ++i)
+    {
+        scene.update(i);
+        app.event().draw();
+    }
+
+    std::vector<double> update;
+    std::vector<double> draw;
+    update.reserve(frames);
+    draw.reserve(frames);
+
+    const auto begin = Clock::now();
+    for (size_t i = 0; i < frames; ++i)
+    {
+        const auto start = Clock::now();
+        scene.update(warmup + i);
+        const auto updated = Clock::now();
+        app.event().draw();
+        const auto drawn = Clock::now();
+
+        update.push_back(elapsed_us(start, updated));
+        draw.push_back(elapsed_us(updated, drawn));
+    }
+    const auto end = Clock::now();
+
+    scene.window().hide();
+
+    SceneResult result;
+    result.name = scene.name();
+    result.frames = frames;
+    result.fps = frames / (elapsed_us(begin, end) / 1e6);
+    result.update = summarize(std::move(update));
+    result.draw = summarize(std::move(draw));
+    return result;
+}
+
+/// Timing results for one microbenchmark.
+struct MicroResult
+{
+    std::string name;
+    size_t iterations{};
+    double ns_per_op{};
+};
+
+/**
+ * Run a function repeatedly for at least the specified time.
+ *
+ * The function returns the number of operations it performed.
+ */
+static MicroResult run_micro(const std::string& name,
+                             const std::function<size_t()>& func,
+                             std::chrono::milliseconds duration)
+{
+    // warm caches before measuring
+    func();
+
+    size_t iterations = 0;
+    size_t ops = 0;
+    const auto start = Clock::now();
+    auto now = start;
+    while (now - start < duration)
+    {
+        ops += func();
+        ++iterations;
+        now = Clock::now();
+    }
+
+    MicroResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ns_per_op = elapsed_us(start, now) * 1000.0 / ops;
+    return result;
+}
+
+static std::vector<MicroResult> run_micros(const std::string& filter,
+        std::chrono::milliseconds duration)
+{
+    std::vector<std::pair<std::string, std::function<size_t()>>> micros;
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> xdist(0, 799);
+    std::uniform_int_distribution<int> ydist(0, 479);
+    std::uniform_int_distribution<int> sdist(1, 120);
+    std::vector<egt::Rect> rects;
+    for (auto i = 0; i < 64; ++i)
+        rects.emplace_back(xdist(gen), ydist(gen), sdist(gen), sdist(gen));
+
+    micros.emplace_back("damage_merge", [rects]()
+    {
+        egt::Screen::DamageArray damage;
+        for (const auto& rect : rects)
+            egt::Screen::damage_algorithm(damage, rect);
+        return rects.size();
+    });
+
+    auto sizer = std::make_shared<egt::BoxSizer>(egt::Orientation::flex);
+    for (auto i = 0; i < 100; ++i)
+        sizer->add(std::make_shared<egt::Button>(std::to_string(i)));
+    micros.emplace_back("layout", [sizer]()
+    {
+        static bool wide = false;
+        wide = !wide;
+        sizer->resize(egt::Size(wide ? 800 : 600, 480));
+        sizer->layout();
+        return 1;
+    });
+
+    // a 40x25 grid of tiles covering the screen
+    auto tiles = [](bool index)
+    {
+        auto frame = std::make_shared<egt::Frame>(egt::Rect(0, 0, 800, 480));
+        frame->spatial_index(index);
+        for (auto i = 0; i < 1000; ++i)
+            frame->add(std::make_shared<egt::Frame>(egt::Rect(i % 40 * 20, i / 40 * 19, 20, 19)));
+        return frame;
+    };
+
+    std::vector<egt::DisplayPoint> points;
+    for (auto i = 0; i < 256; ++i)
+        points.emplace_back(xdist(gen), ydist(gen));
+
+    for (auto index : {false, true})
+    {
+        auto frame = tiles(index);
+        micros.emplace_back(index ? "hit_test_index" : "hit_test", [frame, points]()
+        {
+            volatile size_t sink = 0;
+            for (const auto& point : points)
+                sink = sink + (frame->hit_test(point) != nullptr);
+            return points.size();
+        });
+    }
+
+    auto image = egt::shared_cairo_surface_t(
+                     cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 256, 256),
+                     cairo_surface_destroy);
+    {
+        auto cr = egt::shared_cairo_t(cairo_create(image.get()), cairo_destroy);
+        auto pattern = egt::shared_cairo_pattern_t(
+                           cairo_pattern_create_linear(0, 0, 256, 256),
+                           cairo_pattern_destroy);
+        cairo_pattern_add_color_stop_rgba(pattern.get(), 0, 1, 0, 0, 1);
+        cairo_pattern_add_color_stop_rgba(pattern.get(), 1, 0, 0, 1, 0.5);
+        cairo_set_source(cr.get(), pattern.get());
+        cairo_paint(cr.get());
+    }
+
+    auto png = std::make_shared<std::string>();
+    cairo_surface_write_to_png_stream(image.get(), [](void* closure,
+                                      const unsigned char* data,
+                                      unsigned int length)
+    {
+        static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+        return CAIRO_STATUS_SUCCESS;
+    }, png.get());
+
+    micros.emplace_back("image_decode_png", [png]()
+    {
+        auto surface = egt::detail::load_image_from_memory(
+                           reinterpret_cast<const unsigned char*>(png->data()),
+                           png->size());
+        return 1;
+    });
+
+    micros.emplace_back("image_scale", [image]()
+    {
+        auto surface = egt::detail::ImageCache::scale_surface(image, 256, 256, 400, 300);
+        return 1;
+    });
+
+    std::vector<egt::Color> colors;
+    for (auto i = 0; i < 4096; ++i)
+        colors.emplace_back(egt::Color(static_cast<egt::Color::RGBAType>(gen())));
+
+    micros.emplace_back("color_pixel16", [colors]()
+    {
+        volatile uint16_t sink = 0;
+        for (const auto& color : colors)
+            sink = sink + color.pixel16();
+        return colors.size();
+    });
+
+    micros.emplace_back("color_pixel32", [colors]()
+    {
+        volatile uint32_t sink = 0;
+        for (const auto& color : colors)
+            sink = sink + color.pixel32();
+        return colors.size();
+    });
+
+    micros.emplace_back("color_interp_hsv", [colors]()
+    {
+        volatile uint32_t sink = 0;
+        for (size_t i = 1; i < colors.size(); ++i)
+            sink = sink + egt::Color::interp_hsv(colors[i - 1], colors[i], 0.5).pixel32();
+        return colors.size() - 1;
+    });
+
+    std::vector<MicroResult> results;
+    for (const auto& micro : micros)
+    {
+        if (micro.first.find(filter) == std::string::npos)
+            continue;
+        results.push_back(run_micro(micro.first, micro.second, duration));
+    }
+    return results;
+}
+
+static void write_stats(std::ostream& out, const Stats& stats)
+{
+    out << "{\"mean_us\": " << stats.mean
+        << ", \"p50_us\": " << stats.p50
+        << ", \"p95_us\": " << stats.p95
+        << ", \"max_us\": " << stats.max << "}";
+}
+
+static void write_json(std::ostream& out, const egt::Size& size,
+                       const std::vector<SceneResult>& scenes,
+                       const std::vector<MicroResult>& micros)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"version\": \"" << EGT_VERSION << "\",\n";
+    out << "  \"backend\": \"memory\",\n";
+    out << "  \"screen\": {\"width\": " << size.width()
+        << ", \"height\": " << size.height() << "},\n";
+
+    out << "  \"scenes\": [";
+    for (size_t i = 0; i < scenes.size(); ++i)
+    {
+        const auto& s = scenes[i];
+        out << (i ? ",\n" : "\n");
+        out << "    {\"name\": \"" << s.name << "\", \"frames\": " << s.frames
+            << ", \"fps\": " << s.fps << ", \"update\": ";
+        write_stats(out, s.update);
+        out << ", \"draw\": ";
+        write_stats(out, s.draw);
+        out << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"micro\": [";
+    for (size_t i = 0; i < micros.size(); ++i)
+    {
+        const auto& m = micros[i];
+        out << (i ? ",\n" : "\n");
+        out << "    {\"name\": \"" << m.name << "\", \"iterations\": " << m.iterations
+            << ", \"ns_per_op\": " << m.ns_per_op << "}";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+static void write_table(std::ostream& out,
+                        const std::vector<SceneResult>& scenes,
+                        const std::vector<MicroResult>& micros)
+{
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(18) << "scene" << std::right
+        << std::setw(10) << "fps"
+        << std::setw(12) << "update p50"
+        << std::setw(12) << "update p95"
+        << std::setw(12) << "draw p50"
+        << std::setw(12) << "draw p95" << " (us)\n";
+    for (const auto& s : scenes)
+    {
+        out << std::left << std::setw(18) << s.name << std::right
+            << std::setw(10) << s.fps
+            << std::setw(12) << s.update.p50
+            << std::setw(12) << s.update.p95
+            << std::setw(12) << s.draw.p50
+            << std::setw(12) << s.draw.p95 << "\n";
+    }
+
+    out << "\n" << std::left << std::setw(18) << "micro" << std::right
+        << std::setw(14) << "ns/op" << std::setw(12) << "iterations" << "\n";
+    for (const auto& m : micros)
+    {
+        out << std::left << std::setw(18) << m.name << std::right
+            << std::setw(14) << m.ns_per_op
+            << std::setw(12) << m.iterations << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    cxxopts::Options options(argv[0], "headless EGT benchmarks");
+    options.add_options()
+    ("h,help", "Show help")
+    ("f,frames", "Frames to time per scene", cxxopts::value<size_t>()->default_value("300"))
+    ("w,warmup", "Frames to draw before timing a scene", cxxopts::value<size_t>()->default_value("30"))
+    ("m,micro-time", "Milliseconds to run each microbenchmark", cxxopts::value<int>()->default_value("500"))
+    ("n,name", "Only run benchmarks with names containing this", cxxopts::value<std::string>()->default_value(""))
+    ("o,output", "Write JSON results to this file", cxxopts::value<std::string>()->default_value(""));
+
+    auto args = options.parse(argc, argv);
+
+    if (args.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    // always draw to memory so results do not depend on a display
+    setenv("EGT_BACKEND", "memory", 1);
+    setenv("EGT_SCREEN_SIZE", "800x480", 0);
+
+    egt::Application app(argc, argv);
+
+    const auto frames = args["frames"].as<size_t>();
+    const auto warmup = args["warmup"].as<size_t>();
+    const auto filter = args["name"].as<std::string>();
+
+    std::vector<std::function<std::unique_ptr<Scene>()>> factories =
+    {
+        []() { return std::unique_ptr<Scene>(new ButtonsScene(20)); },
+        []() { return std::unique_ptr<Scene>(new ButtonsScene(200)); },
+        []() { return std::unique_ptr<Scene>(new SlidersScene); },
+        []() { return std::unique_ptr<Scene>(new ListBoxScene); },
+        []() { return std::unique_ptr<Scene>(new LabelsScene); },
+        []() { return std::unique_ptr<Scene>(new GaugesScene); },
+#ifdef EGT_HAS_CHART
+        []() { return std::unique_ptr<Scene>(new ChartScene); },
+#endif
+        []() { return std::unique_ptr<Scene>(new PopupScene); },
+    };
+
+    std::vector<SceneResult> scenes;
+    for (const auto& factory : factories)
+    {
+        auto scene = factory();
+        if (scene->name().find(filter) == std::string::npos)
+            continue;
+        scenes.push_back(run_scene(app, *scene, warmup, frames));
+    }
+
+    const auto micros = run_micros(filter,
+                                   std::chrono::milliseconds(args["micro-time"].as<int>()));
+
+    write_table(std::cout, scenes, micros);
+
+    const auto output = args["output"].as<std::string>();
+    if (!output.empty())
+    {
+        std::ofstream out(output);
+        if (!out)
+        {
+            std::cerr << "failed to open " << output << std::endl;
+            return 1;
+        }
+        write_json(out, app.screen()->size(), scenes, micros);
+    }
+
+    return 0;
+}
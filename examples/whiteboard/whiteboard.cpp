@@ -219,7 +219,8 @@ public:
             const auto mouse = display_to_local(event.pointer().point);
             egt::Painter painter(m_canvas.context());
             cairo_set_antialias(painter.context().get(), CAIRO_ANTIALIAS_NONE);
-            painter.flood(mouse, m_fillpicker.selected_color());
+            // tolerate some of the anti-aliased edges of lines
+            painter.flood(mouse, m_fillpicker.selected_color(), 32);
             damage();
             break;
         }
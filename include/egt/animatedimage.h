@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_ANIMATEDIMAGE_H
+#define EGT_ANIMATEDIMAGE_H
+
+/**
+ * @file
+ * @brief AnimatedImage widget.
+ */
+
+#include <chrono>
+#include <egt/detail/meta.h>
+#include <egt/frame.h>
+#include <egt/signal.h>
+#include <egt/timer.h>
+#include <egt/types.h>
+#include <egt/widget.h>
+#include <memory>
+#include <string>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+class FrameStream;
+}
+
+namespace experimental
+{
+
+/**
+ * Plays an animated image file, decoding frames as they are needed.
+ *
+ * Unlike a Sprite, the whole animation is never loaded in memory.  Frames are
+ * decoded from the file on a worker thread, at most lookahead() frames ahead
+ * of the frame shown, so the memory used is a few frames regardless of the
+ * length of the animation.  This suits long animations like boot animations.
+ *
+ * Supported files are GIF, APNG when built with zlib, and a sequence of ERAW
+ * images concatenated in one file.  For an ERAW sequence, the first reserved
+ * word of the header of each image is the time to show it for, in
+ * milliseconds.
+ *
+ * Frames are shown for the time requested by the file.  If decoding falls
+ * behind, frames that are already late are skipped.
+ *
+ * @code{.cpp}
+ * egt::experimental::AnimatedImage boot(window, "file:boot.gif");
+ * boot.on_eos([&boot]() { boot.hide(); });
+ * boot.loop(false);
+ * boot.start();
+ * @endcode
+ */
+class EGT_API AnimatedImage : public Widget
+{
+public:
+
+    /**
+     * Event signal.
+     * @{
+     */
+    /**
+     * Invoked when the last frame was shown, when not looping.
+     */
+    Signal<> on_eos;
+    /** @} */
+
+    /**
+     * @param[in] uri File to play.
+     * @param[in] rect Initial rectangle of the widget.  If empty, the widget
+     *            is sized to the frames.
+     */
+    explicit AnimatedImage(const std::string& uri = {}, const Rect& rect = {});
+
+    /**
+     * @param[in] parent The parent Frame.
+     * @param[in] uri File to play.
+     * @param[in] rect Initial rectangle of the widget.  If empty, the widget
+     *            is sized to the frames.
+     */
+    explicit AnimatedImage(Frame& parent, const std::string& uri = {},
+                           const Rect& rect = {});
+
+    AnimatedImage(const AnimatedImage&) = delete;
+    AnimatedImage& operator=(const AnimatedImage&) = delete;
+    AnimatedImage(AnimatedImage&&) = delete;
+    AnimatedImage& operator=(AnimatedImage&&) = delete;
+
+    void draw(Painter& painter, const Rect& rect) override;
+
+    /**
+     * Open a file to play.
+     *
+     * The first frame is shown once it is decoded.  Playing starts with
+     * start().
+     *
+     * @param[in] uri File to play.  Only file paths and file: URIs are
+     *            supported, because frames are read from the file as needed.
+     * @throws std::runtime_error if the file cannot be opened or its format
+     *         is not supported.
+     */
+    void load(const std::string& uri);
+
+    /**
+     * Start, or resume, playing.
+     */
+    void start();
+
+    /**
+     * Stop playing, keeping the current frame.
+     */
+    void stop();
+
+    /**
+     * Check if playing.
+     */
+    EGT_NODISCARD bool running() const { return m_running; }
+
+    /**
+     * Set whether to start over after the last frame.
+     *
+     * The default is to loop.
+     */
+    void loop(bool enable);
+
+    /**
+     * Get whether to start over after the last frame.
+     */
+    EGT_NODISCARD bool loop() const { return m_loop; }
+
+    /**
+     * Set the maximum number of frames decoded ahead.
+     *
+     * This takes effect the next time a file is loaded.  The default is 3.
+     */
+    void lookahead(size_t frames) { m_lookahead = frames; }
+
+    /**
+     * Get the maximum number of frames decoded ahead.
+     */
+    EGT_NODISCARD size_t lookahead() const { return m_lookahead; }
+
+    ~AnimatedImage() noexcept override;
+
+protected:
+
+    /// Show the next frame, if it is due and decoded.
+    void present();
+
+    /// Called when a frame is decoded after one was not available.
+    void ready();
+
+    /// Frame stream of the loaded file.
+    std::shared_ptr<detail::FrameStream> m_stream;
+
+    /// Timer for the next frame.
+    Timer m_timer;
+
+    /// Frame shown.
+    shared_cairo_surface_t m_current;
+
+    /// Time to show the current frame for.
+    std::chrono::milliseconds m_current_delay{0};
+
+    /// Time the next frame is due.
+    std::chrono::steady_clock::time_point m_deadline;
+
+    /// Playing state.
+    bool m_running{false};
+
+    /// Loop state.
+    bool m_loop{true};
+
+    /// Maximum number of frames decoded ahead.
+    size_t m_lookahead{3};
+};
+
+}
+}
+}
+
+#endif
@@ -123,6 +123,12 @@ public:
      */
     EGT_NODISCARD const std::vector<Window*>& windows() const { return m_windows; }
 
+    /**
+     * Get the list of input devices created from EGT_INPUT_DEVICES or found
+     * automatically.
+     */
+    EGT_NODISCARD const std::vector<std::unique_ptr<Input>>& inputs() const { return m_inputs; }
+
     /**
      * Paint the entire Screen to a file.
      */
@@ -148,6 +154,22 @@ public:
      */
     void dump_timers(std::ostream& out) const;
 
+    /**
+     * Dump recorded trace events to the specified std::ostream in Chrome trace
+     * event JSON format.
+     *
+     * Trace events are only recorded when EGT is configured with
+     * --enable-trace and the EGT_TRACE environment variable is set.
+     * Otherwise, an empty trace is written.
+     *
+     * Example:
+     * @code{.cpp}
+     * std::ofstream out("trace.json");
+     * app.dump_trace(out);
+     * @endcode
+     */
+    void dump_trace(std::ostream& out) const;
+
     /**
      * Get a list of input devices configured with the EGT_INPUT_DEVICES
      * environment variable.
@@ -126,9 +126,9 @@ public:
      *
      * @see detail::Object::on_event()
      */
-    RegisterHandle on_click(const EventCallback& handler)
+    RegisterHandle on_click(EventCallback handler)
     {
-        return on_event(handler, {EventId::pointer_click});
+        return on_event(std::move(handler), {EventId::pointer_click});
     }
 
     /// Default draw method for the widget.
@@ -132,6 +132,59 @@ public:
      */
     void clear();
 
+    /**
+     * Switch the LineChart to streaming mode.
+     *
+     * In streaming mode, the LineChart shows the last @p capacity samples
+     * added with append().  The samples are equally spaced on the x axis,
+     * which shows the age of samples with the newest at the right edge, and
+     * the x axis always spans the capacity so the plot scrolls at a fixed
+     * scale.
+     *
+     * The samples are kept in a ring buffer allocated once, so appending does
+     * not allocate.  For drawing, the samples are reduced to the minimum and
+     * maximum of each pixel column of the plot, which are cached and only
+     * computed for new samples.  This keeps drawing cheap no matter how many
+     * samples are shown.
+     *
+     * Streaming mode is drawn by a built-in renderer instead of plplot.  The
+     * grid, axes and labels are cached and only drawn again when the size,
+     * style or y range changes.  Appending samples scrolls the cached plot
+     * and draws only the new pixel columns, and only damages the plot area.
+     *
+     * Setting data with data() or add_data() leaves streaming mode.
+     *
+     * @param[in] capacity Number of samples shown, or 0 to leave streaming mode.
+     */
+    void stream_capacity(size_t capacity);
+
+    /**
+     * Get the number of samples shown in streaming mode, or 0 if not streaming.
+     */
+    EGT_NODISCARD size_t stream_capacity() const;
+
+    /**
+     * Append samples in streaming mode.
+     *
+     * @param[in] samples Array of samples.
+     * @param[in] count Number of samples in the array.
+     *
+     * @see stream_capacity()
+     */
+    void append(const double* samples, size_t count);
+
+    /**
+     * Append samples in streaming mode.
+     *
+     * @param[in] samples Contiguous container of samples, like a std::vector
+     *            or std::array.
+     */
+    template<class T>
+    void append(const T& samples)
+    {
+        append(samples.data(), samples.size());
+    }
+
     /**
      * Set the grid style.
      */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_BOXCACHE_H
+#define EGT_DETAIL_BOXCACHE_H
+
+#include <cstdint>
+#include <egt/detail/meta.h>
+#include <egt/geometry.h>
+#include <egt/pattern.h>
+#include <egt/theme.h>
+#include <egt/types.h>
+#include <list>
+#include <unordered_map>
+
+namespace egt
+{
+inline namespace v1
+{
+class Painter;
+
+namespace detail
+{
+
+/**
+ * Internal box rendering cache used by Theme::draw_box().
+ *
+ * Most boxes drawn by a theme are identical apart from their position on the
+ * screen: the same size, radius, border, fill flags and patterns. Instead of
+ * building a rounded rectangle path and filling it with a gradient every time,
+ * the box is rasterized once into an image surface and then composited on
+ * later draws.
+ *
+ * Small boxes are cached whole. Larger boxes are cached as a narrow slice that
+ * contains the corners and a single pixel wide edge, which is stretched to the
+ * requested size when composited. Vertical gradients limit this to horizontal
+ * slicing, unless the background is a solid color.
+ *
+ * Boxes are only cached when compositing the cached surface gives the exact
+ * same result as drawing directly, which means an integer translation only
+ * transform and, for Theme::FillFlag::solid, opaque colors. Everything else
+ * falls back to drawing directly.
+ *
+ * This is a trade off in consuming more memory instead of constantly
+ * rasterizing the same boxes.
+ */
+class EGT_API BoxCache
+{
+public:
+
+    /**
+     * Cache statistics.
+     */
+    struct Stats
+    {
+        /// Number of draws satisfied from the cache.
+        uint64_t hits{0};
+        /// Number of draws that had to rasterize a new cache entry.
+        uint64_t misses{0};
+        /// Number of draws that could not be cached and were drawn directly.
+        uint64_t bypassed{0};
+        /// Number of entries evicted to stay within max_bytes().
+        uint64_t evictions{0};
+        /// Current number of entries in the cache.
+        size_t entries{0};
+        /// Current number of bytes used by cached surfaces.
+        size_t bytes{0};
+    };
+
+    BoxCache() noexcept;
+
+    /**
+     * Draw a box through the cache.
+     *
+     * @return false if the box cannot be cached and must be drawn directly.
+     */
+    bool draw(Painter& painter,
+              const Theme& theme,
+              const Theme::FillFlags& type,
+              const Rect& rect,
+              const Pattern& border,
+              const Pattern& bg,
+              DefaultDim border_width,
+              DefaultDim margin_width,
+              float border_radius,
+              const Theme::BorderFlags& border_flags);
+
+    /**
+     * Clear the cache.
+     *
+     * This must be called when anything that affects how a Theme draws boxes
+     * changes.
+     */
+    void clear();
+
+    /**
+     * Enable or disable the cache.
+     *
+     * The cache can also be disabled with the EGT_NO_BOX_CACHE environment
+     * variable.
+     */
+    void enable(bool enable);
+
+    /// Is the cache enabled?
+    EGT_NODISCARD bool enabled() const { return m_enabled; }
+
+    /// Set the maximum number of bytes used by cached surfaces.
+    void max_bytes(size_t bytes);
+
+    /// Get the maximum number of bytes used by cached surfaces.
+    EGT_NODISCARD size_t max_bytes() const { return m_max_bytes; }
+
+    /**
+     * Set the largest area, in pixels, of a box that is cached whole instead
+     * of being sliced.
+     */
+    void max_whole_area(DefaultDim area) { m_max_whole_area = area; }
+
+    /// Get the largest area, in pixels, of a box that is cached whole.
+    EGT_NODISCARD DefaultDim max_whole_area() const { return m_max_whole_area; }
+
+    /// Get the cache statistics.
+    EGT_NODISCARD Stats stats() const;
+
+    /// Reset the hit, miss, bypass and eviction counters.
+    void reset_stats();
+
+protected:
+
+    /// @private
+    struct Key
+    {
+        size_t theme{0};
+        uint32_t type{0};
+        uint32_t border_flags{0};
+        Size size;
+        DefaultDim border_width{0};
+        DefaultDim margin_width{0};
+        float border_radius{0};
+        int antialias{0};
+        const Pattern* border{nullptr};
+        const Pattern* bg{nullptr};
+
+        EGT_NODISCARD size_t hash() const;
+        EGT_NODISCARD bool operator==(const Key& rhs) const;
+    };
+
+    /// @private
+    struct Entry
+    {
+        Key key;
+        Pattern border;
+        Pattern bg;
+        shared_cairo_surface_t surface;
+        size_t bytes{0};
+    };
+
+    using EntryList = std::list<Entry>;
+
+    shared_cairo_surface_t find(const Key& key, size_t hash);
+    void insert(const Key& key, size_t hash, shared_cairo_surface_t surface);
+    void evict();
+
+    static void composite(Painter& painter, cairo_surface_t* surface,
+                          const Rect& rect, DefaultDim xslice, DefaultDim yslice);
+
+    /// Entries, most recently used first.
+    EntryList m_entries;
+    /// Lookup from key hash to entry.
+    std::unordered_multimap<size_t, EntryList::iterator> m_index;
+    Stats m_stats;
+    size_t m_max_bytes{1024 * 1024};
+    DefaultDim m_max_whole_area{64 * 64};
+    bool m_enabled{true};
+};
+
+/**
+ * Global box cache instance.
+ */
+EGT_API BoxCache& box_cache();
+
+}
+}
+}
+
+#endif
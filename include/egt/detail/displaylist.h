@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_DISPLAYLIST_H
+#define EGT_DETAIL_DISPLAYLIST_H
+
+#include <cairo.h>
+#include <cstdint>
+#include <egt/color.h>
+#include <egt/detail/meta.h>
+#include <egt/geometry.h>
+#include <egt/pattern.h>
+#include <egt/theme.h>
+#include <egt/types.h>
+#include <string>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+class Painter;
+
+namespace detail
+{
+
+/**
+ * Recorded list of drawing commands.
+ *
+ * A Painter constructed with a DisplayList records the commands it is given
+ * instead of drawing them. Everything needed to draw a command is captured
+ * when it is recorded, including the cairo path, transform, operator and
+ * source, so a list can be compared against a previous recording, and later
+ * replayed onto any Painter.
+ *
+ * Only drawing that goes through Painter, and Theme::draw_box(), is recorded.
+ * Anything drawn by calling cairo directly on the context of a recording
+ * Painter is lost.
+ */
+class EGT_API DisplayList
+{
+public:
+
+    DisplayList() = default;
+
+    /// Remove all recorded commands.
+    void clear();
+
+    /// Returns true if there are no recorded commands.
+    EGT_NODISCARD bool empty() const { return m_commands.empty(); }
+
+    /// Number of recorded commands.
+    EGT_NODISCARD size_t size() const { return m_commands.size(); }
+
+    /**
+     * Draw the recorded commands.
+     *
+     * Transforms in the list are relative to the transform of the painter.
+     */
+    void replay(Painter& painter) const;
+
+    /// Compare the drawing produced by two lists.
+    EGT_NODISCARD bool operator==(const DisplayList& rhs) const;
+
+    /// Compare the drawing produced by two lists.
+    EGT_NODISCARD bool operator!=(const DisplayList& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /**
+     * Mark a surface that is never changed after it is created.
+     *
+     * Lists that draw the same surface only compare equal when it is marked,
+     * because any other surface may have been drawn into since it was
+     * recorded.
+     */
+    static void mark_immutable(cairo_surface_t* surface);
+
+    /// Returns true if the surface was marked with mark_immutable().
+    EGT_NODISCARD static bool immutable(const cairo_surface_t* surface);
+
+    /// @private
+    enum class Type : uint8_t
+    {
+        save,
+        restore,
+        push_group,
+        pop_group,
+        fill,
+        stroke,
+        clip,
+        paint,
+        mask,
+        image,
+        fill_rect,
+        text,
+        flood,
+        pixel,
+        box,
+    };
+
+    /**
+     * @name Recording
+     * Called by a recording Painter.
+     * @{
+     */
+    /// @private
+    void state(cairo_t* cr, Type type);
+    /// @private
+    void path(cairo_t* cr, Type type);
+    /// @private
+    void paint(cairo_t* cr, float alpha);
+    /// @private
+    void mask(cairo_t* cr, const shared_cairo_surface_t& surface, const Point& point);
+    /// @private
+    void image(cairo_t* cr, const shared_cairo_surface_t& surface,
+               const Rect& rect, const PointF& point, bool rect_only);
+    /// @private
+    void fill(cairo_t* cr, const Rect& rect, const Color& color);
+    /// @private
+    void text(cairo_t* cr, const std::string& str, uint32_t flags);
+    /// @private
+    void flood(const Point& point, const Color& color, uint32_t tolerance);
+    /// @private
+    void pixel(const Point& point, const Color& color);
+    /// @private
+    void box(cairo_t* cr,
+             const Theme& theme,
+             const Theme::FillFlags& type,
+             const Rect& rect,
+             const Pattern& border,
+             const Pattern& bg,
+             DefaultDim border_width,
+             DefaultDim margin_width,
+             float border_radius,
+             const Theme::BorderFlags& border_flags);
+    /** @} */
+
+protected:
+
+    /// Context state a command is drawn with.
+    struct State
+    {
+        cairo_matrix_t matrix;
+        cairo_operator_t op;
+        cairo_antialias_t antialias;
+        cairo_fill_rule_t fill_rule;
+        cairo_line_cap_t line_cap;
+        cairo_line_join_t line_join;
+        double line_width;
+        uint32_t source;
+
+        EGT_NODISCARD bool operator==(const State& rhs) const;
+    };
+
+    /// Arguments to Theme::draw_box().
+    struct Box
+    {
+        const Theme* theme;
+        Theme::FillFlags type;
+        Rect rect;
+        Pattern border;
+        Pattern bg;
+        DefaultDim border_width;
+        DefaultDim margin_width;
+        float border_radius;
+        Theme::BorderFlags border_flags;
+
+        EGT_NODISCARD bool operator==(const Box& rhs) const;
+    };
+
+    /**
+     * A command only stores its type, state, and a range of m_values with its
+     * arguments. Arguments kept in the other arrays are referenced by index
+     * from m_values.
+     */
+    struct Command
+    {
+        Type type;
+        uint32_t state;
+        uint32_t begin;
+        uint32_t end;
+
+        EGT_NODISCARD bool operator==(const Command& rhs) const
+        {
+            return type == rhs.type && state == rhs.state &&
+                   begin == rhs.begin && end == rhs.end;
+        }
+    };
+
+    uint32_t capture(cairo_t* cr);
+    void add(Type type, uint32_t state, size_t begin, size_t end);
+    void apply(cairo_t* cr, const cairo_matrix_t& base, uint32_t state) const;
+
+    /// Recorded commands.
+    std::vector<Command> m_commands;
+    /// States, shared by consecutive commands when they do not change.
+    std::vector<State> m_states;
+    /// Source patterns referenced by states.
+    std::vector<shared_cairo_pattern_t> m_sources;
+    /// Flattened paths and numeric arguments.
+    std::vector<double> m_values;
+    /// Text arguments.
+    std::vector<std::string> m_strings;
+    /// Surface arguments.
+    std::vector<shared_cairo_surface_t> m_surfaces;
+    /// Font arguments.
+    std::vector<shared_cairo_scaled_font_t> m_fonts;
+    /// Box arguments.
+    std::vector<Box> m_boxes;
+    /// Group popped by the last pop_group, while it is still the source.
+    cairo_pattern_t* m_group{nullptr};
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_INPLACEFUNCTION_H
+#define EGT_DETAIL_INPLACEFUNCTION_H
+
+/**
+ * @file
+ * @brief Function wrapper with inline storage.
+ */
+
+#include <cstddef>
+#include <egt/detail/meta.h>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+template<class Signature, size_t Capacity = 4 * sizeof(void*)>
+class InplaceFunction;
+
+/**
+ * Move-only function wrapper that stores small callables inline.
+ *
+ * This is like std::function, but callables up to Capacity bytes, like
+ * lambdas capturing a few pointers or values, are stored inside the object
+ * instead of being allocated on the heap.  Larger callables are still
+ * supported and are allocated on the heap.
+ *
+ * Like std::function, constructing from a null function pointer or an empty
+ * std::function results in an empty InplaceFunction.
+ */
+template<class R, class... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+    template<class F>
+    using enable_if_callable = typename std::enable_if <
+                               !std::is_same<typename std::decay<F>::type, InplaceFunction>::value &&
+                               !std::is_same<typename std::decay<F>::type, std::nullptr_t>::value >::type;
+
+public:
+
+    InplaceFunction() noexcept = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    InplaceFunction(std::nullptr_t) noexcept
+    {}
+
+    template<class F, class = enable_if_callable<F>>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    InplaceFunction(F&& f)
+    {
+        if (!is_null(f))
+            construct(std::forward<F>(f));
+    }
+
+    InplaceFunction(InplaceFunction&& rhs) noexcept
+    {
+        move_from(rhs);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            reset();
+            move_from(rhs);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template<class F, class = enable_if_callable<F>>
+    InplaceFunction& operator=(F&& f)
+    {
+        reset();
+        if (!is_null(f))
+            construct(std::forward<F>(f));
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    /// Check if a callable is stored.
+    explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+    /// Call the stored callable.
+    R operator()(Args... args) const
+    {
+        return m_ops->invoke(const_cast<void*>(static_cast<const void*>(&m_storage)),
+                             std::forward<Args>(args)...);
+    }
+
+    /// Destroy the stored callable, if any.
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    /// Check if a callable of type F would be stored inline.
+    template<class F>
+    static constexpr bool stored_inline()
+    {
+        return sizeof(F) <= Capacity &&
+               alignof(F) <= alignof(Storage) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+    ~InplaceFunction() noexcept
+    {
+        reset();
+    }
+
+private:
+
+    using Storage = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+    struct Ops
+    {
+        R(*invoke)(void* storage, Args&& ... args);
+        void (*move)(void* to, void* from) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<class F>
+    struct InlineOps
+    {
+        static R invoke(void* storage, Args&& ... args)
+        {
+            return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+        }
+
+        static void move(void* to, void* from) noexcept
+        {
+            new (to) F(std::move(*static_cast<F*>(from)));
+            static_cast<F*>(from)->~F();
+        }
+
+        static void destroy(void* storage) noexcept
+        {
+            static_cast<F*>(storage)->~F();
+        }
+
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    template<class F>
+    struct HeapOps
+    {
+        static R invoke(void* storage, Args&& ... args)
+        {
+            return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+        }
+
+        static void move(void* to, void* from) noexcept
+        {
+            *static_cast<F**>(to) = *static_cast<F**>(from);
+        }
+
+        static void destroy(void* storage) noexcept
+        {
+            delete *static_cast<F**>(storage);
+        }
+
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    template<class F>
+    static bool is_null(const F&) noexcept
+    {
+        return false;
+    }
+
+    template<class T>
+    static bool is_null(T* f) noexcept
+    {
+        return f == nullptr;
+    }
+
+    template<class S>
+    static bool is_null(const std::function<S>& f) noexcept
+    {
+        return !f;
+    }
+
+    template<class F>
+    typename std::enable_if<stored_inline<typename std::decay<F>::type>()>::type
+    construct(F&& f)
+    {
+        using T = typename std::decay<F>::type;
+        new (&m_storage) T(std::forward<F>(f));
+        m_ops = &InlineOps<T>::ops;
+    }
+
+    template<class F>
+    typename std::enable_if < !stored_inline<typename std::decay<F>::type>() >::type
+    construct(F&& f)
+    {
+        using T = typename std::decay<F>::type;
+        *reinterpret_cast<T**>(&m_storage) = new T(std::forward<F>(f));
+        m_ops = &HeapOps<T>::ops;
+    }
+
+    void move_from(InplaceFunction& rhs) noexcept
+    {
+        if (rhs.m_ops)
+        {
+            rhs.m_ops->move(&m_storage, &rhs.m_storage);
+            m_ops = rhs.m_ops;
+            rhs.m_ops = nullptr;
+        }
+    }
+
+    Storage m_storage;
+    const Ops* m_ops{nullptr};
+};
+
+template<class R, class... Args, size_t Capacity>
+template<class F>
+constexpr typename InplaceFunction<R(Args...), Capacity>::Ops
+InplaceFunction<R(Args...), Capacity>::InlineOps<F>::ops;
+
+template<class R, class... Args, size_t Capacity>
+template<class F>
+constexpr typename InplaceFunction<R(Args...), Capacity>::Ops
+InplaceFunction<R(Args...), Capacity>::HeapOps<F>::ops;
+
+}
+}
+}
+
+#endif
@@ -68,6 +68,11 @@ private:
      * Internal descriptor;
      */
     int m_fd{-1};
+
+    /**
+     * Event timestamps use CLOCK_MONOTONIC.
+     */
+    bool m_monotonic{false};
 };
 
 }
@@ -43,6 +43,8 @@ public:
      */
     explicit InputLibInput(Application& app);
 
+    void screen_resized(const Size& size) override;
+
     ~InputLibInput() noexcept override;
 
 private:
@@ -69,6 +71,9 @@ private:
 
     /// The last point seen, indexed by slot, used for reference internally.
     std::array<DisplayPoint, 2> m_last_point{};
+
+    /// Screen size absolute positions are scaled to, used on the input thread.
+    Size m_screen_size;
 };
 
 }
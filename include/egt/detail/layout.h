@@ -9,6 +9,7 @@
 #include <egt/detail/meta.h>
 #include <egt/geometry.h>
 #include <egt/widgetflags.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -89,6 +90,24 @@ struct EGT_API LayoutRect
     uint32_t bmargin{0};
 };
 
+/// Compares all inputs of a LayoutRect.
+inline bool operator==(const LayoutRect& lhs, const LayoutRect& rhs)
+{
+    return lhs.rect == rhs.rect &&
+           lhs.behave == rhs.behave &&
+           lhs.lmargin == rhs.lmargin &&
+           lhs.tmargin == rhs.tmargin &&
+           lhs.rmargin == rhs.rmargin &&
+           lhs.bmargin == rhs.bmargin &&
+           lhs.str == rhs.str;
+}
+
+/// Compares all inputs of a LayoutRect.
+inline bool operator!=(const LayoutRect& lhs, const LayoutRect& rhs)
+{
+    return !(lhs == rhs);
+}
+
 /**
  * Perform a manual flex layout given a parent rect and children rects.
  */
@@ -106,6 +125,51 @@ EGT_API void flex_layout(const Rect& parent,
                          Justification justify,
                          Orientation orient,
                          const AlignFlags& align);
+
+/**
+ * Flex layout that keeps its layout context and last result between calls.
+ *
+ * This is the same as flex_layout(), except the layout is only computed again
+ * when the parent rect, justification, orientation, or any of the children
+ * differ from the last call.  Otherwise, the last result is reused.  The
+ * layout context is also reused, so a layout does not allocate unless there
+ * are more children than before.
+ */
+class EGT_API FlexLayout
+{
+public:
+
+    FlexLayout();
+    FlexLayout(const FlexLayout&) = delete;
+    FlexLayout& operator=(const FlexLayout&) = delete;
+    FlexLayout(FlexLayout&&) noexcept;
+    FlexLayout& operator=(FlexLayout&&) noexcept;
+    ~FlexLayout() noexcept;
+
+    /**
+     * Perform a flex layout given a parent rect and children rects.
+     *
+     * @return true if the layout was computed, or false if the last result
+     *         was reused.
+     */
+    bool layout(const Rect& parent,
+                std::vector<LayoutRect>& children,
+                Justification justify,
+                Orientation orient);
+
+    /**
+     * Forget the last result so the next layout() is computed.
+     */
+    void invalidate();
+
+private:
+
+    struct FlexLayoutImpl;
+
+    /// Layout context and cached inputs and results.
+    std::unique_ptr<FlexLayoutImpl> m_impl;
+};
+
 }
 }
 }
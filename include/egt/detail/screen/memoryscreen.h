@@ -13,6 +13,8 @@
 
 #include <egt/canvas.h>
 #include <egt/screen.h>
+#include <iosfwd>
+#include <memory>
 #include <string>
 
 namespace egt
@@ -22,8 +24,16 @@ inline namespace v1
 namespace detail
 {
 
+class OverdrawAnalyzer;
+
 /**
  * Screen in an in-memory buffer.
+ *
+ * When the EGT_OVERDRAW environment variable is set, drawing is analyzed for
+ * overdraw, estimated from the rectangles widgets draw, and damage that does
+ * not change any pixels.  The results are
+ * written when the screen is destroyed, or with overdraw_report() and
+ * overdraw_save().
  */
 class MemoryScreen : public Screen
 {
@@ -31,12 +41,34 @@ public:
 
     explicit MemoryScreen(const Size& size = Size(800, 480));
 
+    void flip(const DamageArray& damage) override;
+
     void schedule_flip() override {}
 
     virtual void save_to_file(const std::string& filename) const;
 
+    /**
+     * Write overdraw summary numbers, and the widgets with the most wasted
+     * draws, to the specified std::ostream.
+     *
+     * Does nothing unless EGT_OVERDRAW is set.
+     */
+    void overdraw_report(std::ostream& out) const;
+
+    /**
+     * Save overdraw heatmaps to prefix-overdraw.png and prefix-wasted.png.
+     *
+     * Does nothing unless EGT_OVERDRAW is set.
+     */
+    void overdraw_save(const std::string& prefix) const;
+
+    ~MemoryScreen() noexcept override;
+
 protected:
     Canvas m_canvas;
+
+    /// Overdraw analysis, if enabled.
+    std::unique_ptr<OverdrawAnalyzer> m_overdraw;
 };
 
 }
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_SPATIALINDEX_H
+#define EGT_DETAIL_SPATIALINDEX_H
+
+/**
+ * @file
+ * @brief Spatial index of child widgets.
+ */
+
+#include <cstdint>
+#include <egt/detail/meta.h>
+#include <egt/geometry.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+class Widget;
+
+namespace detail
+{
+
+/**
+ * Uniform grid of the boxes of the children of a Frame.
+ *
+ * Each child is stored in every grid cell its box overlaps, so finding the
+ * children under a point only looks at the children in one cell instead of
+ * all of them.  Children with boxes covering a large number of cells are kept
+ * in a separate list that is always searched.
+ *
+ * Children are identified by their index in the children array of the Frame,
+ * which is also their z-order.  The index is rebuilt from the children array
+ * when it is invalidated, which is needed any time children are added,
+ * removed, or reordered.  A child that moves or resizes is updated in place.
+ */
+class EGT_API SpatialIndex
+{
+public:
+
+    /// Helper type for an array of children.
+    using ChildrenArray = std::vector<std::shared_ptr<Widget>>;
+
+    /**
+     * Mark the index as needing to be rebuilt.
+     */
+    void invalidate() { m_valid = false; }
+
+    /**
+     * Rebuild the index if it was invalidated.
+     */
+    void build(const ChildrenArray& children);
+
+    /**
+     * Update the box of a child that moved or resized.
+     *
+     * Does nothing if the index needs to be rebuilt anyway.
+     */
+    void update(const Widget* widget, const Rect& box);
+
+    /**
+     * Find the child with the highest z-order whose box contains a point.
+     *
+     * @param[in] children Children array the index was built from.
+     * @param[in] point Point in the same coordinates as the child boxes.
+     * @param[in] pred Only children for which this returns true are matched.
+     * @return The matching child, or nullptr.
+     */
+    template<class Pred>
+    Widget* find(const ChildrenArray& children, const Point& point, Pred pred)
+    {
+        build(children);
+
+        int best = -1;
+        auto check = [&](const std::vector<uint32_t>& indexes)
+        {
+            for (auto index : indexes)
+            {
+                if (static_cast<int>(index) > best &&
+                    m_entries[index].box.intersect(point) &&
+                    pred(children[index].get()))
+                    best = index;
+            }
+        };
+
+        auto cell = m_cells.find(key(cell_of(point.x()), cell_of(point.y())));
+        if (cell != m_cells.end())
+            check(cell->second);
+        check(m_large);
+
+        return best < 0 ? nullptr : children[best].get();
+    }
+
+private:
+
+    struct Entry
+    {
+        const Widget* widget{nullptr};
+        /// Box the child was indexed with.
+        Rect box;
+    };
+
+    /// Grid cell containing a coordinate.
+    EGT_NODISCARD int32_t cell_of(DefaultDim value) const
+    {
+        return value >= 0 ? value / m_cell_size : (value + 1) / m_cell_size - 1;
+    }
+
+    static uint64_t key(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+               static_cast<uint32_t>(y);
+    }
+
+    void insert(uint32_t index);
+    void erase(uint32_t index);
+
+    /// Width and height of each grid cell.
+    DefaultDim m_cell_size{64};
+    /// Set when the index matches the children.
+    bool m_valid{false};
+    /// Indexed children, in z-order.
+    std::vector<Entry> m_entries;
+    /// Map of child to index in m_entries.
+    std::unordered_map<const Widget*, uint32_t> m_lookup;
+    /// Grid cells, each containing the indexes of the children overlapping it.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    /// Children that overlap too many cells to store in each of them.
+    std::vector<uint32_t> m_large;
+};
+
+}
+}
+}
+
+#endif
@@ -11,6 +11,8 @@
  * @brief Event types.
  */
 
+#include <cassert>
+#include <chrono>
 #include <egt/detail/meta.h>
 #include <egt/geometry.h>
 #include <egt/keycode.h>
@@ -329,6 +331,73 @@ struct EGT_API Event : public EventArg
      */
     void grab(Widget* widget);
 
+    /// Type used for event timestamps.
+    using Timestamp = std::chrono::steady_clock::time_point;
+
+    /**
+     * Get the time the event happened.
+     *
+     * When available, this is the time the input device reported the event
+     * to the kernel.  Otherwise, it is the time the event was dispatched.
+     */
+    EGT_NODISCARD const Timestamp& timestamp() const noexcept
+    {
+        return m_timestamp;
+    }
+
+    /**
+     * Set the time the event happened.
+     */
+    void timestamp(const Timestamp& timestamp) noexcept
+    {
+        m_timestamp = timestamp;
+    }
+
+    /**
+     * Get the number of pointer positions coalesced into this event.
+     *
+     * When an Input coalesces pointer motion, consecutive
+     * EventId::raw_pointer_move events between frames are dispatched as a
+     * single event with the latest position.  The positions of the events that
+     * were dropped, oldest first, are available as the history of the event.
+     *
+     * Only valid with the following events:
+     *   - EventId::raw_pointer_move
+     *   - EventId::pointer_drag
+     *
+     * @see Input::coalesce()
+     */
+    EGT_NODISCARD size_t history_size() const noexcept
+    {
+        return m_history_size;
+    }
+
+    /**
+     * Get a pointer position coalesced into this event.
+     *
+     * @param[in] index Index of the position, where 0 is the oldest.
+     *
+     * @note The history is only valid while the event is being dispatched.
+     */
+    EGT_NODISCARD const DisplayPoint& history(size_t index) const
+    {
+        assert(index < m_history_size);
+        return m_history[index];
+    }
+
+    /**
+     * Set the pointer positions coalesced into this event.
+     *
+     * @param[in] points Positions, oldest first.  Must remain valid while the
+     *            event is dispatched.
+     * @param[in] size Number of positions.
+     */
+    void history(const DisplayPoint* points, size_t size) noexcept
+    {
+        m_history = points;
+        m_history_size = size;
+    }
+
 protected:
 
     /**
@@ -345,6 +414,21 @@ protected:
      * Pointer event data.
      */
     Pointer m_pointer;
+
+    /**
+     * Time the event happened.
+     */
+    Timestamp m_timestamp{};
+
+    /**
+     * Pointer positions coalesced into this event.
+     */
+    const DisplayPoint* m_history{nullptr};
+
+    /**
+     * Number of pointer positions coalesced into this event.
+     */
+    size_t m_history_size{0};
 };
 
 static_assert(detail::rule_of_5<Event>(), "must fulfill rule of 5");
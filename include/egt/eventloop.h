@@ -11,6 +11,9 @@
  * @brief Working with the event loop.
  */
 
+#include <chrono>
+#include <cstdint>
+#include <egt/detail/inplacefunction.h>
 #include <egt/detail/meta.h>
 #include <functional>
 #include <memory>
@@ -29,7 +32,9 @@ class Application;
 
 namespace detail
 {
+class AsyncQueue;
 class PriorityQueue;
+class TimerWheel;
 }
 
 /**
@@ -50,6 +55,135 @@ public:
      */
     asio::io_context& io();
 
+    /**
+     * Handler priorities.
+     *
+     * Each time the event loop wakes up, queued handlers are run from the
+     * highest priority to the lowest.  Priority::input and Priority::frame
+     * handlers are always run.  Once the budget() for the frame is spent,
+     * lower priority handlers are deferred until after the next frame is
+     * drawn, so they can not delay input or frame deadlines.
+     */
+    enum class Priority
+    {
+        /// Background work.
+        idle,
+        /// Normal handlers.
+        normal,
+        /// Timers and animations for the next frame.
+        frame,
+        /// Reading input devices.
+        input,
+    };
+
+    /**
+     * Queue a handler to be run by the event loop.
+     *
+     * This must be called from the event loop thread.
+     *
+     * @param[in] priority Priority of the handler.
+     * @param[in] handler The handler to run.
+     */
+    void post(Priority priority, std::function<void()> handler);
+
+    /// Function type used by call_async().
+    using AsyncCall = detail::InplaceFunction<void(), 8 * sizeof(void*)>;
+
+    /**
+     * Call a function on the event loop thread.
+     *
+     * This may be called from any thread.  The function is called the next
+     * time the event loop wakes up, and always before the next frame is drawn.
+     *
+     * Functions with captures up to the size of 8 pointers are stored in a
+     * pool, so this does not allocate once the pool has grown.
+     *
+     * @param[in] func The function to call.
+     */
+    template<class F>
+    void call_async(F&& func)
+    {
+        post_async(nullptr, AsyncCall(std::forward<F>(func)));
+    }
+
+    /**
+     * Call a function on the event loop thread, replacing any pending call
+     * with the same key.
+     *
+     * Only the latest function posted with a key before it is called is
+     * called, in the place of the first.  This is useful for streaming values
+     * from another thread, where only the latest value is needed.
+     *
+     * @b Example
+     * @code{.cpp}
+     * // on a sensor thread
+     * app.event().call_async(&label, [&label, value]()
+     * {
+     *     label.text(std::to_string(value));
+     * });
+     * @endcode
+     *
+     * @param[in] key Coalescing key, usually the address of the object
+     *                updated by the function.
+     * @param[in] func The function to call.
+     */
+    template<class F>
+    void call_async(const void* key, F&& func)
+    {
+        post_async(key, AsyncCall(std::forward<F>(func)));
+    }
+
+    /**
+     * Cancel any pending call_async() function with a key.
+     *
+     * An object that posts calls with its address as the key should call
+     * this when destroyed, once nothing posts for it anymore, so no call runs
+     * on the destroyed object.
+     *
+     * This must be called from the event loop thread.
+     *
+     * @param[in] key Coalescing key the functions were posted with.
+     */
+    void cancel_async(const void* key);
+
+    /**
+     * Set the time budget for running handlers each time the event loop wakes
+     * up, before drawing.
+     *
+     * The default is 10 milliseconds.
+     */
+    void budget(std::chrono::microseconds budget) { m_budget = budget; }
+
+    /**
+     * Get the time budget for running handlers before drawing.
+     */
+    EGT_NODISCARD std::chrono::microseconds budget() const { return m_budget; }
+
+    /**
+     * Get the io_context to read input devices on.
+     *
+     * If the EGT_INPUT_THREAD environment variable is set, this is run by a
+     * dedicated input thread, so input devices are read and their events
+     * timestamped even while the event loop is busy drawing.  Events are
+     * handed to the event loop through a bounded lock-free queue, which is
+     * drained when the event loop wakes up and at the start of each frame.
+     *
+     * Otherwise, this is the same as io().
+     *
+     * @private
+     */
+    asio::io_context& input_io();
+
+    /**
+     * Stop the input thread, if running.
+     *
+     * This must be called before destroying input devices using input_io().
+     * The input thread is started again by the next call to input_io().
+     *
+     * @private
+     */
+    void stop_input_thread();
+
     /**
      * Perform a draw.
      *
@@ -58,6 +192,19 @@ public:
      */
     void draw();
 
+    /**
+     * Perform any pending layout.
+     *
+     * While the event loop is running, Widget::request_layout() only marks
+     * widgets as needing layout, and all pending layout is performed in a
+     * single pass at the beginning of draw().  Call this if up to date widget
+     * geometry is needed before then.
+     *
+     * @note You do not normally need to call this directly.  It is called by
+     * draw() automatically.
+     */
+    void layout();
+
     /**
      * Run the event loop.
      *
@@ -108,9 +255,81 @@ public:
      */
     void add_idle_callback(IdleCallback func);
 
+    /**
+     * Idle task function definition.
+     *
+     * An idle task does a small piece of work each time it is called, and
+     * returns true if there is more work to do.  It is called repeatedly while
+     * the time slice it is given lasts, and resumed in later idle periods.  The
+     * deadline of the time slice is passed in for tasks that want to do more
+     * work per call.
+     */
+    using IdleTask = std::function<bool (std::chrono::steady_clock::time_point deadline)>;
+
+    /// Handle to an idle task.
+    using IdleTaskHandle = uint64_t;
+
+    /**
+     * Add a task to be run in time slices while the event loop is idle.
+     *
+     * Use this to spread background work, like loading images for the next
+     * screen, across idle periods without delaying input or drawing.  While
+     * there are idle tasks, the event loop does not block waiting for events,
+     * but instead runs one time slice of idle tasks and then checks for
+     * events again.
+     *
+     * Tasks with a higher priority are run first.  Tasks with the same priority
+     * take turns.
+     *
+     * @param[in] task The task.
+     * @param[in] priority Priority of the task.
+     * @return A handle to cancel the task with.
+     */
+    IdleTaskHandle add_idle_task(IdleTask task, int priority = 0);
+
+    /**
+     * Cancel an idle task.
+     *
+     * This may be called from within an idle task, including the task being
+     * cancelled.
+     */
+    void cancel_idle_task(IdleTaskHandle handle);
+
+    /**
+     * Set the length of the time slice of idle tasks.
+     *
+     * The default is 5 milliseconds.
+     */
+    void idle_slice(std::chrono::microseconds slice) { m_idle_slice = slice; }
+
+    /**
+     * Get the length of the time slice of idle tasks.
+     */
+    EGT_NODISCARD std::chrono::microseconds idle_slice() const { return m_idle_slice; }
+
+    /**
+     * Get the idle capacity of the event loop.
+     *
+     * This is the fraction of time, from 0 to 1, the event loop spent waiting
+     * for events or running idle tasks over the last second of running.
+     */
+    EGT_NODISCARD float idle_capacity() const;
+
     /// @private
     detail::PriorityQueue& queue();
 
+    /// @private
+    detail::TimerWheel& timer_wheel();
+
+    /**
+     * Check if layout is being deferred to the next layout pass.
+     *
+     * If it is, a layout pass is scheduled.
+     *
+     * @private
+     */
+    bool defer_layout();
+
     ~EventLoop() noexcept;
 
 protected:
@@ -118,9 +337,21 @@ protected:
     /// Wait for an event to occur.
     int wait();
 
+    /// Queue a call_async() function.
+    void post_async(const void* key, AsyncCall&& call);
+
+    /// Run ready handlers until the budget is spent.
+    int dispatch(std::chrono::steady_clock::time_point deadline);
+
     /// Invoke idle callbacks.
     void invoke_idle_callbacks();
 
+    /// Run idle tasks for one time slice.
+    bool invoke_idle_tasks();
+
+    /// Account time spent idle.
+    void idle_time(std::chrono::steady_clock::duration idle);
+
     struct EventLoopImpl;
 
     /// Internal event loop implementation.
@@ -132,6 +363,21 @@ protected:
     /// Used internally to determine whether the event loop should exit.
     bool m_do_quit{false};
 
+    /// Set while layout is deferred to the next layout pass.
+    bool m_defer_layout{false};
+
+    /// Set while performing a layout pass.
+    bool m_in_layout{false};
+
+    /// Set when layout has been deferred, but the layout pass has not run.
+    bool m_layout_pending{false};
+
+    /// Time budget for running handlers before drawing.
+    std::chrono::microseconds m_budget{std::chrono::milliseconds(10)};
+
+    /// Time slice of idle tasks.
+    std::chrono::microseconds m_idle_slice{std::chrono::milliseconds(5)};
+
     /// Application reference.
     Application& m_app;
 };
@@ -14,6 +14,7 @@
 #include <cassert>
 #include <egt/detail/alignment.h>
 #include <egt/detail/meta.h>
+#include <egt/detail/spatialindex.h>
 #include <egt/screen.h>
 #include <egt/widget.h>
 #include <exception>
@@ -263,7 +264,7 @@ public:
             return;
 
         Widget::show();
-        layout();
+        request_layout();
     }
 
     /**
@@ -272,12 +273,15 @@ public:
      */
     void layout() override;
 
+    /// @private
+    void pending_layout() override;
+
     void resize(const Size& size) override
     {
         if (size != this->size())
         {
             Widget::resize(size);
-            layout();
+            request_layout();
         }
     }
 
@@ -360,6 +364,26 @@ public:
      */
     Widget* hit_test(const DisplayPoint& point);
 
+    /**
+     * Enable or disable a spatial index of the children.
+     *
+     * Normally, finding the child under a point for hit_test() and pointer
+     * events checks every child.  With the spatial index enabled, only the
+     * children near the point are checked.  This is useful for frames with
+     * hundreds of children, like maps, keypads, or grids of tiles.  The index
+     * uses some memory for each child and is updated any time a child moves or
+     * resizes, so it is disabled by default.
+     */
+    void spatial_index(bool enable);
+
+    /**
+     * Check if the spatial index of the children is enabled.
+     */
+    EGT_NODISCARD bool spatial_index() const
+    {
+        return m_spatial_index != nullptr;
+    }
+
     /**
      * Add damage to the damage array.
      *
@@ -493,6 +517,14 @@ protected:
 private:
 
     void remove_all_basic();
+
+    /// Find the top child whose box contains a point.
+    Widget* child_at(const Point& pos, bool events);
+
+    /// Spatial index of children, when enabled.
+    std::unique_ptr<detail::SpatialIndex> m_spatial_index;
+
+    friend class Widget;
 };
 
 }
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_HEATMAP_H
+#define EGT_HEATMAP_H
+
+/**
+ * @file
+ * @brief HeatMap widget.
+ */
+
+#include <array>
+#include <cstdint>
+#include <egt/color.h>
+#include <egt/detail/meta.h>
+#include <egt/frame.h>
+#include <egt/types.h>
+#include <egt/widget.h>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace experimental
+{
+
+/**
+ * Displays a 2D array of values as an image, by mapping each value to a color
+ * of a ColorMap.
+ *
+ * This is meant for data like thermal camera frames or sensor grids that are
+ * updated many times a second.  The ColorMap is sampled once into a lookup
+ * table, and each new array of values is mapped through it into an image the
+ * size of the array when it is set.  Drawing only scales that image to the
+ * content area of the widget, and the widget is only damaged when new values
+ * are set.
+ *
+ * @code{.cpp}
+ * egt::experimental::HeatMap heatmap(window, egt::Rect(0, 0, 320, 240));
+ * heatmap.range(20, 40);
+ * heatmap.data(frame.data(), 80, 60);
+ * @endcode
+ */
+class EGT_API HeatMap : public Widget
+{
+public:
+
+    /**
+     * @param[in] rect Initial rectangle of the widget.
+     */
+    explicit HeatMap(const Rect& rect = {});
+
+    /**
+     * @param[in] parent The parent Frame.
+     * @param[in] rect Initial rectangle of the widget.
+     */
+    explicit HeatMap(Frame& parent, const Rect& rect = {});
+
+    void draw(Painter& painter, const Rect& rect) override;
+
+    /**
+     * Set the values to display.
+     *
+     * The values are mapped to colors immediately, so they do not need to
+     * outlive this call.
+     *
+     * @param[in] values Values, row by row.
+     * @param[in] width Number of values in each row.
+     * @param[in] height Number of rows.
+     */
+    void data(const float* values, size_t width, size_t height);
+
+    /**
+     * Set the values to display.
+     *
+     * @param[in] values Values, row by row.
+     * @param[in] width Number of values in each row.
+     */
+    void data(const std::vector<float>& values, size_t width)
+    {
+        if (width)
+            data(values.data(), width, values.size() / width);
+    }
+
+    /**
+     * Set the color map.
+     *
+     * The minimum of the range is mapped to the first color step and the
+     * maximum to the last one.
+     */
+    void colormap(const ColorMap& colormap);
+
+    /**
+     * Set the range of values mapped to the color map.
+     *
+     * Values outside of the range are mapped to the first or last color.
+     */
+    void range(float min, float max);
+
+    /// Get the minimum of the range.
+    EGT_NODISCARD float min() const { return m_min; }
+
+    /// Get the maximum of the range.
+    EGT_NODISCARD float max() const { return m_max; }
+
+    /**
+     * Enable or disable bilinear filtering when scaling.
+     *
+     * When disabled, each value is drawn as a solid rectangle.
+     */
+    void bilinear(bool enable)
+    {
+        if (detail::change_if_diff<>(m_bilinear, enable))
+            damage();
+    }
+
+    /// Get the bilinear filtering state.
+    EGT_NODISCARD bool bilinear() const { return m_bilinear; }
+
+protected:
+
+    /// Map the last values again, after the range or color map changed.
+    void remap();
+
+    /// Colors of the color map, as premultiplied ARGB32 pixels.
+    std::array<uint32_t, 256> m_lut{};
+
+    /// Last values set.
+    std::vector<float> m_values;
+
+    /// Number of values in each row.
+    size_t m_width{0};
+
+    /// Number of rows.
+    size_t m_height{0};
+
+    /// Minimum of the range.
+    float m_min{0.f};
+
+    /// Maximum of the range.
+    float m_max{1.f};
+
+    /// Bilinear filtering state.
+    bool m_bilinear{true};
+
+    /// Image of the mapped values.
+    unique_cairo_surface_t m_surface;
+};
+
+}
+}
+}
+
+#endif
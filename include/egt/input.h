@@ -15,7 +15,9 @@
 #include <egt/event.h>
 #include <egt/object.h>
 #include <egt/signal.h>
+#include <chrono>
 #include <memory>
+#include <vector>
 
 namespace egt
 {
@@ -24,7 +26,9 @@ inline namespace v1
 
 namespace detail
 {
+class InputThread;
 class MouseGesture;
+class PointerFilter;
 }
 
 class Widget;
@@ -68,15 +72,128 @@ public:
         return m_global_handler;
     }
 
+    /**
+     * Enable or disable coalescing of pointer motion.
+     *
+     * When enabled, consecutive EventId::raw_pointer_move events of the same
+     * slot are not dispatched right away.  Only the latest one is dispatched,
+     * before the next frame is drawn or before any other event from this
+     * input, whichever comes first.  The positions of the dropped events are
+     * kept as the history of the dispatched event, and of any
+     * EventId::pointer_drag generated from it.
+     *
+     * This limits pointer motion handling, and the damage it causes, to once
+     * per frame for input devices that report faster than the frame rate.
+     *
+     * This is disabled by default, unless the EGT_INPUT_COALESCE environment
+     * variable is set.
+     *
+     * @see Event::history()
+     */
+    void coalesce(bool enable);
+
+    /**
+     * Check if coalescing of pointer motion is enabled.
+     */
+    EGT_NODISCARD bool coalesce() const { return m_coalesce; }
+
+    /**
+     * Pointer filtering and prediction settings.
+     *
+     * Filtering uses the 1€ filter, a low pass filter whose cutoff frequency
+     * increases with speed.  Slow movement is smoothed heavily to remove
+     * jitter, and fast movement is smoothed lightly to keep lag low.  To tune
+     * it, first set beta to 0 and lower min_cutoff until jitter at low speed
+     * is acceptable.  Then increase beta until lag at high speed is acceptable.
+     *
+     * Prediction extrapolates pointer motion from the time the device
+     * reported it to the time it will be on screen, using the speed estimated
+     * by the filter even when filtering of positions is not enabled.  Set
+     * prediction to about the time between dispatching an event and the
+     * resulting frame being displayed, usually one or two frame periods.
+     *
+     * @see https://gery.casiez.net/1euro/
+     */
+    struct Filter
+    {
+        /// Enable filtering of pointer positions.
+        bool enabled{false};
+        /// Minimum cutoff frequency, in Hz.
+        float min_cutoff{1.0f};
+        /// Speed coefficient.
+        float beta{0.007f};
+        /// Cutoff frequency of the speed estimate, in Hz.
+        float d_cutoff{1.0f};
+        /// Time to predict ahead of dispatching, or zero to disable prediction.
+        std::chrono::milliseconds prediction{0};
+        /// Maximum time to extrapolate past the last position from the device.
+        std::chrono::milliseconds max_prediction{50};
+    };
+
+    /**
+     * Set pointer filtering and prediction settings.
+     *
+     * Pointer positions are filtered before any gestures are detected, so
+     * EventId::pointer_drag and other gestures use filtered positions too.
+     *
+     * The default settings can be enabled with the EGT_TOUCH_FILTER environment
+     * variable, and prediction enabled with EGT_TOUCH_PREDICT set to a time in
+     * milliseconds.
+     */
+    void filter(const Filter& filter);
+
+    /**
+     * Get pointer filtering and prediction settings.
+     */
+    EGT_NODISCARD const Filter& filter() const { return m_filter; }
+
+    /**
+     * Dispatch any coalesced pointer motion now.
+     */
+    void flush();
+
+    /**
+     * Called when the size of the screen changes.
+     *
+     * Inputs that scale positions to the screen size should not read it from
+     * the Screen, because they may be read on the input thread.  This is
+     * called on the event loop thread.
+     *
+     * @private
+     */
+    virtual void screen_resized(const Size& size)
+    {
+        detail::ignoreparam(size);
+    }
+
+    /**
+     * Dispatch any coalesced pointer motion of all inputs.
+     *
+     * This is called by EventLoop before drawing each frame.
+     *
+     * @private
+     */
+    static void flush_all();
+
     virtual ~Input() noexcept;
 
 protected:
 
     /**
      * Dispatch an event from this input.
+     *
+     * When called on the input thread, the event is queued and dispatched on
+     * the event loop thread instead.
+     *
+     * @see EventLoop::input_io()
      */
     virtual void dispatch(Event& event);
 
+    /**
+     * Dispatch an event without coalescing.
+     */
+    void dispatch_now(Event& event);
+
     /**
      * This is the single global input handler.  Anything can attach to this
      * object and receive all events unfiltered.
@@ -94,6 +211,32 @@ protected:
      * Currently dispatching an event when true.
      */
     bool m_dispatching{false};
+
+    /**
+     * Coalesce pointer motion when true.
+     */
+    bool m_coalesce{false};
+
+    /**
+     * Latest coalesced EventId::raw_pointer_move, if not EventId::none.
+     */
+    Event m_pending;
+
+    /**
+     * Positions of the events coalesced into m_pending.
+     */
+    std::vector<DisplayPoint> m_history;
+    /**
+     * Pointer filtering and prediction settings.
+     */
+    Filter m_filter;
+
+    /**
+     * Pointer filter state, when filtering or prediction is enabled.
+     */
+    std::unique_ptr<detail::PointerFilter> m_pointer_filter;
+
+    friend class detail::InputThread;
 };
 
 namespace detail
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_LATENCY_H
+#define EGT_LATENCY_H
+
+/**
+ * @file
+ * @brief Input to photon latency measurement.
+ */
+
+#include <cstdint>
+#include <egt/detail/enum.h>
+#include <egt/detail/meta.h>
+#include <iosfwd>
+
+namespace egt
+{
+inline namespace v1
+{
+
+/**
+ * Measures the latency from input events to the screen flip that shows their
+ * result.
+ *
+ * Every input event that damages the screen while it is dispatched is followed
+ * through the following points in time:
+ *  - The time the input device reported the event, from Event::timestamp().
+ *  - The start of dispatching the event.
+ *  - The first damage caused by the event.
+ *  - The end of drawing the next frame of the damaged Screen.
+ *  - The submission of the flip of that frame.
+ *
+ * The time between each of these, and the total, is kept in a histogram for
+ * each Stage.  Events that do not cause any damage are not measured, and an
+ * event that damages more than one Screen is measured once for each.
+ *
+ * When tracing is enabled, each measured event is also recorded in the trace,
+ * and the percentiles of each stage are included in the trace metadata.
+ *
+ * Measurement is disabled by default, unless the EGT_INPUT_LATENCY environment
+ * variable is set.  While enabled, a report is printed when the Application
+ * receives SIGUSR1 and when it exits.
+ */
+class EGT_API InputLatency
+{
+public:
+
+    /**
+     * Measured stages.
+     */
+    enum class Stage
+    {
+        /// From the input device to the start of dispatching.
+        queue,
+        /// From the start of dispatching to the first damage.
+        handle,
+        /// From the first damage to the end of drawing.
+        draw,
+        /// From the end of drawing to submitting the flip.
+        flip,
+        /// From the input device to submitting the flip.
+        total,
+    };
+
+    /// Number of stages.
+    static constexpr size_t STAGES = 5;
+
+    /**
+     * Enable or disable measurement.
+     */
+    static void enable(bool enable);
+
+    /**
+     * Check if measurement is enabled.
+     */
+    static bool enabled();
+
+    /**
+     * Get the number of events measured.
+     */
+    static uint64_t count();
+
+    /**
+     * Get a percentile of a stage, in microseconds.
+     *
+     * Histogram buckets are about 5% wide, so the result is accurate to
+     * within that.
+     *
+     * @param[in] stage The stage.
+     * @param[in] percentile The percentile, from 0 to 100.
+     */
+    static double percentile(Stage stage, double percentile);
+
+    /**
+     * Get the maximum of a stage, in microseconds.
+     */
+    static double max(Stage stage);
+
+    /**
+     * Forget all measurements.
+     */
+    static void reset();
+
+    /**
+     * Write the 50th, 90th, 99th percentiles and maximum of each stage.
+     */
+    static void report(std::ostream& out);
+
+    /**
+     * Write the same as report() as a JSON object.
+     */
+    static void report_json(std::ostream& out);
+};
+
+/// Enum string conversion map
+template<>
+EGT_API const std::pair<InputLatency::Stage, char const*> detail::EnumStrings<InputLatency::Stage>::data[5];
+
+/// Overloaded std::ostream insertion operator
+EGT_API std::ostream& operator<<(std::ostream& os, const InputLatency::Stage& stage);
+
+}
+}
+
+#endif
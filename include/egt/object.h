@@ -12,11 +12,10 @@
  */
 
 #include <cstdint>
-#include <egt/detail/cow.h>
+#include <egt/detail/inplacefunction.h>
 #include <egt/detail/meta.h>
 #include <egt/event.h>
 #include <egt/flagsbase.h>
-#include <functional>
 #include <string>
 #include <vector>
 
@@ -51,8 +50,13 @@ public:
      */
     void name(const std::string& name) { m_name = name; }
 
-    /// Event handler callback function.
-    using EventCallback = std::function<void (Event& event)>;
+    /**
+     * Event handler callback function.
+     *
+     * Callables up to a few pointers in size, like a lambda capturing this,
+     * are stored without allocating.
+     */
+    using EventCallback = detail::InplaceFunction<void (Event& event)>;
 
     /// Event handler EventId filter.
     using FilterFlags = FlagsBase<EventId>;
@@ -75,12 +79,15 @@ public:
      * @return A handle used to identify the registration.  This can then be
      *         passed to remove_handler().
      */
-    RegisterHandle on_event(const EventCallback& handler,
+    RegisterHandle on_event(EventCallback handler,
                             const FilterFlags& mask = {});
 
     /**
      * Invoke all handlers with the specified event.
      *
+     * If no handler is registered for the EventId of the event, this returns
+     * without looking at any handler.
+     *
      * @param event The event to invoke.
      */
     void invoke_handlers(Event& event);
@@ -121,7 +128,7 @@ protected:
          * @param[in] m Filter mask for events.
          * @param[in] h Handle for this registration.
          */
-        CallbackMeta(EventCallback c,
+        CallbackMeta(EventCallback&& c,
                      // NOLINTNEXTLINE(modernize-pass-by-value)
                      const FilterFlags& m,
                      RegisterHandle h) noexcept
@@ -142,7 +149,13 @@ protected:
     using CallbackArray = std::vector<CallbackMeta>;
 
     /// Array of callbacks.
-    detail::CopyOnWriteAllocate<CallbackArray> m_callbacks;
+    CallbackArray m_callbacks;
+
+    /// Union of the masks of all callbacks, with all set for an empty mask.
+    FilterFlags m_handled;
+
+    /// Recompute m_handled from m_callbacks.
+    void update_handled();
 
     /// A user defined name for the Object.
     std::string m_name;
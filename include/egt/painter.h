@@ -28,6 +28,11 @@ inline namespace v1
 
 class Image;
 
+namespace detail
+{
+class DisplayList;
+}
+
 /**
  * @defgroup drawing Drawing Classes
  * Drawing related functionality.
@@ -128,6 +133,16 @@ public:
      */
     explicit Painter(shared_cairo_t cr) noexcept;
 
+    /**
+     * Construct a Painter that records into a display list.
+     *
+     * Nothing is drawn. Commands given to the painter are recorded so they can
+     * be compared and replayed later.
+     *
+     * @see detail::DisplayList
+     */
+    explicit Painter(detail::DisplayList& list);
+
     /**
      * Save the state of the current context.
      *
@@ -279,6 +294,8 @@ public:
 
     /**
      * Draw an image surface at the specified point.
+     *
+     * @see fill(const Rect&, const Color&) for when this bypasses cairo.
      */
     Painter& draw(const Image& image);
 
@@ -288,8 +305,12 @@ public:
     Painter& mask(const Image& image, const Point& point = {});
 
     /**
+     * Draw a rectangle of an image surface at the current point.
+     *
      * @param[in] rect The source rect to copy.
      * @param[in] image The image surface to draw.
+     *
+     * @see fill(const Rect&, const Color&) for when this bypasses cairo.
      */
     Painter& draw(const Rect& rect,
                   const Image& image);
@@ -310,6 +331,21 @@ public:
 
     Painter& fill();
 
+    /**
+     * Fill a rectangle with a solid color.
+     *
+     * This clears the current path, like fill().
+     *
+     * When the painter draws directly to a 565 or 8888 image surface with an
+     * integer translation only transform and an axis aligned clip, this, along
+     * with draw(const Image&) and draw(const Rect&, const Image&), bypass cairo
+     * and use optimized pixel kernels.
+     *
+     * @param[in] rect The rectangle.
+     * @param[in] color The color.
+     */
+    Painter& fill(const Rect& rect, const Color& color);
+
     Painter& paint();
 
     Painter& paint(float alpha);
@@ -325,10 +361,28 @@ public:
     Color color_at(const Point& point) noexcept;
     static Color color_at(cairo_surface_t* image, const Point& point) noexcept;
 
-    Painter& flood(const Point& point, const Color& color);
+    /**
+     * Flood fill the area connected to a point with a color.
+     *
+     * All pixels connected to the point that match the color of the pixel at
+     * the point are filled.
+     *
+     * @param[in] point The starting point.
+     * @param[in] color The fill color.
+     * @param[in] tolerance Maximum difference, from 0 to 255, of any channel
+     *            for a pixel to still match. A small tolerance lets a fill
+     *            extend into anti-aliased edges.
+     */
+    Painter& flood(const Point& point, const Color& color, uint32_t tolerance = 0);
 
+    /**
+     * Flood fill the area connected to a point on an image surface.
+     *
+     * @see flood(const Point&, const Color&, uint32_t)
+     */
     static void flood(cairo_surface_t* image,
-                      const Point& point, const Color& color);
+                      const Point& point, const Color& color,
+                      uint32_t tolerance = 0);
 
     /**
      * Get the current underlying context the painter is using.
@@ -338,6 +392,14 @@ public:
         return m_cr;
     }
 
+    /**
+     * Get the display list the painter is recording into, if any.
+     */
+    EGT_NODISCARD detail::DisplayList* recording() const
+    {
+        return m_list;
+    }
+
     /**
      * Get a Size from a surface.
      */
@@ -362,6 +424,11 @@ protected:
      * Cairo context.
      */
     shared_cairo_t m_cr;
+
+    /**
+     * Display list being recorded into.
+     */
+    detail::DisplayList* m_list{nullptr};
 };
 
 }
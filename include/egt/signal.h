@@ -11,10 +11,10 @@
  * @brief Signal definition.
  */
 
+#include <algorithm>
 #include <cstdint>
-#include <egt/detail/cow.h>
+#include <egt/detail/inplacefunction.h>
 #include <egt/detail/meta.h>
-#include <functional>
 #include <vector>
 
 namespace egt
@@ -32,8 +32,11 @@ public:
 
     /**
      * Event handler callback function.
+     *
+     * Callables up to a few pointers in size, like a lambda capturing this,
+     * are stored without allocating.
      */
-    using EventCallback = std::function<void(Args...)>;
+    using EventCallback = detail::InplaceFunction<void(Args...)>;
 
     /**
      * Handle type.
@@ -51,13 +54,13 @@ public:
      * @return A handle used to identify the registration.  This can then be
      *         passed to remove_handler().
      */
-    RegisterHandle on_event(const EventCallback& handler)
+    RegisterHandle on_event(EventCallback handler)
     {
         if (handler)
         {
             // TODO: m_handle_counter can wrap, making the handle non-unique
             auto handle = ++m_handle_counter;
-            m_callbacks->emplace_back(handler, handle);
+            m_callbacks.emplace_back(std::move(handler), handle);
             return handle;
         }
 
@@ -67,9 +70,9 @@ public:
     /**
      * Convenience wrapper for on_event().
      */
-    inline RegisterHandle operator()(const EventCallback& handler)
+    inline RegisterHandle operator()(EventCallback handler)
     {
-        return on_event(handler);
+        return on_event(std::move(handler));
     }
 
     /**
@@ -79,13 +82,10 @@ public:
      */
     void invoke(Args... args)
     {
-        if (!m_enabled)
-            return;
-
-        if (!m_callbacks)
+        if (!m_enabled || m_callbacks.empty())
             return;
 
-        for (auto& callback : *m_callbacks)
+        for (auto& callback : m_callbacks)
             callback.callback(args...);
     }
 
@@ -94,10 +94,7 @@ public:
      */
     void clear()
     {
-        if (!m_callbacks)
-            return;
-
-        m_callbacks->clear();
+        m_callbacks.clear();
     }
 
     /**
@@ -107,17 +104,14 @@ public:
      */
     void remove(RegisterHandle handle)
     {
-        if (!m_callbacks)
-            return;
-
-        auto i = std::find_if(m_callbacks->begin(), m_callbacks->end(),
+        auto i = std::find_if(m_callbacks.begin(), m_callbacks.end(),
                               [handle](const CallbackMeta & meta)
         {
             return meta.handle == handle;
         });
 
-        if (i != m_callbacks->end())
-            m_callbacks->erase(i);
+        if (i != m_callbacks.end())
+            m_callbacks.erase(i);
     }
 
     /**
@@ -154,7 +148,7 @@ private:
      */
     struct CallbackMeta
     {
-        CallbackMeta(EventCallback c,
+        CallbackMeta(EventCallback&& c,
                      RegisterHandle h) noexcept
             : callback(std::move(c)),
               handle(h)
@@ -168,7 +162,7 @@ private:
     using CallbackArray = std::vector<CallbackMeta>;
 
     /// Array of callbacks.
-    detail::CopyOnWriteAllocate<CallbackArray> m_callbacks;
+    CallbackArray m_callbacks;
 
     /// Enabled state for dispatching callbacks.
     bool m_enabled{true};
@@ -12,6 +12,7 @@
  */
 
 #include <egt/detail/alignment.h>
+#include <egt/detail/layout.h>
 #include <egt/detail/meta.h>
 #include <egt/frame.h>
 #include <memory>
@@ -87,7 +88,7 @@ public:
     void justify(Justification justify)
     {
         if (detail::change_if_diff<>(m_justify, justify))
-            layout();
+            request_layout();
     }
 
     /**
@@ -101,7 +102,7 @@ public:
     void orient(Orientation orient)
     {
         if (detail::change_if_diff<>(m_orient, orient))
-            layout();
+            request_layout();
     }
 
     void serialize(Serializer& serializer) const override;
@@ -166,6 +167,8 @@ protected:
     Orientation m_orient{Orientation::horizontal};
     /// @private
     Justification m_justify{Justification::start};
+    /// @private
+    detail::FlexLayout m_flex;
 };
 
 /**
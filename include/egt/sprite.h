@@ -56,6 +56,11 @@ class HardwareSprite;
  *
  * There is no requirement on how many frames are on a line or how many rows of
  * frames there are.
+ *
+ * A sprite can be advanced by calling advance(), or by calling play() to have
+ * it advanced at a fixed frame rate.  All sprites playing at the same frame
+ * rate are advanced together by one shared timer, so many animated sprites do
+ * not need a timer each.
  */
 class EGT_API Sprite : public Window
 {
@@ -121,6 +126,26 @@ public:
      */
     void advance();
 
+    /**
+     * Advance to the next frame at a fixed frame rate.
+     *
+     * The sprite is advanced by a timer shared with all other sprites
+     * playing at the same frame rate.
+     *
+     * @param[in] fps Frames per second.  0 stops playing.
+     */
+    void play(unsigned fps);
+
+    /**
+     * Stop advancing at a fixed frame rate.
+     */
+    void stop();
+
+    /**
+     * Get the frame rate the sprite is playing at, or 0 if not playing.
+     */
+    EGT_NODISCARD unsigned fps() const;
+
     /**
      * Returns true if the current frame is the last frame.
      */
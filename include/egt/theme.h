@@ -28,6 +28,11 @@ inline namespace v1
 class Widget;
 class Painter;
 
+namespace detail
+{
+class BoxCache;
+}
+
 /**
  * Drawable function object.
  *
@@ -211,11 +216,10 @@ public:
 
     /**
      * Set the theme palette.
+     *
+     * @note This clears the box cache.
      */
-    void palette(Palette& palette)
-    {
-        m_palette = palette;
-    }
+    void palette(Palette& palette);
 
     /**
      * Get a reference to the theme Font.
@@ -251,6 +255,8 @@ public:
 
     /**
      * Draw a box specifying the properties directly.
+     *
+     * Boxes are drawn through detail::box_cache() when possible.
      */
     virtual void draw_box(Painter& painter,
                           const FillFlags& type,
@@ -297,13 +303,10 @@ public:
      * Apply the Theme.
      *
      * Automatically called by global_theme() when setting a new theme.
+     *
+     * @note This clears the box cache.
      */
-    virtual void apply()
-    {
-        init_palette();
-        init_font();
-        init_draw();
-    }
+    virtual void apply();
 
     virtual ~Theme() noexcept = default;
 
@@ -316,6 +319,21 @@ protected:
 
     virtual void rounded_box(Painter& painter, const RectF& box, float border_radius) const;
 
+    /**
+     * Draw a box directly, without going through the box cache.
+     *
+     * @see draw_box()
+     */
+    void paint_box(Painter& painter,
+                   const FillFlags& type,
+                   const Rect& rect,
+                   const Pattern& border,
+                   const Pattern& bg,
+                   DefaultDim border_width,
+                   DefaultDim margin_width,
+                   float border_radius,
+                   const BorderFlags& border_flags) const;
+
     /// Palette instance used by the theme.
     Palette m_palette;
 
@@ -342,6 +360,8 @@ protected:
      * Called by apply().
      */
     virtual void init_draw();
+
+    friend class detail::BoxCache;
 };
 
 /// Enum string conversion map
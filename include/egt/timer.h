@@ -130,6 +130,25 @@ public:
      */
     void change_duration(std::chrono::milliseconds duration);
 
+    /**
+     * Set the slack of the timer.
+     *
+     * The timer may fire up to this much later than its duration.  All
+     * timers of the event loop are kept in one timer wheel, and timers whose
+     * slack overlaps are fired in the same wake up of the event loop.  Giving
+     * timers that do not need to be precise some slack reduces the number of
+     * wake ups, which saves power.
+     *
+     * The default is no slack.  This takes effect the next time the timer is
+     * started.
+     */
+    void slack(std::chrono::milliseconds slack) { m_slack = slack; }
+
+    /**
+     * Get the slack of the timer.
+     */
+    EGT_NODISCARD std::chrono::milliseconds slack() const { return m_slack; }
+
     /**
      * Cancel, or stop, the timer.
      */
@@ -233,12 +252,12 @@ protected:
     /// Type for array of registered callbacks.
     using CallbackArray = std::vector<CallbackMeta>;
 
-    /// Asio timer object.
-    asio::steady_timer m_timer;
-
     /// The duration of the timer.
     std::chrono::milliseconds m_duration{};
 
+    /// The slack of the timer.
+    std::chrono::milliseconds m_slack{};
+
     /// Array of registered callbacks.
     CallbackArray m_callbacks;
 
@@ -253,7 +272,7 @@ protected:
 
 private:
 
-    void internal_timer_callback(const asio::error_code& error);
+    void internal_timer_callback();
     void do_cancel();
 };
 
@@ -284,10 +303,6 @@ public:
     using Timer::Timer;
     using Timer::start;
     void start() override;
-
-private:
-
-    void internal_timer_callback(const asio::error_code& error);
 };
 
 }
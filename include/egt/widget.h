@@ -11,6 +11,7 @@
  * @brief Base class Widget definition.
  */
 
+#include <egt/detail/displaylist.h>
 #include <egt/detail/enum.h>
 #include <egt/detail/meta.h>
 #include <egt/event.h>
@@ -621,6 +622,32 @@ public:
      */
     virtual void damage(const Rect& rect);
 
+    /**
+     * Enable or disable recording the drawing of the widget into a display
+     * list.
+     *
+     * When enabled, damage() records what the widget would draw now and
+     * compares it with what it drew last time. If nothing changed, the damage
+     * is dropped. Otherwise, the widget is drawn by replaying its recording.
+     *
+     * This is useful for widgets that are damaged repeatedly without
+     * necessarily changing, for example a Label updated by a timer.
+     *
+     * @warning Only enable this for a widget that draws exclusively through
+     * Painter and Theme::draw_box(), and never for a Frame.
+     *
+     * @see detail::DisplayList
+     */
+    void display_list(bool enable);
+
+    /**
+     * Is recording into a display list enabled?
+     */
+    EGT_NODISCARD bool display_list() const
+    {
+        return m_display_list != nullptr;
+    }
+
     /**
      * Bounding box for the Widget.
      *
@@ -1218,9 +1245,26 @@ public:
      * This will cause the widget to layout itself and any of its children.
      * This can mean, for example, the widget will resize() itself to respect
      * its min_size_hint().
+     *
+     * This always performs layout immediately.  To only mark the widget as
+     * needing layout, use request_layout().
      */
     virtual void layout();
 
+    /**
+     * Request layout of the Widget.
+     *
+     * While the EventLoop is running, this only marks the widget as needing
+     * layout.  All requested layout is then performed in one pass before the
+     * next frame is drawn.  Otherwise, this is the same as calling layout().
+     *
+     * @see EventLoop::layout()
+     */
+    void request_layout();
+
+    /// @private
+    virtual void pending_layout();
+
     /**
      * Helper function to draw this widget's box using the appropriate
      * theme.
@@ -1282,7 +1326,7 @@ public:
 
         m_font = std::make_unique<Font>(font);
         damage();
-        layout();
+        request_layout();
         parent_layout();
     }
 
@@ -1410,7 +1454,7 @@ protected:
     EGT_NODISCARD bool parent_in_layout();
 
     /**
-     * Call our parent to do a layout.
+     * Request layout of our parent.
      */
     void parent_layout();
 
@@ -1523,6 +1567,38 @@ private:
      */
     std::unique_ptr<Font> m_font;
 
+    /**
+     * Last display list drawn, when enabled.
+     */
+    std::unique_ptr<detail::DisplayList> m_display_list;
+
+    /**
+     * box() when m_display_list was drawn.
+     */
+    Rect m_display_list_box;
+
+    /**
+     * Set when m_display_list may not match what is on the screen, so damage
+     * cannot be dropped.
+     */
+    bool m_display_list_stale{true};
+
+    /**
+     * Set when layout of this widget has been requested, but not performed.
+     */
+    bool m_layout_pending{false};
+
+    /**
+     * Set when layout of a widget under this one has been requested, but not
+     * performed.
+     */
+    bool m_child_layout_pending{false};
+
+    /**
+     * Draw, through the display list when enabled.
+     */
+    void draw_recorded(Painter& painter, const Rect& rect);
+
     friend class Frame;
 };
 
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/animatedimage/framestream.h"
+#include "egt/animatedimage.h"
+#include "egt/app.h"
+#include "egt/painter.h"
+#include "egt/respath.h"
+#include <stdexcept>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace experimental
+{
+
+AnimatedImage::AnimatedImage(const std::string& uri, const Rect& rect)
+    : Widget(rect)
+{
+    name("AnimatedImage" + std::to_string(m_widgetid));
+    fill_flags().clear();
+
+    m_timer.on_timeout([this]() { present(); });
+
+    if (!uri.empty())
+        load(uri);
+}
+
+AnimatedImage::AnimatedImage(Frame& parent, const std::string& uri, const Rect& rect)
+    : AnimatedImage(uri, rect)
+{
+    parent.add(*this);
+}
+
+void AnimatedImage::load(const std::string& uri)
+{
+    std::string path;
+    switch (detail::resolve_path(uri, path))
+    {
+    case detail::SchemeType::filesystem:
+        break;
+    case detail::SchemeType::unknown:
+        path = resolve_file_path(uri);
+        break;
+    default:
+        throw std::runtime_error("unsupported uri: " + uri);
+    }
+
+    auto decoder = detail::AnimationDecoder::open(path);
+    if (!decoder)
+        throw std::runtime_error("unable to load animation: " + uri);
+
+    m_timer.cancel();
+    m_stream.reset();
+    m_current.reset();
+    m_current_delay = {};
+
+    m_stream = detail::FrameStream::create(Application::instance().event(),
+                                           std::move(decoder), m_lookahead,
+                                           m_loop, [this]() { ready(); });
+
+    if (box().empty())
+        resize(m_stream->size() + Size(2 * moat(), 2 * moat()));
+
+    damage();
+
+    // the first frame is shown as soon as it is decoded
+    present();
+}
+
+void AnimatedImage::start()
+{
+    if (m_running || !m_stream)
+        return;
+
+    m_running = true;
+    m_deadline = std::chrono::steady_clock::now();
+
+    // give the frame already shown its full time
+    if (m_current)
+    {
+        m_deadline += m_current_delay;
+        m_timer.start(m_current_delay);
+    }
+    else
+    {
+        present();
+    }
+}
+
+void AnimatedImage::stop()
+{
+    m_running = false;
+    m_timer.cancel();
+}
+
+void AnimatedImage::loop(bool enable)
+{
+    m_loop = enable;
+    if (m_stream)
+        m_stream->loop(enable);
+}
+
+void AnimatedImage::ready()
+{
+    if (!m_timer.running())
+        present();
+}
+
+void AnimatedImage::present()
+{
+    if (!m_stream)
+        return;
+
+    // when stopped, only the first frame is shown
+    if (!m_running && m_current)
+        return;
+
+    detail::FrameStream::Frame frame;
+    if (!m_stream->pop(frame))
+    {
+        if (m_running && m_stream->finished())
+        {
+            m_running = false;
+            on_eos.invoke();
+        }
+
+        // otherwise ready() is called when the frame is decoded
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if (m_running)
+    {
+        // skip frames whose time has already passed
+        detail::FrameStream::Frame later;
+        while (m_deadline + frame.delay < now && m_stream->pop(later))
+        {
+            m_deadline += frame.delay;
+            m_stream->recycle(std::move(frame.surface));
+            frame = std::move(later);
+        }
+    }
+
+    m_stream->recycle(std::move(m_current));
+    m_current = std::move(frame.surface);
+    m_current_delay = frame.delay;
+    damage();
+
+    if (!m_running)
+        return;
+
+    m_deadline += m_current_delay;
+    if (m_deadline < now)
+        m_deadline = now + m_current_delay;
+
+    m_timer.start(std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - now));
+}
+
+void AnimatedImage::draw(Painter& painter, const Rect&)
+{
+    Painter::AutoSaveRestore sr(painter);
+
+    draw_box(painter, Palette::ColorId::bg, Palette::ColorId::border);
+
+    if (!m_current)
+        return;
+
+    const auto b = content_area();
+    const auto size = m_stream->size();
+    const auto origin = b.point() + Point((b.width() - size.width()) / 2,
+                                          (b.height() - size.height()) / 2);
+
+    auto cr = painter.context().get();
+    cairo_rectangle(cr, b.x(), b.y(), b.width(), b.height());
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, m_current.get(), origin.x(), origin.y());
+    cairo_paint(cr);
+}
+
+AnimatedImage::~AnimatedImage() noexcept = default;
+
+}
+}
+}
@@ -8,6 +8,7 @@
 #endif
 
 #include "detail/egtlog.h"
+#include "detail/trace.h"
 #include "egt/app.h"
 #include "egt/detail/filesystem.h"
 #include "egt/detail/screen/kmsscreen.h"
@@ -15,6 +16,7 @@
 #include "egt/detail/string.h"
 #include "egt/eventloop.h"
 #include "egt/input.h"
+#include "egt/latency.h"
 #include "egt/painter.h"
 #include "egt/respath.h"
 #include "egt/serialize.h"
@@ -263,6 +265,7 @@ void Application::setup_backend(bool primary)
 void Application::setup_inputs()
 {
     m_input_devices.clear();
+    m_event.stop_input_thread();
     m_inputs.clear();
 
     // EGT_INPUT_DEVICES=library:event_device1,event_device2;library:event_device3
@@ -357,7 +360,12 @@ void Application::signal_handler(const asio::error_code& error, int signum)
         return;
 
     if (signum == SIGUSR1)
+    {
         dump(std::cout);
+        detail::trace_dump();
+        if (InputLatency::enabled())
+            InputLatency::report(std::cout);
+    }
     else if (signum == SIGUSR2)
     {
         if (m_argc)
@@ -443,6 +451,11 @@ void Application::dump_timers(std::ostream& out) const
     }
 }
 
+void Application::dump_trace(std::ostream& out) const
+{
+    detail::trace_dump(out);
+}
+
 const std::vector<std::pair<std::string, std::string>>& Application::get_input_devices()
 {
     return m_input_devices;
@@ -452,6 +465,15 @@ Application::~Application() noexcept
 {
     Input::global_input().remove_handler(m_handle);
 
+    // inputs may be read on the input thread
+    m_event.stop_input_thread();
+    m_inputs.clear();
+
+    detail::trace_dump();
+
+    if (InputLatency::enabled() && InputLatency::count())
+        InputLatency::report(std::cout);
+
     if (the_app == this)
         the_app = nullptr;
 }
@@ -103,7 +103,7 @@ void Button::text(const std::string& text)
     {
         on_text_changed.invoke();
         damage();
-        layout();
+        request_layout();
     }
 }
 
@@ -150,7 +150,7 @@ void Button::checked(bool value)
 void Button::set_parent(Frame* parent)
 {
     TextWidget::set_parent(parent);
-    layout();
+    request_layout();
 }
 
 Size Button::min_size_hint() const
@@ -49,6 +49,21 @@ void LineChart::clear()
     m_impl->clear();
 }
 
+void LineChart::stream_capacity(size_t capacity)
+{
+    m_impl->stream_capacity(capacity);
+}
+
+size_t LineChart::stream_capacity() const
+{
+    return m_impl->stream_capacity();
+}
+
+void LineChart::append(const double* samples, size_t count)
+{
+    m_impl->append(samples, count);
+}
+
 void LineChart::grid_style(GridFlag flag)
 {
     m_impl->grid_style(flag);
@@ -0,0 +1,504 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "detail/animatedimage/apng.h"
+#include "detail/blit.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Frames are shown for at least this long.
+static constexpr std::chrono::milliseconds MIN_APNG_DELAY{10};
+
+static constexpr uint32_t chunk_type(const char* name)
+{
+    return (static_cast<uint32_t>(name[0]) << 24u) |
+           (static_cast<uint32_t>(name[1]) << 16u) |
+           (static_cast<uint32_t>(name[2]) << 8u) |
+           static_cast<uint32_t>(name[3]);
+}
+
+static bool read_u32(std::istream& in, uint32_t& value)
+{
+    unsigned char b[4];
+    if (!in.read(reinterpret_cast<char*>(b), sizeof(b)))
+        return false;
+    value = (b[0] << 24u) | (b[1] << 16u) | (b[2] << 8u) | b[3];
+    return true;
+}
+
+static inline uint32_t premultiply(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+    if (a != 255)
+    {
+        r = (r * a + 127) / 255;
+        g = (g * a + 127) / 255;
+        b = (b * a + 127) / 255;
+    }
+    return (a << 24u) | (r << 16u) | (g << 8u) | b;
+}
+
+static inline unsigned char paeth(int a, int b, int c)
+{
+    const auto p = a + b - c;
+    const auto pa = std::abs(p - a);
+    const auto pb = std::abs(p - b);
+    const auto pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    if (pb <= pc)
+        return b;
+    return c;
+}
+
+ApngDecoder::ApngDecoder(const std::string& filename)
+    : m_file(filename, std::ios_base::binary)
+{
+    static const unsigned char signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    unsigned char header[sizeof(signature)];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, signature, sizeof(signature)))
+        return;
+
+    uint32_t length = 0;
+    uint32_t type = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!read_chunk(length, type) || type != chunk_type("IHDR") || length != 13 ||
+        !read_u32(m_file, width) || !read_u32(m_file, height))
+        return;
+
+    unsigned char info[5];
+    if (!m_file.read(reinterpret_cast<char*>(info), sizeof(info)) || !skip_chunk(0))
+        return;
+
+    const auto depth = info[0];
+    const auto interlace = info[4];
+    m_color_type = info[1];
+    switch (m_color_type)
+    {
+    case 0:
+    case 3:
+        m_bpp = 1;
+        break;
+    case 2:
+        m_bpp = 3;
+        break;
+    case 4:
+        m_bpp = 2;
+        break;
+    case 6:
+        m_bpp = 4;
+        break;
+    default:
+        return;
+    }
+
+    if (depth != 8 || interlace != 0 || !valid_size(width, height))
+        return;
+
+    m_size = Size(width, height);
+    m_canvas.assign(static_cast<size_t>(width) * height, 0);
+    m_palette.fill(0xff000000u);
+    m_first_chunk = m_file.tellg();
+}
+
+bool ApngDecoder::read_chunk(uint32_t& length, uint32_t& type)
+{
+    return read_u32(m_file, length) && read_u32(m_file, type);
+}
+
+bool ApngDecoder::skip_chunk(uint32_t length)
+{
+    // the CRC is not checked
+    m_file.ignore(length + 4);
+    return static_cast<bool>(m_file);
+}
+
+bool ApngDecoder::read_palette(uint32_t length)
+{
+    unsigned char rgb[256 * 3];
+    const auto count = std::min<uint32_t>(length / 3, 256);
+    if (!m_file.read(reinterpret_cast<char*>(rgb), count * 3))
+        return false;
+
+    for (size_t i = 0; i < count; ++i)
+        m_palette[i] = premultiply(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2], 255);
+
+    return skip_chunk(length - count * 3);
+}
+
+bool ApngDecoder::read_transparency(uint32_t length)
+{
+    unsigned char data[256];
+    const auto count = std::min<uint32_t>(length, sizeof(data));
+    if (!m_file.read(reinterpret_cast<char*>(data), count))
+        return false;
+
+    if (m_color_type == 3)
+    {
+        // follows the palette, so the palette is still opaque
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto p = m_palette[i];
+            m_palette[i] = premultiply((p >> 16u) & 0xffu, (p >> 8u) & 0xffu, p & 0xffu, data[i]);
+        }
+    }
+    else if (m_color_type == 0 && count >= 2)
+    {
+        m_key = {{data[1], data[1], data[1]}};
+    }
+    else if (m_color_type == 2 && count >= 6)
+    {
+        m_key = {{data[1], data[3], data[5]}};
+    }
+
+    return skip_chunk(length - count);
+}
+
+bool ApngDecoder::read_frame_control(uint32_t length, FrameControl& control)
+{
+    unsigned char data[26];
+    if (length != sizeof(data) || !m_file.read(reinterpret_cast<char*>(data), sizeof(data)))
+        return false;
+
+    auto u32 = [&data](size_t offset)
+    {
+        return (data[offset] << 24u) | (data[offset + 1] << 16u) |
+               (data[offset + 2] << 8u) | data[offset + 3];
+    };
+
+    const uint32_t width = u32(4);
+    const uint32_t height = u32(8);
+    const uint32_t x = u32(12);
+    const uint32_t y = u32(16);
+    // written so the sums cannot wrap
+    const auto canvas_width = static_cast<uint32_t>(m_size.width());
+    const auto canvas_height = static_cast<uint32_t>(m_size.height());
+    if (!width || !height ||
+        x > canvas_width || width > canvas_width - x ||
+        y > canvas_height || height > canvas_height - y)
+        return false;
+
+    const uint32_t num = (data[20] << 8u) | data[21];
+    uint32_t den = (data[22] << 8u) | data[23];
+    if (!den)
+        den = 100;
+
+    control.area = Rect(x, y, width, height);
+    control.delay = std::max(std::chrono::milliseconds(num * 1000 / den), MIN_APNG_DELAY);
+    control.dispose = data[24];
+    control.blend = data[25];
+
+    return skip_chunk(0);
+}
+
+bool ApngDecoder::inflate_frame(uint32_t length, uint32_t type, const Size& size)
+{
+    const size_t row = 1 + size.width() * m_bpp;
+    m_raw.resize(row * size.height());
+
+    z_stream stream{};
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if (inflateInit(&stream) != Z_OK)
+        return false;
+
+    stream.next_out = m_raw.data();
+    stream.avail_out = m_raw.size();
+
+    const size_t BUFSIZE = 8 * 1024;
+    unsigned char buffer[BUFSIZE];
+    int res = Z_OK;
+    bool ok = true;
+    while (ok)
+    {
+        // frame data chunks start with a sequence number
+        if (type == chunk_type("fdAT"))
+        {
+            uint32_t sequence = 0;
+            if (length < 4 || !read_u32(m_file, sequence))
+            {
+                ok = false;
+                break;
+            }
+            length -= 4;
+        }
+
+        while (length)
+        {
+            const auto count = std::min<size_t>(length, BUFSIZE);
+            if (!m_file.read(reinterpret_cast<char*>(buffer), count))
+            {
+                ok = false;
+                break;
+            }
+            length -= count;
+
+            if (res == Z_STREAM_END)
+                continue;
+
+            stream.next_in = buffer;
+            stream.avail_in = count;
+            res = inflate(&stream, Z_NO_FLUSH);
+            if (res != Z_OK && res != Z_STREAM_END &&
+                !(res == Z_BUF_ERROR && !stream.avail_out))
+                ok = false;
+        }
+
+        if (!ok || !skip_chunk(0))
+            break;
+
+        // the data of a frame may be split into consecutive chunks
+        uint32_t next_type = 0;
+        if (!read_chunk(length, next_type))
+        {
+            ok = false;
+            break;
+        }
+
+        if (next_type != type)
+        {
+            m_file.seekg(-8, std::ios_base::cur);
+            break;
+        }
+    }
+
+    inflateEnd(&stream);
+
+    if (!ok || stream.avail_out)
+        return false;
+
+    // undo the filter of each row, in place
+    const unsigned char* prev = nullptr;
+    for (auto y = 0; y < size.height(); ++y)
+    {
+        auto filter = m_raw[y * row];
+        auto cur = m_raw.data() + y * row + 1;
+        const auto bytes = row - 1;
+
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            const int a = i >= m_bpp ? cur[i - m_bpp] : 0;
+            const int b = prev ? prev[i] : 0;
+            const int c = prev && i >= m_bpp ? prev[i - m_bpp] : 0;
+
+            switch (filter)
+            {
+            case 1:
+                cur[i] += a;
+                break;
+            case 2:
+                cur[i] += b;
+                break;
+            case 3:
+                cur[i] += (a + b) / 2;
+                break;
+            case 4:
+                cur[i] += paeth(a, b, c);
+                break;
+            default:
+                break;
+            }
+        }
+
+        prev = cur;
+    }
+
+    return true;
+}
+
+void ApngDecoder::compose(const FrameControl& control)
+{
+    m_dispose = control.dispose;
+    // restoring before the first frame is clearing
+    if (m_first_frame && m_dispose == 2)
+        m_dispose = 1;
+    m_first_frame = false;
+    m_area = control.area;
+
+    if (m_dispose == 2)
+    {
+        m_previous.resize(m_area.width() * m_area.height());
+        for (auto y = 0; y < m_area.height(); ++y)
+            std::copy_n(m_canvas.data() + (m_area.y() + y) * m_size.width() + m_area.x(),
+                        m_area.width(), m_previous.data() + y * m_area.width());
+    }
+
+    const auto width = m_area.width();
+    const size_t row = 1 + width * m_bpp;
+    std::vector<uint32_t> line(width);
+
+    for (auto y = 0; y < m_area.height(); ++y)
+    {
+        const auto src = m_raw.data() + y * row + 1;
+        for (auto x = 0; x < width; ++x)
+        {
+            const auto p = src + x * m_bpp;
+            switch (m_color_type)
+            {
+            case 0:
+                line[x] = premultiply(p[0], p[0], p[0], p[0] == m_key[0] ? 0 : 255);
+                break;
+            case 2:
+                line[x] = premultiply(p[0], p[1], p[2],
+                                      (p[0] == m_key[0] && p[1] == m_key[1] && p[2] == m_key[2]) ? 0 : 255);
+                break;
+            case 3:
+                line[x] = m_palette[p[0]];
+                break;
+            case 4:
+                line[x] = premultiply(p[0], p[0], p[0], p[1]);
+                break;
+            default:
+                line[x] = premultiply(p[0], p[1], p[2], p[3]);
+                break;
+            }
+        }
+
+        const auto dst = m_canvas.data() + (m_area.y() + y) * m_size.width() + m_area.x();
+        if (control.blend)
+            over32(dst, line.data(), width);
+        else
+            std::copy_n(line.data(), width, dst);
+    }
+}
+
+void ApngDecoder::dispose()
+{
+    if (m_area.empty())
+        return;
+
+    if (m_dispose == 1)
+    {
+        for (auto y = m_area.y(); y < m_area.y() + m_area.height(); ++y)
+            std::fill_n(m_canvas.data() + y * m_size.width() + m_area.x(), m_area.width(), 0);
+    }
+    else if (m_dispose == 2)
+    {
+        for (auto y = 0; y < m_area.height(); ++y)
+            std::copy_n(m_previous.data() + y * m_area.width(), m_area.width(),
+                        m_canvas.data() + (m_area.y() + y) * m_size.width() + m_area.x());
+    }
+
+    m_area = {};
+}
+
+bool ApngDecoder::next(unsigned char* data, size_t stride,
+                       std::chrono::milliseconds& delay)
+{
+    if (!valid())
+        return false;
+
+    dispose();
+
+    FrameControl control;
+    while (true)
+    {
+        uint32_t length = 0;
+        uint32_t type = 0;
+        if (!read_chunk(length, type))
+            return false;
+
+        bool ok = true;
+        if (type == chunk_type("IEND"))
+        {
+            return false;
+        }
+        else if (type == chunk_type("PLTE"))
+        {
+            ok = read_palette(length);
+        }
+        else if (type == chunk_type("tRNS"))
+        {
+            ok = read_transparency(length);
+        }
+        else if (type == chunk_type("acTL"))
+        {
+            m_animated = true;
+            ok = skip_chunk(length);
+        }
+        else if (type == chunk_type("fcTL"))
+        {
+            ok = read_frame_control(length, m_control);
+            m_have_control = ok;
+        }
+        else if (type == chunk_type("IDAT") && m_animated && !m_have_control)
+        {
+            // the default image is not part of the animation
+            ok = skip_chunk(length);
+        }
+        else if (type == chunk_type("IDAT") || type == chunk_type("fdAT"))
+        {
+            if (m_have_control)
+            {
+                control = m_control;
+            }
+            else if (type == chunk_type("IDAT"))
+            {
+                control.area = Rect({}, m_size);
+                control.delay = MIN_APNG_DELAY;
+            }
+            else
+            {
+                return false;
+            }
+
+            if (!inflate_frame(length, type, control.area.size()))
+                return false;
+
+            compose(control);
+            m_have_control = false;
+            break;
+        }
+        else
+        {
+            ok = skip_chunk(length);
+        }
+
+        if (!ok)
+            return false;
+    }
+
+    for (auto y = 0; y < m_size.height(); ++y)
+        std::copy_n(m_canvas.data() + y * m_size.width(), m_size.width(),
+                    reinterpret_cast<uint32_t*>(data + y * stride));
+
+    delay = control.delay;
+    return true;
+}
+
+bool ApngDecoder::rewind()
+{
+    if (!valid())
+        return false;
+
+    m_file.clear();
+    m_file.seekg(m_first_chunk);
+    std::fill(m_canvas.begin(), m_canvas.end(), 0);
+    m_animated = false;
+    m_have_control = false;
+    m_first_frame = true;
+    m_dispose = 0;
+    m_area = {};
+    return static_cast<bool>(m_file);
+}
+
+}
+}
+}
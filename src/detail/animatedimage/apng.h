@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ANIMATEDIMAGE_APNG_H
+#define EGT_SRC_DETAIL_ANIMATEDIMAGE_APNG_H
+
+#include "detail/animatedimage/decoder.h"
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Decoder of APNG images.
+ *
+ * Each frame is composed onto a canvas with the blend and dispose operations
+ * of its frame control, and the canvas is the frame.  A PNG that is not
+ * animated is decoded as a single frame.
+ *
+ * Only non-interlaced images with 8 bits per sample are supported.
+ */
+class ApngDecoder : public AnimationDecoder
+{
+public:
+
+    explicit ApngDecoder(const std::string& filename);
+
+    bool next(unsigned char* data, size_t stride,
+              std::chrono::milliseconds& delay) override;
+
+    bool rewind() override;
+
+    /// Check if the file is a supported PNG image.
+    EGT_NODISCARD bool valid() const { return m_first_chunk != 0; }
+
+private:
+
+    /// Frame control chunk.
+    struct FrameControl
+    {
+        Rect area;
+        std::chrono::milliseconds delay{0};
+        int dispose{0};
+        int blend{0};
+    };
+
+    /// Read the length and type of the next chunk.
+    bool read_chunk(uint32_t& length, uint32_t& type);
+
+    /// Skip the rest of a chunk, and its CRC.
+    bool skip_chunk(uint32_t length);
+
+    bool read_palette(uint32_t length);
+    bool read_transparency(uint32_t length);
+    bool read_frame_control(uint32_t length, FrameControl& control);
+
+    /**
+     * Inflate the data chunks of a frame, starting with a chunk whose header
+     * was just read.
+     */
+    bool inflate_frame(uint32_t length, uint32_t type, const Size& size);
+
+    /// Convert the inflated frame and compose it onto the canvas.
+    void compose(const FrameControl& control);
+
+    /// Undo the last frame as requested by its dispose operation.
+    void dispose();
+
+    std::ifstream m_file;
+    /// Offset of the first chunk after the header.
+    std::streamoff m_first_chunk{0};
+
+    int m_color_type{0};
+    /// Bytes per pixel.
+    size_t m_bpp{0};
+    /// Palette, as premultiplied ARGB32.
+    std::array<uint32_t, 256> m_palette{};
+    /// Transparent color of images without alpha, or -1.
+    std::array<int, 3> m_key{{-1, -1, -1}};
+
+    bool m_animated{false};
+    bool m_have_control{false};
+    FrameControl m_control;
+
+    /// Inflated and unfiltered rows of the last frame.
+    std::vector<unsigned char> m_raw;
+
+    /// Composed frame, as premultiplied ARGB32.
+    std::vector<uint32_t> m_canvas;
+    /// Canvas under the last frame, if its dispose operation restores it.
+    std::vector<uint32_t> m_previous;
+    /// Set until the first frame is shown.
+    bool m_first_frame{true};
+    int m_dispose{0};
+    Rect m_area;
+};
+
+}
+}
+}
+
+#endif
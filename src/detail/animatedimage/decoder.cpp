@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "detail/animatedimage/decoder.h"
+#include "detail/animatedimage/erawsequence.h"
+#include "detail/animatedimage/gif.h"
+#include "detail/egtlog.h"
+#ifdef HAVE_ZLIB
+#include "detail/animatedimage/apng.h"
+#endif
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+template<class T>
+static std::unique_ptr<AnimationDecoder> try_open(const std::string& filename)
+{
+    auto decoder = std::make_unique<T>(filename);
+    if (!decoder->valid())
+        return nullptr;
+    return decoder;
+}
+
+bool AnimationDecoder::valid_size(uint32_t width, uint32_t height)
+{
+    static constexpr uint32_t MAX_DIMENSION = 0x7fff;
+    static constexpr uint64_t MAX_PIXELS = 4096 * 4096;
+
+    return width && height &&
+           width <= MAX_DIMENSION && height <= MAX_DIMENSION &&
+           static_cast<uint64_t>(width) * height <= MAX_PIXELS;
+}
+
+std::unique_ptr<AnimationDecoder> AnimationDecoder::open(const std::string& filename)
+{
+    std::unique_ptr<AnimationDecoder> decoder = try_open<GifDecoder>(filename);
+#ifdef HAVE_ZLIB
+    if (!decoder)
+        decoder = try_open<ApngDecoder>(filename);
+#endif
+    if (!decoder)
+        decoder = try_open<ErawSequenceDecoder>(filename);
+
+    if (!decoder)
+        EGTLOG_DEBUG("no animation decoder for {}", filename);
+
+    return decoder;
+}
+
+}
+}
+}
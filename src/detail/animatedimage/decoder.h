@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ANIMATEDIMAGE_DECODER_H
+#define EGT_SRC_DETAIL_ANIMATEDIMAGE_DECODER_H
+
+#include "egt/detail/meta.h"
+#include "egt/geometry.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Decoder of the frames of an animated image, one frame at a time.
+ *
+ * Decoders read the file as frames are needed instead of loading it, and
+ * only keep the state needed to compose the next frame, so memory does not
+ * depend on the length of the animation.
+ */
+class AnimationDecoder : private NonCopyable<AnimationDecoder>
+{
+public:
+
+    /**
+     * Open a decoder for a file, chosen by the contents of the file.
+     *
+     * @return nullptr if the file cannot be read or the format is not
+     *         supported.
+     */
+    static std::unique_ptr<AnimationDecoder> open(const std::string& filename);
+
+    /// Size of the frames.
+    EGT_NODISCARD const Size& size() const { return m_size; }
+
+    /**
+     * Decode the next frame.
+     *
+     * @param[out] data Premultiplied ARGB32 pixels of the whole frame.
+     * @param[in] stride Number of bytes between rows of data.
+     * @param[out] delay Time to show the frame for.
+     * @return false at the end of the animation, or on an error.
+     */
+    virtual bool next(unsigned char* data, size_t stride,
+                      std::chrono::milliseconds& delay) = 0;
+
+    /**
+     * Go back to the first frame.
+     */
+    virtual bool rewind() = 0;
+
+    virtual ~AnimationDecoder() = default;
+
+protected:
+
+    AnimationDecoder() = default;
+
+    /**
+     * Check if frame dimensions read from a file can be decoded.
+     *
+     * Each dimension must fit a cairo image surface, and a frame must not
+     * have more than 4096 x 4096 pixels, so a corrupt header cannot exhaust
+     * memory.
+     */
+    static bool valid_size(uint32_t width, uint32_t height);
+
+    /// Size of the frames.
+    Size m_size;
+};
+
+}
+}
+}
+
+#endif
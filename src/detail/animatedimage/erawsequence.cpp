@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/animatedimage/erawsequence.h"
+#include "detail/erawimage.h"
+#include <algorithm>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+static constexpr std::chrono::milliseconds DEFAULT_ERAW_DELAY{40};
+
+ErawSequenceDecoder::ErawSequenceDecoder(const std::string& filename)
+    : m_file(filename, std::ios_base::binary)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (ErawImage::read_header(m_file, width, height, m_delay) &&
+        valid_size(width, height))
+    {
+        m_size = Size(width, height);
+        m_have_header = true;
+    }
+}
+
+bool ErawSequenceDecoder::next(unsigned char* data, size_t stride,
+                               std::chrono::milliseconds& delay)
+{
+    if (m_size.empty())
+        return false;
+
+    if (!m_have_header)
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        if (!ErawImage::read_header(m_file, width, height, m_delay))
+            return false;
+
+        if (width != static_cast<uint32_t>(m_size.width()) ||
+            height != static_cast<uint32_t>(m_size.height()))
+            return false;
+    }
+    m_have_header = false;
+
+    // images are stored without padding between rows
+    if (stride == m_size.width() * sizeof(uint32_t))
+    {
+        if (!ErawImage::read_pixels(m_file, reinterpret_cast<uint32_t*>(data),
+                                    m_size.width() * m_size.height()))
+            return false;
+    }
+    else
+    {
+        std::vector<uint32_t> pixels(m_size.width() * m_size.height());
+        if (!ErawImage::read_pixels(m_file, pixels.data(), pixels.size()))
+            return false;
+
+        for (auto y = 0; y < m_size.height(); ++y)
+            std::copy_n(pixels.data() + y * m_size.width(), m_size.width(),
+                        reinterpret_cast<uint32_t*>(data + y * stride));
+    }
+
+    delay = m_delay ? std::chrono::milliseconds(m_delay) : DEFAULT_ERAW_DELAY;
+    return true;
+}
+
+bool ErawSequenceDecoder::rewind()
+{
+    if (m_size.empty())
+        return false;
+
+    m_file.clear();
+    m_file.seekg(0);
+    m_have_header = false;
+    return static_cast<bool>(m_file);
+}
+
+}
+}
+}
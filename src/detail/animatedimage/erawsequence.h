@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ANIMATEDIMAGE_ERAWSEQUENCE_H
+#define EGT_SRC_DETAIL_ANIMATEDIMAGE_ERAWSEQUENCE_H
+
+#include "detail/animatedimage/decoder.h"
+#include <fstream>
+#include <string>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Decoder of a sequence of ERAW images concatenated in one file.
+ *
+ * All images must be the same size.  The first reserved word of the header
+ * of each image is the time to show it for, in milliseconds.  If 0, the
+ * frame is shown for 40 milliseconds.
+ */
+class ErawSequenceDecoder : public AnimationDecoder
+{
+public:
+
+    explicit ErawSequenceDecoder(const std::string& filename);
+
+    bool next(unsigned char* data, size_t stride,
+              std::chrono::milliseconds& delay) override;
+
+    bool rewind() override;
+
+    /// Check if the file starts with an ERAW image.
+    EGT_NODISCARD bool valid() const { return !m_size.empty(); }
+
+private:
+
+    std::ifstream m_file;
+    /// Set when the header of the next frame was already read.
+    bool m_have_header{false};
+    uint32_t m_delay{0};
+};
+
+}
+}
+}
+
+#endif
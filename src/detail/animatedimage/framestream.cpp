@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/animatedimage/framestream.h"
+#include "detail/egtlog.h"
+#include "egt/eventloop.h"
+#include <algorithm>
+#include <exception>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+std::shared_ptr<FrameStream> FrameStream::create(EventLoop& event,
+        std::unique_ptr<AnimationDecoder> decoder,
+        size_t lookahead, bool loop,
+        InplaceFunction<void()> ready)
+{
+    auto stream = std::make_shared<FrameStream>(event, std::move(decoder),
+                  lookahead, loop, std::move(ready));
+
+    // the thread only holds a weak reference, to post ready calls with
+    stream->m_self = stream;
+    stream->m_thread = std::thread(&FrameStream::run, stream.get());
+
+    return stream;
+}
+
+FrameStream::FrameStream(EventLoop& event, std::unique_ptr<AnimationDecoder> decoder,
+                         size_t lookahead, bool loop, InplaceFunction<void()> ready)
+    : m_event(event),
+      m_decoder(std::move(decoder)),
+      m_size(m_decoder->size()),
+      m_lookahead(std::max<size_t>(lookahead, 1)),
+      m_ready(std::move(ready)),
+      m_loop(loop)
+{}
+
+bool FrameStream::pop(Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_frames.empty())
+    {
+        m_waiting = true;
+        return false;
+    }
+
+    frame = std::move(m_frames.front());
+    m_frames.pop_front();
+    m_cv.notify_one();
+    return true;
+}
+
+void FrameStream::recycle(shared_cairo_surface_t surface)
+{
+    if (!surface)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(surface));
+}
+
+bool FrameStream::finished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_end && m_frames.empty();
+}
+
+void FrameStream::loop(bool enable)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loop = enable;
+}
+
+void FrameStream::notify()
+{
+    if (!m_waiting)
+        return;
+    m_waiting = false;
+
+    // the stream may be gone by the time the call runs
+    auto self = m_self;
+    m_event.call_async(this, [self]()
+    {
+        if (auto stream = self.lock())
+            stream->m_ready();
+    });
+}
+
+void FrameStream::run()
+{
+    try
+    {
+        decode();
+    }
+    catch (const std::exception& e)
+    {
+        // a corrupt file must not take the application down with the thread
+        EGTLOG_DEBUG("animation decoding failed: {}", e.what());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_end = true;
+        notify();
+    }
+}
+
+void FrameStream::decode()
+{
+    size_t decoded = 0;
+
+    while (true)
+    {
+        shared_cairo_surface_t surface;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || m_frames.size() < m_lookahead; });
+            if (m_stop)
+                return;
+
+            if (!m_free.empty())
+            {
+                surface = std::move(m_free.back());
+                m_free.pop_back();
+            }
+        }
+
+        if (!surface)
+            surface = shared_cairo_surface_t(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                             m_size.width(), m_size.height()),
+                                             cairo_surface_destroy);
+
+        bool ok = cairo_surface_status(surface.get()) == CAIRO_STATUS_SUCCESS;
+        if (ok)
+        {
+            cairo_surface_flush(surface.get());
+            std::chrono::milliseconds delay{0};
+            if (m_decoder->next(cairo_image_surface_get_data(surface.get()),
+                                cairo_image_surface_get_stride(surface.get()),
+                                delay))
+            {
+                cairo_surface_mark_dirty(surface.get());
+                ++decoded;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_frames.push_back({std::move(surface), delay});
+                notify();
+                continue;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok)
+        {
+            m_free.push_back(std::move(surface));
+
+            // nothing to loop with one frame
+            if (m_loop && decoded > 1 && m_decoder->rewind())
+            {
+                decoded = 0;
+                continue;
+            }
+        }
+
+        m_end = true;
+        notify();
+        return;
+    }
+}
+
+FrameStream::~FrameStream() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+}
+}
+}
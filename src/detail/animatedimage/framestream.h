@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ANIMATEDIMAGE_FRAMESTREAM_H
+#define EGT_SRC_DETAIL_ANIMATEDIMAGE_FRAMESTREAM_H
+
+#include "detail/animatedimage/decoder.h"
+#include "egt/detail/inplacefunction.h"
+#include "egt/detail/meta.h"
+#include "egt/types.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+class EventLoop;
+
+namespace detail
+{
+
+/**
+ * Decodes the frames of an animation ahead of time on a worker thread.
+ *
+ * At most lookahead frames are decoded ahead of the frame shown.  The
+ * surfaces of frames no longer shown are given back with recycle() and
+ * decoded into again, so the memory used is a few frames regardless of the
+ * length of the animation.
+ *
+ * When looping, the decoder is rewound at the end of the animation, unless
+ * it only has one frame.
+ */
+class FrameStream : private NonCopyable<FrameStream>
+{
+public:
+
+    /// A decoded frame.
+    struct Frame
+    {
+        shared_cairo_surface_t surface;
+        std::chrono::milliseconds delay{0};
+    };
+
+    /**
+     * Create a stream and start decoding.
+     *
+     * @param[in] event Event loop to call ready on.
+     * @param[in] decoder The decoder.
+     * @param[in] lookahead Maximum number of frames decoded ahead.
+     * @param[in] loop Rewind at the end of the animation.
+     * @param[in] ready Called on the event loop thread when a frame or the
+     *            end of the animation is ready after pop() returned false.
+     */
+    static std::shared_ptr<FrameStream> create(EventLoop& event,
+            std::unique_ptr<AnimationDecoder> decoder,
+            size_t lookahead, bool loop,
+            InplaceFunction<void()> ready);
+
+    /// @private use create()
+    FrameStream(EventLoop& event, std::unique_ptr<AnimationDecoder> decoder,
+                size_t lookahead, bool loop, InplaceFunction<void()> ready);
+
+    /// Size of the frames.
+    EGT_NODISCARD Size size() const { return m_size; }
+
+    /**
+     * Take the next frame, if it is decoded.
+     *
+     * If not, ready is called when it is.
+     */
+    bool pop(Frame& frame);
+
+    /**
+     * Give back the surface of a frame that is no longer shown.
+     */
+    void recycle(shared_cairo_surface_t surface);
+
+    /**
+     * Check if all frames were taken and there are no more.
+     */
+    EGT_NODISCARD bool finished();
+
+    /**
+     * Set whether the decoder is rewound at the end of the animation.
+     *
+     * This has no effect once the end was reached.
+     */
+    void loop(bool enable);
+
+    ~FrameStream() noexcept;
+
+private:
+
+    /// Thread function, ending the stream if decoding throws.
+    void run();
+
+    void decode();
+
+    /// Have ready called on the event loop thread.  Called with m_mutex held.
+    void notify();
+
+    EventLoop& m_event;
+    std::unique_ptr<AnimationDecoder> m_decoder;
+    Size m_size;
+    size_t m_lookahead;
+    InplaceFunction<void()> m_ready;
+    std::weak_ptr<FrameStream> m_self;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Frame> m_frames;
+    std::vector<shared_cairo_surface_t> m_free;
+    bool m_loop;
+    /// Set when pop() found no frame.
+    bool m_waiting{false};
+    /// Set when the decoder has no more frames.
+    bool m_end{false};
+    bool m_stop{false};
+
+    std::thread m_thread;
+};
+
+}
+}
+}
+
+#endif
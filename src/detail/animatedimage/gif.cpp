@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/animatedimage/gif.h"
+#include <algorithm>
+#include <cstring>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Browsers show frames with a delay of 0 or 10 ms for this long.
+static constexpr std::chrono::milliseconds DEFAULT_GIF_DELAY{100};
+
+static bool read_u16(std::istream& in, uint16_t& value)
+{
+    unsigned char b[2];
+    if (!in.read(reinterpret_cast<char*>(b), sizeof(b)))
+        return false;
+    value = b[0] | (b[1] << 8u);
+    return true;
+}
+
+namespace
+{
+/**
+ * Reads the bytes of a sequence of data sub-blocks.
+ */
+class SubBlockReader
+{
+public:
+    explicit SubBlockReader(std::istream& in)
+        : m_in(in)
+    {}
+
+    /// Get the next byte, or -1 at the terminator or on an error.
+    int get()
+    {
+        if (m_pos == m_len)
+        {
+            if (m_done)
+                return -1;
+
+            const auto len = m_in.get();
+            if (len <= 0 || !m_in.read(reinterpret_cast<char*>(m_block), len))
+            {
+                m_done = true;
+                return -1;
+            }
+            m_len = len;
+            m_pos = 0;
+        }
+
+        return m_block[m_pos++];
+    }
+
+    /// Skip to after the terminator.
+    bool finish()
+    {
+        while (!m_done)
+        {
+            m_pos = m_len;
+            get();
+        }
+        return static_cast<bool>(m_in);
+    }
+
+private:
+    std::istream& m_in;
+    unsigned char m_block[255]{};
+    int m_pos{0};
+    int m_len{0};
+    bool m_done{false};
+};
+}
+
+GifDecoder::GifDecoder(const std::string& filename)
+    : m_file(filename, std::ios_base::binary)
+{
+    char signature[6];
+    if (!m_file.read(signature, sizeof(signature)) ||
+        (std::memcmp(signature, "GIF87a", 6) && std::memcmp(signature, "GIF89a", 6)))
+        return;
+
+    uint16_t width = 0;
+    uint16_t height = 0;
+    if (!read_u16(m_file, width) || !read_u16(m_file, height))
+        return;
+
+    const auto packed = m_file.get();
+    // background color and aspect ratio are not used
+    m_file.ignore(2);
+    if (!m_file || !valid_size(width, height))
+        return;
+
+    if (packed & 0x80)
+    {
+        m_global_count = 2u << (packed & 0x07u);
+        if (!read_palette(m_global, m_global_count))
+            return;
+    }
+
+    m_size = Size(width, height);
+    m_canvas.assign(static_cast<size_t>(width) * height, 0);
+    m_first_block = m_file.tellg();
+}
+
+bool GifDecoder::read_palette(Palette& palette, size_t count)
+{
+    unsigned char rgb[256 * 3];
+    if (!m_file.read(reinterpret_cast<char*>(rgb), count * 3))
+        return false;
+
+    palette.fill(0xff000000u);
+    for (size_t i = 0; i < count; ++i)
+        palette[i] = 0xff000000u | (rgb[i * 3] << 16u) | (rgb[i * 3 + 1] << 8u) | rgb[i * 3 + 2];
+
+    return true;
+}
+
+bool GifDecoder::skip_blocks()
+{
+    SubBlockReader reader(m_file);
+    return reader.finish();
+}
+
+bool GifDecoder::read_control()
+{
+    SubBlockReader reader(m_file);
+    const auto packed = reader.get();
+    const auto lo = reader.get();
+    const auto hi = reader.get();
+    const auto transparent = reader.get();
+    if (transparent < 0)
+        return false;
+
+    m_control.disposal = (packed >> 2) & 0x07;
+    m_control.transparent = (packed & 0x01) ? transparent : -1;
+    m_control.delay = std::chrono::milliseconds((lo | (hi << 8)) * 10);
+
+    return reader.finish();
+}
+
+bool GifDecoder::read_image()
+{
+    uint16_t left = 0;
+    uint16_t top = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    if (!read_u16(m_file, left) || !read_u16(m_file, top) ||
+        !read_u16(m_file, width) || !read_u16(m_file, height))
+        return false;
+
+    const auto packed = m_file.get();
+    if (!m_file)
+        return false;
+
+    Palette local{};
+    const Palette* palette = &m_global;
+    if (packed & 0x80)
+    {
+        if (!read_palette(local, 2u << (packed & 0x07u)))
+            return false;
+        palette = &local;
+    }
+
+    m_disposal = m_control.disposal;
+    m_area = Rect::intersection(Rect(left, top, width, height), Rect({}, m_size));
+
+    if (m_disposal == 3 && !m_area.empty())
+    {
+        m_previous.resize(m_area.width() * m_area.height());
+        for (auto y = 0; y < m_area.height(); ++y)
+            std::copy_n(m_canvas.data() + (m_area.y() + y) * m_size.width() + m_area.x(),
+                        m_area.width(), m_previous.data() + y * m_area.width());
+    }
+
+    // rows in the order they are stored
+    std::vector<uint16_t> rows(height);
+    if (packed & 0x40)
+    {
+        size_t i = 0;
+        for (auto pass : {std::make_pair(0, 8), std::make_pair(4, 8),
+                          std::make_pair(2, 4), std::make_pair(1, 2)
+                         })
+        {
+            for (auto y = pass.first; y < height; y += pass.second)
+                rows[i++] = y;
+        }
+    }
+    else
+    {
+        for (size_t y = 0; y < height; ++y)
+            rows[y] = y;
+    }
+
+    // codes below the clear code index the 256 entry palette
+    const auto min_code_size = m_file.get();
+    if (min_code_size < 1 || min_code_size > 8)
+        return false;
+
+    const size_t total = static_cast<size_t>(width) * height;
+    size_t written = 0;
+    const auto transparent = m_control.transparent;
+    auto output = [&](int index)
+    {
+        if (written >= total)
+            return;
+
+        const int x = left + written % width;
+        const int y = top + rows[written / width];
+        ++written;
+
+        if (index == transparent || x >= m_size.width() || y >= m_size.height())
+            return;
+
+        m_canvas[y * m_size.width() + x] = (*palette)[index];
+    };
+
+    // LZW decompression
+    static constexpr int MAX_CODES = 4096;
+    uint16_t prefix[MAX_CODES];
+    uint8_t suffix[MAX_CODES];
+    uint8_t stack[MAX_CODES + 1];
+
+    const int clear = 1 << min_code_size;
+    const int eoi = clear + 1;
+    for (auto i = 0; i < clear; ++i)
+        suffix[i] = i;
+
+    int code_size = min_code_size + 1;
+    int next = clear + 2;
+    int old = -1;
+    int first = 0;
+    uint32_t bits = 0;
+    int nbits = 0;
+
+    SubBlockReader reader(m_file);
+    while (written < total)
+    {
+        while (nbits < code_size)
+        {
+            const auto b = reader.get();
+            if (b < 0)
+                break;
+            bits |= static_cast<uint32_t>(b) << nbits;
+            nbits += 8;
+        }
+        // truncated data leaves the rest of the image as is
+        if (nbits < code_size)
+            break;
+
+        int code = bits & ((1u << code_size) - 1u);
+        bits >>= code_size;
+        nbits -= code_size;
+
+        if (code == clear)
+        {
+            code_size = min_code_size + 1;
+            next = clear + 2;
+            old = -1;
+            continue;
+        }
+
+        if (code == eoi)
+            break;
+
+        if (old < 0)
+        {
+            if (code > clear)
+                return false;
+            output(code);
+            first = code;
+            old = code;
+            continue;
+        }
+
+        const auto in = code;
+        size_t sp = 0;
+        if (code >= next)
+        {
+            if (code > next)
+                return false;
+            stack[sp++] = first;
+            code = old;
+        }
+
+        while (code >= clear)
+        {
+            stack[sp++] = suffix[code];
+            code = prefix[code];
+        }
+        first = code;
+        stack[sp++] = first;
+
+        if (next < MAX_CODES)
+        {
+            prefix[next] = old;
+            suffix[next] = first;
+            if (++next == (1 << code_size) && code_size < 12)
+                ++code_size;
+        }
+        old = in;
+
+        while (sp)
+            output(stack[--sp]);
+    }
+
+    return reader.finish();
+}
+
+void GifDecoder::dispose()
+{
+    if (m_area.empty())
+        return;
+
+    if (m_disposal == 2)
+    {
+        for (auto y = m_area.y(); y < m_area.y() + m_area.height(); ++y)
+            std::fill_n(m_canvas.data() + y * m_size.width() + m_area.x(), m_area.width(), 0);
+    }
+    else if (m_disposal == 3)
+    {
+        for (auto y = 0; y < m_area.height(); ++y)
+            std::copy_n(m_previous.data() + y * m_area.width(), m_area.width(),
+                        m_canvas.data() + (m_area.y() + y) * m_size.width() + m_area.x());
+    }
+
+    m_area = {};
+}
+
+bool GifDecoder::next(unsigned char* data, size_t stride,
+                      std::chrono::milliseconds& delay)
+{
+    if (!valid())
+        return false;
+
+    dispose();
+
+    while (true)
+    {
+        const auto block = m_file.get();
+        if (block == 0x21)
+        {
+            const auto label = m_file.get();
+            if (!(label == 0xf9 ? read_control() : skip_blocks()))
+                return false;
+        }
+        else if (block == 0x2c)
+        {
+            if (!read_image())
+                return false;
+            break;
+        }
+        else
+        {
+            // trailer, or an error
+            return false;
+        }
+    }
+
+    for (auto y = 0; y < m_size.height(); ++y)
+        std::copy_n(m_canvas.data() + y * m_size.width(), m_size.width(),
+                    reinterpret_cast<uint32_t*>(data + y * stride));
+
+    delay = m_control.delay > std::chrono::milliseconds(10) ? m_control.delay : DEFAULT_GIF_DELAY;
+    m_control = {};
+
+    return true;
+}
+
+bool GifDecoder::rewind()
+{
+    if (!valid())
+        return false;
+
+    m_file.clear();
+    m_file.seekg(m_first_block);
+    std::fill(m_canvas.begin(), m_canvas.end(), 0);
+    m_control = {};
+    m_disposal = 0;
+    m_area = {};
+    return static_cast<bool>(m_file);
+}
+
+}
+}
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ANIMATEDIMAGE_GIF_H
+#define EGT_SRC_DETAIL_ANIMATEDIMAGE_GIF_H
+
+#include "detail/animatedimage/decoder.h"
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Decoder of GIF images.
+ *
+ * Each image of the file is composed onto a canvas, with the disposal and
+ * transparency of its graphic control extension, and the canvas is the
+ * frame.
+ */
+class GifDecoder : public AnimationDecoder
+{
+public:
+
+    explicit GifDecoder(const std::string& filename);
+
+    bool next(unsigned char* data, size_t stride,
+              std::chrono::milliseconds& delay) override;
+
+    bool rewind() override;
+
+    /// Check if the file starts with a GIF header.
+    EGT_NODISCARD bool valid() const { return m_first_block != 0; }
+
+private:
+
+    using Palette = std::array<uint32_t, 256>;
+
+    /// Read a color table of a number of entries.
+    bool read_palette(Palette& palette, size_t count);
+
+    /// Skip data sub-blocks up to and including the terminator.
+    bool skip_blocks();
+
+    /// Read the graphic control extension.
+    bool read_control();
+
+    /// Read an image onto the canvas.
+    bool read_image();
+
+    /// Undo the last image as requested by its disposal.
+    void dispose();
+
+    std::ifstream m_file;
+    /// Offset of the first block after the header.
+    std::streamoff m_first_block{0};
+
+    Palette m_global{};
+    size_t m_global_count{0};
+
+    /// Composed frame, as premultiplied ARGB32.
+    std::vector<uint32_t> m_canvas;
+    /// Canvas under the last image, if its disposal restores it.
+    std::vector<uint32_t> m_previous;
+
+    /// Graphic control of the next image.
+    struct Control
+    {
+        int disposal{0};
+        int transparent{-1};
+        std::chrono::milliseconds delay{0};
+    };
+
+    Control m_control;
+    /// Disposal and area of the last image.
+    int m_disposal{0};
+    Rect m_area;
+};
+
+}
+}
+}
+
+#endif
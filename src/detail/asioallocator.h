@@ -84,14 +84,15 @@ public:
         m_handler(arg1, arg2);
     }
 
-    void* asio_handler_allocate(std::size_t size,
-                                CustomAllocHandler<Handler>* this_handler)
+    // found by argument dependent lookup, so these must not be members
+    friend void* asio_handler_allocate(std::size_t size,
+                                       CustomAllocHandler<Handler>* this_handler)
     {
         return this_handler->m_allocator.allocate(size);
     }
 
-    void asio_handler_deallocate(void* pointer, std::size_t /*size*/,
-                                 CustomAllocHandler<Handler>* this_handler)
+    friend void asio_handler_deallocate(void* pointer, std::size_t /*size*/,
+                                        CustomAllocHandler<Handler>* this_handler)
     {
         this_handler->m_allocator.deallocate(pointer);
     }
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/asyncqueue.h"
+#include "detail/trace.h"
+#include <algorithm>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+AsyncQueue::AsyncQueue(asio::io_context& io)
+    : m_io(io)
+{}
+
+AsyncQueue::Node* AsyncQueue::allocate()
+{
+    if (!m_free)
+    {
+        m_blocks.emplace_back(new Node[BLOCK_SIZE]);
+        auto& block = m_blocks.back();
+        for (size_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            block[i].next = m_free;
+            m_free = &block[i];
+        }
+    }
+
+    auto node = m_free;
+    m_free = node->next;
+    node->next = nullptr;
+    return node;
+}
+
+void AsyncQueue::post(const void* key, Call&& call)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (key)
+    {
+        auto i = std::find_if(m_keyed.begin(), m_keyed.end(),
+                              [key](const Node * node) { return node->key == key; });
+        if (i != m_keyed.end())
+        {
+            // latest wins, in the place of the first
+            (*i)->call = std::move(call);
+            return;
+        }
+    }
+
+    auto node = allocate();
+    node->key = key;
+    node->call = std::move(call);
+
+    if (m_tail)
+        m_tail->next = node;
+    else
+        m_head = node;
+    m_tail = node;
+
+    if (key)
+        m_keyed.push_back(node);
+
+    // one wake up of the event loop at a time
+    if (!m_wake)
+    {
+        m_wake = true;
+        asio::post(m_io, [this]() { drain(); });
+    }
+}
+
+void AsyncQueue::cancel(const void* key)
+{
+    if (!key)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // cancelled nodes stay queued with no call, and are returned to the pool
+    // by drain()
+    auto i = std::find_if(m_keyed.begin(), m_keyed.end(),
+                          [key](const Node * node) { return node->key == key; });
+    if (i != m_keyed.end())
+    {
+        (*i)->call = nullptr;
+        m_keyed.erase(i);
+    }
+
+    for (auto node = m_draining; node; node = node->next)
+        if (node->key == key)
+            node->call = nullptr;
+}
+
+void AsyncQueue::drain()
+{
+    Node* head;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake = false;
+        head = m_head;
+        m_head = m_tail = nullptr;
+        m_keyed.clear();
+    }
+
+    if (!head)
+        return;
+
+    EGT_TRACE_SCOPE("async calls");
+
+    Node* tail = nullptr;
+    for (auto node = head; node; node = node->next)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_draining = node->next;
+        }
+
+        if (node->call)
+            node->call();
+        // release anything the call holds before returning the node
+        node->call = nullptr;
+        tail = node;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_draining = nullptr;
+    tail->next = m_free;
+    m_free = head;
+}
+
+}
+}
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_ASYNCQUEUE_H
+#define EGT_SRC_DETAIL_ASYNCQUEUE_H
+
+#include "egt/detail/meta.h"
+#include "egt/eventloop.h"
+#include <egt/asio.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Queue of calls posted from any thread to be run on the event loop thread.
+ *
+ * Calls are stored in nodes taken from a pool, so posting does not allocate
+ * once the pool has grown to the peak number of pending calls.  A call posted
+ * with the same key as a pending call replaces it.
+ */
+class AsyncQueue : private NonCopyable<AsyncQueue>
+{
+public:
+
+    using Call = EventLoop::AsyncCall;
+
+    /**
+     * @param[in] io The io_context of the event loop, used to wake it up.
+     */
+    explicit AsyncQueue(asio::io_context& io);
+
+    /**
+     * Queue a call.  May be called from any thread.
+     *
+     * @param[in] key Coalescing key, or nullptr.
+     * @param[in] call The call.
+     */
+    void post(const void* key, Call&& call);
+
+    /**
+     * Drop any pending call with a key.  Called on the event loop thread.
+     *
+     * This includes calls of a drain() that is running, but not the call
+     * running now.
+     */
+    void cancel(const void* key);
+
+    /**
+     * Run all queued calls.  Called on the event loop thread.
+     *
+     * Calls posted while draining are run by the next drain.
+     */
+    void drain();
+
+private:
+
+    struct Node
+    {
+        const void* key{nullptr};
+        Call call;
+        Node* next{nullptr};
+    };
+
+    /// Get a node from the pool.  Called with the mutex held.
+    Node* allocate();
+
+    /// Number of nodes the pool grows by.
+    static constexpr size_t BLOCK_SIZE = 32;
+
+    asio::io_context& m_io;
+    std::mutex m_mutex;
+    /// Pending calls, oldest first.
+    Node* m_head{nullptr};
+    Node* m_tail{nullptr};
+    /// Pending calls with a key.
+    std::vector<Node*> m_keyed;
+    /// Calls not yet run by the running drain().
+    Node* m_draining{nullptr};
+    /// Unused nodes.
+    Node* m_free{nullptr};
+    /// Storage of all nodes.
+    std::vector<std::unique_ptr<Node[]>> m_blocks;
+    /// Set while a drain() is posted to the event loop.
+    bool m_wake{false};
+};
+
+}
+}
+}
+
+#endif
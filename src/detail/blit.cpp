@@ -0,0 +1,679 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "detail/blit.h"
+#include "detail/egtlog.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EGT_BLIT_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EGT_BLIT_NEON
+#endif
+
+#if defined(__arm__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+extern "C" {
+#ifdef __arm__
+    extern void* arm_memset16(uint16_t*, uint16_t, size_t);
+    extern void* arm_memset32(uint32_t*, uint32_t, size_t);
+#endif
+}
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/*
+ * Composite one premultiplied pixel over another, two channels at a time.
+ */
+static inline uint32_t over_pixel(uint32_t s, uint32_t d)
+{
+    const uint32_t ia = 255u - (s >> 24u);
+
+    uint32_t rb = (d & 0x00ff00ffu) * ia + 0x00800080u;
+    rb = ((rb + ((rb >> 8u) & 0x00ff00ffu)) >> 8u) & 0x00ff00ffu;
+
+    uint32_t ag = ((d >> 8u) & 0x00ff00ffu) * ia + 0x00800080u;
+    ag = (ag + ((ag >> 8u) & 0x00ff00ffu)) & 0xff00ff00u;
+
+    return s + (rb | ag);
+}
+
+static inline uint32_t expand565(uint16_t p)
+{
+    const uint32_t r = (p >> 11u) & 0x1fu;
+    const uint32_t g = (p >> 5u) & 0x3fu;
+    const uint32_t b = p & 0x1fu;
+
+    return 0xff000000u |
+           (((r << 3u) | (r >> 2u)) << 16u) |
+           (((g << 2u) | (g >> 4u)) << 8u) |
+           ((b << 3u) | (b >> 2u));
+}
+
+static inline uint16_t pack565(uint32_t p)
+{
+    return static_cast<uint16_t>(((p >> 8u) & 0xf800u) |
+                                 ((p >> 5u) & 0x07e0u) |
+                                 ((p >> 3u) & 0x001fu));
+}
+
+static void generic_fill16(uint16_t* dst, uint16_t value, size_t count)
+{
+#ifdef __arm__
+    arm_memset16(dst, value, count);
+#else
+    while (count--)
+        *dst++ = value;
+#endif
+}
+
+static void generic_fill32(uint32_t* dst, uint32_t value, size_t count)
+{
+#ifdef __arm__
+    arm_memset32(dst, value, count);
+#else
+    while (count--)
+        *dst++ = value;
+#endif
+}
+
+static void generic_over32(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    while (count--)
+    {
+        const auto s = *src++;
+        const auto a = s >> 24u;
+        if (a == 255)
+            *dst = s;
+        else if (a)
+            *dst = over_pixel(s, *dst);
+        ++dst;
+    }
+}
+
+static void generic_over16(uint16_t* dst, const uint32_t* src, size_t count)
+{
+    while (count--)
+    {
+        const auto s = *src++;
+        const auto a = s >> 24u;
+        if (a == 255)
+            *dst = pack565(s);
+        else if (a)
+            *dst = pack565(over_pixel(s, expand565(*dst)));
+        ++dst;
+    }
+}
+
+static void generic_colormap32(uint32_t* dst, const float* src, size_t count,
+                              float offset, float scale, const uint32_t* lut)
+{
+    while (count--)
+    {
+        auto t = (*src++ - offset) * scale;
+        // written so NaN selects the first entry
+        t = t > 0.f ? std::min(t, 255.f) : 0.f;
+        *dst++ = lut[static_cast<int>(t + 0.5f)];
+    }
+}
+
+/*
+ * BT.601 video range to RGB with 6 bit coefficients, except luma which takes
+ * 7 bits to reach 255 at white.  The intermediate values fit in 16 bits, or
+ * saturate past 255, so the SIMD kernels give the same result.
+ */
+static inline void yuv_pixel(int y, int u, int v, int& r, int& g, int& b)
+{
+    y = (((y - 16) * 149) >> 1) + 32;
+    u -= 128;
+    v -= 128;
+
+    r = std::min(std::max((y + v * 102) >> 6, 0), 255);
+    g = std::min(std::max((y - u * 25 - v * 52) >> 6, 0), 255);
+    b = std::min(std::max((y + u * 129) >> 6, 0), 255);
+}
+
+static void generic_yuv32(uint32_t* dst, const uint8_t* y, const uint8_t* u,
+                          const uint8_t* v, size_t count)
+{
+    while (count--)
+    {
+        int r;
+        int g;
+        int b;
+        yuv_pixel(*y++, *u++, *v++, r, g, b);
+        *dst++ = 0xff000000u | (r << 16u) | (g << 8u) | b;
+    }
+}
+
+static void generic_yuv16(uint16_t* dst, const uint8_t* y, const uint8_t* u,
+                          const uint8_t* v, size_t count)
+{
+    while (count--)
+    {
+        int r;
+        int g;
+        int b;
+        yuv_pixel(*y++, *u++, *v++, r, g, b);
+        *dst++ = static_cast<uint16_t>(((r & 0xf8) << 8u) | ((g & 0xfc) << 3u) | (b >> 3u));
+    }
+}
+
+#ifdef EGT_BLIT_X86
+
+__attribute__((target("sse2")))
+static void sse2_fill16(uint16_t* dst, uint16_t value, size_t count)
+{
+    const __m128i v = _mm_set1_epi16(static_cast<short>(value));
+    for (; count >= 8; count -= 8, dst += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+    while (count--)
+        *dst++ = value;
+}
+
+__attribute__((target("sse2")))
+static void sse2_fill32(uint32_t* dst, uint32_t value, size_t count)
+{
+    const __m128i v = _mm_set1_epi32(static_cast<int>(value));
+    for (; count >= 4; count -= 4, dst += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+    while (count--)
+        *dst++ = value;
+}
+
+__attribute__((target("sse2")))
+static void sse2_over32(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i amask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+
+    for (; count >= 4; count -= 4, dst += 4, src += 4)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i alpha = _mm_and_si128(s, amask);
+
+        // fully transparent or fully opaque blocks are common
+        const auto transparent = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero));
+        if (transparent == 0xffff)
+            continue;
+        const auto opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, amask));
+        if (opaque == 0xffff)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), s);
+            continue;
+        }
+
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+
+        // broadcast 255 - alpha to every channel
+        __m128i ia = _mm_srli_epi32(s, 24);
+        ia = _mm_or_si128(ia, _mm_slli_epi32(ia, 8));
+        ia = _mm_or_si128(ia, _mm_slli_epi32(ia, 16));
+        ia = _mm_xor_si128(ia, ones);
+
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(ia, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(ia, zero));
+
+        // divide by 255
+        lo = _mm_add_epi16(lo, half);
+        hi = _mm_add_epi16(hi, half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+
+    generic_over32(dst, src, count);
+}
+
+__attribute__((target("sse2")))
+static void sse2_colormap32(uint32_t* dst, const float* src, size_t count,
+                            float offset, float scale, const uint32_t* lut)
+{
+    const __m128 o = _mm_set1_ps(offset);
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 top = _mm_set1_ps(255.f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    alignas(16) int32_t index[4];
+    for (; count >= 4; count -= 4, dst += 4, src += 4)
+    {
+        __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src), o), s);
+        // max returns the second operand for NaN
+        t = _mm_min_ps(_mm_max_ps(t, zero), top);
+        _mm_store_si128(reinterpret_cast<__m128i*>(index),
+                        _mm_cvttps_epi32(_mm_add_ps(t, half)));
+
+        // no gather before avx2
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_setr_epi32(static_cast<int>(lut[index[0]]),
+                                        static_cast<int>(lut[index[1]]),
+                                        static_cast<int>(lut[index[2]]),
+                                        static_cast<int>(lut[index[3]])));
+    }
+
+    generic_colormap32(dst, src, count, offset, scale, lut);
+}
+
+/*
+ * Convert 8 pixels, leaving each channel clamped in the low 8 bytes.
+ */
+__attribute__((target("sse2")))
+static inline void sse2_yuv_pixels(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                   __m128i& r, __m128i& g, __m128i& b)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i yy = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y)), zero);
+    __m128i uu = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u)), zero);
+    __m128i vv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v)), zero);
+
+    // 149 / 2 as 74 + 1 / 2 to stay in 16 bits
+    yy = _mm_sub_epi16(yy, _mm_set1_epi16(16));
+    yy = _mm_add_epi16(_mm_mullo_epi16(yy, _mm_set1_epi16(74)), _mm_srai_epi16(yy, 1));
+    yy = _mm_add_epi16(yy, _mm_set1_epi16(32));
+    uu = _mm_sub_epi16(uu, _mm_set1_epi16(128));
+    vv = _mm_sub_epi16(vv, _mm_set1_epi16(128));
+
+    r = _mm_adds_epi16(yy, _mm_mullo_epi16(vv, _mm_set1_epi16(102)));
+    g = _mm_subs_epi16(_mm_subs_epi16(yy, _mm_mullo_epi16(uu, _mm_set1_epi16(25))),
+                       _mm_mullo_epi16(vv, _mm_set1_epi16(52)));
+    b = _mm_adds_epi16(yy, _mm_mullo_epi16(uu, _mm_set1_epi16(129)));
+
+    r = _mm_srai_epi16(r, 6);
+    g = _mm_srai_epi16(g, 6);
+    b = _mm_srai_epi16(b, 6);
+
+    r = _mm_packus_epi16(r, r);
+    g = _mm_packus_epi16(g, g);
+    b = _mm_packus_epi16(b, b);
+}
+
+__attribute__((target("sse2")))
+static void sse2_yuv32(uint32_t* dst, const uint8_t* y, const uint8_t* u,
+                       const uint8_t* v, size_t count)
+{
+    const __m128i alpha = _mm_set1_epi8(-1);
+
+    for (; count >= 8; count -= 8, dst += 8, y += 8, u += 8, v += 8)
+    {
+        __m128i r;
+        __m128i g;
+        __m128i b;
+        sse2_yuv_pixels(y, u, v, r, g, b);
+
+        // bytes are b, g, r, a on little endian
+        const __m128i bg = _mm_unpacklo_epi8(b, g);
+        const __m128i ra = _mm_unpacklo_epi8(r, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(bg, ra));
+    }
+
+    generic_yuv32(dst, y, u, v, count);
+}
+
+__attribute__((target("sse2")))
+static void sse2_yuv16(uint16_t* dst, const uint8_t* y, const uint8_t* u,
+                       const uint8_t* v, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; count >= 8; count -= 8, dst += 8, y += 8, u += 8, v += 8)
+    {
+        __m128i r;
+        __m128i g;
+        __m128i b;
+        sse2_yuv_pixels(y, u, v, r, g, b);
+
+        r = _mm_and_si128(_mm_slli_epi16(_mm_unpacklo_epi8(r, zero), 8),
+                          _mm_set1_epi16(static_cast<short>(0xf800)));
+        g = _mm_and_si128(_mm_slli_epi16(_mm_unpacklo_epi8(g, zero), 3),
+                          _mm_set1_epi16(0x07e0));
+        b = _mm_srli_epi16(_mm_unpacklo_epi8(b, zero), 3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_or_si128(r, _mm_or_si128(g, b)));
+    }
+
+    generic_yuv16(dst, y, u, v, count);
+}
+
+__attribute__((target("avx2")))
+static void avx2_fill16(uint16_t* dst, uint16_t value, size_t count)
+{
+    const __m256i v = _mm256_set1_epi16(static_cast<short>(value));
+    for (; count >= 16; count -= 16, dst += 16)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+    while (count--)
+        *dst++ = value;
+}
+
+__attribute__((target("avx2")))
+static void avx2_fill32(uint32_t* dst, uint32_t value, size_t count)
+{
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(value));
+    for (; count >= 8; count -= 8, dst += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+    while (count--)
+        *dst++ = value;
+}
+
+__attribute__((target("avx2")))
+static void avx2_over32(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i amask = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+
+    for (; count >= 8; count -= 8, dst += 8, src += 8)
+    {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i alpha = _mm256_and_si256(s, amask);
+
+        const auto transparent = _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, zero));
+        if (transparent == -1)
+            continue;
+        const auto opaque = _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, amask));
+        if (opaque == -1)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), s);
+            continue;
+        }
+
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+
+        __m256i ia = _mm256_srli_epi32(s, 24);
+        ia = _mm256_or_si256(ia, _mm256_slli_epi32(ia, 8));
+        ia = _mm256_or_si256(ia, _mm256_slli_epi32(ia, 16));
+        ia = _mm256_xor_si256(ia, ones);
+
+        // unpack and pack both work within 128 bit lanes, so pixel order is kept
+        __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(ia, zero));
+        __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(ia, zero));
+
+        lo = _mm256_add_epi16(lo, half);
+        hi = _mm256_add_epi16(hi, half);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                            _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)));
+    }
+
+    sse2_over32(dst, src, count);
+}
+
+__attribute__((target("avx2")))
+static void avx2_colormap32(uint32_t* dst, const float* src, size_t count,
+                            float offset, float scale, const uint32_t* lut)
+{
+    const __m256 o = _mm256_set1_ps(offset);
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 top = _mm256_set1_ps(255.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const auto table = reinterpret_cast<const int*>(lut);
+
+    for (; count >= 8; count -= 8, dst += 8, src += 8)
+    {
+        __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src), o), s);
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), top);
+        const __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(t, half));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                            _mm256_i32gather_epi32(table, index, 4));
+    }
+
+    sse2_colormap32(dst, src, count, offset, scale, lut);
+}
+
+#endif
+
+#ifdef EGT_BLIT_NEON
+
+static void neon_fill16(uint16_t* dst, uint16_t value, size_t count)
+{
+    const uint16x8_t v = vdupq_n_u16(value);
+    for (; count >= 8; count -= 8, dst += 8)
+        vst1q_u16(dst, v);
+    while (count--)
+        *dst++ = value;
+}
+
+static void neon_fill32(uint32_t* dst, uint32_t value, size_t count)
+{
+    const uint32x4_t v = vdupq_n_u32(value);
+    for (; count >= 4; count -= 4, dst += 4)
+        vst1q_u32(dst, v);
+    while (count--)
+        *dst++ = value;
+}
+
+static inline uint8x8_t neon_mul_div255(uint8x8_t c, uint8x8_t a)
+{
+    const uint16x8_t t = vmull_u8(c, a);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+static void neon_over32(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    for (; count >= 8; count -= 8, dst += 8, src += 8)
+    {
+        // channels are deinterleaved as b, g, r, a on little endian
+        const uint8x8x4_t s = vld4_u8(reinterpret_cast<const uint8_t*>(src));
+        uint8x8x4_t d = vld4_u8(reinterpret_cast<const uint8_t*>(dst));
+        const uint8x8_t ia = vmvn_u8(s.val[3]);
+
+        for (int c = 0; c < 4; ++c)
+            d.val[c] = vqadd_u8(s.val[c], neon_mul_div255(d.val[c], ia));
+
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), d);
+    }
+
+    generic_over32(dst, src, count);
+}
+
+static void neon_colormap32(uint32_t* dst, const float* src, size_t count,
+                            float offset, float scale, const uint32_t* lut)
+{
+    const float32x4_t o = vdupq_n_f32(offset);
+    const float32x4_t s = vdupq_n_f32(scale);
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t top = vdupq_n_f32(255.f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+
+    uint32_t index[4];
+    for (; count >= 4; count -= 4, dst += 4, src += 4)
+    {
+        float32x4_t t = vmulq_f32(vsubq_f32(vld1q_f32(src), o), s);
+        // compare instead of max so NaN selects the first entry
+        t = vbslq_f32(vcgtq_f32(t, zero), t, zero);
+        t = vminq_f32(t, top);
+        vst1q_u32(index, vcvtq_u32_f32(vaddq_f32(t, half)));
+
+        dst[0] = lut[index[0]];
+        dst[1] = lut[index[1]];
+        dst[2] = lut[index[2]];
+        dst[3] = lut[index[3]];
+    }
+
+    generic_colormap32(dst, src, count, offset, scale, lut);
+}
+
+/*
+ * Convert 8 pixels to clamped channels.
+ */
+static inline void neon_yuv_pixels(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                   uint8x8_t& r, uint8x8_t& g, uint8x8_t& b)
+{
+    int16x8_t yy = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y)));
+    const int16x8_t uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u))), vdupq_n_s16(128));
+    const int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v))), vdupq_n_s16(128));
+
+    // 149 / 2 as 74 + 1 / 2 to stay in 16 bits
+    yy = vsubq_s16(yy, vdupq_n_s16(16));
+    yy = vaddq_s16(vmulq_n_s16(yy, 74), vshrq_n_s16(yy, 1));
+    yy = vaddq_s16(yy, vdupq_n_s16(32));
+
+    // saturating narrow clamps to 0 through 255
+    r = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(vv, 102)), 6);
+    g = vqshrun_n_s16(vqsubq_s16(vqsubq_s16(yy, vmulq_n_s16(uu, 25)),
+                                 vmulq_n_s16(vv, 52)), 6);
+    b = vqshrun_n_s16(vqaddq_s16(yy, vmulq_n_s16(uu, 129)), 6);
+}
+
+static void neon_yuv32(uint32_t* dst, const uint8_t* y, const uint8_t* u,
+                       const uint8_t* v, size_t count)
+{
+    for (; count >= 8; count -= 8, dst += 8, y += 8, u += 8, v += 8)
+    {
+        uint8x8x4_t p;
+        neon_yuv_pixels(y, u, v, p.val[2], p.val[1], p.val[0]);
+        p.val[3] = vdup_n_u8(255);
+        vst4_u8(reinterpret_cast<uint8_t*>(dst), p);
+    }
+
+    generic_yuv32(dst, y, u, v, count);
+}
+
+static void neon_yuv16(uint16_t* dst, const uint8_t* y, const uint8_t* u,
+                       const uint8_t* v, size_t count)
+{
+    for (; count >= 8; count -= 8, dst += 8, y += 8, u += 8, v += 8)
+    {
+        uint8x8_t r;
+        uint8x8_t g;
+        uint8x8_t b;
+        neon_yuv_pixels(y, u, v, r, g, b);
+
+        uint16x8_t p = vshll_n_u8(r, 8);
+        p = vsriq_n_u16(p, vshll_n_u8(g, 8), 5);
+        p = vsriq_n_u16(p, vshll_n_u8(b, 8), 11);
+        vst1q_u16(dst, p);
+    }
+
+    generic_yuv16(dst, y, u, v, count);
+}
+
+#endif
+
+namespace
+{
+struct BlitKernels
+{
+    const char* isa;
+    void (*fill16)(uint16_t*, uint16_t, size_t);
+    void (*fill32)(uint32_t*, uint32_t, size_t);
+    void (*over32)(uint32_t*, const uint32_t*, size_t);
+    void (*over16)(uint16_t*, const uint32_t*, size_t);
+    void (*colormap32)(uint32_t*, const float*, size_t, float, float, const uint32_t*);
+    void (*yuv32)(uint32_t*, const uint8_t*, const uint8_t*, const uint8_t*, size_t);
+    void (*yuv16)(uint16_t*, const uint8_t*, const uint8_t*, const uint8_t*, size_t);
+};
+}
+
+static BlitKernels select_kernels()
+{
+    BlitKernels kernels{"generic", generic_fill16, generic_fill32,
+                        generic_over32, generic_over16, generic_colormap32,
+                        generic_yuv32, generic_yuv16};
+
+#ifdef EGT_BLIT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels = {"avx2", avx2_fill16, avx2_fill32, avx2_over32, generic_over16,
+                   avx2_colormap32, sse2_yuv32, sse2_yuv16};
+    else if (__builtin_cpu_supports("sse2"))
+        kernels = {"sse2", sse2_fill16, sse2_fill32, sse2_over32, generic_over16,
+                   sse2_colormap32, sse2_yuv32, sse2_yuv16};
+#endif
+
+#ifdef EGT_BLIT_NEON
+    bool neon = true;
+#if defined(__arm__) && defined(__linux__)
+    neon = getauxval(AT_HWCAP) & HWCAP_NEON;
+#endif
+    if (neon)
+        kernels = {"neon", neon_fill16, neon_fill32, neon_over32, generic_over16,
+                   neon_colormap32, neon_yuv32, neon_yuv16};
+#endif
+
+    EGTLOG_DEBUG("blit kernels: {}", kernels.isa);
+
+    return kernels;
+}
+
+static const BlitKernels& kernels()
+{
+    static const BlitKernels k = select_kernels();
+    return k;
+}
+
+void fill16(uint16_t* dst, uint16_t value, size_t count)
+{
+    kernels().fill16(dst, value, count);
+}
+
+void fill32(uint32_t* dst, uint32_t value, size_t count)
+{
+    kernels().fill32(dst, value, count);
+}
+
+void over32(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    kernels().over32(dst, src, count);
+}
+
+void over16(uint16_t* dst, const uint32_t* src, size_t count)
+{
+    kernels().over16(dst, src, count);
+}
+
+void colormap32(uint32_t* dst, const float* src, size_t count,
+                float offset, float scale, const uint32_t* lut)
+{
+    kernels().colormap32(dst, src, count, offset, scale, lut);
+}
+
+void yuv32(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+           size_t count)
+{
+    kernels().yuv32(dst, y, u, v, count);
+}
+
+void yuv16(uint16_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+           size_t count)
+{
+    kernels().yuv16(dst, y, u, v, count);
+}
+
+const char* blit_isa()
+{
+    return kernels().isa;
+}
+
+}
+}
+}
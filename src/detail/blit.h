@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_BLIT_H
+#define EGT_SRC_DETAIL_BLIT_H
+
+/**
+ * @file
+ * @brief Pixel kernels for drawing without cairo.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Fill a span of 16 bit pixels.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] value Pixel value.
+ * @param[in] count Number of pixels.
+ */
+void fill16(uint16_t* dst, uint16_t value, size_t count);
+
+/**
+ * Fill a span of 32 bit pixels.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] value Pixel value.
+ * @param[in] count Number of pixels.
+ */
+void fill32(uint32_t* dst, uint32_t value, size_t count);
+
+/**
+ * Composite a span of premultiplied ARGB32 pixels onto ARGB32 or RGB24 pixels
+ * with the OVER operator.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] src Source pixels.
+ * @param[in] count Number of pixels.
+ */
+void over32(uint32_t* dst, const uint32_t* src, size_t count);
+
+/**
+ * Composite a span of premultiplied ARGB32 pixels onto RGB565 pixels with the
+ * OVER operator.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] src Source pixels.
+ * @param[in] count Number of pixels.
+ */
+void over16(uint16_t* dst, const uint32_t* src, size_t count);
+
+/**
+ * Map a span of values to pixels through a 256 entry lookup table.
+ *
+ * Each value selects the entry at (value - offset) * scale, rounded and
+ * clamped to 0 through 255.  NaN selects the first entry.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] src Source values.
+ * @param[in] count Number of pixels.
+ * @param[in] offset Value mapped to the first entry.
+ * @param[in] scale Entries per unit of value.
+ * @param[in] lut Lookup table of 256 pixels.
+ */
+void colormap32(uint32_t* dst, const float* src, size_t count,
+                float offset, float scale, const uint32_t* lut);
+
+/**
+ * Convert a span of BT.601 video range YUV to opaque ARGB32 or RGB24 pixels.
+ *
+ * Chroma is not subsampled: every pixel has its own u and v.
+ *
+ * @param[in] dst Destination pixels.
+ * @param[in] y Luma values.
+ * @param[in] u Blue difference values.
+ * @param[in] v Red difference values.
+ * @param[in] count Number of pixels.
+ */
+void yuv32(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+           size_t count);
+
+/**
+ * Convert a span of BT.601 video range YUV to RGB565 pixels.
+ *
+ * @see yuv32()
+ */
+void yuv16(uint16_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+           size_t count);
+
+/**
+ * Name of the instruction set the kernels were selected for at runtime.
+ */
+const char* blit_isa();
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "detail/egtlog.h"
+#include "egt/detail/boxcache.h"
+#include "egt/detail/math.h"
+#include "egt/painter.h"
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <typeinfo>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+template<class T>
+static inline void hash_combine(size_t& seed, const T& v)
+{
+    seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+}
+
+static size_t pattern_hash(const Pattern& pattern)
+{
+    size_t seed = 0;
+    hash_combine(seed, static_cast<int>(pattern.type()));
+    if (pattern.type() == Pattern::Type::solid)
+    {
+        hash_combine(seed, pattern.solid().pixel32());
+    }
+    else
+    {
+        for (const auto& step : pattern.steps())
+        {
+            hash_combine(seed, step.first);
+            hash_combine(seed, step.second.pixel32());
+        }
+    }
+    return seed;
+}
+
+/*
+ * The start and end points of a linear pattern are ignored, because
+ * Theme::draw_box() always forces them relative to the box.
+ */
+static bool pattern_equal(const Pattern& lhs, const Pattern& rhs)
+{
+    if (lhs.type() != rhs.type())
+        return false;
+
+    if (lhs.type() == Pattern::Type::solid)
+        return lhs.solid() == rhs.solid();
+
+    const auto& a = lhs.steps();
+    const auto& b = rhs.steps();
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t x = 0; x < a.size(); ++x)
+    {
+        if (!detail::float_equal(a[x].first, b[x].first) ||
+            a[x].second != b[x].second)
+            return false;
+    }
+
+    return true;
+}
+
+static bool pattern_opaque(const Pattern& pattern)
+{
+    if (pattern.type() == Pattern::Type::solid)
+        return pattern.solid().alpha() == 255;
+
+    for (const auto& step : pattern.steps())
+        if (step.second.alpha() != 255)
+            return false;
+
+    return true;
+}
+
+size_t BoxCache::Key::hash() const
+{
+    size_t seed = theme;
+    hash_combine(seed, type);
+    hash_combine(seed, border_flags);
+    hash_combine(seed, size.width());
+    hash_combine(seed, size.height());
+    hash_combine(seed, border_width);
+    hash_combine(seed, margin_width);
+    hash_combine(seed, border_radius);
+    hash_combine(seed, antialias);
+    if (border)
+        hash_combine(seed, pattern_hash(*border));
+    hash_combine(seed, pattern_hash(*bg));
+    return seed;
+}
+
+bool BoxCache::Key::operator==(const Key& rhs) const
+{
+    if (theme != rhs.theme ||
+        type != rhs.type ||
+        border_flags != rhs.border_flags ||
+        size != rhs.size ||
+        border_width != rhs.border_width ||
+        margin_width != rhs.margin_width ||
+        !detail::float_equal(border_radius, rhs.border_radius) ||
+        antialias != rhs.antialias)
+        return false;
+
+    if ((border == nullptr) != (rhs.border == nullptr))
+        return false;
+
+    if (border && !pattern_equal(*border, *rhs.border))
+        return false;
+
+    return pattern_equal(*bg, *rhs.bg);
+}
+
+static inline bool box_cache_disabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_NO_BOX_CACHE"))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+BoxCache::BoxCache() noexcept
+    : m_enabled(!box_cache_disabled())
+{}
+
+bool BoxCache::draw(Painter& painter,
+                    const Theme& theme,
+                    const Theme::FillFlags& type,
+                    const Rect& rect,
+                    const Pattern& border,
+                    const Pattern& bg,
+                    DefaultDim border_width,
+                    DefaultDim margin_width,
+                    float border_radius,
+                    const Theme::BorderFlags& border_flags)
+{
+    if (!m_enabled || rect.empty())
+        return false;
+
+    auto cr = painter.context().get();
+
+    // a cached surface is only pixel exact under an integer translation
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (!detail::float_equal(matrix.xx, 1.0) ||
+        !detail::float_equal(matrix.yy, 1.0) ||
+        !detail::float_equal(matrix.xy, 0.0) ||
+        !detail::float_equal(matrix.yx, 0.0) ||
+        !detail::float_equal(matrix.x0, std::round(matrix.x0)) ||
+        !detail::float_equal(matrix.y0, std::round(matrix.y0)) ||
+        cairo_get_operator(cr) != CAIRO_OPERATOR_OVER)
+    {
+        m_stats.bypassed++;
+        return false;
+    }
+
+    // radial patterns, and border patterns, are positioned in absolute
+    // coordinates and cannot be moved around
+    const bool use_border = border_width != 0;
+    if (bg.type() == Pattern::Type::radial ||
+        (use_border && border.type() != Pattern::Type::solid))
+    {
+        m_stats.bypassed++;
+        return false;
+    }
+
+    // compositing with OVER is only the same as drawing with SOURCE when
+    // everything drawn is opaque
+    if (type.is_set(Theme::FillFlag::solid) &&
+        (!pattern_opaque(bg) || (use_border && !pattern_opaque(border))))
+    {
+        m_stats.bypassed++;
+        return false;
+    }
+
+    // distance from each edge of the box that is affected by the corners,
+    // with room for antialiasing
+    const auto corner = static_cast<DefaultDim>(std::ceil(margin_width +
+                        border_width * 2 + border_radius)) + 2;
+    const auto slice = corner * 2 + 1;
+
+    DefaultDim xslice = 0;
+    DefaultDim yslice = 0;
+    auto size = rect.size();
+    if (rect.width() * rect.height() > m_max_whole_area)
+    {
+        if (rect.width() > slice)
+        {
+            xslice = corner;
+            size.width(slice);
+        }
+
+        // vertical gradients have to be cached at full height
+        if (bg.type() == Pattern::Type::solid && rect.height() > slice)
+        {
+            yslice = corner;
+            size.height(slice);
+        }
+    }
+
+    Key key;
+    key.theme = typeid(theme).hash_code();
+    key.type = type.raw();
+    key.border_flags = border_flags.raw();
+    key.size = size;
+    key.border_width = border_width;
+    key.margin_width = margin_width;
+    key.border_radius = border_radius;
+    key.antialias = cairo_get_antialias(cr);
+    key.border = use_border ? &border : nullptr;
+    key.bg = &bg;
+
+    const auto hash = key.hash();
+    auto surface = find(key, hash);
+    if (surface)
+    {
+        m_stats.hits++;
+    }
+    else
+    {
+        m_stats.misses++;
+
+        surface = shared_cairo_surface_t(
+                      cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                              size.width(), size.height()),
+                      cairo_surface_destroy);
+
+        auto scr = shared_cairo_t(cairo_create(surface.get()), cairo_destroy);
+        cairo_set_antialias(scr.get(), cairo_get_antialias(cr));
+
+        Painter spainter(scr);
+        theme.paint_box(spainter, type, Rect(Point(), size), border, bg,
+                        border_width, margin_width, border_radius, border_flags);
+
+        cairo_surface_flush(surface.get());
+
+        insert(key, hash, surface);
+    }
+
+    composite(painter, surface.get(), rect, xslice, yslice);
+
+    return true;
+}
+
+void BoxCache::composite(Painter& painter, cairo_surface_t* surface,
+                         const Rect& rect, DefaultDim xslice, DefaultDim yslice)
+{
+    auto cr = painter.context().get();
+    const auto ssize = Painter::surface_to_size(surface);
+
+    // bands of the surface, and where they go in rect, along one axis
+    struct Band
+    {
+        DefaultDim src;
+        DefaultDim src_len;
+        DefaultDim dst;
+        DefaultDim dst_len;
+    };
+
+    const auto bands = [](DefaultDim slice, DefaultDim src_len,
+                          DefaultDim dst, DefaultDim dst_len,
+                          Band * out) -> size_t
+    {
+        if (!slice)
+        {
+            out[0] = {0, src_len, dst, dst_len};
+            return 1;
+        }
+
+        out[0] = {0, slice, dst, slice};
+        out[1] = {slice, 1, dst + slice, dst_len - slice * 2};
+        out[2] = {slice + 1, slice, dst + dst_len - slice, slice};
+        return 3;
+    };
+
+    Band xbands[3];
+    Band ybands[3];
+    const auto xcount = bands(xslice, ssize.width(), rect.x(), rect.width(), xbands);
+    const auto ycount = bands(yslice, ssize.height(), rect.y(), rect.height(), ybands);
+
+    unique_cairo_pattern_t pattern(cairo_pattern_create_for_surface(surface));
+    cairo_pattern_set_filter(pattern.get(), CAIRO_FILTER_NEAREST);
+    cairo_pattern_set_extend(pattern.get(), CAIRO_EXTEND_PAD);
+
+    Painter::AutoSaveRestore sr(painter);
+    cairo_new_path(cr);
+
+    for (size_t y = 0; y < ycount; ++y)
+    {
+        for (size_t x = 0; x < xcount; ++x)
+        {
+            const auto& xb = xbands[x];
+            const auto& yb = ybands[y];
+
+            if (xb.dst_len <= 0 || yb.dst_len <= 0)
+                continue;
+
+            // user space to pattern space, which stretches the single pixel
+            // edge bands with nearest filtering
+            const double sx = static_cast<double>(xb.src_len) / xb.dst_len;
+            const double sy = static_cast<double>(yb.src_len) / yb.dst_len;
+            cairo_matrix_t matrix;
+            cairo_matrix_init(&matrix, sx, 0, 0, sy,
+                              xb.src - xb.dst * sx,
+                              yb.src - yb.dst * sy);
+            cairo_pattern_set_matrix(pattern.get(), &matrix);
+
+            cairo_set_source(cr, pattern.get());
+            cairo_rectangle(cr, xb.dst, yb.dst, xb.dst_len, yb.dst_len);
+            cairo_fill(cr);
+        }
+    }
+}
+
+shared_cairo_surface_t BoxCache::find(const Key& key, size_t hash)
+{
+    const auto range = m_index.equal_range(hash);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (i->second->key == key)
+        {
+            // move to the front of the list as most recently used
+            m_entries.splice(m_entries.begin(), m_entries, i->second);
+            return i->second->surface;
+        }
+    }
+
+    return nullptr;
+}
+
+void BoxCache::insert(const Key& key, size_t hash, shared_cairo_surface_t surface)
+{
+    const auto bytes = static_cast<size_t>(cairo_image_surface_get_stride(surface.get())) *
+                       cairo_image_surface_get_height(surface.get());
+
+    // not worth evicting everything else for
+    if (bytes > m_max_bytes)
+        return;
+
+    m_entries.emplace_front();
+    auto& entry = m_entries.front();
+    entry.key = key;
+    entry.bg = *key.bg;
+    entry.key.bg = &entry.bg;
+    if (key.border)
+    {
+        entry.border = *key.border;
+        entry.key.border = &entry.border;
+    }
+    entry.surface = std::move(surface);
+    entry.bytes = bytes;
+
+    m_index.emplace(hash, m_entries.begin());
+    m_stats.bytes += bytes;
+    m_stats.entries++;
+
+    evict();
+}
+
+void BoxCache::evict()
+{
+    while (m_stats.bytes > m_max_bytes && !m_entries.empty())
+    {
+        auto last = std::prev(m_entries.end());
+
+        const auto range = m_index.equal_range(last->key.hash());
+        for (auto i = range.first; i != range.second; ++i)
+        {
+            if (i->second == last)
+            {
+                m_index.erase(i);
+                break;
+            }
+        }
+
+        m_stats.bytes -= last->bytes;
+        m_stats.entries--;
+        m_stats.evictions++;
+        m_entries.erase(last);
+    }
+}
+
+void BoxCache::clear()
+{
+    EGTLOG_DEBUG("box cache clear: {} entries {} bytes",
+                 m_stats.entries, m_stats.bytes);
+
+    m_index.clear();
+    m_entries.clear();
+    m_stats.entries = 0;
+    m_stats.bytes = 0;
+}
+
+void BoxCache::enable(bool enable)
+{
+    m_enabled = enable;
+    if (!m_enabled)
+        clear();
+}
+
+void BoxCache::max_bytes(size_t bytes)
+{
+    m_max_bytes = bytes;
+    evict();
+}
+
+BoxCache::Stats BoxCache::stats() const
+{
+    return m_stats;
+}
+
+void BoxCache::reset_stats()
+{
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.bypassed = 0;
+    m_stats.evictions = 0;
+}
+
+BoxCache& box_cache()
+{
+    static BoxCache cache;
+    return cache;
+}
+
+}
+}
+}
@@ -19,6 +19,7 @@
 #include "egt/video.h"
 #include <exception>
 #include <gst/gst.h>
+#include <utility>
 
 namespace egt
 {
@@ -174,12 +175,27 @@ gboolean CameraImpl::bus_callback(GstBus* bus, GstMessage* message, gpointer dat
 }
 
 /*
- * Its a Basic window: copying buffer to cairo surface.
+ * Its a Basic window: converting and scaling the buffer into the damaged part
+ * of the composition surface.
  */
 void CameraImpl::draw(Painter& painter, const Rect& rect)
 {
     ignoreparam(rect);
 
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_sample_mutex);
+        if (m_pending_sample)
+        {
+            if (m_camerasample)
+                gst_sample_unref(m_camerasample);
+            m_camerasample = m_pending_sample;
+            m_pending_sample = nullptr;
+        }
+        std::swap(dropped, m_dropped);
+    }
+    m_renderer.dropped(dropped);
+
     if (m_camerasample)
     {
         GstCaps* caps = gst_sample_get_caps(m_camerasample);
@@ -191,36 +207,22 @@ void CameraImpl::draw(Painter& painter, const Rect& rect)
 
         EGTLOG_TRACE("videowidth = {}  videoheight = {}", width, height);
 
-        gst_sample_ref(m_camerasample);
+        YuvRenderer::Format format;
+        if (!YuvRenderer::format(gst_structure_get_string(capsStruct, "format"), format))
+        {
+            EGTLOG_DEBUG("unsupported camera format");
+            return;
+        }
+
         GstBuffer* buffer = gst_sample_get_buffer(m_camerasample);
 
         GstMapInfo map;
         if (gst_buffer_map(buffer, &map, GST_MAP_READ))
         {
-            const auto box = m_interface.content_area();
-            const auto surface = unique_cairo_surface_t(
-                                     cairo_image_surface_create_for_data(map.data,
-                                             CAIRO_FORMAT_RGB16_565,
-                                             width,
-                                             height,
-                                             cairo_format_stride_for_width(CAIRO_FORMAT_RGB16_565, width)));
-
-            if (cairo_surface_status(surface.get()) == CAIRO_STATUS_SUCCESS)
-            {
-                auto cr = painter.context().get();
-                if (width != box.width() || height != box.height())
-                {
-                    double scalex = static_cast<double>(box.width()) / width;
-                    double scaley = static_cast<double>(box.height()) / height;
-                    cairo_scale(cr, scalex, scaley);
-                }
-                cairo_set_source_surface(cr, surface.get(), box.x(), box.y());
-                cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-                cairo_paint(cr);
-            }
+            m_renderer.draw(painter, m_interface.content_area(), format,
+                            Size(width, height), map.data, map.size);
             gst_buffer_unmap(buffer, &map);
         }
-        gst_sample_unref(m_camerasample);
     }
 }
 
@@ -258,14 +260,22 @@ GstFlowReturn CameraImpl::on_new_buffer(GstElement* elt, gpointer data)
         else
 #endif
         {
-            if (Application::check_instance())
             {
-                asio::post(Application::instance().event().io(), [impl, sample]()
+                std::lock_guard<std::mutex> lock(impl->m_sample_mutex);
+
+                // a sample that was not drawn before the next one is late
+                if (impl->m_pending_sample)
                 {
-                    if (impl->m_camerasample)
-                        gst_sample_unref(impl->m_camerasample);
+                    gst_sample_unref(impl->m_pending_sample);
+                    ++impl->m_dropped;
+                }
+                impl->m_pending_sample = sample;
+            }
 
-                    impl->m_camerasample = sample;
+            if (Application::check_instance())
+            {
+                Application::instance().event().call_async(impl, [impl]()
+                {
                     impl->m_interface.damage();
                 });
             }
@@ -330,13 +340,25 @@ bool CameraImpl::start()
     }
 
     std::string vscale;
-    if ((w != box.width()) || (h != box.height()))
+    std::string format;
+    if (m_interface.plane_window())
     {
-        vscale = fmt::format(" videoscale ! video/x-raw,width={},height={} !", box.width(), box.height());
-        EGTLOG_DEBUG("scaling video: {} to {} ", Size(w, h), box.size());
-    }
+        if ((w != box.width()) || (h != box.height()))
+        {
+            vscale = fmt::format(" videoscale ! video/x-raw,width={},height={} !", box.width(), box.height());
+            EGTLOG_DEBUG("scaling video: {} to {} ", Size(w, h), box.size());
+        }
 
-    const auto format = detail::gstreamer_format(m_interface.format());
+        format = detail::gstreamer_format(m_interface.format());
+    }
+    else
+    {
+        /*
+         * Converted and scaled in draw().  videoconvert passes buffers through
+         * when the camera already gives one of these formats.
+         */
+        format = YuvRenderer::caps_formats;
+    }
     EGTLOG_DEBUG("format: {}  ", format);
 
     static constexpr auto appsink_pipe =
@@ -368,6 +390,9 @@ bool CameraImpl::start()
 
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
     g_object_set(G_OBJECT(m_appsink), "emit-signals", TRUE, "sync", TRUE, nullptr);
+    // never queue frames
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    g_object_set(G_OBJECT(m_appsink), "max-buffers", 1, "drop", TRUE, nullptr);
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
     g_signal_connect(m_appsink, "new-sample", G_CALLBACK(on_new_buffer), this);
 
@@ -420,6 +445,18 @@ CameraImpl::~CameraImpl() noexcept
         m_gmain_thread.join();
         g_main_loop_unref(m_gmain_loop);
     }
+
+    // stop streaming before releasing the samples
+    stop();
+
+    // a damage posted by on_new_buffer() may not have run yet
+    if (Application::check_instance())
+        Application::instance().event().cancel_async(this);
+
+    if (m_pending_sample)
+        gst_sample_unref(m_pending_sample);
+    if (m_camerasample)
+        gst_sample_unref(m_camerasample);
 }
 
 std::tuple<std::string, std::string, std::string, std::vector<std::tuple<int, int>>>
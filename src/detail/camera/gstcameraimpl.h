@@ -6,8 +6,10 @@
 #ifndef EGT_SRC_DETAIL_CAMERA_GSTCAMERAIMPL_H
 #define EGT_SRC_DETAIL_CAMERA_GSTCAMERAIMPL_H
 
+#include "detail/video/yuvrenderer.h"
 #include "egt/camera.h"
 #include <gst/gst.h>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -45,7 +47,14 @@ protected:
     std::string m_devnode;
     GstElement* m_pipeline{nullptr};
     GstElement* m_appsink{nullptr};
+    /// Sample drawn.
     GstSample* m_camerasample{nullptr};
+    /// Latest sample not drawn yet, protected by m_sample_mutex.
+    GstSample* m_pending_sample{nullptr};
+    /// Samples replaced before they were drawn, protected by m_sample_mutex.
+    size_t m_dropped{0};
+    std::mutex m_sample_mutex;
+    YuvRenderer m_renderer;
     Rect m_rect;
     GMainLoop* m_gmain_loop{nullptr};
     std::thread m_gmain_thread;
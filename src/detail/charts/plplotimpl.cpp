@@ -65,6 +65,8 @@ inline bool change_if_diff(T1& first, T2& second, const T3& to)
 
 void PlPlotImpl::data(const ChartBase::DataArray& data)
 {
+    m_stream.reset();
+
     if (change_if_diff(m_xdata, m_ydata, data))
     {
         m_sdata.clear();
@@ -77,6 +79,8 @@ void PlPlotImpl::data(const ChartBase::DataArray& data)
 
 void PlPlotImpl::add_data(const ChartBase::DataArray& data)
 {
+    m_stream.reset();
+
     if (!data.empty())
     {
         /**
@@ -99,6 +103,8 @@ void PlPlotImpl::add_data(const ChartBase::DataArray& data)
 
 void PlPlotImpl::data(const ChartBase::StringDataArray& data)
 {
+    m_stream.reset();
+
     if (change_if_diff(m_ydata, m_sdata, data))
     {
         m_xdata.clear();
@@ -111,6 +117,9 @@ void PlPlotImpl::data(const ChartBase::StringDataArray& data)
 
 size_t PlPlotImpl::data_size() const
 {
+    if (m_stream)
+        return m_stream->size();
+
     if (!m_xdata.empty())
         return m_xdata.size();
 
@@ -122,6 +131,8 @@ size_t PlPlotImpl::data_size() const
 
 void PlPlotImpl::add_data(const ChartBase::StringDataArray& data)
 {
+    m_stream.reset();
+
     if (!data.empty())
     {
         /**
@@ -185,6 +196,12 @@ void PlPlotImpl::remove_data(uint32_t count)
 
 void PlPlotImpl::clear()
 {
+    if (m_stream && m_stream->size())
+    {
+        m_stream->clear();
+        invoke_damage();
+    }
+
     if (!m_ydata.empty() ||
         !m_xdata.empty() ||
         !m_sdata.empty())
@@ -196,6 +213,40 @@ void PlPlotImpl::clear()
     }
 }
 
+void PlPlotImpl::stream_capacity(size_t capacity)
+{
+    if (capacity == stream_capacity())
+        return;
+
+    if (capacity)
+    {
+        m_stream = std::make_unique<StreamBuffer>(capacity);
+        m_xdata.clear();
+        m_ydata.clear();
+        m_sdata.clear();
+    }
+    else
+    {
+        m_stream.reset();
+    }
+
+    invoke_damage();
+}
+
+size_t PlPlotImpl::stream_capacity() const
+{
+    return m_stream ? m_stream->capacity() : 0;
+}
+
+void PlPlotImpl::append(const double* samples, size_t count)
+{
+    if (!m_stream || !count)
+        return;
+
+    m_stream->append(samples, count);
+    invoke_stream_damage();
+}
+
 void PlPlotImpl::title(const std::string& title)
 {
     if (detail::change_if_diff<>(m_title, title))
@@ -271,6 +322,11 @@ void PlPlotImpl::plplot_verify_viewport()
         m_ymax = std::round(*std::max_element(m_ydata.begin(), m_ydata.end()));
     }
 
+    plplot_adjust_range();
+}
+
+void PlPlotImpl::plplot_adjust_range()
+{
     if (!detail::float_equal(m_bank, 0.0f))
     {
         auto xdiff = (m_xmax - m_xmin) * m_bank;
@@ -478,7 +534,8 @@ void PlPlotImpl::plplot_viewport(PLFLT size)
 PlPlotImpl::~PlPlotImpl() = default;
 
 PlPlotLineChart::PlPlotLineChart(LineChart& interface)
-    : m_interface(interface)
+    : m_strip(interface),
+      m_interface(interface)
 {
 }
 
@@ -489,6 +546,25 @@ void PlPlotLineChart::draw(Painter& painter, const Rect& rect)
     m_interface.draw_box(painter, Palette::ColorId::bg,
                          Palette::ColorId::border);
 
+    if (m_stream)
+    {
+        StripChart::Style style;
+        style.grid = m_grid;
+        style.grid_width = m_grid_width;
+        style.line_width = m_line_width;
+        style.pattern = m_pattern;
+        style.bank = m_bank;
+        style.xlabel = m_xlabel;
+        style.ylabel = m_ylabel;
+        style.title = m_title;
+        style.font = m_interface.font();
+        style.grid_color = m_interface.color(Palette::ColorId::button_bg).first();
+        style.line_color = m_interface.color(Palette::ColorId::button_fg).first();
+        style.text_color = m_interface.color(Palette::ColorId::label_text).first();
+        m_strip.draw(painter, *m_stream, style);
+        return;
+    }
+
     auto b = m_interface.content_area();
 
     if (!m_initalize)
@@ -6,6 +6,8 @@
 #ifndef EGT_SRC_DETAIL_CHARTS_PLPLOTIMPL_H
 #define EGT_SRC_DETAIL_CHARTS_PLPLOTIMPL_H
 
+#include "detail/charts/streambuffer.h"
+#include "detail/charts/stripchart.h"
 #include "egt/chart.h"
 #include "egt/painter.h"
 #include <memory>
@@ -52,6 +54,12 @@ public:
 
     void clear();
 
+    void stream_capacity(size_t capacity);
+
+    size_t stream_capacity() const;
+
+    void append(const double* samples, size_t count);
+
     void grid_style(ChartBase::GridFlag flag);
 
     void grid_width(int val);
@@ -105,10 +113,21 @@ protected:
     std::vector<PLFLT> m_ydata;
     std::vector<std::string> m_sdata;
 
+    /// Samples in streaming mode, or null.
+    std::unique_ptr<StreamBuffer> m_stream;
+
+    /// Damage the chart after samples were appended in streaming mode.
+    virtual void invoke_stream_damage()
+    {
+        invoke_damage();
+    }
+
     void plplot_color(const Color& color);
 
     void plplot_verify_viewport();
 
+    void plplot_adjust_range();
+
     void plplot_viewport(PLFLT size);
 
     void plplot_box(bool xtick_label, bool ytick_label);
@@ -131,6 +150,15 @@ public:
     }
 
 protected:
+
+    void invoke_stream_damage() override
+    {
+        m_strip.appended(*m_stream);
+    }
+
+    /// Streaming mode is drawn natively instead of with plplot.
+    StripChart m_strip;
+
     LineChart& m_interface;
 };
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/charts/streambuffer.h"
+#include <algorithm>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+StreamBuffer::StreamBuffer(size_t capacity)
+    : m_samples(std::max<size_t>(capacity, 1))
+{}
+
+void StreamBuffer::append(const double* samples, size_t count)
+{
+    const auto start = m_end;
+
+    // only the last capacity() samples can be kept
+    if (count > capacity())
+    {
+        m_end += count - capacity();
+        samples += count - capacity();
+        count = capacity();
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        m_samples[(m_end + i) % capacity()] = samples[i];
+    m_end += count;
+    m_size = std::min(m_size + count, capacity());
+
+    if (!m_per_column)
+        return;
+
+    // none of the old samples are left
+    if (start < begin())
+        m_column_count = 0;
+
+    // trimming first keeps the columns within the ring; it may already add
+    // some of the new samples to the oldest column, which does no harm
+    trim_front();
+
+    if (!m_column_count)
+        m_first_column = begin() / m_per_column;
+
+    for (auto index = std::max(start, begin()); index < m_end; ++index)
+        add_column_sample(index);
+}
+
+void StreamBuffer::add_column_sample(uint64_t index)
+{
+    const auto value = at(index);
+    const auto number = index / m_per_column;
+    if (number >= m_first_column + m_column_count)
+    {
+        m_columns[number % m_columns.size()] = {value, value};
+        ++m_column_count;
+    }
+    else
+    {
+        auto& c = m_columns[number % m_columns.size()];
+        c.min = std::min(c.min, value);
+        c.max = std::max(c.max, value);
+    }
+}
+
+void StreamBuffer::trim_front()
+{
+    while (m_column_count && (m_first_column + 1) * m_per_column <= begin())
+    {
+        --m_column_count;
+        ++m_first_column;
+    }
+
+    if (!m_column_count || m_first_column * m_per_column >= begin())
+        return;
+
+    // the oldest column lost some samples
+    const auto last = std::min<uint64_t>((m_first_column + 1) * m_per_column, m_end);
+    auto& c = m_columns[m_first_column % m_columns.size()];
+    c.min = c.max = at(begin());
+    for (auto index = begin() + 1; index < last; ++index)
+    {
+        c.min = std::min(c.min, at(index));
+        c.max = std::max(c.max, at(index));
+    }
+}
+
+void StreamBuffer::clear()
+{
+    m_size = 0;
+    m_column_count = 0;
+    m_first_column = m_per_column ? m_end / m_per_column : 0;
+}
+
+void StreamBuffer::decimate(size_t columns)
+{
+    // one column more than requested may be partially filled at each end
+    columns = std::max<size_t>(columns, 2) - 1;
+    const auto per_column = std::max<size_t>((capacity() + columns - 1) / columns, 1);
+    if (per_column == m_per_column)
+        return;
+
+    m_per_column = per_column;
+    // capacity() samples span at most one more column than they fill
+    m_columns.resize((capacity() + m_per_column - 1) / m_per_column + 1);
+    m_column_count = 0;
+    m_first_column = begin() / m_per_column;
+
+    for (auto index = begin(); index < m_end; ++index)
+        add_column_sample(index);
+}
+
+}
+}
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_CHARTS_STREAMBUFFER_H
+#define EGT_SRC_DETAIL_CHARTS_STREAMBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Fixed capacity ring buffer of samples, with cached min/max decimation.
+ *
+ * Samples are numbered by the order they were appended in.  Only the last
+ * capacity() samples are kept.
+ *
+ * For drawing, the samples are reduced to columns holding the minimum and
+ * maximum of a fixed number of consecutive samples.  Columns are aligned to
+ * sample numbers, so a column never changes once complete, and appending
+ * only computes the columns the new samples fall in.
+ *
+ * Samples and columns are both kept in rings allocated up front, so
+ * appending does not allocate.
+ */
+class StreamBuffer
+{
+public:
+
+    /// Minimum and maximum of the samples of a column.
+    struct Column
+    {
+        double min;
+        double max;
+    };
+
+    /**
+     * @param[in] capacity Maximum number of samples kept.
+     */
+    explicit StreamBuffer(size_t capacity);
+
+    /**
+     * Append samples, dropping the oldest ones beyond the capacity.
+     */
+    void append(const double* samples, size_t count);
+
+    /**
+     * Remove all samples.  Sample numbers keep counting.
+     */
+    void clear();
+
+    /// Number of samples kept.
+    size_t size() const { return m_size; }
+
+    /// Maximum number of samples kept.
+    size_t capacity() const { return m_samples.size(); }
+
+    /// Number of the next sample appended.
+    uint64_t end() const { return m_end; }
+
+    /// Number of the oldest sample kept.
+    uint64_t begin() const { return m_end - m_size; }
+
+    /// Get a sample by number, from begin() to end().
+    double at(uint64_t index) const { return m_samples[index % m_samples.size()]; }
+
+    /**
+     * Set the number of columns to reduce the samples to.
+     *
+     * A full buffer is reduced to at most this many columns.  The columns are
+     * only recomputed if this changes the number of samples per column.
+     */
+    void decimate(size_t columns);
+
+    /// Number of samples in each column, or 0 if not decimating.
+    size_t samples_per_column() const { return m_per_column; }
+
+    /// Number of the first column.  Column n starts at sample n * samples_per_column().
+    uint64_t first_column() const { return m_first_column; }
+
+    /// Number of columns.
+    size_t column_count() const { return m_column_count; }
+
+    /// Get a column by number, from first_column() to first_column() + column_count().
+    const Column& column(uint64_t number) const { return m_columns[number % m_columns.size()]; }
+
+private:
+
+    /// Drop columns of samples no longer kept, and recompute the oldest
+    /// column from the samples still kept.
+    void trim_front();
+
+    /// Add a sample, at the end of the last column or in a new one.
+    void add_column_sample(uint64_t index);
+
+    std::vector<double> m_samples;
+    size_t m_size{0};
+    uint64_t m_end{0};
+    size_t m_per_column{0};
+    /// Ring of columns, indexed by column number.
+    std::vector<Column> m_columns;
+    size_t m_column_count{0};
+    uint64_t m_first_column{0};
+};
+
+}
+}
+}
+
+#endif
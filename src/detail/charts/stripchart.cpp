@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/charts/stripchart.h"
+#include "egt/detail/math.h"
+#include "egt/widget.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Length of tick marks.
+static constexpr int TICK = 4;
+
+/// Space between tick marks, labels and the widget edges.
+static constexpr int SPACING = 4;
+
+/// Number of major ticks aimed for on each axis.
+static constexpr int TICKS = 5;
+
+/// Number of minor ticks per major tick.
+static constexpr int MINOR_TICKS = 5;
+
+/**
+ * Round a tick spacing up to 1, 2 or 5 times a power of 10.
+ */
+static double nice_step(double range, int ticks)
+{
+    const auto raw = range / ticks;
+    const auto magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    const auto residual = raw / magnitude;
+    if (residual > 5)
+        return 10 * magnitude;
+    if (residual > 2)
+        return 5 * magnitude;
+    if (residual > 1)
+        return 2 * magnitude;
+    return magnitude;
+}
+
+static std::string tick_label(double value, double step)
+{
+    // don't show rounding errors around zero
+    if (std::fabs(value) < step * 1e-9)
+        value = 0;
+
+    std::ostringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+static void set_color(cairo_t* cr, const Color& color, float alpha = 1.0f)
+{
+    cairo_set_source_rgba(cr, color.redf(), color.greenf(), color.bluef(),
+                          color.alphaf() * alpha);
+}
+
+bool StripChart::Style::operator==(const Style& rhs) const
+{
+    return grid == rhs.grid &&
+           grid_width == rhs.grid_width &&
+           line_width == rhs.line_width &&
+           pattern == rhs.pattern &&
+           detail::float_equal(bank, rhs.bank) &&
+           xlabel == rhs.xlabel &&
+           ylabel == rhs.ylabel &&
+           title == rhs.title &&
+           font == rhs.font &&
+           grid_color == rhs.grid_color &&
+           line_color == rhs.line_color &&
+           text_color == rhs.text_color;
+}
+
+bool StripChart::Range::operator==(const Range& rhs) const
+{
+    return detail::float_equal(min, rhs.min) &&
+           detail::float_equal(max, rhs.max) &&
+           detail::float_equal(step, rhs.step);
+}
+
+StripChart::StripChart(Widget& widget)
+    : m_widget(widget)
+{}
+
+StripChart::Range StripChart::range(const StreamBuffer& stream) const
+{
+    double lo = 0;
+    double hi = 1;
+
+    // the columns always cover all samples, so this does not depend on the
+    // number of columns
+    if (stream.column_count())
+    {
+        const auto first = stream.first_column();
+        lo = stream.column(first).min;
+        hi = stream.column(first).max;
+        for (auto column = first; column < first + stream.column_count(); ++column)
+        {
+            const auto& c = stream.column(column);
+            lo = std::min(lo, c.min);
+            hi = std::max(hi, c.max);
+        }
+    }
+
+    if (!detail::float_equal(m_style.bank, 0.0f))
+    {
+        const auto diff = (hi - lo) * m_style.bank;
+        lo -= diff;
+        hi += diff;
+    }
+
+    if (detail::float_equal(lo, hi))
+    {
+        auto diff = std::fabs(hi) * 0.1;
+        if (detail::float_equal(diff, 0.0))
+            diff = 1;
+        lo -= diff;
+        hi += diff;
+    }
+
+    // only move the range in whole ticks, so it rarely changes
+    Range result;
+    result.step = nice_step(hi - lo, TICKS);
+    result.min = std::floor(lo / result.step) * result.step;
+    result.max = std::ceil(hi / result.step) * result.step;
+    return result;
+}
+
+void StripChart::layout(const Size& size)
+{
+    m_size = size;
+
+    m_background.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                       size.width(), size.height()));
+    auto cr = shared_cairo_t(cairo_create(m_background.get()), cairo_destroy);
+    Painter painter(cr);
+    painter.set(m_style.font);
+
+    const auto font_height = static_cast<int>(std::ceil(m_style.font.size()));
+    const auto grid = static_cast<int>(m_style.grid);
+    const bool ticks = grid >= static_cast<int>(ChartBase::GridFlag::box_ticks);
+
+    int left = 1;
+    int right = 1;
+    int top = 1;
+    int bottom = 1;
+    if (ticks)
+    {
+        const auto min_width = painter.text_size(tick_label(m_range.min, m_range.step)).width();
+        const auto max_width = painter.text_size(tick_label(m_range.max, m_range.step)).width();
+        left = std::max(min_width, max_width) + TICK + SPACING * 2;
+        right = painter.text_size("0").width() / 2 + SPACING;
+        top = font_height / 2 + SPACING;
+        bottom = font_height + TICK + SPACING * 2;
+
+        if (!m_style.ylabel.empty())
+            left += font_height + SPACING;
+        if (!m_style.xlabel.empty())
+            bottom += font_height + SPACING;
+        if (!m_style.title.empty())
+            top += font_height + SPACING;
+    }
+
+    m_plot = Rect(left, top,
+                  std::max(size.width() - left - right, 0),
+                  std::max(size.height() - top - bottom, 0));
+
+    if (m_plot.empty())
+    {
+        m_front.reset();
+        m_back.reset();
+    }
+    else
+    {
+        m_front.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                      m_plot.width(), m_plot.height()));
+        m_back.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                     m_plot.width(), m_plot.height()));
+    }
+
+    m_background_valid = false;
+    m_plot_valid = false;
+}
+
+double StripChart::y(double value) const
+{
+    return (m_range.max - value) / (m_range.max - m_range.min) *
+           (m_plot.height() - 1) + 0.5;
+}
+
+void StripChart::draw_background(const StreamBuffer& stream)
+{
+    auto cr = shared_cairo_t(cairo_create(m_background.get()), cairo_destroy);
+    auto c = cr.get();
+    Painter painter(cr);
+    painter.set(m_style.font);
+
+    cairo_set_operator(c, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(c);
+    cairo_set_operator(c, CAIRO_OPERATOR_OVER);
+
+    m_background_valid = true;
+
+    const auto grid = static_cast<int>(m_style.grid);
+    if (grid < static_cast<int>(ChartBase::GridFlag::box) || m_plot.empty())
+        return;
+
+    cairo_set_line_width(c, m_style.grid_width);
+    set_color(c, m_style.grid_color);
+
+    // align to pixel centers
+    const auto left = m_plot.x() + 0.5;
+    const auto right = m_plot.x() + m_plot.width() - 0.5;
+    const auto top = m_plot.y() + 0.5;
+    const auto bottom = m_plot.y() + m_plot.height() - 0.5;
+
+    cairo_rectangle(c, left, top, right - left, bottom - top);
+    cairo_stroke(c);
+
+    if (grid < static_cast<int>(ChartBase::GridFlag::box_ticks))
+        return;
+
+    const auto ysteps = static_cast<int>(std::round((m_range.max - m_range.min) / m_range.step));
+    auto yvalue = [this](int i) { return m_range.min + i * m_range.step; };
+    auto ypos = [this](double value) { return m_plot.y() + std::round(y(value) - 0.5) + 0.5; };
+
+    // the x axis shows the age of samples, in samples
+    const auto per_column = std::max<size_t>(stream.samples_per_column(), 1);
+    const double span = static_cast<double>(m_plot.width() - 1) * per_column;
+    const auto xstep = span > 0 ? nice_step(span, TICKS) : 1.0;
+    const auto xsteps = static_cast<int>(std::floor(span / xstep));
+    auto xpos = [&](double age) { return std::round(right - age / per_column - 0.5) + 0.5; };
+
+    if (grid >= static_cast<int>(ChartBase::GridFlag::box_minor_ticks_coord))
+    {
+        set_color(c, m_style.grid_color, 0.5f);
+        for (int i = 0; i < ysteps * MINOR_TICKS; ++i)
+        {
+            const auto yp = ypos(m_range.min + i * m_range.step / MINOR_TICKS);
+            cairo_move_to(c, left, yp);
+            cairo_line_to(c, right, yp);
+        }
+        for (int i = 0; i <= xsteps * MINOR_TICKS; ++i)
+        {
+            const auto xp = xpos(i * xstep / MINOR_TICKS);
+            cairo_move_to(c, xp, top);
+            cairo_line_to(c, xp, bottom);
+        }
+        cairo_stroke(c);
+    }
+
+    set_color(c, m_style.grid_color);
+
+    if (grid >= static_cast<int>(ChartBase::GridFlag::box_major_ticks_coord))
+    {
+        for (int i = 1; i < ysteps; ++i)
+        {
+            cairo_move_to(c, left, ypos(yvalue(i)));
+            cairo_line_to(c, right, ypos(yvalue(i)));
+        }
+        for (int i = 1; i <= xsteps; ++i)
+        {
+            cairo_move_to(c, xpos(i * xstep), top);
+            cairo_line_to(c, xpos(i * xstep), bottom);
+        }
+        cairo_stroke(c);
+    }
+
+    if (grid >= static_cast<int>(ChartBase::GridFlag::box_ticks_coord) &&
+        m_range.min < 0 && m_range.max > 0)
+    {
+        cairo_move_to(c, left, ypos(0));
+        cairo_line_to(c, right, ypos(0));
+        cairo_stroke(c);
+    }
+
+    // ticks
+    for (int i = 0; i <= ysteps; ++i)
+    {
+        cairo_move_to(c, left, ypos(yvalue(i)));
+        cairo_line_to(c, left + TICK, ypos(yvalue(i)));
+        cairo_move_to(c, right, ypos(yvalue(i)));
+        cairo_line_to(c, right - TICK, ypos(yvalue(i)));
+    }
+    for (int i = 0; i <= xsteps; ++i)
+    {
+        cairo_move_to(c, xpos(i * xstep), bottom);
+        cairo_line_to(c, xpos(i * xstep), bottom - TICK);
+        cairo_move_to(c, xpos(i * xstep), top);
+        cairo_line_to(c, xpos(i * xstep), top + TICK);
+    }
+    cairo_stroke(c);
+
+    // tick labels
+    set_color(c, m_style.text_color);
+    for (int i = 0; i <= ysteps; ++i)
+    {
+        const auto text = tick_label(yvalue(i), m_range.step);
+        const auto size = painter.text_size(text);
+        cairo_move_to(c, m_plot.x() - SPACING - size.width(),
+                      ypos(yvalue(i)) - size.height() / 2.0);
+        painter.draw(text);
+    }
+    for (int i = 0; i <= xsteps; ++i)
+    {
+        const auto text = tick_label(-i * xstep, xstep);
+        const auto size = painter.text_size(text);
+        cairo_move_to(c, xpos(i * xstep) - size.width() / 2.0, bottom + TICK + SPACING);
+        painter.draw(text);
+    }
+
+    // labels
+    const auto font_height = std::ceil(m_style.font.size());
+    if (!m_style.xlabel.empty())
+    {
+        const auto size = painter.text_size(m_style.xlabel);
+        cairo_move_to(c, m_plot.center().x() - size.width() / 2.0,
+                      m_size.height() - SPACING - font_height);
+        painter.draw(m_style.xlabel);
+    }
+
+    if (!m_style.title.empty())
+    {
+        const auto size = painter.text_size(m_style.title);
+        cairo_move_to(c, m_plot.center().x() - size.width() / 2.0, SPACING);
+        painter.draw(m_style.title);
+    }
+
+    if (!m_style.ylabel.empty())
+    {
+        const auto size = painter.text_size(m_style.ylabel);
+        cairo_save(c);
+        cairo_translate(c, SPACING, m_plot.center().y() + size.width() / 2.0);
+        cairo_rotate(c, -detail::pi<double>() / 2);
+        cairo_move_to(c, 0, 0);
+        painter.draw(m_style.ylabel);
+        cairo_restore(c);
+    }
+}
+
+void StripChart::draw_line(cairo_t* cr, const StreamBuffer& stream, uint64_t from, double x)
+{
+    if (!stream.column_count())
+        return;
+
+    cairo_save(cr);
+
+    cairo_rectangle(cr, x, 0, m_plot.width() - x, m_plot.height());
+    cairo_clip(cr);
+
+    cairo_set_line_width(cr, m_style.line_width);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+    set_color(cr, m_style.line_color);
+
+    if (m_style.pattern == static_cast<int>(LineChart::LinePattern::dotted))
+    {
+        const double dashes[] = {1.0, 2.0 * m_style.line_width};
+        cairo_set_dash(cr, dashes, 2, 0);
+    }
+    else if (m_style.pattern == static_cast<int>(LineChart::LinePattern::dashes))
+    {
+        const double dashes[] = {4.0 * m_style.line_width, 2.0 * m_style.line_width};
+        cairo_set_dash(cr, dashes, 2, 0);
+    }
+
+    const auto first = stream.first_column();
+    const auto last = first + stream.column_count() - 1;
+    from = std::max(from, first);
+
+    for (auto column = from; column <= last; ++column)
+    {
+        const auto& c = stream.column(column);
+        const auto xp = m_plot.width() - 1 - static_cast<double>(last - column) + 0.5;
+
+        // alternate the direction of the vertical segment of each column, by
+        // column number so it does not change as the plot scrolls, so the
+        // line continues from where the previous column ended
+        const bool rising = column % 2 == 0;
+        if (column == from)
+            cairo_move_to(cr, xp, y(rising ? c.min : c.max));
+        else
+            cairo_line_to(cr, xp, y(rising ? c.min : c.max));
+        cairo_line_to(cr, xp, y(rising ? c.max : c.min));
+    }
+
+    cairo_stroke(cr);
+    cairo_restore(cr);
+}
+
+void StripChart::update_plot(StreamBuffer& stream)
+{
+    const auto per_column = stream.samples_per_column();
+    const bool empty = !stream.size();
+    const auto last = empty ? 0 : (stream.end() - 1) / per_column;
+
+    // the plot layer can be updated if it holds the samples before the new
+    // ones, with the same columns, and the line is solid; dashes would not
+    // line up, because their phase depends on where the line starts
+    const bool solid = m_style.pattern != static_cast<int>(LineChart::LinePattern::dotted) &&
+                       m_style.pattern != static_cast<int>(LineChart::LinePattern::dashes);
+    bool incremental = solid && m_plot_valid && m_drawn_size && !empty &&
+                       per_column == m_drawn_per_column &&
+                       stream.end() >= m_drawn_end &&
+                       stream.size() == std::min<uint64_t>(stream.capacity(),
+                               m_drawn_size + (stream.end() - m_drawn_end));
+
+    uint64_t drawn_last = 0;
+    if (incremental)
+    {
+        if (stream.end() == m_drawn_end)
+            return;
+
+        drawn_last = (m_drawn_end - 1) / per_column;
+        if (last - drawn_last >= static_cast<uint64_t>(m_plot.width()))
+            incremental = false;
+    }
+
+    if (incremental)
+    {
+        const auto shift = last - drawn_last;
+        if (shift)
+        {
+            auto cr = unique_cairo_t(cairo_create(m_back.get()));
+            cairo_set_operator(cr.get(), CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_surface(cr.get(), m_front.get(), -static_cast<double>(shift), 0);
+            cairo_paint(cr.get());
+            std::swap(m_front, m_back);
+        }
+
+        // the last column drawn may have been partial, so draw again from a
+        // little before it, far enough for the line width, and draw the line
+        // from further back so it is the same as it would be in one go
+        const auto margin = static_cast<uint64_t>(std::ceil(m_style.line_width)) + 2;
+        const auto x = std::max(0.0, std::floor(m_plot.width() - 1.0 -
+                                static_cast<double>(last - drawn_last) - margin));
+
+        auto cr = unique_cairo_t(cairo_create(m_front.get()));
+        cairo_set_operator(cr.get(), CAIRO_OPERATOR_CLEAR);
+        cairo_rectangle(cr.get(), x, 0, m_plot.width() - x, m_plot.height());
+        cairo_fill(cr.get());
+        cairo_set_operator(cr.get(), CAIRO_OPERATOR_OVER);
+
+        const auto from = drawn_last > margin * 2 + 1 ? drawn_last - margin * 2 - 1 : 0;
+        draw_line(cr.get(), stream, from, x);
+    }
+    else
+    {
+        auto cr = unique_cairo_t(cairo_create(m_front.get()));
+        cairo_set_operator(cr.get(), CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr.get());
+        cairo_set_operator(cr.get(), CAIRO_OPERATOR_OVER);
+
+        if (!empty)
+            draw_line(cr.get(), stream, 0, 0);
+    }
+
+    cairo_surface_flush(m_front.get());
+
+    m_plot_valid = true;
+    m_drawn_end = stream.end();
+    m_drawn_size = stream.size();
+    m_drawn_per_column = per_column;
+}
+
+void StripChart::appended(StreamBuffer& stream)
+{
+    if (!m_plot_valid || m_plot.empty())
+    {
+        m_widget.damage();
+        return;
+    }
+
+    stream.decimate(m_plot.width());
+
+    // new tick labels
+    if (range(stream) != m_range)
+    {
+        m_widget.damage();
+        return;
+    }
+
+    const auto area = m_widget.content_area();
+    m_widget.damage(Rect(area.point() + m_plot.point(), m_plot.size()));
+}
+
+void StripChart::draw(Painter& painter, StreamBuffer& stream, const Style& style)
+{
+    const auto area = m_widget.content_area();
+    if (area.empty())
+        return;
+
+    if (!stream.samples_per_column())
+        stream.decimate(m_plot.empty() ? area.width() : m_plot.width());
+
+    bool relayout = !m_background || area.size() != m_size;
+    if (style != m_style)
+    {
+        m_style = style;
+        relayout = true;
+    }
+
+    const auto r = range(stream);
+    if (r != m_range)
+    {
+        m_range = r;
+        relayout = true;
+    }
+
+    if (relayout)
+        layout(area.size());
+
+    if (m_plot.empty())
+        return;
+
+    stream.decimate(m_plot.width());
+
+    if (stream.samples_per_column() != m_drawn_per_column)
+        m_background_valid = false;
+
+    if (!m_background_valid)
+        draw_background(stream);
+
+    update_plot(stream);
+
+    auto cr = painter.context().get();
+    cairo_save(cr);
+    cairo_set_source_surface(cr, m_background.get(), area.x(), area.y());
+    cairo_paint(cr);
+    const auto plot = Rect(area.point() + m_plot.point(), m_plot.size());
+    cairo_set_source_surface(cr, m_front.get(), plot.x(), plot.y());
+    cairo_rectangle(cr, plot.x(), plot.y(), plot.width(), plot.height());
+    cairo_fill(cr);
+    cairo_restore(cr);
+}
+
+}
+}
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_CHARTS_STRIPCHART_H
+#define EGT_SRC_DETAIL_CHARTS_STRIPCHART_H
+
+#include "detail/charts/streambuffer.h"
+#include "egt/chart.h"
+#include "egt/color.h"
+#include "egt/detail/meta.h"
+#include "egt/font.h"
+#include "egt/geometry.h"
+#include "egt/painter.h"
+#include "egt/types.h"
+#include <string>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Native cairo renderer for a streaming line chart.
+ *
+ * The chart is drawn from two cached layers.  The background layer holds the
+ * grid, axes, tick labels and labels, and is only drawn again when the size,
+ * style or y range of the chart changes.  The plot layer holds the line.
+ *
+ * The x axis shows the age of samples, with the newest sample at the right
+ * edge of the plot, so it does not change as samples arrive.  When new
+ * columns arrive, the plot layer is scrolled left by the number of new
+ * columns and only the new columns are drawn, and only the plot area is
+ * damaged.
+ */
+class StripChart : private NonCopyable<StripChart>
+{
+public:
+
+    /// Everything the drawing depends on besides the samples.
+    struct Style
+    {
+        ChartBase::GridFlag grid{ChartBase::GridFlag::box_ticks};
+        int grid_width{1};
+        int line_width{2};
+        int pattern{1};
+        float bank{0};
+        std::string xlabel;
+        std::string ylabel;
+        std::string title;
+        Font font;
+        Color grid_color;
+        Color line_color;
+        Color text_color;
+
+        bool operator==(const Style& rhs) const;
+        bool operator!=(const Style& rhs) const { return !(*this == rhs); }
+    };
+
+    explicit StripChart(Widget& widget);
+
+    /**
+     * Damage what needs to be drawn after samples were appended.
+     *
+     * This is only the plot area, unless the y range changes.
+     */
+    void appended(StreamBuffer& stream);
+
+    /**
+     * Draw the chart in the content area of the widget.
+     */
+    void draw(Painter& painter, StreamBuffer& stream, const Style& style);
+
+private:
+
+    /// Range and tick spacing of the y axis.
+    struct Range
+    {
+        double min{0};
+        double max{0};
+        double step{0};
+
+        bool operator==(const Range& rhs) const;
+        bool operator!=(const Range& rhs) const { return !(*this == rhs); }
+    };
+
+    /// Compute the y range of the decimated samples.
+    Range range(const StreamBuffer& stream) const;
+
+    /// Compute the plot area inside the content area.
+    void layout(const Size& size);
+
+    void draw_background(const StreamBuffer& stream);
+
+    /// Draw the line from a column to the newest one, clipped to x and right.
+    void draw_line(cairo_t* cr, const StreamBuffer& stream, uint64_t from, double x);
+
+    void update_plot(StreamBuffer& stream);
+
+    /// Position of a value on the y axis of the plot layer.
+    double y(double value) const;
+
+    Widget& m_widget;
+    Style m_style;
+    Range m_range;
+    /// Size of the content area the layers were drawn for.
+    Size m_size;
+    /// Plot area, relative to the content area.
+    Rect m_plot;
+    bool m_background_valid{false};
+
+    unique_cairo_surface_t m_background;
+    unique_cairo_surface_t m_front;
+    /// Scratch surface scrolled into.
+    unique_cairo_surface_t m_back;
+
+    /// Set when the plot layer holds the samples up to m_drawn_end.
+    bool m_plot_valid{false};
+    uint64_t m_drawn_end{0};
+    size_t m_drawn_size{0};
+    size_t m_drawn_per_column{0};
+};
+
+}
+}
+}
+
+#endif
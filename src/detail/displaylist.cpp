@@ -0,0 +1,545 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "egt/detail/displaylist.h"
+#include "egt/detail/math.h"
+#include "egt/image.h"
+#include "egt/painter.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Source index of a state that uses the group popped by pop_group.
+static constexpr uint32_t group_source = UINT32_MAX;
+
+static bool matrix_equal(const cairo_matrix_t& lhs, const cairo_matrix_t& rhs)
+{
+    return detail::float_equal(lhs.xx, rhs.xx) &&
+           detail::float_equal(lhs.yx, rhs.yx) &&
+           detail::float_equal(lhs.xy, rhs.xy) &&
+           detail::float_equal(lhs.yy, rhs.yy) &&
+           detail::float_equal(lhs.x0, rhs.x0) &&
+           detail::float_equal(lhs.y0, rhs.y0);
+}
+
+static const cairo_user_data_key_t immutable_key{};
+
+void DisplayList::mark_immutable(cairo_surface_t* surface)
+{
+    // the key is the mark, so any non-null data will do
+    cairo_surface_set_user_data(surface, &immutable_key,
+                                const_cast<cairo_user_data_key_t*>(&immutable_key),
+                                nullptr);
+}
+
+bool DisplayList::immutable(const cairo_surface_t* surface)
+{
+    return cairo_surface_get_user_data(const_cast<cairo_surface_t*>(surface),
+                                       &immutable_key);
+}
+
+/*
+ * Compare what two cairo patterns draw, instead of their identity, because
+ * most patterns are created again every time something is drawn.
+ */
+static bool source_equal(cairo_pattern_t* lhs, cairo_pattern_t* rhs)
+{
+    const auto type = cairo_pattern_get_type(lhs);
+
+    // the same surface pattern still draws whatever its surface holds now
+    if (lhs == rhs && type != CAIRO_PATTERN_TYPE_SURFACE)
+        return true;
+
+    if (type != cairo_pattern_get_type(rhs))
+        return false;
+
+    cairo_matrix_t lmatrix;
+    cairo_matrix_t rmatrix;
+    cairo_pattern_get_matrix(lhs, &lmatrix);
+    cairo_pattern_get_matrix(rhs, &rmatrix);
+    if (!matrix_equal(lmatrix, rmatrix) ||
+        cairo_pattern_get_extend(lhs) != cairo_pattern_get_extend(rhs) ||
+        cairo_pattern_get_filter(lhs) != cairo_pattern_get_filter(rhs))
+        return false;
+
+    switch (type)
+    {
+    case CAIRO_PATTERN_TYPE_SOLID:
+    {
+        double l[4];
+        double r[4];
+        cairo_pattern_get_rgba(lhs, &l[0], &l[1], &l[2], &l[3]);
+        cairo_pattern_get_rgba(rhs, &r[0], &r[1], &r[2], &r[3]);
+        return std::equal(std::begin(l), std::end(l), std::begin(r));
+    }
+    case CAIRO_PATTERN_TYPE_SURFACE:
+    {
+        cairo_surface_t* l = nullptr;
+        cairo_surface_t* r = nullptr;
+        cairo_pattern_get_surface(lhs, &l);
+        cairo_pattern_get_surface(rhs, &r);
+        return l == r && DisplayList::immutable(l);
+    }
+    case CAIRO_PATTERN_TYPE_LINEAR:
+    case CAIRO_PATTERN_TYPE_RADIAL:
+    {
+        double l[6] = {};
+        double r[6] = {};
+        if (type == CAIRO_PATTERN_TYPE_LINEAR)
+        {
+            cairo_pattern_get_linear_points(lhs, &l[0], &l[1], &l[2], &l[3]);
+            cairo_pattern_get_linear_points(rhs, &r[0], &r[1], &r[2], &r[3]);
+        }
+        else
+        {
+            cairo_pattern_get_radial_circles(lhs, &l[0], &l[1], &l[2], &l[3], &l[4], &l[5]);
+            cairo_pattern_get_radial_circles(rhs, &r[0], &r[1], &r[2], &r[3], &r[4], &r[5]);
+        }
+
+        if (!std::equal(std::begin(l), std::end(l), std::begin(r)))
+            return false;
+
+        int lcount = 0;
+        int rcount = 0;
+        cairo_pattern_get_color_stop_count(lhs, &lcount);
+        cairo_pattern_get_color_stop_count(rhs, &rcount);
+        if (lcount != rcount)
+            return false;
+
+        for (auto i = 0; i < lcount; ++i)
+        {
+            double ls[5];
+            double rs[5];
+            cairo_pattern_get_color_stop_rgba(lhs, i, &ls[0], &ls[1], &ls[2], &ls[3], &ls[4]);
+            cairo_pattern_get_color_stop_rgba(rhs, i, &rs[0], &rs[1], &rs[2], &rs[3], &rs[4]);
+            if (!std::equal(std::begin(ls), std::end(ls), std::begin(rs)))
+                return false;
+        }
+
+        return true;
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+bool DisplayList::State::operator==(const State& rhs) const
+{
+    return matrix_equal(matrix, rhs.matrix) &&
+           op == rhs.op &&
+           antialias == rhs.antialias &&
+           fill_rule == rhs.fill_rule &&
+           line_cap == rhs.line_cap &&
+           line_join == rhs.line_join &&
+           detail::float_equal(line_width, rhs.line_width) &&
+           source == rhs.source;
+}
+
+bool DisplayList::Box::operator==(const Box& rhs) const
+{
+    return theme == rhs.theme &&
+           type == rhs.type &&
+           rect == rhs.rect &&
+           source_equal(border.pattern(), rhs.border.pattern()) &&
+           source_equal(bg.pattern(), rhs.bg.pattern()) &&
+           border_width == rhs.border_width &&
+           margin_width == rhs.margin_width &&
+           detail::float_equal(border_radius, rhs.border_radius) &&
+           border_flags == rhs.border_flags;
+}
+
+void DisplayList::clear()
+{
+    m_commands.clear();
+    m_states.clear();
+    m_sources.clear();
+    m_values.clear();
+    m_strings.clear();
+    m_surfaces.clear();
+    m_fonts.clear();
+    m_boxes.clear();
+    m_group = nullptr;
+}
+
+uint32_t DisplayList::capture(cairo_t* cr)
+{
+    State state{};
+    cairo_get_matrix(cr, &state.matrix);
+    state.op = cairo_get_operator(cr);
+    state.antialias = cairo_get_antialias(cr);
+    state.fill_rule = cairo_get_fill_rule(cr);
+    state.line_cap = cairo_get_line_cap(cr);
+    state.line_join = cairo_get_line_join(cr);
+    state.line_width = cairo_get_line_width(cr);
+
+    auto source = cairo_get_source(cr);
+    if (source == m_group)
+    {
+        state.source = group_source;
+    }
+    else if (!m_sources.empty() && source_equal(m_sources.back().get(), source))
+    {
+        // once replaced, the group cannot be the source again
+        m_group = nullptr;
+        state.source = m_sources.size() - 1;
+    }
+    else
+    {
+        m_group = nullptr;
+        state.source = m_sources.size();
+        m_sources.emplace_back(cairo_pattern_reference(source), cairo_pattern_destroy);
+    }
+
+    if (!m_states.empty() && m_states.back() == state)
+        return m_states.size() - 1;
+
+    m_states.push_back(state);
+    return m_states.size() - 1;
+}
+
+void DisplayList::add(Type type, uint32_t state, size_t begin, size_t end)
+{
+    m_commands.push_back({type, state, static_cast<uint32_t>(begin),
+                          static_cast<uint32_t>(end)});
+}
+
+void DisplayList::state(cairo_t* cr, Type type)
+{
+    // the popped group is only available as the current source
+    if (type == Type::pop_group)
+        m_group = cairo_get_source(cr);
+
+    add(type, 0, m_values.size(), m_values.size());
+}
+
+void DisplayList::path(cairo_t* cr, Type type)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+
+    std::unique_ptr<cairo_path_t, decltype(&cairo_path_destroy)>
+    path(cairo_copy_path(cr), cairo_path_destroy);
+
+    if (path->status == CAIRO_STATUS_SUCCESS)
+    {
+        for (auto i = 0; i < path->num_data; i += path->data[i].header.length)
+        {
+            const auto& data = path->data[i];
+            m_values.push_back(data.header.type);
+            for (auto p = 1; p < data.header.length; ++p)
+            {
+                m_values.push_back(path->data[i + p].point.x);
+                m_values.push_back(path->data[i + p].point.y);
+            }
+        }
+    }
+
+    add(type, state, begin, m_values.size());
+}
+
+void DisplayList::paint(cairo_t* cr, float alpha)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(alpha);
+    add(Type::paint, state, begin, m_values.size());
+}
+
+void DisplayList::mask(cairo_t* cr, const shared_cairo_surface_t& surface, const Point& point)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(m_surfaces.size());
+    m_values.push_back(point.x());
+    m_values.push_back(point.y());
+    m_surfaces.push_back(surface);
+    add(Type::mask, state, begin, m_values.size());
+}
+
+void DisplayList::image(cairo_t* cr, const shared_cairo_surface_t& surface,
+                        const Rect& rect, const PointF& point, bool rect_only)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(m_surfaces.size());
+    m_values.push_back(rect.x());
+    m_values.push_back(rect.y());
+    m_values.push_back(rect.width());
+    m_values.push_back(rect.height());
+    m_values.push_back(point.x());
+    m_values.push_back(point.y());
+    m_values.push_back(rect_only);
+    m_surfaces.push_back(surface);
+    add(Type::image, state, begin, m_values.size());
+}
+
+void DisplayList::fill(cairo_t* cr, const Rect& rect, const Color& color)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(rect.x());
+    m_values.push_back(rect.y());
+    m_values.push_back(rect.width());
+    m_values.push_back(rect.height());
+    m_values.push_back(color.pixel32());
+    add(Type::fill_rect, state, begin, m_values.size());
+}
+
+void DisplayList::text(cairo_t* cr, const std::string& str, uint32_t flags)
+{
+    double x = 0;
+    double y = 0;
+    cairo_get_current_point(cr, &x, &y);
+
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(m_strings.size());
+    m_values.push_back(m_fonts.size());
+    m_values.push_back(x);
+    m_values.push_back(y);
+    m_values.push_back(flags);
+    m_strings.push_back(str);
+    m_fonts.emplace_back(cairo_scaled_font_reference(cairo_get_scaled_font(cr)),
+                         cairo_scaled_font_destroy);
+    add(Type::text, state, begin, m_values.size());
+}
+
+void DisplayList::flood(const Point& point, const Color& color, uint32_t tolerance)
+{
+    const auto begin = m_values.size();
+    m_values.push_back(point.x());
+    m_values.push_back(point.y());
+    m_values.push_back(color.pixel32());
+    m_values.push_back(tolerance);
+    add(Type::flood, 0, begin, m_values.size());
+}
+
+void DisplayList::pixel(const Point& point, const Color& color)
+{
+    const auto begin = m_values.size();
+    m_values.push_back(point.x());
+    m_values.push_back(point.y());
+    m_values.push_back(color.pixel32());
+    add(Type::pixel, 0, begin, m_values.size());
+}
+
+void DisplayList::box(cairo_t* cr,
+                      const Theme& theme,
+                      const Theme::FillFlags& type,
+                      const Rect& rect,
+                      const Pattern& border,
+                      const Pattern& bg,
+                      DefaultDim border_width,
+                      DefaultDim margin_width,
+                      float border_radius,
+                      const Theme::BorderFlags& border_flags)
+{
+    const auto state = capture(cr);
+    const auto begin = m_values.size();
+    m_values.push_back(m_boxes.size());
+    m_boxes.push_back({&theme, type, rect, border, bg, border_width,
+                       margin_width, border_radius, border_flags});
+    add(Type::box, state, begin, m_values.size());
+}
+
+bool DisplayList::operator==(const DisplayList& rhs) const
+{
+    // arguments are stored in the order they are recorded, so equal lists have
+    // equal arrays
+    if (m_commands != rhs.m_commands ||
+        m_states != rhs.m_states ||
+        m_values != rhs.m_values ||
+        m_strings != rhs.m_strings ||
+        m_surfaces != rhs.m_surfaces ||
+        m_boxes != rhs.m_boxes ||
+        m_sources.size() != rhs.m_sources.size() ||
+        m_fonts.size() != rhs.m_fonts.size())
+        return false;
+
+    for (const auto& surface : m_surfaces)
+        if (!immutable(surface.get()))
+            return false;
+
+    for (size_t i = 0; i < m_sources.size(); ++i)
+        if (!source_equal(m_sources[i].get(), rhs.m_sources[i].get()))
+            return false;
+
+    for (size_t i = 0; i < m_fonts.size(); ++i)
+        if (m_fonts[i] != rhs.m_fonts[i])
+            return false;
+
+    return true;
+}
+
+void DisplayList::apply(cairo_t* cr, const cairo_matrix_t& base, uint32_t state) const
+{
+    const auto& s = m_states[state];
+
+    cairo_matrix_t matrix;
+    cairo_matrix_multiply(&matrix, &s.matrix, &base);
+    cairo_set_matrix(cr, &matrix);
+    cairo_set_operator(cr, s.op);
+    cairo_set_antialias(cr, s.antialias);
+    cairo_set_fill_rule(cr, s.fill_rule);
+    cairo_set_line_cap(cr, s.line_cap);
+    cairo_set_line_join(cr, s.line_join);
+    cairo_set_line_width(cr, s.line_width);
+    if (s.source != group_source)
+        cairo_set_source(cr, m_sources[s.source].get());
+}
+
+void DisplayList::replay(Painter& painter) const
+{
+    auto cr = painter.context().get();
+
+    Painter::AutoSaveRestore sr(painter);
+
+    cairo_matrix_t base;
+    cairo_get_matrix(cr, &base);
+
+    const auto index = [](double value)
+    {
+        return static_cast<size_t>(value);
+    };
+
+    const auto dim = [](double value)
+    {
+        return static_cast<DefaultDim>(value);
+    };
+
+    for (const auto& command : m_commands)
+    {
+        const auto v = m_values.data() + command.begin;
+
+        switch (command.type)
+        {
+        case Type::save:
+            painter.save();
+            break;
+        case Type::restore:
+            painter.restore();
+            break;
+        case Type::push_group:
+            painter.push_group();
+            break;
+        case Type::pop_group:
+            painter.pop_group();
+            break;
+        case Type::fill:
+        case Type::stroke:
+        case Type::clip:
+        {
+            apply(cr, base, command.state);
+            cairo_new_path(cr);
+            for (auto i = command.begin; i < command.end;)
+            {
+                const auto type = static_cast<cairo_path_data_type_t>(m_values[i++]);
+                const auto p = m_values.data() + i;
+                switch (type)
+                {
+                case CAIRO_PATH_MOVE_TO:
+                    cairo_move_to(cr, p[0], p[1]);
+                    i += 2;
+                    break;
+                case CAIRO_PATH_LINE_TO:
+                    cairo_line_to(cr, p[0], p[1]);
+                    i += 2;
+                    break;
+                case CAIRO_PATH_CURVE_TO:
+                    cairo_curve_to(cr, p[0], p[1], p[2], p[3], p[4], p[5]);
+                    i += 6;
+                    break;
+                case CAIRO_PATH_CLOSE_PATH:
+                    cairo_close_path(cr);
+                    break;
+                }
+            }
+
+            if (command.type == Type::fill)
+                cairo_fill(cr);
+            else if (command.type == Type::stroke)
+                cairo_stroke(cr);
+            else
+                cairo_clip(cr);
+            break;
+        }
+        case Type::paint:
+            apply(cr, base, command.state);
+            if (v[0] >= 1.0)
+                cairo_paint(cr);
+            else
+                cairo_paint_with_alpha(cr, v[0]);
+            break;
+        case Type::mask:
+            apply(cr, base, command.state);
+            cairo_mask_surface(cr, m_surfaces[index(v[0])].get(), v[1], v[2]);
+            break;
+        case Type::image:
+        {
+            apply(cr, base, command.state);
+            const Image image(m_surfaces[index(v[0])]);
+            cairo_new_path(cr);
+            cairo_move_to(cr, v[5], v[6]);
+            if (!detail::float_equal(v[7], 0.0))
+                painter.draw(Rect(dim(v[1]), dim(v[2]), dim(v[3]), dim(v[4])), image);
+            else
+                painter.draw(image);
+            break;
+        }
+        case Type::fill_rect:
+            apply(cr, base, command.state);
+            painter.fill(Rect(dim(v[0]), dim(v[1]), dim(v[2]), dim(v[3])),
+                         Color::pixel32(static_cast<uint32_t>(v[4])));
+            break;
+        case Type::text:
+        {
+            apply(cr, base, command.state);
+            cairo_set_scaled_font(cr, m_fonts[index(v[1])].get());
+            cairo_new_path(cr);
+            cairo_move_to(cr, v[2], v[3]);
+            Painter::TextDrawFlags flags;
+            flags.raw() = static_cast<uint32_t>(v[4]);
+            painter.draw(m_strings[index(v[0])], flags);
+            break;
+        }
+        case Type::flood:
+        case Type::pixel:
+        {
+            // recorded as given to the painter, which flood and pixel do not
+            // transform, so only the translation of the replaying painter
+            // moves them
+            const Point point(dim(v[0] + base.x0), dim(v[1] + base.y0));
+            const auto color = Color::pixel32(static_cast<uint32_t>(v[2]));
+            if (command.type == Type::flood)
+                painter.flood(point, color, static_cast<uint32_t>(v[3]));
+            else
+                painter.color_at(point, color);
+            break;
+        }
+        case Type::box:
+        {
+            apply(cr, base, command.state);
+            const auto& b = m_boxes[index(v[0])];
+            b.theme->draw_box(painter, b.type, b.rect, b.border, b.bg,
+                              b.border_width, b.margin_width, b.border_radius,
+                              b.border_flags);
+            break;
+        }
+        }
+    }
+}
+
+}
+}
+}
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <egt/types.h>
 #include <fstream>
+#include <istream>
 #include <string>
 
 extern "C" {
@@ -88,54 +89,91 @@ public:
         return 0x50502AA2;
     }
 
-    static shared_cairo_surface_t load(const std::string& filename)
+    /**
+     * Read the header of an image from a stream.
+     *
+     * @param[in] i The stream.
+     * @param[out] width Width of the image.
+     * @param[out] height Height of the image.
+     * @param[out] delay First reserved word, used as the frame delay in
+     *             milliseconds by a sequence of images.
+     */
+    static bool read_header(std::istream& i, uint32_t& width, uint32_t& height,
+                            uint32_t& delay)
     {
-        std::ifstream i(filename, std::ios_base::binary);
-        if (!i)
-            return nullptr;
         alignas(4) uint32_t magic = 0;
-        alignas(4) uint32_t width = 0;
-        alignas(4) uint32_t height = 0;
         alignas(4) uint32_t reserved = 0;
-        i.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        if (!i.read(reinterpret_cast<char*>(&magic), sizeof(magic)))
+            return false;
         if (magic != egt_magic())
-            return nullptr;
+            return false;
         if (!i.read(reinterpret_cast<char*>(&width), sizeof(width)) ||
             !i.read(reinterpret_cast<char*>(&height), sizeof(height)) ||
-            !i.read(reinterpret_cast<char*>(&reserved), sizeof(reserved)) ||
+            !i.read(reinterpret_cast<char*>(&delay), sizeof(delay)) ||
             !i.read(reinterpret_cast<char*>(&reserved), sizeof(reserved)) ||
             !i.read(reinterpret_cast<char*>(&reserved), sizeof(reserved)) ||
             !i.read(reinterpret_cast<char*>(&reserved), sizeof(reserved)))
-            return nullptr;
-
-        auto surface =
-            shared_cairo_surface_t(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
-                                   width, height),
-                                   cairo_surface_destroy);
-        auto data =
-            reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(surface.get()));
-        auto end = data + (width * height);
+            return false;
+        return true;
+    }
 
+    /**
+     * Read the pixels of an image from a stream, after its header.
+     *
+     * @param[in] i The stream.
+     * @param[out] data Pixels, with no padding between rows.
+     * @param[in] count Number of pixels.
+     */
+    static bool read_pixels(std::istream& i, uint32_t* data, size_t count)
+    {
+        const auto end = data + count;
         while (data < end)
         {
             alignas(4) uint16_t block = 0;
             if (!i.read(reinterpret_cast<char*>(&block), sizeof(block)))
-                return nullptr;
+                return false;
             if (block & 0x8000)
             {
                 block &= 0x7fff;
+                if (block > end - data)
+                    return false;
                 alignas(4) uint32_t value = 0;
                 if (!i.read(reinterpret_cast<char*>(&value), sizeof(value)))
-                    return nullptr;
+                    return false;
                 memset32(data, value, block);
             }
             else if (block)
             {
+                if (block > end - data)
+                    return false;
                 if (!i.read(reinterpret_cast<char*>(data), block * sizeof(uint32_t)))
-                    return nullptr;
+                    return false;
             }
             data += block;
         }
+        return true;
+    }
+
+    static shared_cairo_surface_t load(const std::string& filename)
+    {
+        std::ifstream i(filename, std::ios_base::binary);
+        if (!i)
+            return nullptr;
+        alignas(4) uint32_t width = 0;
+        alignas(4) uint32_t height = 0;
+        alignas(4) uint32_t delay = 0;
+        if (!read_header(i, width, height, delay))
+            return nullptr;
+
+        auto surface =
+            shared_cairo_surface_t(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                   width, height),
+                                   cairo_surface_destroy);
+        auto data =
+            reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(surface.get()));
+
+        if (!read_pixels(i, data, width * height))
+            return nullptr;
 
         i.close();
 
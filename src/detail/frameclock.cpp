@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/frameclock.h"
+#include <algorithm>
+#include <map>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+std::shared_ptr<FrameClock> FrameClock::get(unsigned fps)
+{
+    static std::map<unsigned, std::weak_ptr<FrameClock>> clocks;
+
+    fps = std::max(fps, 1u);
+
+    auto& weak = clocks[fps];
+    auto clock = weak.lock();
+    if (!clock)
+    {
+        clock = std::make_shared<FrameClock>(fps);
+        weak = clock;
+    }
+
+    return clock;
+}
+
+FrameClock::FrameClock(unsigned fps)
+    : m_fps(std::max(fps, 1u)),
+      m_timer(std::chrono::milliseconds(std::max(1000u / m_fps, 1u)))
+{
+    m_timer.name("FrameClock" + std::to_string(m_fps));
+    m_timer.on_timeout([this]() { tick(); });
+}
+
+FrameClock::Handle FrameClock::add(Callback callback)
+{
+    // 0 marks removed subscribers
+    if (!++m_next_handle)
+        ++m_next_handle;
+    const auto handle = m_next_handle;
+
+    // the subscribers must not move while they are being called
+    if (m_ticking)
+        m_added.emplace_back(handle, std::move(callback));
+    else
+        m_subscribers.emplace_back(handle, std::move(callback));
+
+    if (!m_timer.running())
+        m_timer.start();
+
+    return handle;
+}
+
+void FrameClock::remove(Handle handle)
+{
+    auto match = [handle](const std::pair<Handle, Callback>& s)
+    {
+        return s.first == handle;
+    };
+
+    auto added = std::find_if(m_added.begin(), m_added.end(), match);
+    if (added != m_added.end())
+    {
+        m_added.erase(added);
+        return;
+    }
+
+    auto i = std::find_if(m_subscribers.begin(), m_subscribers.end(), match);
+    if (i == m_subscribers.end())
+        return;
+
+    // erased after the tick, so the loop in tick() stays valid
+    if (m_ticking)
+        i->first = 0;
+    else
+        m_subscribers.erase(i);
+
+    if (!m_ticking && m_subscribers.empty())
+        m_timer.cancel();
+}
+
+void FrameClock::tick()
+{
+    m_ticking = true;
+
+    for (auto& subscriber : m_subscribers)
+    {
+        if (subscriber.first)
+            subscriber.second();
+    }
+
+    m_ticking = false;
+
+    m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                       [](const std::pair<Handle, Callback>& s)
+    {
+        return !s.first;
+    }), m_subscribers.end());
+
+    // subscribers added while ticking wait for the next frame
+    for (auto& subscriber : m_added)
+        m_subscribers.emplace_back(std::move(subscriber));
+    m_added.clear();
+
+    if (m_subscribers.empty())
+        m_timer.cancel();
+}
+
+}
+}
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_FRAMECLOCK_H
+#define EGT_SRC_DETAIL_FRAMECLOCK_H
+
+#include "egt/detail/inplacefunction.h"
+#include "egt/detail/meta.h"
+#include "egt/timer.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Timer shared by everything animating at the same frame rate.
+ *
+ * Instead of each animation running its own timer, animations subscribe to
+ * the clock for their frame rate, and all of them are advanced from the one
+ * timer of that clock.  The timer only runs while there are subscribers.
+ */
+class FrameClock : private NonCopyable<FrameClock>
+{
+public:
+
+    /// Subscriber callback, called once per frame.
+    using Callback = InplaceFunction<void()>;
+
+    /// Handle to remove a subscriber.
+    using Handle = uint32_t;
+
+    /**
+     * Get the clock for a frame rate.
+     *
+     * The clock lives as long as something holds the returned pointer.  The
+     * last pointer must not be released from a subscriber callback.
+     *
+     * @param[in] fps Frames per second, at least 1.
+     */
+    static std::shared_ptr<FrameClock> get(unsigned fps);
+
+    /// @private use get()
+    explicit FrameClock(unsigned fps);
+
+    /**
+     * Add a subscriber, starting the clock if needed.
+     */
+    Handle add(Callback callback);
+
+    /**
+     * Remove a subscriber, stopping the clock if it was the last one.
+     *
+     * This may be called from a subscriber callback.
+     */
+    void remove(Handle handle);
+
+    /// Frames per second.
+    EGT_NODISCARD unsigned fps() const { return m_fps; }
+
+private:
+
+    void tick();
+
+    unsigned m_fps;
+    PeriodicTimer m_timer;
+    Handle m_next_handle{0};
+    std::vector<std::pair<Handle, Callback>> m_subscribers;
+    /// Subscribers added while ticking.
+    std::vector<std::pair<Handle, Callback>> m_added;
+    /// Set while calling subscribers.
+    bool m_ticking{false};
+};
+
+}
+}
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "detail/dump.h"
 #include "detail/egtlog.h"
+#include "egt/detail/displaylist.h"
 #include "egt/detail/image.h"
 #include "egt/detail/imagecache.h"
 #include "egt/detail/math.h"
@@ -100,6 +101,9 @@ shared_cairo_surface_t ImageCache::get(const std::string& uri,
                                      "cairo: {}: {}", cairo_status_to_string(cairo_surface_status(image.get())), uri));
     }
 
+    // cached images are shared, so they must never be drawn into
+    DisplayList::mark_immutable(image.get());
+
     m_cache.insert(std::make_pair(nameid, image));
 
     return image;
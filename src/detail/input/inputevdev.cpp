@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "detail/trace.h"
 #include "detail/input/inputkeyboard.h"
+#include "detail/input/timestamp.h"
+#include "detail/priorityqueue.h"
 #include "egt/app.h"
 #include "egt/detail/input/inputevdev.h"
 #include "egt/geometry.h"
@@ -16,7 +19,9 @@
 #include <cstdlib>
 #include <fcntl.h>
 #include <linux/input.h>
+#include <ctime>
 #include <string>
+#include <sys/ioctl.h>
 #include <sys/time.h>
 #include <unistd.h>
 
@@ -28,7 +33,7 @@ namespace detail
 {
 
 InputEvDev::InputEvDev(Application& app, const std::string& path)
-    : m_input(app.event().io()),
+    : m_input(app.event().input_io()),
       m_input_buf(sizeof(struct input_event) * 10),
       m_keyboard(std::make_unique<InputKeyboard>())
 {
@@ -37,13 +42,18 @@ InputEvDev::InputEvDev(Application& app, const std::string& path)
     {
         detail::info("input device: {}", path);
 
+        // report event times on the same clock as std::chrono::steady_clock
+        int clock = CLOCK_MONOTONIC;
+        m_monotonic = ioctl(m_fd, EVIOCSCLOCKID, &clock) == 0;
+
         m_input.assign(m_fd);
 
         asio::async_read(m_input, asio::buffer(m_input_buf.data(), m_input_buf.size()),
                          egt::asio::transfer_at_least(sizeof(struct input_event)),
-                         std::bind(&InputEvDev::handle_read, this,
-                                   std::placeholders::_1,
-                                   std::placeholders::_2));
+                         app.event().queue().wrap(detail::priorities::input,
+                                 std::bind(&InputEvDev::handle_read, this,
+                                           std::placeholders::_1,
+                                           std::placeholders::_2)));
     }
     else
     {
@@ -51,6 +61,18 @@ InputEvDev::InputEvDev(Application& app, const std::string& path)
     }
 }
 
+static inline struct timeval event_time(const struct input_event& e)
+{
+#ifdef input_event_sec
+    struct timeval tv {};
+    tv.tv_sec = e.input_event_sec;
+    tv.tv_usec = e.input_event_usec;
+    return tv;
+#else
+    return e.time;
+#endif
+}
+
 void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
 {
     if (error)
@@ -59,6 +81,8 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
         return;
     }
 
+    EGT_TRACE_SCOPE("input read");
+
     const auto ev = reinterpret_cast<struct input_event*>(m_input_buf.data());
     const struct input_event* e;
 
@@ -67,6 +91,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
     int x = 0;
     int y = 0;
     bool absolute_event = false;
+    Event::Timestamp timestamp;
 
     if (length == 0 || length % sizeof(e[0]) != 0)
     {
@@ -78,6 +103,8 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
     for (e = ev; e < end; e++)
     {
         auto value = e->value;
+        timestamp = m_monotonic ? monotonic_timestamp(event_time(*e)) :
+                    realtime_timestamp(event_time(*e));
 
         EGTLOG_DEBUG("event type: {}", e->type);
         switch (e->type)
@@ -127,6 +154,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
             {
                 Event event(value ? EventId::raw_pointer_down : EventId::raw_pointer_up,
                             Pointer(m_last_point, Pointer::Button::left));
+                event.timestamp(timestamp);
                 dispatch(event);
                 break;
             }
@@ -134,6 +162,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
             {
                 Event event(value ? EventId::raw_pointer_down : EventId::raw_pointer_up,
                             Pointer(m_last_point, Pointer::Button::right));
+                event.timestamp(timestamp);
                 dispatch(event);
                 break;
             }
@@ -141,6 +170,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
             {
                 Event event(value ? EventId::raw_pointer_down : EventId::raw_pointer_up,
                             Pointer(m_last_point, Pointer::Button::middle));
+                event.timestamp(timestamp);
                 dispatch(event);
                 break;
             }
@@ -152,6 +182,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
                 {
                     const auto unicode = m_keyboard->on_key(e->code, EventId::keyboard_up);
                     Event event(EventId::keyboard_up, Key(linux_to_ekey(e->code), unicode));
+                    event.timestamp(timestamp);
                     dispatch(event);
                     break;
                 }
@@ -159,6 +190,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
                 {
                     const auto unicode = m_keyboard->on_key(e->code, EventId::keyboard_down);
                     Event event(EventId::keyboard_down, Key(linux_to_ekey(e->code), unicode));
+                    event.timestamp(timestamp);
                     dispatch(event);
                     break;
                 }
@@ -166,6 +198,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
                 {
                     const auto unicode = m_keyboard->on_key(e->code, EventId::keyboard_repeat);
                     Event event(EventId::keyboard_repeat, Key(linux_to_ekey(e->code), unicode));
+                    event.timestamp(timestamp);
                     dispatch(event);
                     break;
                 }
@@ -183,6 +216,7 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
     {
         m_last_point = DisplayPoint(x, y);
         Event event(EventId::raw_pointer_move, Pointer(m_last_point));
+        event.timestamp(timestamp);
         dispatch(event);
     }
     else
@@ -191,15 +225,17 @@ void InputEvDev::handle_read(const asio::error_code& error, std::size_t length)
         {
             m_last_point = DisplayPoint(m_last_point.x() + dx, m_last_point.y() + dy);
             Event event(EventId::raw_pointer_move, Pointer(m_last_point));
+            event.timestamp(timestamp);
             dispatch(event);
         }
     }
 
     asio::async_read(m_input, asio::buffer(m_input_buf.data(), m_input_buf.size()),
                      egt::asio::transfer_at_least(sizeof(struct input_event)),
-                     std::bind(&InputEvDev::handle_read, this,
-                               std::placeholders::_1,
-                               std::placeholders::_2));
+                     Application::instance().event().queue().wrap(detail::priorities::input,
+                             std::bind(&InputEvDev::handle_read, this,
+                                       std::placeholders::_1,
+                                       std::placeholders::_2)));
 }
 
 InputEvDev::~InputEvDev() noexcept
@@ -6,7 +6,10 @@
 #include "detail/egtlog.h"
 #include "detail/asioallocator.h"
 #include "detail/dump.h"
+#include "detail/trace.h"
 #include "detail/input/inputkeyboard.h"
+#include "detail/input/timestamp.h"
+#include "detail/priorityqueue.h"
 #include "egt/app.h"
 #include "egt/detail/input/inputlibinput.h"
 #include "egt/detail/meta.h"
@@ -120,9 +123,14 @@ static struct libinput* tools_open_udev(const char* seat, bool grab)
 
 InputLibInput::InputLibInput(Application& app)
     : m_app(app),
-      m_input(app.event().io()),
+      m_input(app.event().input_io()),
       m_impl(std::make_unique<LibInputImpl>())
 {
+    // taken here, on the event loop thread, and then updated through the
+    // input thread by screen_resized()
+    if (app.screen())
+        m_screen_size = app.screen()->size();
+
     const char* seat_or_device = "seat0";
     li = tools_open_udev(seat_or_device, false);
     if (!li)
@@ -135,21 +143,28 @@ InputLibInput::InputLibInput(Application& app)
     m_input.assign(libinput_get_fd(li));
 
     // go ahead and enumerate devices and start the first async_read
-#ifdef USE_PRIORITY_QUEUE
     asio::async_read(m_input, asio::null_buffers(),
-                     m_app.event().queue().wrap(detail::priorities::moderate,
+                     m_app.event().queue().wrap(detail::priorities::input,
+                             detail::make_custom_alloc_handler(m_impl->allocator,
                              [this](const asio::error_code & error, std::size_t)
     {
         handle_read(error);
-    }));
-#else
-    asio::async_read(m_input, asio::null_buffers(),
-                     detail::make_custom_alloc_handler(m_impl->allocator,
-                             [this](const asio::error_code & error, std::size_t)
+    })));
+}
+
+void InputLibInput::screen_resized(const Size& size)
+{
+    // without an input thread, events are handled on this thread
+    if (&m_input.get_executor().context() == &m_app.event().io())
     {
-        handle_read(error);
-    }));
-#endif
+        m_screen_size = size;
+        return;
+    }
+
+    asio::post(m_input.get_executor(), [this, size]()
+    {
+        m_screen_size = size;
+    });
 }
 
 void InputLibInput::handle_event_device_notify(struct libinput_event* ev)
@@ -201,29 +216,30 @@ void InputLibInput::handle_event_touch(struct libinput_event* ev)
     case LIBINPUT_EVENT_TOUCH_UP:
     {
         Event event(EventId::raw_pointer_up, Pointer(m_last_point[slot], slot));
+        event.timestamp(monotonic_timestamp(libinput_event_touch_get_time_usec(t)));
         dispatch(event);
         break;
     }
     case LIBINPUT_EVENT_TOUCH_DOWN:
     {
-        const auto& screen_size = Application::instance().screen()->size();
-        const auto x = libinput_event_touch_get_x_transformed(t, screen_size.width());
-        const auto y = libinput_event_touch_get_y_transformed(t, screen_size.height());
+        const auto x = libinput_event_touch_get_x_transformed(t, m_screen_size.width());
+        const auto y = libinput_event_touch_get_y_transformed(t, m_screen_size.height());
 
         m_last_point[slot] = DisplayPoint(x, y);
 
         Event event(EventId::raw_pointer_down, Pointer(m_last_point[slot], slot));
+        event.timestamp(monotonic_timestamp(libinput_event_touch_get_time_usec(t)));
         dispatch(event);
         break;
     }
     case LIBINPUT_EVENT_TOUCH_MOTION:
     {
-        const auto& screen_size = Application::instance().screen()->size();
-        const auto x = libinput_event_touch_get_x_transformed(t, screen_size.width());
-        const auto y = libinput_event_touch_get_y_transformed(t, screen_size.height());
+        const auto x = libinput_event_touch_get_x_transformed(t, m_screen_size.width());
+        const auto y = libinput_event_touch_get_y_transformed(t, m_screen_size.height());
 
         m_last_point[slot] = DisplayPoint(x, y);
         Event event(EventId::raw_pointer_move, Pointer(m_last_point[slot], slot));
+        event.timestamp(monotonic_timestamp(libinput_event_touch_get_time_usec(t)));
         dispatch(event);
         break;
     }
@@ -241,6 +257,7 @@ void InputLibInput::handle_event_pointer_motion(struct libinput_event* ev)
 
     m_last_point[0] += DisplayPoint(x, y);
     Event event(EventId::raw_pointer_move, Pointer(m_last_point[0], 0));
+    event.timestamp(monotonic_timestamp(libinput_event_pointer_get_time_usec(t)));
     dispatch(event);
 }
 
@@ -248,12 +265,12 @@ void InputLibInput::handle_event_pointer_motion_absolute(struct libinput_event*
 {
     struct libinput_event_pointer* t = libinput_event_get_pointer_event(ev);
 
-    const auto& screen_size = Application::instance().screen()->size();
-    const auto x = libinput_event_pointer_get_absolute_x_transformed(t, screen_size.width());
-    const auto y = libinput_event_pointer_get_absolute_y_transformed(t, screen_size.height());
+    const auto x = libinput_event_pointer_get_absolute_x_transformed(t, m_screen_size.width());
+    const auto y = libinput_event_pointer_get_absolute_y_transformed(t, m_screen_size.height());
 
     m_last_point[0] = DisplayPoint(x, y);
     Event event(EventId::raw_pointer_move, Pointer(m_last_point[0], 0));
+    event.timestamp(monotonic_timestamp(libinput_event_pointer_get_time_usec(t)));
     dispatch(event);
 }
 
@@ -272,6 +289,7 @@ void InputLibInput::handle_event_keyboard(struct libinput_event* ev)
     {
         const auto unicode = m_impl->keyboard.on_key(key + EVDEV_OFFSET, EventId::keyboard_down);
         Event event(EventId::keyboard_down, Key(linux_to_ekey(key), unicode));
+        event.timestamp(monotonic_timestamp(libinput_event_keyboard_get_time_usec(k)));
         dispatch(event);
         break;
     }
@@ -279,6 +297,7 @@ void InputLibInput::handle_event_keyboard(struct libinput_event* ev)
     {
         const auto unicode = m_impl->keyboard.on_key(key + EVDEV_OFFSET, EventId::keyboard_up);
         Event event(EventId::keyboard_up, Key(linux_to_ekey(key), unicode));
+        event.timestamp(monotonic_timestamp(libinput_event_keyboard_get_time_usec(k)));
         dispatch(event);
         break;
     }
@@ -315,6 +334,7 @@ void InputLibInput::handle_event_button(struct libinput_event* ev)
         const bool is_press = libinput_event_pointer_get_button_state(p) == LIBINPUT_BUTTON_STATE_PRESSED;
         Event event(is_press ? EventId::raw_pointer_down : EventId::raw_pointer_up,
                     Pointer(m_last_point[0], b));
+        event.timestamp(monotonic_timestamp(libinput_event_pointer_get_time_usec(p)));
         dispatch(event);
     }
 }
@@ -340,6 +360,8 @@ void InputLibInput::handle_read(const asio::error_code& error)
         return;
     }
 
+    EGT_TRACE_SCOPE("input read");
+
     detail::code_timer(time_input_enabled(), "libinput: ", [this]()
     {
         struct libinput_event* ev;
@@ -397,21 +419,13 @@ void InputLibInput::handle_read(const asio::error_code& error)
             libinput_event_destroy(ev);
         }
 
-#ifdef USE_PRIORITY_QUEUE
-        asio::async_read(m_input, asio::null_buffers(),
-                         m_app.event().queue().wrap(detail::priorities::moderate,
-                                 [this](const asio::error_code & error, std::size_t)
-        {
-            handle_read(error);
-        }));
-#else
         asio::async_read(m_input, asio::null_buffers(),
-                         detail::make_custom_alloc_handler(m_impl->allocator,
+                         m_app.event().queue().wrap(detail::priorities::input,
+                                 detail::make_custom_alloc_handler(m_impl->allocator,
                                  [this](const asio::error_code & error, std::size_t)
         {
             handle_read(error);
-        }));
-#endif
+        })));
     });
 }
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/egtlog.h"
+#include "detail/input/inputthread.h"
+#include "detail/trace.h"
+#include "egt/input.h"
+#include <chrono>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+static thread_local InputThread* current_thread = nullptr;
+
+InputThread::InputThread(asio::io_context& ui)
+    : m_ui(ui)
+{}
+
+InputThread* InputThread::current()
+{
+    return current_thread;
+}
+
+void InputThread::start()
+{
+    if (m_thread.joinable())
+        return;
+
+    // completions of operations aborted by destroying input devices while
+    // stopped are still queued, and would run on destroyed devices, so they
+    // are destroyed with the old io_context instead
+    m_work.reset();
+    m_io = std::make_unique<asio::io_context>();
+    m_work = std::make_unique<asio::executor_work_guard<asio::io_context::executor_type>>(
+                 asio::make_work_guard(*m_io));
+
+    m_stop = false;
+    m_thread = std::thread(&InputThread::run, this);
+}
+
+void InputThread::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_stop = true;
+    m_io->stop();
+    m_thread.join();
+
+    Entry entry;
+    while (m_queue.pop(entry))
+    {}
+}
+
+void InputThread::run()
+{
+    current_thread = this;
+    detail::info("input thread started");
+    m_io->run();
+    current_thread = nullptr;
+}
+
+void InputThread::push(Input* input, const Event& event)
+{
+    Entry entry{input, event};
+
+    if (egt_unlikely(!m_queue.push(entry)))
+    {
+        detail::warn("input queue full");
+
+        // the event loop is stalled, so wait for it instead of dropping the
+        // event
+        do
+        {
+            if (m_stop)
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        while (!m_queue.push(entry));
+    }
+
+    // one wake up of the event loop at a time
+    if (!m_wake.exchange(true))
+        asio::post(m_ui, [this]() { drain(); });
+}
+
+void InputThread::drain()
+{
+    // clear before popping, so events pushed from now on wake up again
+    m_wake = false;
+
+    if (m_queue.empty())
+        return;
+
+    EGT_TRACE_SCOPE("input drain");
+
+    Entry entry;
+    while (m_queue.pop(entry))
+        entry.input->dispatch(entry.event);
+}
+
+InputThread::~InputThread() noexcept
+{
+    stop();
+}
+
+}
+}
+}
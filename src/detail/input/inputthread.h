@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_INPUT_INPUTTHREAD_H
+#define EGT_DETAIL_INPUT_INPUTTHREAD_H
+
+#include "detail/spscqueue.h"
+#include "egt/detail/meta.h"
+#include "egt/event.h"
+#include <atomic>
+#include <egt/asio.hpp>
+#include <memory>
+#include <thread>
+
+namespace egt
+{
+inline namespace v1
+{
+class Input;
+
+namespace detail
+{
+
+/**
+ * Thread that input devices are read on.
+ *
+ * Input devices using io() are read on this thread, so they are not held up
+ * by drawing.  Events they dispatch are queued here and dispatched on the
+ * thread running the event loop by drain().
+ */
+class InputThread : private NonCopyable<InputThread>
+{
+public:
+
+    /**
+     * @param[in] ui The io_context of the event loop, used to wake it up when
+     *               events are queued.
+     */
+    explicit InputThread(asio::io_context& ui);
+
+    /**
+     * The io_context run by the thread.
+     */
+    asio::io_context& io() { return *m_io; }
+
+    /**
+     * Start the thread, if not already running.
+     *
+     * A new io() is created when starting again after stop(), so handlers of
+     * input devices destroyed while stopped are discarded instead of run.
+     */
+    void start();
+
+    /**
+     * Stop the thread, and drop any queued events.
+     *
+     * No more handlers are run on io() once this returns, so input devices
+     * using it can be destroyed.  Input devices must be created again after
+     * the thread is started again.
+     */
+    void stop();
+
+    /**
+     * Queue an event from an input.
+     *
+     * If the queue is full, this waits for the event loop to make room.
+     *
+     * Called on the input thread.
+     */
+    void push(Input* input, const Event& event);
+
+    /**
+     * Dispatch all queued events.
+     *
+     * Called on the event loop thread.
+     */
+    void drain();
+
+    /**
+     * Get the InputThread of the calling thread, or nullptr.
+     */
+    static InputThread* current();
+
+    ~InputThread() noexcept;
+
+private:
+
+    void run();
+
+    struct Entry
+    {
+        Input* input{nullptr};
+        Event event;
+    };
+
+    /// Maximum number of events queued.
+    static constexpr size_t QUEUE_SIZE = 1024;
+
+    asio::io_context& m_ui;
+    std::unique_ptr<asio::io_context> m_io;
+    std::unique_ptr<asio::executor_work_guard<asio::io_context::executor_type>> m_work;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    /// Set while a drain() is posted to the event loop.
+    std::atomic<bool> m_wake{false};
+    SpscQueue<Entry, QUEUE_SIZE> m_queue;
+};
+
+}
+}
+}
+
+#endif
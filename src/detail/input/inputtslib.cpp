@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "detail/input/timestamp.h"
+#include "detail/priorityqueue.h"
+#include "detail/trace.h"
 #include "egt/app.h"
 #include "egt/detail/input/inputtslib.h"
 #include <chrono>
@@ -27,7 +30,7 @@ struct tslibimpl
 };
 
 InputTslib::InputTslib(Application& app, const std::string& path)
-    : m_input(app.event().io()),
+    : m_input(app.event().input_io()),
       m_impl(new detail::tslibimpl)
 {
     constexpr int NONBLOCKING = 1;
@@ -47,7 +50,8 @@ InputTslib::InputTslib(Application& app, const std::string& path)
         m_input.assign(ts_fd(m_impl->ts));
 
         asio::async_read(m_input, asio::null_buffers(),
-                         std::bind(&InputTslib::handle_read, this, std::placeholders::_1));
+                         app.event().queue().wrap(detail::priorities::input,
+                                 std::bind(&InputTslib::handle_read, this, std::placeholders::_1)));
     }
     else
     {
@@ -69,6 +73,8 @@ void InputTslib::handle_read(const asio::error_code& error)
         return;
     }
 
+    EGT_TRACE_SCOPE("input read");
+
     struct ts_sample_mt** samp_mt = m_impl->samp_mt;
 
     int ret = ts_read_mt(m_impl->ts, samp_mt, CHANNELS, SAMPLE_COUNT);
@@ -79,6 +85,7 @@ void InputTslib::handle_read(const asio::error_code& error)
     }
 
     std::array<bool, 2> move{};
+    std::array<Event::Timestamp, 2> move_time{};
 
     for (int j = 0; j < ret; j++)
     {
@@ -107,6 +114,8 @@ void InputTslib::handle_read(const asio::error_code& error)
             const auto y = samp_mt[j][i].y;
             const auto slot = samp_mt[j][i].slot;
             const auto pen_down = samp_mt[j][i].pen_down;
+            // tslib does not change the clock of the device from CLOCK_REALTIME
+            const auto timestamp = realtime_timestamp(samp_mt[j][i].tv);
 
             if (egt_unlikely(x < 0 || y < 0))
                 continue;
@@ -122,6 +131,7 @@ void InputTslib::handle_read(const asio::error_code& error)
                     m_last_point[slot] = DisplayPoint(x, y);
                     Event event(EventId::raw_pointer_up, Pointer(m_last_point[slot],
                                 Pointer::Button::left));
+                    event.timestamp(timestamp);
                     dispatch(event);
                 }
                 else
@@ -131,6 +141,7 @@ void InputTslib::handle_read(const asio::error_code& error)
                     {
                         m_last_point[slot] = point;
                         move[slot] = true;
+                        move_time[slot] = timestamp;
                     }
                 }
             }
@@ -152,6 +163,7 @@ void InputTslib::handle_read(const asio::error_code& error)
                     {
                         Event event(EventId::pointer_dblclick,
                                     Pointer(m_last_point[slot], Pointer::Button::left));
+                        event.timestamp(timestamp);
                         dispatch(event);
                     }
                     else
@@ -162,6 +174,7 @@ void InputTslib::handle_read(const asio::error_code& error)
 
                         Event event(EventId::raw_pointer_down,
                                     Pointer(m_last_point[slot], Pointer::Button::left));
+                        event.timestamp(timestamp);
                         dispatch(event);
                     }
 
@@ -179,17 +192,14 @@ void InputTslib::handle_read(const asio::error_code& error)
 
             Event event(EventId::raw_pointer_move,
                         Pointer(m_last_point[slot], Pointer::Button::left));
+            event.timestamp(move_time[slot]);
             dispatch(event);
         }
     }
 
-#ifdef USE_PRIORITY_QUEUE
-    asio::async_read(m_input, asio::null_buffers(),
-                     m_app.event().queue().wrap(detail::priorities::moderate, std::bind(&InputTslib::handle_read, this, std::placeholders::_1)));
-#else
     asio::async_read(m_input, asio::null_buffers(),
-                     std::bind(&InputTslib::handle_read, this, std::placeholders::_1));
-#endif
+                     Application::instance().event().queue().wrap(detail::priorities::input,
+                             std::bind(&InputTslib::handle_read, this, std::placeholders::_1)));
 }
 
 InputTslib::~InputTslib() noexcept
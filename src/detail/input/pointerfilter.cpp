@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/input/pointerfilter.h"
+#include "egt/detail/math.h"
+#include <cmath>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Slots above this are passed through unfiltered.
+static constexpr size_t MAX_SLOTS = 16;
+
+float OneEuroFilter::alpha(float cutoff, float dt)
+{
+    const auto tau = 1.0f / (2.0f * detail::pi<float>() * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+float OneEuroFilter::filter(float value, float dt, const Input::Filter& settings)
+{
+    if (!m_valid || dt <= 0)
+    {
+        if (!m_valid)
+        {
+            m_value = m_raw = value;
+            m_speed = 0;
+            m_valid = true;
+        }
+        return m_value;
+    }
+
+    // the derivative is low pass filtered on its own
+    const auto speed = (value - m_raw) / dt;
+    m_raw = value;
+    m_speed += alpha(settings.d_cutoff, dt) * (speed - m_speed);
+
+    const auto cutoff = settings.min_cutoff + settings.beta * std::fabs(m_speed);
+    m_value += alpha(cutoff, dt) * (value - m_value);
+    return m_value;
+}
+
+void PointerFilter::filter(Event& event, const Input::Filter& settings)
+{
+    const auto index = event.pointer().slot;
+    if (index >= MAX_SLOTS)
+        return;
+    if (index >= m_slots.size())
+        m_slots.resize(index + 1);
+
+    auto& slot = m_slots[index];
+    const auto& point = event.pointer().point;
+
+    switch (event.id())
+    {
+    case EventId::raw_pointer_down:
+        // a new stroke starts where the pointer went down
+        slot.x.reset();
+        slot.y.reset();
+        slot.active = false;
+        break;
+    case EventId::raw_pointer_move:
+    case EventId::raw_pointer_up:
+        break;
+    default:
+        return;
+    }
+
+    const auto dt = slot.active ?
+                    std::chrono::duration<float>(event.timestamp() - slot.time).count() : 0.f;
+
+    slot.fx = slot.x.filter(point.x(), dt, settings);
+    slot.fy = slot.y.filter(point.y(), dt, settings);
+    slot.time = event.timestamp();
+    slot.active = event.id() != EventId::raw_pointer_up;
+
+    // the up position too, so the pointer does not jump on release
+    if (settings.enabled)
+        event.pointer().point = DisplayPoint(std::lround(slot.fx), std::lround(slot.fy));
+}
+
+void PointerFilter::predict(Event& event, Event::Timestamp time,
+                            const Input::Filter& settings) const
+{
+    const auto index = event.pointer().slot;
+    if (index >= m_slots.size())
+        return;
+
+    const auto& slot = m_slots[index];
+    if (!slot.active)
+        return;
+
+    const auto ahead = detail::clamp(std::chrono::duration<float>(time - slot.time).count(),
+                                     0.f,
+                                     std::chrono::duration<float>(settings.max_prediction).count());
+
+    // without filtering, predict from where the pointer really is
+    float x = event.pointer().point.x();
+    float y = event.pointer().point.y();
+    if (settings.enabled)
+    {
+        x = slot.fx;
+        y = slot.fy;
+    }
+
+    event.pointer().point = DisplayPoint(std::lround(x + slot.x.speed() * ahead),
+                                         std::lround(y + slot.y.speed() * ahead));
+}
+
+}
+}
+}
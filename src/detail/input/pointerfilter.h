@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_INPUT_POINTERFILTER_H
+#define EGT_DETAIL_INPUT_POINTERFILTER_H
+
+#include "egt/event.h"
+#include "egt/input.h"
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * The 1€ filter.
+ *
+ * A low pass filter whose cutoff frequency increases with the speed of the
+ * filtered value.
+ *
+ * Casiez, G., Roussel, N. and Vogel, D. (2012). 1€ Filter: A Simple
+ * Speed-based Low-pass Filter for Noisy Input in Interactive Systems.
+ */
+class OneEuroFilter
+{
+public:
+
+    /**
+     * Filter a value.
+     *
+     * @param[in] value The new value.
+     * @param[in] dt Seconds since the last value.
+     * @param[in] settings Filter settings.
+     */
+    float filter(float value, float dt, const Input::Filter& settings);
+
+    /// Filtered speed of the value, in units per second.
+    EGT_NODISCARD float speed() const { return m_speed; }
+
+    /// Forget all previous values.
+    void reset() { m_valid = false; }
+
+private:
+
+    static float alpha(float cutoff, float dt);
+
+    bool m_valid{false};
+    float m_value{0};
+    float m_raw{0};
+    float m_speed{0};
+};
+
+/**
+ * Filters and predicts the pointer positions of each slot of an Input.
+ */
+class PointerFilter
+{
+public:
+
+    /**
+     * Filter a raw pointer event in place.
+     *
+     * EventId::raw_pointer_down starts a new stroke at its position.  The
+     * position of EventId::raw_pointer_move and EventId::raw_pointer_up is
+     * replaced with the filtered position, and EventId::raw_pointer_up ends
+     * the stroke.
+     */
+    void filter(Event& event, const Input::Filter& settings);
+
+    /**
+     * Predict the position of the slot of an EventId::raw_pointer_move.
+     *
+     * The prediction uses the filtered speed, starting from the filtered
+     * position when filtering is enabled, and from the position of the event
+     * otherwise.
+     *
+     * @param[in] event The event, which is changed to the predicted position.
+     * @param[in] time Time the event is predicted for.
+     * @param[in] settings Filter settings.
+     */
+    void predict(Event& event, Event::Timestamp time, const Input::Filter& settings) const;
+
+private:
+
+    struct Slot
+    {
+        OneEuroFilter x;
+        OneEuroFilter y;
+        /// Time of the last position.
+        Event::Timestamp time;
+        /// Filtered position.
+        float fx{0};
+        float fy{0};
+        bool active{false};
+    };
+
+    std::vector<Slot> m_slots;
+};
+
+}
+}
+}
+
+#endif
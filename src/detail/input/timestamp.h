@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_DETAIL_INPUT_TIMESTAMP_H
+#define EGT_DETAIL_INPUT_TIMESTAMP_H
+
+#include "egt/event.h"
+#include <chrono>
+#include <cstdint>
+#include <sys/time.h>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Convert a CLOCK_MONOTONIC kernel timestamp to an Event::Timestamp.
+ *
+ * std::chrono::steady_clock uses CLOCK_MONOTONIC on Linux.
+ */
+inline Event::Timestamp monotonic_timestamp(uint64_t usec)
+{
+    return Event::Timestamp(std::chrono::duration_cast<Event::Timestamp::duration>(
+                                std::chrono::microseconds(usec)));
+}
+
+/// @overload
+inline Event::Timestamp monotonic_timestamp(const struct timeval& tv)
+{
+    return monotonic_timestamp(static_cast<uint64_t>(tv.tv_sec) * 1000000ULL + tv.tv_usec);
+}
+
+/**
+ * Convert a CLOCK_REALTIME kernel timestamp to an Event::Timestamp.
+ */
+inline Event::Timestamp realtime_timestamp(const struct timeval& tv)
+{
+    const auto realtime = std::chrono::system_clock::time_point(
+                              std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                  std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec)));
+    const auto age = std::chrono::system_clock::now() - realtime;
+    return std::chrono::steady_clock::now() -
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+}
+
+}
+}
+}
+
+#endif
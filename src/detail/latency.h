@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_LATENCY_H
+#define EGT_SRC_DETAIL_LATENCY_H
+
+/**
+ * @file
+ * @brief Hooks for InputLatency.
+ */
+
+#include "egt/event.h"
+
+namespace egt
+{
+inline namespace v1
+{
+
+class Screen;
+
+namespace detail
+{
+
+/// Called at the start of dispatching an input event.
+void latency_dispatch_begin(const Event& event);
+
+/// Called at the end of dispatching an input event.
+void latency_dispatch_end();
+
+/// Called for any damage to a screen.
+void latency_damage(const Screen* screen);
+
+/// Called when drawing of a frame of a screen is done, before it is flipped.
+void latency_draw_end(const Screen* screen);
+
+/// Called after a flip of a screen has been submitted.
+void latency_flip(const Screen* screen);
+
+}
+}
+}
+
+#endif
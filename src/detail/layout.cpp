@@ -97,6 +97,22 @@ static uint32_t align_to_behave(const AlignFlags& align)
     return behave;
 }
 
+static void run_flex(lay_context& ctx,
+                     const Rect& parent,
+                     std::vector<LayoutRect>& children,
+                     Justification justify,
+                     Orientation orient)
+{
+    lay_reserve_items_capacity(&ctx, children.size() + 1);
+
+    lay_id outer_parent = lay_item(&ctx);
+    lay_set_size_xy(&ctx, outer_parent, parent.width(), parent.height());
+    uint32_t contains = justify_to_contains(justify, orient);
+    lay_set_contain(&ctx, outer_parent, contains);
+
+    run_and_apply(ctx, outer_parent, children);
+}
+
 void flex_layout(const Rect& parent,
                  std::vector<LayoutRect>& children,
                  Justification justify,
@@ -110,14 +126,7 @@ void flex_layout(const Rect& parent,
         lay_destroy_context(&ctx);
     });
 
-    lay_reserve_items_capacity(&ctx, children.size() + 1);
-
-    lay_id outer_parent = lay_item(&ctx);
-    lay_set_size_xy(&ctx, outer_parent, parent.width(), parent.height());
-    uint32_t contains = justify_to_contains(justify, orient);
-    lay_set_contain(&ctx, outer_parent, contains);
-
-    run_and_apply(ctx, outer_parent, children);
+    run_flex(ctx, parent, children, justify, orient);
 }
 
 void flex_layout(const Rect& parent,
@@ -151,6 +160,81 @@ void flex_layout(const Rect& parent,
     run_and_apply(ctx, inner_parent, children);
 }
 
+struct FlexLayout::FlexLayoutImpl
+{
+    FlexLayoutImpl()
+    {
+        lay_init_context(&ctx);
+    }
+
+    FlexLayoutImpl(const FlexLayoutImpl&) = delete;
+    FlexLayoutImpl& operator=(const FlexLayoutImpl&) = delete;
+
+    ~FlexLayoutImpl() noexcept
+    {
+        lay_destroy_context(&ctx);
+    }
+
+    lay_context ctx{};
+    bool valid{false};
+    Rect parent;
+    Justification justify{Justification::none};
+    Orientation orient{Orientation::none};
+    /// Children passed to the last computed layout.
+    std::vector<LayoutRect> inputs;
+    /// Resulting rects of the last computed layout.
+    std::vector<Rect> results;
+};
+
+FlexLayout::FlexLayout()
+    : m_impl(std::make_unique<FlexLayoutImpl>())
+{}
+
+FlexLayout::FlexLayout(FlexLayout&&) noexcept = default;
+FlexLayout& FlexLayout::operator=(FlexLayout&&) noexcept = default;
+FlexLayout::~FlexLayout() noexcept = default;
+
+bool FlexLayout::layout(const Rect& parent,
+                        std::vector<LayoutRect>& children,
+                        Justification justify,
+                        Orientation orient)
+{
+    auto& impl = *m_impl;
+
+    if (impl.valid &&
+        impl.parent.size() == parent.size() &&
+        impl.justify == justify &&
+        impl.orient == orient &&
+        impl.inputs == children)
+    {
+        for (size_t i = 0; i < children.size(); ++i)
+            children[i].rect = impl.results[i];
+        return false;
+    }
+
+    impl.valid = false;
+    impl.parent = parent;
+    impl.justify = justify;
+    impl.orient = orient;
+    impl.inputs = children;
+
+    // keeps the items already allocated
+    lay_reset_context(&impl.ctx);
+    run_flex(impl.ctx, parent, children, justify, orient);
+
+    impl.results.resize(children.size());
+    for (size_t i = 0; i < children.size(); ++i)
+        impl.results[i] = children[i].rect;
+    impl.valid = true;
+
+    return true;
+}
+
+void FlexLayout::invalidate()
+{
+    m_impl->valid = false;
+}
+
 }
 }
 }
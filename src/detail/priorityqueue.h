@@ -11,9 +11,13 @@
 #ifndef EGT_SRC_DETAIL_PRIORITYQUEUE_H
 #define EGT_SRC_DETAIL_PRIORITYQUEUE_H
 
+#include <array>
+#include <chrono>
+#include <deque>
 #include <egt/asio.hpp>
-#include <functional>
-#include <queue>
+#include <egt/detail/inplacefunction.h>
+#include <egt/eventloop.h>
+#include <thread>
 #include <utility>
 
 namespace egt
@@ -23,38 +27,105 @@ inline namespace v1
 namespace detail
 {
 
-enum class priorities
-{
-    low = 0,
-    moderate = 50,
-    high = 100,
-};
+using priorities = EventLoop::Priority;
 
+/**
+ * Queue of handlers run by the event loop in priority order.
+ *
+ * Handlers of the same priority are run in the order they were added.
+ * Handlers with priorities::input and priorities::frame are always run.
+ * Handlers with lower priorities are left queued once a deadline has passed,
+ * and run on a later call to execute().
+ */
 class PriorityQueue
 {
 public:
 
-    void add(priorities priority, std::function<void()> function)
+    /**
+     * Queued handler.
+     *
+     * Completed asio handlers, with their arguments bound, are stored inline
+     * without allocating.
+     */
+    using Callback = InplaceFunction<void(), 8 * sizeof(void*)>;
+
+    PriorityQueue()
+        : m_thread(std::this_thread::get_id())
+    {}
+
+    void add(priorities priority, Callback function)
     {
-        m_handlers.push(queued_handler(priority, std::move(function)));
+        m_handlers[static_cast<size_t>(priority)].emplace_back(std::move(function));
     }
 
-    void execute_all()
+    /**
+     * Check if there are no queued handlers.
+     */
+    EGT_NODISCARD bool empty() const
     {
-        while (!m_handlers.empty())
+        for (const auto& handlers : m_handlers)
+            if (!handlers.empty())
+                return false;
+        return true;
+    }
+
+    /**
+     * Run queued handlers, including any they add, until the deadline.
+     *
+     * @return The number of handlers run.
+     */
+    int execute(std::chrono::steady_clock::time_point deadline)
+    {
+        int count = 0;
+        while (true)
         {
-            queued_handler handler = m_handlers.top();
-            m_handlers.pop();
-            handler.execute();
+            auto i = m_handlers.size();
+            while (i && m_handlers[i - 1].empty())
+                --i;
+            if (!i)
+                break;
+
+            auto& handlers = m_handlers[i - 1];
+            if (static_cast<priorities>(i - 1) < priorities::frame &&
+                std::chrono::steady_clock::now() >= deadline)
+                break;
+
+            auto handler = std::move(handlers.front());
+            handlers.pop_front();
+            handler();
+            ++count;
         }
+        return count;
+    }
+
+    /**
+     * Run all queued handlers, including any they add.
+     */
+    int execute_all()
+    {
+        return execute(std::chrono::steady_clock::time_point::max());
+    }
+
+    /**
+     * Check if called on the thread that created the queue.
+     */
+    EGT_NODISCARD bool owner_thread() const
+    {
+        return std::this_thread::get_id() == m_thread;
     }
 
+    /**
+     * Handler that runs in the queue when completed by asio.
+     *
+     * The allocation and continuation hooks of the wrapped handler are used
+     * for the operation, so handlers like CustomAllocHandler still work.
+     */
     template <typename Handler>
     class WrappedHandler
     {
     public:
         WrappedHandler(PriorityQueue& q, priorities p, Handler h)
-            : queue_(q), m_priority(p), handler_(h)
+            : queue_(q), m_priority(p), handler_(std::move(h))
         {
         }
 
@@ -83,43 +154,49 @@ public:
     template <typename Handler>
     WrappedHandler<Handler> wrap(priorities priority, Handler handler)
     {
-        return WrappedHandler<Handler>(*this, priority, handler);
+        return WrappedHandler<Handler>(*this, priority, std::move(handler));
     }
 
 private:
 
-    class queued_handler
-    {
-    public:
-        queued_handler(priorities p, std::function<void()> f)
-            : m_priority(p), m_function(std::move(f))
-        {
-        }
-
-        void execute()
-        {
-            m_function();
-        }
-
-        friend bool operator<(const queued_handler& a,
-                              const queued_handler& b)
-        {
-            return a.m_priority < b.m_priority;
-        }
+    static constexpr size_t PRIORITIES = static_cast<size_t>(priorities::input) + 1;
 
-    private:
-        priorities m_priority;
-        std::function<void()> m_function;
-    };
-
-    std::priority_queue<queued_handler> m_handlers;
+    std::array<std::deque<Callback>, PRIORITIES> m_handlers;
+    std::thread::id m_thread;
 };
 
 template <typename Function, typename Handler>
 void asio_handler_invoke(Function f,
                          PriorityQueue::WrappedHandler<Handler>* h)
 {
-    h->queue_.add(h->m_priority, std::forward<Function>(f));
+    // handlers completed on another thread, like the input thread, run there
+    if (!h->queue_.owner_thread())
+    {
+        f();
+        return;
+    }
+
+    h->queue_.add(h->m_priority, std::move(f));
+}
+
+template <typename Handler>
+void* asio_handler_allocate(std::size_t size,
+                            PriorityQueue::WrappedHandler<Handler>* h)
+{
+    return egt_asio_handler_alloc_helpers::allocate(size, h->handler_);
+}
+
+template <typename Handler>
+void asio_handler_deallocate(void* pointer, std::size_t size,
+                             PriorityQueue::WrappedHandler<Handler>* h)
+{
+    egt_asio_handler_alloc_helpers::deallocate(pointer, size, h->handler_);
+}
+
+template <typename Handler>
+bool asio_handler_is_continuation(PriorityQueue::WrappedHandler<Handler>* h)
+{
+    return egt_asio_handler_cont_helpers::is_continuation(h->handler_);
 }
 
 }
@@ -4,8 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "detail/screen/overdraw.h"
 #include "egt/detail/screen/memoryscreen.h"
 #include <cairo.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 namespace egt
 {
@@ -14,6 +18,14 @@ inline namespace v1
 namespace detail
 {
 
+static const char* overdraw_prefix()
+{
+    const auto value = std::getenv("EGT_OVERDRAW");
+    if (value && strlen(value))
+        return value;
+    return nullptr;
+}
+
 MemoryScreen::MemoryScreen(const Size& size)
     : m_canvas(size)
 {
@@ -22,6 +34,45 @@ MemoryScreen::MemoryScreen(const Size& size)
     detail::info("fb size {}", size);
 
     init(size);
+
+    if (overdraw_prefix())
+    {
+        detail::info("overdraw analysis enabled");
+        m_overdraw = std::make_unique<OverdrawAnalyzer>(m_surface);
+        OverdrawAnalyzer::active(m_overdraw.get());
+    }
+}
+
+void MemoryScreen::flip(const DamageArray& damage)
+{
+    Screen::flip(damage);
+
+    if (m_overdraw)
+        m_overdraw->frame(damage);
+}
+
+void MemoryScreen::overdraw_report(std::ostream& out) const
+{
+    if (m_overdraw)
+        m_overdraw->report(out);
+}
+
+void MemoryScreen::overdraw_save(const std::string& prefix) const
+{
+    if (m_overdraw)
+        m_overdraw->save(prefix);
+}
+
+MemoryScreen::~MemoryScreen() noexcept
+{
+    if (m_overdraw)
+    {
+        if (OverdrawAnalyzer::active() == m_overdraw.get())
+            OverdrawAnalyzer::active(nullptr);
+
+        overdraw_report(std::cout);
+        overdraw_save(overdraw_prefix());
+    }
 }
 
 void MemoryScreen::save_to_file(const std::string& filename) const
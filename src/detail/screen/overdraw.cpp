@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/egtlog.h"
+#include "detail/screen/overdraw.h"
+#include "egt/color.h"
+#include "egt/widget.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+OverdrawAnalyzer* OverdrawAnalyzer::m_active = nullptr;
+
+static size_t surface_bpp(cairo_surface_t* surface)
+{
+    return cairo_image_surface_get_format(surface) == CAIRO_FORMAT_RGB16_565 ? 2 : 4;
+}
+
+OverdrawAnalyzer::OverdrawAnalyzer(shared_cairo_surface_t surface)
+    : m_surface(std::move(surface)),
+      m_box(0, 0,
+            cairo_image_surface_get_width(m_surface.get()),
+            cairo_image_surface_get_height(m_surface.get()))
+{
+    const auto pixels = m_box.width() * m_box.height();
+    m_previous.resize(pixels * surface_bpp(m_surface.get()));
+    m_writes.resize(pixels);
+    m_changed.resize(pixels);
+    m_total_writes.resize(pixels);
+    m_damaged.resize(pixels);
+    m_unchanged.resize(pixels);
+}
+
+void OverdrawAnalyzer::draw(cairo_t* cr, const Widget& widget, const Rect& rect)
+{
+    // only drawing that ends up on the screen surface is interesting
+    if (cairo_get_target(cr) != m_surface.get())
+        return;
+
+    double x1 = rect.x();
+    double y1 = rect.y();
+    double x2 = rect.x() + rect.width();
+    double y2 = rect.y() + rect.height();
+    cairo_user_to_device(cr, &x1, &y1);
+    cairo_user_to_device(cr, &x2, &y2);
+
+    const auto left = static_cast<int>(std::floor(std::min(x1, x2)));
+    const auto top = static_cast<int>(std::floor(std::min(y1, y2)));
+    const auto right = static_cast<int>(std::ceil(std::max(x1, x2)));
+    const auto bottom = static_cast<int>(std::ceil(std::max(y1, y2)));
+
+    const auto device = Rect::intersection(Rect(left, top, right - left, bottom - top), m_box);
+    if (device.empty())
+        return;
+
+    m_draws.push_back({widget.name(), device});
+}
+
+void OverdrawAnalyzer::frame(const Screen::DamageArray& damage)
+{
+    const auto width = static_cast<size_t>(m_box.width());
+    const auto bpp = surface_bpp(m_surface.get());
+
+    cairo_surface_flush(m_surface.get());
+    const auto data = cairo_image_surface_get_data(m_surface.get());
+    const auto stride = cairo_image_surface_get_stride(m_surface.get());
+
+    for (const auto& d : m_draws)
+    {
+        for (auto y = d.rect.y(); y < d.rect.bottom(); ++y)
+        {
+            auto writes = &m_writes[y * width + d.rect.x()];
+            for (auto x = 0; x < d.rect.width(); ++x)
+                ++writes[x];
+        }
+    }
+
+    for (const auto& rect : damage)
+    {
+        const auto r = Rect::intersection(rect, m_box);
+        if (r.empty())
+            continue;
+
+        for (auto y = r.y(); y < r.bottom(); ++y)
+        {
+            const auto row = y * width;
+            const auto current = data + y * stride;
+            const auto previous = &m_previous[row * bpp];
+
+            for (auto x = r.x(); x < r.right(); ++x)
+            {
+                const auto index = row + x;
+
+                if (std::memcmp(current + x * bpp, previous + x * bpp, bpp))
+                {
+                    m_changed[index] = 1;
+                    ++m_changed_pixels;
+                }
+                else
+                {
+                    ++m_unchanged[index];
+                }
+
+                ++m_damaged[index];
+                m_total_writes[index] += m_writes[index];
+                m_written_pixels += m_writes[index];
+                m_max_writes = std::max<uint32_t>(m_max_writes, m_writes[index]);
+            }
+
+            std::memcpy(previous + r.x() * bpp, current + r.x() * bpp, r.width() * bpp);
+        }
+
+        m_damaged_pixels += r.width() * r.height();
+    }
+
+    for (const auto& d : m_draws)
+    {
+        auto& stats = m_widgets[d.name];
+        ++stats.draws;
+        stats.pixels += d.rect.width() * d.rect.height();
+
+        for (auto y = d.rect.y(); y < d.rect.bottom(); ++y)
+        {
+            const auto row = y * width;
+            for (auto x = d.rect.x(); x < d.rect.right(); ++x)
+            {
+                if (!m_changed[row + x])
+                    ++stats.wasted;
+            }
+
+            std::fill_n(&m_writes[row + d.rect.x()], d.rect.width(), 0);
+        }
+    }
+
+    for (const auto& rect : damage)
+    {
+        const auto r = Rect::intersection(rect, m_box);
+        for (auto y = r.y(); y < r.bottom(); ++y)
+            std::fill_n(&m_changed[y * width + r.x()], r.width(), 0);
+    }
+
+    m_draws.clear();
+    ++m_frames;
+}
+
+void OverdrawAnalyzer::report(std::ostream& out) const
+{
+    const auto wasted = m_damaged_pixels - m_changed_pixels;
+
+    out << fmt::format("frames: {}\n", m_frames);
+    out << fmt::format("damaged pixels: {} ({:.0f} per frame)\n", m_damaged_pixels,
+                       m_frames ? static_cast<double>(m_damaged_pixels) / m_frames : 0.);
+    out << fmt::format("changed pixels: {}\n", m_changed_pixels);
+    out << fmt::format("wasted damage: {:.1f}%\n",
+                       m_damaged_pixels ? 100. * wasted / m_damaged_pixels : 0.);
+    out << fmt::format("average draws covering a damaged pixel: {:.2f}\n",
+                       m_damaged_pixels ? static_cast<double>(m_written_pixels) / m_damaged_pixels : 0.);
+    out << fmt::format("maximum draws covering a pixel in a frame: {}\n", m_max_writes);
+
+    std::vector<std::pair<std::string, WidgetStats>> widgets(m_widgets.begin(), m_widgets.end());
+    std::sort(widgets.begin(), widgets.end(), [](const auto & lhs, const auto & rhs)
+    {
+        return lhs.second.wasted > rhs.second.wasted;
+    });
+
+    out << fmt::format("{:<32} {:>10} {:>14} {:>14} {:>8}\n",
+                       "widget", "draws", "covered", "wasted", "wasted%");
+    for (const auto& w : widgets)
+    {
+        out << fmt::format("{:<32} {:>10} {:>14} {:>14} {:>7.1f}%\n",
+                           w.first, w.second.draws, w.second.pixels, w.second.wasted,
+                           w.second.pixels ? 100. * w.second.wasted / w.second.pixels : 0.);
+    }
+}
+
+void OverdrawAnalyzer::save(const std::string& prefix) const
+{
+#if CAIRO_HAS_PNG_FUNCTIONS == 1
+    const auto width = m_box.width();
+    const auto height = m_box.height();
+
+    auto heatmap = [&](const std::string& filename, const experimental::ColorMap & colors,
+                       const std::function<float(size_t)>& value)
+    {
+        unique_cairo_surface_t surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height));
+        const auto data = cairo_image_surface_get_data(surface.get());
+        const auto stride = cairo_image_surface_get_stride(surface.get());
+
+        for (auto y = 0; y < height; ++y)
+        {
+            auto row = reinterpret_cast<uint32_t*>(data + y * stride);
+            for (auto x = 0; x < width; ++x)
+            {
+                const auto index = y * width + x;
+                // never damaged pixels are black
+                if (!m_damaged[index])
+                    row[x] = 0xff000000;
+                else
+                    row[x] = colors.interp_cached(std::min(1.f, std::max(0.f, value(index)))).pixel32();
+            }
+        }
+
+        cairo_surface_mark_dirty(surface.get());
+        cairo_surface_write_to_png(surface.get(), filename.c_str());
+    };
+
+    // blue is drawn once, red is drawn 8 or more times
+    const experimental::ColorMap overdraw({Color(0x0000ffff), Color(0x00ff00ff),
+                                           Color(0xffff00ff), Color(0xff0000ff)});
+    heatmap(prefix + "-overdraw.png", overdraw, [this](size_t index)
+    {
+        return (static_cast<float>(m_total_writes[index]) / m_damaged[index] - 1.f) / 7.f;
+    });
+
+    // green is always changed when damaged, red never is
+    const experimental::ColorMap wasted({Color(0x00ff00ff), Color(0xffff00ff),
+                                         Color(0xff0000ff)});
+    heatmap(prefix + "-wasted.png", wasted, [this](size_t index)
+    {
+        return static_cast<float>(m_unchanged[index]) / m_damaged[index];
+    });
+#else
+    detail::ignoreparam(prefix);
+    detail::error("png support not available");
+#endif
+}
+
+}
+}
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_SCREEN_OVERDRAW_H
+#define EGT_SRC_DETAIL_SCREEN_OVERDRAW_H
+
+/**
+ * @file
+ * @brief Overdraw and damage efficiency analysis.
+ */
+
+#include "egt/geometry.h"
+#include "egt/screen.h"
+#include "egt/types.h"
+#include <cairo.h>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+class Widget;
+
+namespace detail
+{
+
+/**
+ * Estimates how many times each pixel of a screen surface is drawn by widgets
+ * each frame, and measures how much of the damage of each frame did not change
+ * any pixels.
+ *
+ * Overdraw is a rectangle coverage estimate.  Widgets report the rectangle
+ * they are asked to draw with draw(), and every pixel of it counts as drawn,
+ * whether or not the widget writes it, so a widget that only draws part of its
+ * box, like text on a transparent background, is overcounted.
+ *
+ * At the end of each frame, frame() compares the damaged pixels to the
+ * previous frame.  Any damaged pixel that is identical to the previous frame
+ * was wasted work, and it is attributed to each widget whose rectangle covered
+ * it.
+ */
+class OverdrawAnalyzer
+{
+public:
+
+    /**
+     * @param[in] surface Screen surface to analyze.
+     */
+    explicit OverdrawAnalyzer(shared_cairo_surface_t surface);
+
+    /**
+     * Record that a widget is drawing a rectangle, which counts every pixel
+     * of it as drawn.
+     *
+     * @param[in] cr Context the widget is drawn with.
+     * @param[in] widget The widget.
+     * @param[in] rect Rectangle in the user coordinates of cr.
+     */
+    void draw(cairo_t* cr, const Widget& widget, const Rect& rect);
+
+    /**
+     * Finish a frame.
+     *
+     * @param[in] damage Damage drawn this frame in screen coordinates.
+     */
+    void frame(const Screen::DamageArray& damage);
+
+    /// Write summary numbers and the most wasteful widgets.
+    void report(std::ostream& out) const;
+
+    /**
+     * Save heatmaps.
+     *
+     * Writes prefix-overdraw.png, with the average number of draw rectangles
+     * covering each pixel when damaged, and prefix-wasted.png, with the
+     * fraction of the time each pixel was damaged without changing.
+     */
+    void save(const std::string& prefix) const;
+
+    /// Get the active analyzer, if any.
+    static OverdrawAnalyzer* active() { return m_active; }
+
+    /// Set the active analyzer.
+    static void active(OverdrawAnalyzer* analyzer) { m_active = analyzer; }
+
+private:
+
+    struct WidgetStats
+    {
+        /// Number of draw() calls.
+        uint64_t draws{0};
+        /// Pixels covered by draw() rectangles.
+        uint64_t pixels{0};
+        /// Pixels covered that did not change.
+        uint64_t wasted{0};
+    };
+
+    struct Draw
+    {
+        std::string name;
+        Rect rect;
+    };
+
+    shared_cairo_surface_t m_surface;
+    Rect m_box;
+    std::vector<unsigned char> m_previous;
+
+    /// Draw rectangles covering each pixel this frame.
+    std::vector<uint16_t> m_writes;
+    /// Pixels that changed this frame.
+    std::vector<uint8_t> m_changed;
+    /// Draws this frame.
+    std::vector<Draw> m_draws;
+
+    /// Total draw rectangles covering each pixel.
+    std::vector<uint32_t> m_total_writes;
+    /// Number of frames each pixel was damaged.
+    std::vector<uint32_t> m_damaged;
+    /// Number of frames each pixel was damaged without changing.
+    std::vector<uint32_t> m_unchanged;
+
+    std::map<std::string, WidgetStats> m_widgets;
+
+    uint64_t m_frames{0};
+    uint64_t m_damaged_pixels{0};
+    uint64_t m_changed_pixels{0};
+    uint64_t m_written_pixels{0};
+    uint32_t m_max_writes{0};
+
+    static OverdrawAnalyzer* m_active;
+};
+
+}
+}
+}
+
+#endif
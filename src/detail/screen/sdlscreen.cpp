@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "detail/trace.h"
 #include "egt/app.h"
 #include "egt/detail/screen/sdlscreen.h"
 #include "egt/eventloop.h"
@@ -97,6 +98,8 @@ SDLScreen::SDLScreen(Application& app, const Size& size)
             // Rendering and event handling
             while ((SDL_PollEvent(&event) != 0))
             {
+                EGT_TRACE_SCOPE("input read");
+
                 switch (event.type)
                 {
                 case SDL_QUIT:
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "detail/trace.h"
 #include "detail/input/inputkeyboard.h"
 #include "detail/screen/keyboard_code_conversion_x.h"
 #include "detail/screen/x11wrap.h"
@@ -153,6 +154,8 @@ void X11Screen::handle_read(const asio::error_code& error)
         return;
     }
 
+    EGT_TRACE_SCOPE("input read");
+
     while (XPending(m_priv->display))
     {
         XEvent e;
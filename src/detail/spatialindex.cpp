@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "egt/detail/math.h"
+#include "egt/detail/spatialindex.h"
+#include "egt/widget.h"
+#include <algorithm>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/// Children overlapping more cells than this are not stored in cells.
+static constexpr auto MAX_CELLS_PER_CHILD = 64;
+
+void SpatialIndex::build(const ChildrenArray& children)
+{
+    if (m_valid)
+        return;
+
+    m_entries.clear();
+    m_lookup.clear();
+    m_cells.clear();
+    m_large.clear();
+
+    // size cells so a typical child overlaps a few of them
+    DefaultDim total = 0;
+    for (const auto& child : children)
+        total += std::max(child->width(), child->height());
+    if (!children.empty())
+        m_cell_size = detail::clamp<DefaultDim>(total / static_cast<DefaultDim>(children.size()), 16, 512);
+
+    m_entries.reserve(children.size());
+    m_lookup.reserve(children.size());
+    for (uint32_t index = 0; index < children.size(); ++index)
+    {
+        m_entries.push_back({children[index].get(), children[index]->box()});
+        m_lookup.emplace(children[index].get(), index);
+        insert(index);
+    }
+
+    m_valid = true;
+}
+
+void SpatialIndex::update(const Widget* widget, const Rect& box)
+{
+    if (!m_valid)
+        return;
+
+    auto i = m_lookup.find(widget);
+    if (i == m_lookup.end())
+        return;
+
+    auto& entry = m_entries[i->second];
+    if (entry.box == box)
+        return;
+
+    erase(i->second);
+    entry.box = box;
+    insert(i->second);
+}
+
+void SpatialIndex::insert(uint32_t index)
+{
+    const auto& box = m_entries[index].box;
+    const auto x1 = cell_of(box.x());
+    const auto y1 = cell_of(box.y());
+    const auto x2 = cell_of(box.right());
+    const auto y2 = cell_of(box.bottom());
+
+    if ((static_cast<int64_t>(x2) - x1 + 1) * (static_cast<int64_t>(y2) - y1 + 1) >
+        MAX_CELLS_PER_CHILD)
+    {
+        m_large.push_back(index);
+        return;
+    }
+
+    for (auto y = y1; y <= y2; ++y)
+        for (auto x = x1; x <= x2; ++x)
+            m_cells[key(x, y)].push_back(index);
+}
+
+void SpatialIndex::erase(uint32_t index)
+{
+    auto remove = [index](std::vector<uint32_t>& indexes)
+    {
+        indexes.erase(std::remove(indexes.begin(), indexes.end(), index),
+                      indexes.end());
+    };
+
+    const auto& box = m_entries[index].box;
+    const auto x1 = cell_of(box.x());
+    const auto y1 = cell_of(box.y());
+    const auto x2 = cell_of(box.right());
+    const auto y2 = cell_of(box.bottom());
+
+    if ((static_cast<int64_t>(x2) - x1 + 1) * (static_cast<int64_t>(y2) - y1 + 1) >
+        MAX_CELLS_PER_CHILD)
+    {
+        remove(m_large);
+        return;
+    }
+
+    for (auto y = y1; y <= y2; ++y)
+    {
+        for (auto x = x1; x <= x2; ++x)
+        {
+            auto cell = m_cells.find(key(x, y));
+            if (cell != m_cells.end())
+                remove(cell->second);
+        }
+    }
+}
+
+}
+}
+}
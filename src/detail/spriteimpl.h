@@ -6,8 +6,10 @@
 #ifndef EGT_SRC_DETAIL_SPRITEIMPL_H
 #define EGT_SRC_DETAIL_SPRITEIMPL_H
 
+#include "detail/frameclock.h"
 #include <egt/geometry.h>
 #include <egt/image.h>
+#include <memory>
 #include <vector>
 
 namespace egt
@@ -64,6 +66,45 @@ public:
         show_frame(index);
     }
 
+    /**
+     * Advance from the shared frame clock for a frame rate.
+     */
+    void play(unsigned fps)
+    {
+        if (!fps)
+        {
+            stop();
+            return;
+        }
+
+        if (m_clock && m_clock->fps() == fps)
+            return;
+
+        stop();
+        m_clock = FrameClock::get(fps);
+        m_clock_handle = m_clock->add([this]() { advance(); });
+    }
+
+    /**
+     * Stop advancing from the frame clock.
+     */
+    void stop()
+    {
+        if (m_clock)
+        {
+            m_clock->remove(m_clock_handle);
+            m_clock.reset();
+        }
+    }
+
+    /**
+     * Frame rate played at, or 0 if not playing.
+     */
+    unsigned fps() const
+    {
+        return m_clock ? m_clock->fps() : 0;
+    }
+
     /**
      * Returns true if the current frame is the last frame.
      */
@@ -113,7 +154,10 @@ public:
         return m_strips.size() - 1;
     }
 
-    virtual ~SpriteImpl() = default;
+    virtual ~SpriteImpl()
+    {
+        stop();
+    }
 
 protected:
 
@@ -168,6 +212,16 @@ protected:
      * The current strip being used.
      */
     uint32_t m_strip{0};
+
+    /**
+     * Frame clock advancing the sprite, if playing.
+     */
+    std::shared_ptr<FrameClock> m_clock;
+
+    /**
+     * Subscription to m_clock.
+     */
+    FrameClock::Handle m_clock_handle{0};
 };
 
 }
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_SPSCQUEUE_H
+#define EGT_SRC_DETAIL_SPSCQUEUE_H
+
+#include "egt/detail/meta.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+/**
+ * Bounded lock-free single producer, single consumer queue.
+ *
+ * One thread may call push() while another thread calls pop().  Neither call
+ * blocks or allocates.
+ *
+ * @tparam T Element type, which must be default constructible.
+ * @tparam N Capacity, which must be a power of 2.
+ */
+template<class T, size_t N>
+class SpscQueue : private NonCopyable<SpscQueue<T, N>>
+{
+    static_assert(N && (N & (N - 1)) == 0, "capacity must be a power of 2");
+
+public:
+
+    /**
+     * Add an element to the back of the queue.
+     *
+     * @return false if the queue is full.
+     */
+    bool push(T value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == N)
+            return false;
+
+        m_items[tail & (N - 1)] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove an element from the front of the queue.
+     *
+     * @return false if the queue is empty.
+     */
+    bool pop(T& value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        value = std::move(m_items[head & (N - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Check if the queue is empty.
+     *
+     * The result may be out of date as soon as it is returned, unless called
+     * by the consumer while the producer is stopped.
+     */
+    EGT_NODISCARD bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) ==
+               m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+
+    std::array<T, N> m_items{};
+
+    // keep the producer and consumer indexes on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+}
+}
+}
+
+#endif
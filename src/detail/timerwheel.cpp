@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/priorityqueue.h"
+#include "detail/timerwheel.h"
+#include "detail/trace.h"
+#include <algorithm>
+#include <limits>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+TimerWheel::TimerWheel(asio::io_context& io, PriorityQueue& queue)
+    : m_timer(io),
+      m_queue(queue),
+      m_epoch(Clock::now())
+{
+    for (auto& level : m_slots)
+        for (auto& slot : level)
+            slot.prev = slot.next = &slot;
+    m_overflow.prev = m_overflow.next = &m_overflow;
+    m_expired.prev = m_expired.next = &m_expired;
+}
+
+void TimerWheel::link(Link& list, Link& link)
+{
+    link.prev = list.prev;
+    link.next = &list;
+    list.prev->next = &link;
+    list.prev = &link;
+}
+
+void TimerWheel::unlink(Link& link)
+{
+    link.prev->next = link.next;
+    link.next->prev = link.prev;
+    link.prev = link.next = nullptr;
+}
+
+uint64_t TimerWheel::ticks(Clock::time_point time) const
+{
+    if (time <= m_epoch)
+        return 0;
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - m_epoch);
+    // round up, so timers never fire early
+    return ms.count() + (m_epoch + ms < time ? 1 : 0);
+}
+
+void TimerWheel::place(Entry& entry)
+{
+    // anything already due goes in the current slot
+    const auto deadline = std::max(entry.deadline, m_now);
+    const auto delta = deadline - m_now;
+
+    for (size_t level = 0; level < LEVELS; ++level)
+    {
+        if (delta < (1ULL << (BITS * (level + 1))))
+        {
+            link(m_slots[level][(deadline >> (BITS * level)) & MASK], entry);
+            return;
+        }
+    }
+
+    link(m_overflow, entry);
+}
+
+void TimerWheel::add(Entry& entry, Clock::time_point deadline, std::chrono::milliseconds slack)
+{
+    if (entry.linked())
+        remove(entry);
+
+    // time is only advanced while there are entries, so catch up after idling
+    if (!m_count)
+    {
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_epoch);
+        m_now = std::max<uint64_t>(m_now, now.count());
+    }
+
+    entry.deadline = ticks(deadline);
+    entry.slack = std::max<int64_t>(0, slack.count());
+    place(entry);
+    ++m_count;
+
+    // entries added while firing are taken care of after firing
+    if (!m_firing && entry.deadline + entry.slack < m_armed)
+        arm();
+}
+
+void TimerWheel::remove(Entry& entry)
+{
+    if (!entry.linked())
+        return;
+
+    unlink(entry);
+    --m_count;
+}
+
+void TimerWheel::cascade(size_t level)
+{
+    auto& slot = m_slots[level][(m_now >> (BITS * level)) & MASK];
+    while (slot.next != &slot)
+    {
+        auto& entry = static_cast<Entry&>(*slot.next);
+        unlink(entry);
+        place(entry);
+    }
+}
+
+void TimerWheel::advance(uint64_t to)
+{
+    while (m_now <= to)
+    {
+        auto index = m_now & MASK;
+        if (index == 0)
+        {
+            // refill the lower levels at the start of each block
+            size_t level = 1;
+            for (; level < LEVELS; ++level)
+            {
+                cascade(level);
+                if ((m_now >> (BITS * level)) & MASK)
+                    break;
+            }
+
+            if (level == LEVELS)
+            {
+                // walk the old overflow list while placing its entries
+                auto link = m_overflow.next;
+                m_overflow.prev = m_overflow.next = &m_overflow;
+                while (link != &m_overflow)
+                {
+                    auto next = link->next;
+                    link->prev = link->next = nullptr;
+                    place(static_cast<Entry&>(*link));
+                    link = next;
+                }
+            }
+        }
+
+        auto& slot = m_slots[0][index];
+        while (slot.next != &slot)
+        {
+            auto& entry = *slot.next;
+            unlink(entry);
+            link(m_expired, entry);
+        }
+
+        m_now = std::min(next_tick(), to + 1);
+    }
+}
+
+uint64_t TimerWheel::next_tick() const
+{
+    // overflow entries are placed at the start of each turn of the last level
+    const auto top = BITS * LEVELS;
+    auto next = m_overflow.next != &m_overflow ?
+                ((m_now >> top) + 1) << top :
+                std::numeric_limits<uint64_t>::max();
+
+    // the next slot with entries, which for higher levels is when it cascades
+    for (size_t level = 0; level < LEVELS; ++level)
+    {
+        const auto shift = BITS * level;
+        const auto position = m_now >> shift;
+        for (uint64_t i = 1; i <= SLOTS; ++i)
+        {
+            const auto& slot = m_slots[level][(position + i) & MASK];
+            if (slot.next != &slot)
+            {
+                next = std::min(next, (position + i) << shift);
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+uint64_t TimerWheel::next_wakeup() const
+{
+    auto next = std::numeric_limits<uint64_t>::max();
+
+    for (size_t level = 0; level < LEVELS; ++level)
+    {
+        const auto shift = BITS * level;
+        const auto position = m_now >> shift;
+        bool first = true;
+
+        // the current slot of higher levels holds entries a whole turn ahead,
+        // unless this is the start of a block that has not been cascaded yet
+        const size_t begin = (level && (m_now & ((1ULL << shift) - 1))) ? 1 : 0;
+        for (auto i = begin; i < begin + SLOTS; ++i)
+        {
+            const auto& slot = m_slots[level][(position + i) & MASK];
+            if (slot.next == &slot)
+                continue;
+
+            if (!first)
+            {
+                // everything here is due after the start of the slot
+                next = std::min(next, (position + i) << shift);
+                break;
+            }
+
+            first = false;
+            for (auto link = slot.next; link != &slot; link = link->next)
+            {
+                const auto& entry = static_cast<const Entry&>(*link);
+                next = std::min(next, entry.deadline + entry.slack);
+            }
+        }
+    }
+
+    for (auto link = m_overflow.next; link != &m_overflow; link = link->next)
+    {
+        const auto& entry = static_cast<const Entry&>(*link);
+        next = std::min(next, entry.deadline + entry.slack);
+    }
+
+    return next;
+}
+
+void TimerWheel::arm()
+{
+    if (!m_count)
+        return;
+
+    const auto next = std::max(next_wakeup(), m_now);
+    if (next >= m_armed)
+        return;
+
+    m_armed = next;
+    m_timer.expires_at(m_epoch + std::chrono::milliseconds(next));
+    m_timer.async_wait(m_queue.wrap(priorities::frame,
+                                    [this](const asio::error_code & error)
+    {
+        expired(error);
+    }));
+}
+
+void TimerWheel::expired(const asio::error_code& error)
+{
+    if (error)
+        return;
+
+    EGT_TRACE_SCOPE("timers");
+
+    m_armed = NOT_ARMED;
+
+    // everything due by now fires in this one wake up
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_epoch);
+    advance(now.count());
+
+    m_firing = true;
+    while (m_expired.next != &m_expired)
+    {
+        auto& entry = static_cast<Entry&>(*m_expired.next);
+        unlink(entry);
+        --m_count;
+        entry.callback();
+    }
+    m_firing = false;
+
+    arm();
+}
+
+TimerWheel::~TimerWheel() noexcept
+{
+    auto clear = [](Link & list)
+    {
+        while (list.next != &list)
+            unlink(*list.next);
+    };
+
+    for (auto& level : m_slots)
+        for (auto& slot : level)
+            clear(slot);
+    clear(m_overflow);
+    clear(m_expired);
+}
+
+}
+}
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_TIMERWHEEL_H
+#define EGT_SRC_DETAIL_TIMERWHEEL_H
+
+#include "egt/detail/inplacefunction.h"
+#include "egt/detail/meta.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <egt/asio.hpp>
+#include <limits>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+class PriorityQueue;
+
+/**
+ * Hierarchical timer wheel.
+ *
+ * All timers of the event loop are kept in one wheel, driven by a single
+ * asio::steady_timer.  Adding and cancelling a timer is O(1).
+ *
+ * Each timer has a deadline, and a slack it may fire late by.  The wheel
+ * wakes up at the latest time that is still within the slack of every
+ * timer, and fires all timers whose deadline has passed by then in that one
+ * wake up.
+ *
+ * Time is kept in ticks of one millisecond.
+ */
+class TimerWheel : private NonCopyable<TimerWheel>
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Intrusive list link.
+    struct Link
+    {
+        Link* prev{nullptr};
+        Link* next{nullptr};
+    };
+
+    /**
+     * A timer in the wheel.
+     */
+    struct Entry : Link
+    {
+        /// Deadline, in ticks.
+        uint64_t deadline{0};
+        /// Slack, in ticks.
+        uint64_t slack{0};
+        /// Called when the timer fires.
+        InplaceFunction<void()> callback;
+
+        /// Check if the entry is in the wheel.
+        EGT_NODISCARD bool linked() const { return next != nullptr; }
+    };
+
+    TimerWheel(asio::io_context& io, PriorityQueue& queue);
+
+    /**
+     * Add an entry, or move it if already added.
+     *
+     * @param[in] entry The entry.
+     * @param[in] deadline Time to fire the entry at.
+     * @param[in] slack Time the entry may fire late by.
+     */
+    void add(Entry& entry, Clock::time_point deadline, std::chrono::milliseconds slack);
+
+    /**
+     * Remove an entry, if added.
+     */
+    void remove(Entry& entry);
+
+    /**
+     * Check if there are any timers.
+     */
+    EGT_NODISCARD bool empty() const { return !m_count; }
+
+    ~TimerWheel() noexcept;
+
+private:
+
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t BITS = 6;
+    static constexpr size_t SLOTS = 1 << BITS;
+    static constexpr uint64_t MASK = SLOTS - 1;
+
+    /// Convert a time to ticks, rounding up.
+    EGT_NODISCARD uint64_t ticks(Clock::time_point time) const;
+
+    /// Put an entry in the slot for its deadline.
+    void place(Entry& entry);
+
+    /// Move the entries of a slot back into the wheel.
+    void cascade(size_t level);
+
+    /// Move all entries due by a tick to m_expired.
+    void advance(uint64_t to);
+
+    /// Next tick after m_now with a slot to expire or cascade.
+    EGT_NODISCARD uint64_t next_tick() const;
+
+    /// Earliest tick any entry must fire at.
+    EGT_NODISCARD uint64_t next_wakeup() const;
+
+    /// Arm the wake up timer if it is later than the next wake up.
+    void arm();
+
+    /// Wake up timer handler.
+    void expired(const asio::error_code& error);
+
+    static void link(Link& list, Link& link);
+    static void unlink(Link& link);
+
+    asio::steady_timer m_timer;
+    PriorityQueue& m_queue;
+    /// Time of tick zero.
+    Clock::time_point m_epoch;
+    /// Current tick.  All entries due before this have been expired.
+    uint64_t m_now{0};
+    static constexpr uint64_t NOT_ARMED = std::numeric_limits<uint64_t>::max();
+
+    /// Tick the wake up timer is armed for, or NOT_ARMED.
+    uint64_t m_armed{NOT_ARMED};
+    /// Number of entries in the wheel, including expired ones.
+    size_t m_count{0};
+    /// Set while firing expired entries.
+    bool m_firing{false};
+    std::array<std::array<Link, SLOTS>, LEVELS> m_slots;
+    /// Entries beyond the last level.
+    Link m_overflow;
+    /// Entries due, but not yet fired.
+    Link m_expired;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/egtlog.h"
+#include "detail/trace.h"
+#include "egt/latency.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+#ifdef EGT_ENABLE_TRACE
+
+/// Number of events kept per thread.
+static constexpr size_t TRACE_EVENTS = 8192;
+
+struct TraceEvent
+{
+    /// Position in the ring buffer when the event was started.
+    uint64_t sequence{0};
+    const char* name{nullptr};
+    char detail[32]{};
+    int64_t begin{0};
+    /// Zero until the event has ended.
+    std::atomic<int64_t> end{0};
+};
+
+struct TraceBuffer
+{
+    explicit TraceBuffer(uint32_t t)
+        : tid(t)
+    {}
+
+    uint32_t tid;
+    /**
+     * Held while an event is started, and while trace_dump() copies the
+     * events, so it only ever waits on a dump.
+     */
+    std::mutex lock;
+    uint64_t head{0};
+    std::array<TraceEvent, TRACE_EVENTS> events;
+};
+
+/// Copy of an ended event taken by trace_dump().
+struct TraceRecord
+{
+    uint32_t tid;
+    const char* name;
+    char detail[32];
+    int64_t begin;
+    int64_t end;
+};
+
+struct TraceRegistry
+{
+    std::mutex lock;
+    /// Buffers are kept after their threads exit so they can still be dumped.
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+};
+
+static TraceRegistry& trace_registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+static std::chrono::steady_clock::time_point trace_epoch()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+static inline int64_t trace_time(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - trace_epoch()).count();
+}
+
+static inline int64_t trace_now()
+{
+    return trace_time(std::chrono::steady_clock::now());
+}
+
+static TraceBuffer* trace_buffer() noexcept
+{
+    thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer)
+    {
+        try
+        {
+            auto& registry = trace_registry();
+            std::lock_guard<std::mutex> lock(registry.lock);
+            buffer = std::make_shared<TraceBuffer>(registry.buffers.size() + 1);
+            registry.buffers.push_back(buffer);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+    return buffer.get();
+}
+
+bool trace_enabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_TRACE") && strlen(std::getenv("EGT_TRACE")))
+        {
+            trace_epoch();
+            value += 1;
+        }
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+/// Start the next event in a buffer, which is in progress while end is zero.
+static TraceEvent& start_event(TraceBuffer& buffer, const char* name,
+                               const char* detail, size_t len,
+                               int64_t begin, int64_t end) noexcept
+{
+    std::lock_guard<std::mutex> lock(buffer.lock);
+    const auto head = buffer.head;
+    auto& event = buffer.events[head % TRACE_EVENTS];
+    event.sequence = head;
+    event.name = name;
+    len = std::min(len, sizeof(event.detail) - 1);
+    if (len)
+        std::memcpy(event.detail, detail, len);
+    event.detail[len] = '\0';
+    event.begin = begin;
+    event.end.store(end, std::memory_order_relaxed);
+    buffer.head = head + 1;
+    return event;
+}
+
+void TraceScope::begin(const char* name, const char* detail, size_t len) noexcept
+{
+    auto buffer = trace_buffer();
+    if (!buffer)
+        return;
+
+    auto& event = start_event(*buffer, name, detail, len, trace_now(), 0);
+    m_event = &event;
+    m_sequence = event.sequence;
+}
+
+void TraceScope::end() noexcept
+{
+    // the event is lost if the buffer wrapped around while it was in progress,
+    // which only this thread can do, so the sequence is not read concurrently
+    if (m_event->sequence == m_sequence)
+        m_event->end.store(trace_now(), std::memory_order_relaxed);
+}
+
+void trace_span(const char* name, const char* detail,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end) noexcept
+{
+    if (!trace_enabled())
+        return;
+
+    auto buffer = trace_buffer();
+    if (!buffer)
+        return;
+
+    // events must not end before they begin
+    const auto b = trace_time(begin);
+    start_event(*buffer, name, detail, detail ? strlen(detail) : 0,
+                b, std::max(trace_time(end), b));
+}
+
+static void json_string(std::ostream& out, const char* str)
+{
+    out << '"';
+    for (; *str; ++str)
+    {
+        const auto c = *str;
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+/// Copy the ended events of a buffer, while its thread cannot start new ones.
+static void snapshot(TraceBuffer& buffer, std::vector<TraceRecord>& records)
+{
+    std::lock_guard<std::mutex> lock(buffer.lock);
+    const auto head = buffer.head;
+    const auto count = std::min<uint64_t>(head, TRACE_EVENTS);
+    for (auto i = head - count; i < head; ++i)
+    {
+        const auto& event = buffer.events[i % TRACE_EVENTS];
+        const auto end = event.end.load(std::memory_order_relaxed);
+        // still in progress
+        if (!end)
+            continue;
+
+        TraceRecord record;
+        record.tid = buffer.tid;
+        record.name = event.name;
+        std::memcpy(record.detail, event.detail, sizeof(record.detail));
+        record.begin = event.begin;
+        record.end = end;
+        records.push_back(record);
+    }
+}
+
+void trace_dump(std::ostream& out)
+{
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        auto& registry = trace_registry();
+        std::lock_guard<std::mutex> lock(registry.lock);
+        buffers = registry.buffers;
+    }
+
+    // formatting happens after each buffer is released
+    std::vector<TraceRecord> records;
+    records.reserve(buffers.size() * TRACE_EVENTS);
+    for (auto& buffer : buffers)
+        snapshot(*buffer, records);
+
+    const auto pid = getpid();
+    bool first = true;
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& record : records)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+
+        out << "{\"ph\":\"X\",\"cat\":\"egt\",\"name\":";
+        json_string(out, record.name);
+        out << ",\"pid\":" << pid
+            << ",\"tid\":" << record.tid
+            << ",\"ts\":" << record.begin / 1000.
+            << ",\"dur\":" << (record.end - record.begin) / 1000.;
+        if (record.detail[0])
+        {
+            out << ",\"args\":{\"detail\":";
+            json_string(out, record.detail);
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n]";
+
+    if (InputLatency::count())
+    {
+        out << ",\n\"metadata\":{\"input_latency_us\":";
+        InputLatency::report_json(out);
+        out << "}";
+    }
+
+    out << "}\n";
+}
+
+#else
+
+bool trace_enabled()
+{
+    return false;
+}
+
+void TraceScope::begin(const char*, const char*, size_t) noexcept
+{}
+
+void TraceScope::end() noexcept
+{}
+
+void trace_span(const char*, const char*,
+                std::chrono::steady_clock::time_point,
+                std::chrono::steady_clock::time_point) noexcept
+{}
+
+void trace_dump(std::ostream& out)
+{
+    out << "{\"traceEvents\":[]}\n";
+}
+
+#endif
+
+void trace_dump()
+{
+    if (!trace_enabled())
+        return;
+
+    const auto filename = std::getenv("EGT_TRACE");
+    std::ofstream out(filename);
+    if (!out)
+    {
+        warn("unable to write trace to {}", filename);
+        return;
+    }
+
+    trace_dump(out);
+    EGTLOG_DEBUG("trace written to {}", filename);
+}
+
+}
+}
+}
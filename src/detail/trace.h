@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_TRACE_H
+#define EGT_SRC_DETAIL_TRACE_H
+
+/**
+ * @file
+ * @brief Per frame tracing.
+ *
+ * Tracing is only compiled in when EGT is configured with --enable-trace, and
+ * only records when the EGT_TRACE environment variable is set.  Otherwise,
+ * EGT_TRACE_SCOPE() and EGT_TRACE_SCOPE_DETAIL() expand to nothing and their
+ * arguments are not evaluated.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+struct TraceEvent;
+
+/**
+ * Returns true if trace events are being recorded.
+ */
+bool trace_enabled();
+
+/**
+ * Write all recorded trace events in Chrome trace event JSON format.
+ *
+ * The output can be loaded in chrome://tracing or https://ui.perfetto.dev.
+ */
+void trace_dump(std::ostream& out);
+
+/**
+ * Write all recorded trace events to the file named by EGT_TRACE.
+ */
+void trace_dump();
+
+/**
+ * Record a trace event with explicit begin and end times.
+ *
+ * This is for events that do not match a scope, like the latency of an input
+ * event.
+ *
+ * @param[in] name Name of the event. Must be a string literal.
+ * @param[in] detail Additional detail, which is copied, or nullptr.
+ * @param[in] begin Begin time.
+ * @param[in] end End time.
+ */
+void trace_span(const char* name, const char* detail,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end) noexcept;
+
+/**
+ * Records the time between construction and destruction as a trace event.
+ *
+ * Events are stored in a fixed size ring buffer per thread, so recording never
+ * allocates after the first event on a thread.  Each buffer has its own lock,
+ * which only waits while trace_dump() copies that buffer.  Once a buffer is
+ * full, the oldest events are overwritten.
+ */
+class TraceScope
+{
+public:
+
+    /**
+     * @param[in] name Name of the event. Must be a string literal.
+     */
+    explicit TraceScope(const char* name) noexcept
+    {
+        if (trace_enabled())
+            begin(name, nullptr, 0);
+    }
+
+    /**
+     * @param[in] name Name of the event. Must be a string literal.
+     * @param[in] detail Additional detail, like a widget name, that is copied.
+     */
+    TraceScope(const char* name, const std::string& detail) noexcept
+    {
+        if (trace_enabled())
+            begin(name, detail.data(), detail.size());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() noexcept
+    {
+        if (m_event)
+            end();
+    }
+
+private:
+
+    void begin(const char* name, const char* detail, size_t len) noexcept;
+    void end() noexcept;
+
+    TraceEvent* m_event{nullptr};
+    uint64_t m_sequence{0};
+};
+
+}
+}
+}
+
+#define EGT_TRACE_CONCAT_(a, b) a##b
+#define EGT_TRACE_CONCAT(a, b) EGT_TRACE_CONCAT_(a, b)
+
+#ifdef EGT_ENABLE_TRACE
+/// Trace the current scope.
+#define EGT_TRACE_SCOPE(event_name) \
+    egt::detail::TraceScope EGT_TRACE_CONCAT(trace_scope_, __LINE__)(event_name)
+/// Trace the current scope, with additional detail.
+#define EGT_TRACE_SCOPE_DETAIL(event_name, event_detail) \
+    egt::detail::TraceScope EGT_TRACE_CONCAT(trace_scope_, __LINE__)(event_name, event_detail)
+#else
+#define EGT_TRACE_SCOPE(event_name)
+#define EGT_TRACE_SCOPE_DETAIL(event_name, event_detail)
+#endif
+
+#endif
@@ -14,6 +14,7 @@
 #include "egt/types.h"
 #include "egt/uri.h"
 #include <string>
+#include <utility>
 
 #ifdef HAVE_LIBPLANES
 #include "egt/detail/screen/kmsoverlay.h"
@@ -58,8 +59,24 @@ GstAppSinkImpl::GstAppSinkImpl(VideoWindow& interface, const Size& size)
 void GstAppSinkImpl::draw(Painter& painter, const Rect& rect)
 {
     ignoreparam(rect);
+
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_sample_mutex);
+        if (m_pending_sample)
+        {
+            if (m_videosample)
+                gst_sample_unref(m_videosample);
+            m_videosample = m_pending_sample;
+            m_pending_sample = nullptr;
+        }
+        std::swap(dropped, m_dropped);
+    }
+    m_renderer.dropped(dropped);
+
     /*
-     * its a Basic window copying buffer to Cairo surface.
+     * its a Basic window converting and scaling the buffer into the damaged
+     * part of the composition surface.
      */
     if (m_videosample)
     {
@@ -70,41 +87,26 @@ void GstAppSinkImpl::draw(Painter& painter, const Rect& rect)
         gst_structure_get_int(capsStruct, "width", &width);
         gst_structure_get_int(capsStruct, "height", &height);
 
-        gst_sample_ref(m_videosample);
+        YuvRenderer::Format format;
+        if (!YuvRenderer::format(gst_structure_get_string(capsStruct, "format"), format))
+        {
+            EGTLOG_DEBUG("unsupported video format");
+            return;
+        }
+
         GstBuffer* buffer = gst_sample_get_buffer(m_videosample);
         if (buffer)
         {
             GstMapInfo map;
             if (gst_buffer_map(buffer, &map, GST_MAP_READ))
             {
-                auto box = m_interface.box();
-                auto surface = unique_cairo_surface_t(
-                                   cairo_image_surface_create_for_data(map.data,
-                                           CAIRO_FORMAT_RGB16_565,
-                                           width,
-                                           height,
-                                           cairo_format_stride_for_width(CAIRO_FORMAT_RGB16_565, width)));
-
-                if (cairo_surface_status(surface.get()) == CAIRO_STATUS_SUCCESS)
-                {
-                    auto cr = painter.context().get();
-                    if (width != box.width() || height != box.height())
-                    {
-                        double scalex = static_cast<double>(box.width()) / width;
-                        double scaley = static_cast<double>(box.height()) / height;
-                        cairo_scale(cr, scalex, scaley);
-                    }
-                    cairo_set_source_surface(cr, surface.get(), box.x(), box.y());
-                    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-                    cairo_paint(cr);
-                }
+                m_renderer.draw(painter, m_interface.box(), format,
+                                Size(width, height), map.data, map.size);
 
                 m_position = GST_BUFFER_TIMESTAMP(buffer);
                 gst_buffer_unmap(buffer, &map);
             }
         }
-        gst_sample_unref(m_videosample);
-
     }
 }
 
@@ -138,14 +140,22 @@ GstFlowReturn GstAppSinkImpl::on_new_buffer(GstElement* elt, gpointer data)
         else
 #endif
         {
-            if (Application::check_instance())
             {
-                asio::post(Application::instance().event().io(), [impl, sample]()
+                std::lock_guard<std::mutex> lock(impl->m_sample_mutex);
+
+                // a sample that was not drawn before the next one is late
+                if (impl->m_pending_sample)
                 {
-                    if (impl->m_videosample)
-                        gst_sample_unref(impl->m_videosample);
+                    gst_sample_unref(impl->m_pending_sample);
+                    ++impl->m_dropped;
+                }
+                impl->m_pending_sample = sample;
+            }
 
-                    impl->m_videosample = sample;
+            if (Application::check_instance())
+            {
+                Application::instance().event().call_async(impl, [impl]()
+                {
                     impl->m_interface.damage();
                 });
             }
@@ -157,7 +167,7 @@ GstFlowReturn GstAppSinkImpl::on_new_buffer(GstElement* elt, gpointer data)
 
 std::string GstAppSinkImpl::create_pipeline()
 {
-    std::string vc = " ! videoconvert ! video/x-raw,format=";
+    std::string vc;
 #ifdef HAVE_LIBPLANES
     if (m_interface.plane_window())
     {
@@ -166,12 +176,20 @@ std::string GstAppSinkImpl::create_pipeline()
         PixelFormat fmt = detail::egt_format(s->get_plane_format());
         EGTLOG_DEBUG("egt_format = {}", fmt);
 
-        vc += detail::gstreamer_format(fmt);
+        vc = fmt::format("videoscale ! video/x-raw,width={},height={} ! "
+                         "videoconvert ! video/x-raw,format={}",
+                         m_size.width(), m_size.height(),
+                         detail::gstreamer_format(fmt));
     }
     else
 #endif
     {
-        vc += "RGB16";
+        /*
+         * Converted and scaled in draw().  videoconvert passes buffers through
+         * when the decoder already gives one of these formats.
+         */
+        vc = fmt::format("videoconvert ! video/x-raw,format={}",
+                         YuvRenderer::caps_formats);
     }
 
     std::string a_pipe;
@@ -184,10 +202,10 @@ std::string GstAppSinkImpl::create_pipeline()
 
     static constexpr auto pipeline =
         "uridecodebin uri={} expose-all-streams=false name=video " \
-        " {} video. ! queue ! videoscale ! video/x-raw,width={},height={} {} " \
+        " {} video. ! queue ! {} " \
         " ! appsink name=appsink video. {} ";
 
-    return fmt::format(pipeline, m_uri, caps, m_size.width(), m_size.height(), vc, a_pipe);
+    return fmt::format(pipeline, m_uri, caps, vc, a_pipe);
 }
 
 /* This function takes a textual representation of a pipeline
@@ -250,6 +268,9 @@ bool GstAppSinkImpl::media(const std::string& uri)
 
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
         g_object_set(G_OBJECT(m_appsink), "emit-signals", TRUE, "sync", TRUE, nullptr);
+        // let decoders skip frames that would be late, and never queue frames
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+        g_object_set(G_OBJECT(m_appsink), "qos", TRUE, "max-buffers", 1, "drop", TRUE, nullptr);
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
         g_signal_connect(m_appsink, "new-sample", G_CALLBACK(on_new_buffer), this);
 
@@ -273,6 +294,21 @@ void GstAppSinkImpl::scale(float scalex, float scaley)
     m_interface.resize(Size(m_size.width() * scalex, m_size.height() * scaley));
 }
 
+GstAppSinkImpl::~GstAppSinkImpl() noexcept
+{
+    // stop streaming before releasing the samples
+    destroyPipeline();
+
+    // a damage posted by on_new_buffer() may not have run yet
+    if (Application::check_instance())
+        Application::instance().event().cancel_async(this);
+
+    if (m_pending_sample)
+        gst_sample_unref(m_pending_sample);
+    if (m_videosample)
+        gst_sample_unref(m_videosample);
+}
+
 gboolean GstAppSinkImpl::post_position(gpointer data)
 {
     auto impl = static_cast<GstAppSinkImpl*>(data);
@@ -7,7 +7,9 @@
 #define EGT_SRC_DETAIL_VIDEO_GSTAPPSINKIMPL_H
 
 #include "detail/video/gstdecoderimpl.h"
+#include "detail/video/yuvrenderer.h"
 #include <gst/app/gstappsink.h>
+#include <mutex>
 #include <string>
 
 namespace egt
@@ -30,11 +32,24 @@ public:
 
     void scale(float scalex, float scaley) override;
 
+    ~GstAppSinkImpl() noexcept override;
+
 protected:
     GstElement* m_appsink;
 
+    /// Sample drawn.
     GstSample* m_videosample{nullptr};
 
+    /// Latest sample not drawn yet, protected by m_sample_mutex.
+    GstSample* m_pending_sample{nullptr};
+
+    /// Samples replaced before they were drawn, protected by m_sample_mutex.
+    size_t m_dropped{0};
+
+    std::mutex m_sample_mutex;
+
+    YuvRenderer m_renderer;
+
     static GstFlowReturn on_new_buffer(GstElement* elt, gpointer data);
 
     static gboolean post_position(gpointer data);
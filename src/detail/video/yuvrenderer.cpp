@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/blit.h"
+#include "detail/egtlog.h"
+#include "detail/video/yuvrenderer.h"
+#include "egt/detail/math.h"
+#include "egt/painter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace detail
+{
+
+constexpr const char* YuvRenderer::caps_formats;
+
+static inline bool time_video_enabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_TIME_VIDEO"))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+bool YuvRenderer::format(const char* name, Format& format)
+{
+    if (!name)
+        return false;
+
+    if (!strcmp(name, "I420"))
+        format = Format::i420;
+    else if (!strcmp(name, "NV12"))
+        format = Format::nv12;
+    else if (!strcmp(name, "YUY2"))
+        format = Format::yuy2;
+    else
+        return false;
+
+    return true;
+}
+
+static inline size_t round_up(size_t value, size_t n)
+{
+    return (value + n - 1) & ~(n - 1);
+}
+
+/*
+ * Strides and plane offsets follow gst_video_info_set_format().
+ */
+bool YuvRenderer::layout(Format format, const Size& size, const uint8_t* data,
+                         size_t length, Source& src)
+{
+    if (size.empty())
+        return false;
+
+    const auto width = static_cast<size_t>(size.width());
+    const auto height = static_cast<size_t>(size.height());
+
+    src.size = size;
+
+    size_t needed = 0;
+    switch (format)
+    {
+    case Format::i420:
+    {
+        src.ystride = round_up(width, 4);
+        src.cstride = round_up(round_up(width, 2) / 2, 4);
+        const auto uoffset = src.ystride * round_up(height, 2);
+        const auto voffset = uoffset + src.cstride * (round_up(height, 2) / 2);
+        src.y = data;
+        src.u = data + uoffset;
+        src.v = data + voffset;
+        src.ystep = 1;
+        src.cstep = 1;
+        src.cshift = 1;
+        needed = voffset + src.cstride * (round_up(height, 2) / 2);
+        break;
+    }
+    case Format::nv12:
+    {
+        src.ystride = round_up(width, 4);
+        src.cstride = src.ystride;
+        const auto offset = src.ystride * round_up(height, 2);
+        src.y = data;
+        src.u = data + offset;
+        src.v = data + offset + 1;
+        src.ystep = 1;
+        src.cstep = 2;
+        src.cshift = 1;
+        needed = offset + src.cstride * (round_up(height, 2) / 2);
+        break;
+    }
+    case Format::yuy2:
+    {
+        // y0 u y1 v
+        src.ystride = round_up(width * 2, 4);
+        src.cstride = src.ystride;
+        src.y = data;
+        src.u = data + 1;
+        src.v = data + 3;
+        src.ystep = 2;
+        src.cstep = 4;
+        src.cshift = 0;
+        needed = src.ystride * height;
+        break;
+    }
+    }
+
+    return length >= needed;
+}
+
+bool YuvRenderer::draw(Painter& painter, const Rect& box, Format format,
+                       const Size& size, const uint8_t* data, size_t length)
+{
+    Source src{};
+    if (!layout(format, size, data, length, src))
+    {
+        EGTLOG_DEBUG("video frame of {} bytes is too short for {}", length, size);
+        return false;
+    }
+
+    if (box.empty())
+        return true;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (!draw_target(painter, box, src))
+        draw_surface(painter, box, src);
+
+    report(std::chrono::steady_clock::now() - start);
+
+    return true;
+}
+
+bool YuvRenderer::draw_target(Painter& painter, const Rect& box, const Source& src)
+{
+    // a recording painter has nothing to write to
+    if (painter.recording())
+        return false;
+
+    auto cr = painter.context().get();
+    auto target = cairo_get_group_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE)
+        return false;
+
+    bool rgb565;
+    size_t bpp;
+    switch (cairo_image_surface_get_format(target))
+    {
+    case CAIRO_FORMAT_ARGB32:
+    case CAIRO_FORMAT_RGB24:
+        rgb565 = false;
+        bpp = 4;
+        break;
+    case CAIRO_FORMAT_RGB16_565:
+        rgb565 = true;
+        bpp = 2;
+        break;
+    default:
+        return false;
+    }
+
+    // only a whole pixel translation maps the box to target pixels
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    double ox;
+    double oy;
+    cairo_surface_get_device_offset(target, &ox, &oy);
+    const auto dx = matrix.x0 + ox;
+    const auto dy = matrix.y0 + oy;
+    if (!detail::float_equal(matrix.xx, 1.0) ||
+        !detail::float_equal(matrix.yy, 1.0) ||
+        !detail::float_equal(matrix.xy, 0.0) ||
+        !detail::float_equal(matrix.yx, 0.0) ||
+        !detail::float_equal(dx, std::round(dx)) ||
+        !detail::float_equal(dy, std::round(dy)))
+        return false;
+
+    // fails when the clip is not made of whole pixel rectangles
+    std::unique_ptr<cairo_rectangle_list_t, decltype(&cairo_rectangle_list_destroy)>
+    rects(cairo_copy_clip_rectangle_list(cr), cairo_rectangle_list_destroy);
+    if (rects->status != CAIRO_STATUS_SUCCESS)
+        return false;
+
+    const Point offset(static_cast<int>(std::round(dx)), static_cast<int>(std::round(dy)));
+    const Rect bounds(0, 0,
+                      cairo_image_surface_get_width(target),
+                      cairo_image_surface_get_height(target));
+
+    cairo_surface_flush(target);
+
+    auto data = cairo_image_surface_get_data(target);
+    const auto stride = static_cast<size_t>(cairo_image_surface_get_stride(target));
+
+    for (auto i = 0; i < rects->num_rectangles; ++i)
+    {
+        const auto& r = rects->rectangles[i];
+        const Rect clip(static_cast<int>(std::round(r.x)),
+                        static_cast<int>(std::round(r.y)),
+                        static_cast<int>(std::round(r.width)),
+                        static_cast<int>(std::round(r.height)));
+
+        // pixels of the target to write
+        const auto dst = Rect::intersection(Rect::intersection(clip, box) + offset, bounds);
+        if (dst.empty())
+            continue;
+
+        convert(src, box.size(), dst - offset - box.point(),
+                data + dst.y() * stride + dst.x() * bpp, stride, rgb565);
+
+        cairo_surface_mark_dirty_rectangle(target,
+                                           dst.x() - ox, dst.y() - oy,
+                                           dst.width(), dst.height());
+    }
+
+    return true;
+}
+
+void YuvRenderer::draw_surface(Painter& painter, const Rect& box, const Source& src)
+{
+    if (!m_surface ||
+        cairo_image_surface_get_width(m_surface.get()) != box.width() ||
+        cairo_image_surface_get_height(m_surface.get()) != box.height())
+    {
+        m_surface.reset(cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+                        box.width(), box.height()));
+    }
+
+    if (cairo_surface_status(m_surface.get()) != CAIRO_STATUS_SUCCESS)
+        return;
+
+    cairo_surface_flush(m_surface.get());
+    convert(src, box.size(), Rect(Point(), box.size()),
+            cairo_image_surface_get_data(m_surface.get()),
+            cairo_image_surface_get_stride(m_surface.get()), false);
+    cairo_surface_mark_dirty(m_surface.get());
+
+    Painter::AutoSaveRestore sr(painter);
+
+    auto cr = painter.context().get();
+    cairo_set_source_surface(cr, m_surface.get(), box.x(), box.y());
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_rectangle(cr, box.x(), box.y(), box.width(), box.height());
+    cairo_fill(cr);
+}
+
+void YuvRenderer::convert(const Source& src, const Size& scaled, const Rect& region,
+                          uint8_t* dst, size_t stride, bool rgb565)
+{
+    const auto count = static_cast<size_t>(region.width());
+    const auto bpp = rgb565 ? 2 : 4;
+    const int64_t width = src.size.width();
+    const int64_t height = src.size.height();
+    const int64_t x0 = region.x();
+    const int64_t y0 = region.y();
+
+    // nearest source column for the center of each destination column
+    m_luma.resize(count);
+    m_chroma.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto x = static_cast<uint32_t>(((2 * (x0 + static_cast<int64_t>(i)) + 1) * width) /
+                                             (2 * scaled.width()));
+        m_luma[i] = x * src.ystep;
+        m_chroma[i] = (x / 2) * src.cstep;
+    }
+
+    // luma rows can be used as is when not scaled horizontally
+    const bool direct = width == scaled.width() && src.ystep == 1;
+
+    m_line.resize(count * 3);
+    auto ly = m_line.data();
+    auto lu = ly + count;
+    auto lv = lu + count;
+
+    int64_t last = -1;
+    for (auto j = 0; j < region.height(); ++j, dst += stride)
+    {
+        const auto y = ((2 * (y0 + j) + 1) * height) / (2 * scaled.height());
+
+        // scaling up repeats rows
+        if (y == last)
+        {
+            memcpy(dst, dst - stride, count * bpp);
+            continue;
+        }
+        last = y;
+
+        const auto yrow = src.y + y * src.ystride;
+        const auto crow = (y >> src.cshift) * src.cstride;
+        const auto urow = src.u + crow;
+        const auto vrow = src.v + crow;
+
+        const uint8_t* py = ly;
+        if (direct)
+            py = yrow + region.x();
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+                ly[i] = yrow[m_luma[i]];
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            lu[i] = urow[m_chroma[i]];
+            lv[i] = vrow[m_chroma[i]];
+        }
+
+        if (rgb565)
+            yuv16(reinterpret_cast<uint16_t*>(dst), py, lu, lv, count);
+        else
+            yuv32(reinterpret_cast<uint32_t*>(dst), py, lu, lv, count);
+    }
+}
+
+void YuvRenderer::report(std::chrono::steady_clock::duration elapsed)
+{
+    if (!time_video_enabled())
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (m_report == std::chrono::steady_clock::time_point{})
+        m_report = now;
+
+    ++m_conversions;
+    m_total += elapsed;
+    m_max = std::max(m_max, elapsed);
+
+    if (now - m_report < std::chrono::seconds(1))
+        return;
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    fmt::print("video: {} conversions, {} dropped, convert avg {} us, max {} us\n",
+               m_conversions, m_dropped,
+               duration_cast<microseconds>(m_total).count() / m_conversions,
+               duration_cast<microseconds>(m_max).count());
+
+    m_conversions = 0;
+    m_dropped = 0;
+    m_total = {};
+    m_max = {};
+    m_report = now;
+}
+
+}
+}
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef EGT_SRC_DETAIL_VIDEO_YUVRENDERER_H
+#define EGT_SRC_DETAIL_VIDEO_YUVRENDERER_H
+
+#include "egt/geometry.h"
+#include "egt/types.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+class Painter;
+
+namespace detail
+{
+
+/**
+ * Draws YUV video frames, converting and scaling them on the CPU.
+ *
+ * This replaces videoconvert and videoscale in an appsink pipeline.  When the
+ * painter targets an image surface with only a translation, the frame is
+ * converted straight into the clipped part of the target, so only damaged
+ * pixels are converted and nothing is composited.  Otherwise, the frame is
+ * converted into a surface that is painted with cairo.
+ *
+ * Scaling is nearest neighbor.  Frames must have the default GStreamer layout,
+ * which is what an appsink receives since it does not accept video meta.
+ *
+ * When the EGT_TIME_VIDEO environment variable is non-empty, conversion times
+ * and dropped frames are printed every second.
+ */
+class YuvRenderer
+{
+public:
+
+    /// Supported frame formats.
+    enum class Format
+    {
+        i420,
+        nv12,
+        yuy2,
+    };
+
+    /// GStreamer caps format field for the supported formats.
+    static constexpr const char* caps_formats = "(string){I420,NV12,YUY2}";
+
+    /**
+     * Get the format for a GStreamer format name.
+     *
+     * @return false if the format is not supported.
+     */
+    static bool format(const char* name, Format& format);
+
+    /**
+     * Draw a frame scaled to a box.
+     *
+     * @param[in] painter Painter to draw with.
+     * @param[in] box Box to draw the frame in.
+     * @param[in] format Format of the frame.
+     * @param[in] size Size of the frame.
+     * @param[in] data Frame data.
+     * @param[in] length Length of the frame data.
+     * @return false if the data is too short for the frame.
+     */
+    bool draw(Painter& painter, const Rect& box, Format format,
+              const Size& size, const uint8_t* data, size_t length);
+
+    /**
+     * Count frames replaced by a newer one before they were drawn.
+     */
+    void dropped(size_t frames) { m_dropped += frames; }
+
+private:
+
+    /// Planes of a frame, with their sampling.
+    struct Source
+    {
+        Size size;
+        const uint8_t* y;
+        const uint8_t* u;
+        const uint8_t* v;
+        size_t ystride;
+        size_t cstride;
+        /// Bytes between luma samples.
+        size_t ystep;
+        /// Bytes between chroma samples, each covering two pixels.
+        size_t cstep;
+        /// Chroma rows are shared by this power of two of rows.
+        size_t cshift;
+    };
+
+    static bool layout(Format format, const Size& size, const uint8_t* data,
+                       size_t length, Source& src);
+
+    bool draw_target(Painter& painter, const Rect& box, const Source& src);
+
+    void draw_surface(Painter& painter, const Rect& box, const Source& src);
+
+    /**
+     * Convert part of a frame scaled to a size.
+     *
+     * @param[in] src The frame.
+     * @param[in] scaled Size the frame is scaled to.
+     * @param[in] region Part of the scaled frame to convert.
+     * @param[in] dst First destination pixel of the region.
+     * @param[in] stride Destination stride.
+     * @param[in] rgb565 Convert to RGB565 instead of ARGB32.
+     */
+    void convert(const Source& src, const Size& scaled, const Rect& region,
+                 uint8_t* dst, size_t stride, bool rgb565);
+
+    void report(std::chrono::steady_clock::duration elapsed);
+
+    /// Source byte offsets of luma and chroma for each converted column.
+    std::vector<uint32_t> m_luma;
+    std::vector<uint32_t> m_chroma;
+    /// Sampled y, u and v for one row.
+    std::vector<uint8_t> m_line;
+
+    /// Surface used when the target cannot be written to directly.
+    unique_cairo_surface_t m_surface;
+
+    size_t m_conversions{0};
+    size_t m_dropped{0};
+    std::chrono::steady_clock::duration m_total{};
+    std::chrono::steady_clock::duration m_max{};
+    std::chrono::steady_clock::time_point m_report{};
+};
+
+}
+}
+}
+
+#endif
@@ -3,14 +3,21 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "detail/asyncqueue.h"
 #include "detail/dump.h"
 #include "detail/egtlog.h"
+#include "detail/input/inputthread.h"
 #include "detail/priorityqueue.h"
+#include "detail/timerwheel.h"
+#include "detail/trace.h"
 #include "egt/app.h"
+#include "egt/detail/math.h"
 #include "egt/eventloop.h"
+#include "egt/input.h"
 #include "egt/tools.h"
 #include "egt/widget.h"
 #include "egt/window.h"
+#include <algorithm>
 #include <cstdlib>
 #include <egt/asio.hpp>
 #include <numeric>
@@ -25,6 +32,33 @@ struct EventLoop::EventLoopImpl
     asio::io_context m_io;
     asio::executor_work_guard<asio::io_context::executor_type> m_work{egt::asio::make_work_guard(m_io)};
     detail::PriorityQueue m_queue;
+    detail::TimerWheel m_timers{m_io, m_queue};
+    detail::AsyncQueue m_async{m_io};
+    std::unique_ptr<detail::InputThread> m_input_thread;
+
+    struct IdleTaskEntry
+    {
+        EventLoop::IdleTaskHandle handle;
+        int priority;
+        EventLoop::IdleTask task;
+        /// Last turn the task was run on.
+        uint64_t turn;
+    };
+
+    std::vector<IdleTaskEntry> m_tasks;
+    EventLoop::IdleTaskHandle m_task_handle{0};
+    /// Task currently running, or 0.
+    EventLoop::IdleTaskHandle m_running_task{0};
+    /// Set when the running task is cancelled.
+    bool m_running_cancelled{false};
+    uint64_t m_turn{0};
+
+    /// Start of the current idle capacity window.
+    std::chrono::steady_clock::time_point m_window_start{std::chrono::steady_clock::now()};
+    /// Time spent idle in the current window.
+    std::chrono::steady_clock::duration m_window_idle{};
+    /// Idle capacity of the last complete window.
+    float m_idle_capacity{1.0f};
 };
 
 EventLoop::EventLoop(Application& app) noexcept
@@ -37,6 +71,37 @@ asio::io_context& EventLoop::io()
     return m_impl->m_io;
 }
 
+static inline bool input_thread_enabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_INPUT_THREAD"))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+asio::io_context& EventLoop::input_io()
+{
+    if (!input_thread_enabled())
+        return io();
+
+    if (!m_impl->m_input_thread)
+        m_impl->m_input_thread = std::make_unique<detail::InputThread>(io());
+
+    m_impl->m_input_thread->start();
+    return m_impl->m_input_thread->io();
+}
+
+void EventLoop::stop_input_thread()
+{
+    if (m_impl->m_input_thread)
+        m_impl->m_input_thread->stop();
+}
+
 static inline bool time_event_loop_enabled()
 {
     static int value = 0;
@@ -50,34 +115,69 @@ static inline bool time_event_loop_enabled()
     return value == 1;
 }
 
-// maximum number of handlers when in a tight poll loop
-static const auto MAX_POLL_COUNT = 10;
+int EventLoop::dispatch(std::chrono::steady_clock::time_point deadline)
+{
+    int ret = 0;
+
+    // run ready handlers, which queue prioritized handlers instead of running
+    // them, until nothing else is ready
+    //
+    // libinput async_read will always return something on poll_one() until we
+    // have satisfied the handler, so this has to give up at the deadline
+    while (std::chrono::steady_clock::now() < deadline && m_impl->m_io.poll_one())
+        ret++;
+
+    ret += m_impl->m_queue.execute(deadline);
+
+    return ret;
+}
 
 int EventLoop::wait()
 {
     int ret = 0;
+    std::chrono::steady_clock::duration idle{};
 
-    detail::code_timer(time_event_loop_enabled(), "wait: ", [this, &ret]()
+    detail::code_timer(time_event_loop_enabled(), "wait: ", [this, &ret, &idle]()
     {
-        ret = m_impl->m_io.run_one_for(std::chrono::milliseconds(100));
-        if (ret)
+        // don't block while handlers deferred from the last frame are queued,
+        // or while there are idle tasks to run
+        if (m_impl->m_queue.empty())
+        {
+            if (m_impl->m_tasks.empty())
+            {
+                const auto start = std::chrono::steady_clock::now();
+                // timers wake the io_context up themselves, so without idle
+                // callbacks to poll there is no reason to wake up periodically
+                if (m_idle.empty())
+                    ret = m_impl->m_io.run_one();
+                else
+                    ret = m_impl->m_io.run_one_for(std::chrono::milliseconds(100));
+                idle += std::chrono::steady_clock::now() - start;
+            }
+            else
+            {
+                ret = m_impl->m_io.poll_one();
+            }
+        }
+
+        if (ret || !m_impl->m_queue.empty())
         {
-            // hmm, libinput async_read will always return something on poll_one()
-            // until we have satisfied the handler, so we have to give up at
-            // some point
-            int count = MAX_POLL_COUNT;
-            while (m_impl->m_io.poll_one() && count--)
-            {}
-
-#ifdef USE_PRIORITY_QUEUE
-            m_impl->m_queue.execute_all();
-#endif
+            EGT_TRACE_SCOPE("handlers");
+
+            ret += dispatch(std::chrono::steady_clock::now() + m_budget);
         }
     });
 
     if (!ret)
     {
-        if (!m_idle.empty())
+        const auto start = std::chrono::steady_clock::now();
+        if (invoke_idle_tasks())
+        {
+            idle += std::chrono::steady_clock::now() - start;
+            // let anything the tasks changed be drawn
+            ret = 1;
+        }
+        else if (!m_idle.empty())
         {
             invoke_idle_callbacks();
             // fake out that we did something in the idle callback
@@ -85,6 +185,8 @@ int EventLoop::wait()
         }
     }
 
+    idle_time(idle);
+
     return ret;
 }
 
@@ -94,8 +196,64 @@ void EventLoop::quit()
     m_impl->m_io.stop();
 }
 
+static inline bool sync_layout_enabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_SYNC_LAYOUT"))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+bool EventLoop::defer_layout()
+{
+    // requests made during the layout pass are handled immediately
+    if (!m_defer_layout || m_in_layout)
+        return false;
+
+    m_layout_pending = true;
+    return true;
+}
+
+void EventLoop::layout()
+{
+    if (!m_layout_pending)
+        return;
+
+    EGT_TRACE_SCOPE("layout pass");
+
+    m_layout_pending = false;
+    m_in_layout = true;
+    auto reset = detail::on_scope_exit([this]() { m_in_layout = false; });
+
+    // windows may be created by layout, so don't use iterators
+    const auto& windows = m_app.windows();
+    for (size_t i = 0; i < windows.size(); ++i)
+    {
+        // layout starts at top level frames and plane frames, the rest are
+        // reached through their parents
+        if (!windows[i]->parent())
+            windows[i]->pending_layout();
+    }
+}
+
 void EventLoop::draw()
 {
+    EGT_TRACE_SCOPE("frame");
+
+    // deliver queued input, calls from other threads, and coalesced pointer
+    // motion before this frame is laid out
+    if (m_impl->m_input_thread)
+        m_impl->m_input_thread->drain();
+    m_impl->m_async.drain();
+    Input::flush_all();
+
+    layout();
+
     detail::code_timer(time_event_loop_enabled(), "draw: ", [this]()
     {
         for (auto& w : m_app.windows())
@@ -112,17 +270,30 @@ void EventLoop::draw()
 
 int EventLoop::poll()
 {
-    int ret = 0;
-    int count = MAX_POLL_COUNT;
-    while (m_impl->m_io.poll_one() && count--)
-    {
-        ret++;
-    }
-    return ret;
+    return dispatch(std::chrono::steady_clock::now() + m_budget);
+}
+
+void EventLoop::post(Priority priority, std::function<void()> handler)
+{
+    m_impl->m_queue.add(priority, std::move(handler));
+}
+
+void EventLoop::post_async(const void* key, AsyncCall&& call)
+{
+    m_impl->m_async.post(key, std::move(call));
+}
+
+void EventLoop::cancel_async(const void* key)
+{
+    m_impl->m_async.cancel(key);
 }
 
 int EventLoop::step()
 {
+    auto defer = m_defer_layout;
+    m_defer_layout = !sync_layout_enabled();
+    auto reset = detail::on_scope_exit([this, defer]() { m_defer_layout = defer; });
+
     auto ret = poll();
     if (ret)
         draw();
@@ -147,6 +318,10 @@ int EventLoop::run()
 {
     experimental::FramesPerSecond fps;
 
+    auto defer = m_defer_layout;
+    m_defer_layout = !sync_layout_enabled();
+    auto reset = detail::on_scope_exit([this, defer]() { m_defer_layout = defer; });
+
     // initial draw
     draw();
 
@@ -170,6 +345,9 @@ int EventLoop::run()
         }
     }
 
+    // leave geometry up to date for code after the event loop
+    layout();
+
     EGTLOG_TRACE("EventLoop::run() exiting");
 
     return 0;
@@ -186,11 +364,116 @@ void EventLoop::invoke_idle_callbacks()
         i();
 }
 
+EventLoop::IdleTaskHandle EventLoop::add_idle_task(IdleTask task, int priority)
+{
+    const auto handle = ++m_impl->m_task_handle;
+    m_impl->m_tasks.push_back({handle, priority, std::move(task), 0});
+    return handle;
+}
+
+void EventLoop::cancel_idle_task(IdleTaskHandle handle)
+{
+    if (handle == m_impl->m_running_task)
+    {
+        // removed when it returns
+        m_impl->m_running_cancelled = true;
+        return;
+    }
+
+    auto& tasks = m_impl->m_tasks;
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                               [handle](const EventLoopImpl::IdleTaskEntry & entry)
+    {
+        return entry.handle == handle;
+    }), tasks.end());
+}
+
+bool EventLoop::invoke_idle_tasks()
+{
+    auto& tasks = m_impl->m_tasks;
+    if (tasks.empty())
+        return false;
+
+    EGT_TRACE_SCOPE("idle tasks");
+
+    const auto deadline = std::chrono::steady_clock::now() + m_idle_slice;
+
+    while (!tasks.empty() && std::chrono::steady_clock::now() < deadline)
+    {
+        // highest priority first, and the one that waited longest of those
+        auto next = std::min_element(tasks.begin(), tasks.end(),
+                                     [](const EventLoopImpl::IdleTaskEntry & a,
+                                        const EventLoopImpl::IdleTaskEntry & b)
+        {
+            if (a.priority != b.priority)
+                return a.priority > b.priority;
+            return a.turn < b.turn;
+        });
+
+        next->turn = ++m_impl->m_turn;
+        m_impl->m_running_task = next->handle;
+        m_impl->m_running_cancelled = false;
+
+        // the task may add or cancel tasks, so don't hold on to the entry
+        auto task = std::move(next->task);
+        bool more = true;
+        while (more && !m_impl->m_running_cancelled &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            more = task(deadline);
+        }
+
+        const auto handle = m_impl->m_running_task;
+        m_impl->m_running_task = 0;
+
+        auto entry = std::find_if(tasks.begin(), tasks.end(),
+                                  [handle](const EventLoopImpl::IdleTaskEntry & entry)
+        {
+            return entry.handle == handle;
+        });
+
+        if (!more || m_impl->m_running_cancelled)
+            tasks.erase(entry);
+        else
+            entry->task = std::move(task);
+    }
+
+    return true;
+}
+
+void EventLoop::idle_time(std::chrono::steady_clock::duration idle)
+{
+    static constexpr auto WINDOW = std::chrono::seconds(1);
+
+    m_impl->m_window_idle += idle;
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = now - m_impl->m_window_start;
+    if (elapsed >= WINDOW)
+    {
+        m_impl->m_idle_capacity =
+            detail::clamp(std::chrono::duration<float>(m_impl->m_window_idle).count() /
+                          std::chrono::duration<float>(elapsed).count(), 0.f, 1.f);
+        m_impl->m_window_start = now;
+        m_impl->m_window_idle = {};
+    }
+}
+
+float EventLoop::idle_capacity() const
+{
+    return m_impl->m_idle_capacity;
+}
+
 detail::PriorityQueue& EventLoop::queue()
 {
     return m_impl->m_queue;
 }
 
+detail::TimerWheel& EventLoop::timer_wheel()
+{
+    return m_impl->m_timers;
+}
+
 EventLoop::~EventLoop() noexcept = default;
 
 }
@@ -5,6 +5,9 @@
  */
 #include "detail/egtlog.h"
 #include "detail/dump.h"
+#include "detail/latency.h"
+#include "detail/screen/overdraw.h"
+#include "detail/trace.h"
 #include "egt/detail/layout.h"
 #include "egt/detail/math.h"
 #include "egt/frame.h"
@@ -39,7 +42,9 @@ void Frame::add(const std::shared_ptr<Widget>& widget)
 
     widget->set_parent(this);
     m_children.emplace_back(widget);
-    layout();
+    if (m_spatial_index)
+        m_spatial_index->invalidate();
+    request_layout();
 }
 
 bool Frame::is_child(Widget* widget) const
@@ -69,10 +74,13 @@ void Frame::remove(Widget* widget)
     if (i != m_children.end())
     {
         // note order here - damage and then unset parent
+        (*i)->m_display_list_stale = true;
         (*i)->damage();
         (*i)->m_parent = nullptr;
         m_children.erase(i);
-        layout();
+        if (m_spatial_index)
+            m_spatial_index->invalidate();
+        request_layout();
     }
     else if (widget->m_parent == this)
     {
@@ -85,17 +93,20 @@ void Frame::remove_all_basic()
     for (auto& i : m_children)
     {
         // note order here - damage and then unset parent
+        i->m_display_list_stale = true;
         i->damage();
         i->m_parent = nullptr;
     }
 
+    if (m_spatial_index)
+        m_spatial_index->invalidate();
     m_children.clear();
 }
 
 void Frame::remove_all()
 {
     remove_all_basic();
-    layout();
+    request_layout();
 }
 
 void Frame::handle(Event& event)
@@ -119,17 +130,9 @@ void Frame::handle(Event& event)
     {
         auto pos = display_to_local(event.pointer().point);
 
-        for (auto& child : detail::reverse_iterate(m_children))
-        {
-            if (!child->can_handle_event())
-                continue;
-
-            if (child->box().intersect(pos))
-            {
-                child->handle(event);
-                break;
-            }
-        }
+        auto child = child_at(pos, true);
+        if (child)
+            child->handle(event);
 
         break;
     }
@@ -160,20 +163,18 @@ Widget* Frame::hit_test(const DisplayPoint& point)
 {
     Point pos = display_to_local(point);
 
-    for (auto& child : detail::reverse_iterate(m_children))
+    auto child = child_at(pos, false);
+    if (child)
     {
-        if (child->box().intersect(pos))
+        if (child->frame())
         {
-            if (child->frame())
-            {
-                auto frame = dynamic_cast<Frame*>(child.get());
-                if (frame)
-                    return frame->hit_test(point);
-            }
-            else
-            {
-                return child.get();
-            }
+            auto frame = dynamic_cast<Frame*>(child);
+            if (frame)
+                return frame->hit_test(point);
+        }
+        else
+        {
+            return child;
         }
     }
 
@@ -183,6 +184,39 @@ Widget* Frame::hit_test(const DisplayPoint& point)
     return nullptr;
 }
 
+Widget* Frame::child_at(const Point& pos, bool events)
+{
+    if (m_spatial_index)
+    {
+        return m_spatial_index->find(m_children, pos, [events](const Widget * child)
+        {
+            return !events || child->can_handle_event();
+        });
+    }
+
+    for (auto& child : detail::reverse_iterate(m_children))
+    {
+        if (events && !child->can_handle_event())
+            continue;
+
+        if (child->box().intersect(pos))
+            return child.get();
+    }
+
+    return nullptr;
+}
+
+void Frame::spatial_index(bool enable)
+{
+    if (enable == spatial_index())
+        return;
+
+    if (enable)
+        m_spatial_index = std::make_unique<detail::SpatialIndex>();
+    else
+        m_spatial_index.reset();
+}
+
 void Frame::add_damage(const Rect& rect)
 {
     // if we get here, we must have a screen
@@ -193,6 +227,8 @@ void Frame::add_damage(const Rect& rect)
     if (egt_unlikely(rect.empty()))
         return;
 
+    detail::latency_damage(screen());
+
     // not allowed to damage() in draw()
     assert(!m_in_draw);
     if (m_in_draw)
@@ -260,6 +296,8 @@ void Frame::zorder_down(const Widget* widget)
     if (i != m_children.end() && i != m_children.begin())
     {
         auto to = std::prev(i);
+        (*i)->m_display_list_stale = true;
+        (*to)->m_display_list_stale = true;
         (*i)->damage();
         (*to)->damage();
         std::iter_swap(i, to);
@@ -278,10 +316,14 @@ void Frame::zorder_up(const Widget* widget)
         auto to = std::next(i);
         if (to != m_children.end())
         {
+            (*i)->m_display_list_stale = true;
+            (*to)->m_display_list_stale = true;
             (*i)->damage();
             (*to)->damage();
             std::iter_swap(i, to);
-            layout();
+            if (m_spatial_index)
+                m_spatial_index->invalidate();
+            request_layout();
         }
     }
 }
@@ -299,7 +341,9 @@ void Frame::zorder_bottom(const Widget* widget)
     if (i != m_children.end() && i != m_children.begin())
     {
         std::rotate(m_children.begin(), i, i + 1);
-        layout();
+        if (m_spatial_index)
+            m_spatial_index->invalidate();
+        request_layout();
     }
 }
 
@@ -316,7 +360,9 @@ void Frame::zorder_top(const Widget* widget)
     if (i != m_children.end())
     {
         std::rotate(i, i + 1, m_children.end());
-        layout();
+        if (m_spatial_index)
+            m_spatial_index->invalidate();
+        request_layout();
     }
 }
 
@@ -439,6 +485,28 @@ void Frame::draw_child(Painter& painter, const Rect& crect, Widget* child)
         if (r.empty())
             return;
 
+        EGT_TRACE_SCOPE_DETAIL("draw", child->name());
+
+        auto overdraw = detail::OverdrawAnalyzer::active();
+        if (egt_unlikely(overdraw != nullptr))
+            overdraw->draw(painter.context().get(), *child, r);
+
+        // only build the timer prefix when timing is enabled
+        auto draw = [child, &painter, &r]()
+        {
+            if (egt_unlikely(time_child_draw_enabled()))
+            {
+                detail::code_timer(true, child->name() + " draw: ", [child, &painter, &r]()
+                {
+                    child->draw_recorded(painter, r);
+                });
+            }
+            else
+            {
+                child->draw_recorded(painter, r);
+            }
+        };
+
         if (detail::float_equal(child->alpha(), 1.f))
         {
             Painter::AutoSaveRestore sr2(painter);
@@ -451,10 +519,7 @@ void Frame::draw_child(Painter& painter, const Rect& crect, Widget* child)
                 painter.clip();
             }
 
-            detail::code_timer(time_child_draw_enabled(), child->name() + " draw: ", [child, &painter, &r]()
-            {
-                child->draw(painter, r);
-            });
+            draw();
         }
         else
         {
@@ -469,10 +534,7 @@ void Frame::draw_child(Painter& painter, const Rect& crect, Widget* child)
                     painter.clip();
                 }
 
-                detail::code_timer(time_child_draw_enabled(), child->name() + " draw: ", [child, &painter, &r]()
-                {
-                    child->draw(painter, r);
-                });
+                draw();
             }
 
             // we pushed a group for the child to draw into it, now paint that
@@ -516,11 +578,30 @@ void Frame::paint_children_to_file()
     }
 }
 
+void Frame::pending_layout()
+{
+    if (m_layout_pending)
+    {
+        // layout() of a frame lays out all of its children too
+        m_layout_pending = false;
+        m_child_layout_pending = false;
+        layout();
+    }
+    else if (m_child_layout_pending)
+    {
+        m_child_layout_pending = false;
+        for (auto& child : m_children)
+            child->pending_layout();
+    }
+}
+
 void Frame::layout()
 {
     if (!visible())
         return;
 
+    EGT_TRACE_SCOPE_DETAIL("layout", name());
+
     // we cannot layout with no space
     if (size().empty())
         return;
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "detail/trace.h"
 #include "egt/detail/alignment.h"
 #include "egt/detail/enum.h"
 #include "egt/grid.h"
@@ -342,6 +343,8 @@ void StaticGrid::layout()
     if (!visible())
         return;
 
+    EGT_TRACE_SCOPE_DETAIL("layout", name());
+
     // we cannot layout with no space
     if (size().empty())
         return;
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/blit.h"
+#include "egt/detail/math.h"
+#include "egt/heatmap.h"
+#include "egt/painter.h"
+#include <algorithm>
+
+namespace egt
+{
+inline namespace v1
+{
+namespace experimental
+{
+
+HeatMap::HeatMap(const Rect& rect)
+    : Widget(rect)
+{
+    name("HeatMap" + std::to_string(m_widgetid));
+
+    colormap(ColorMap({Palette::blue, Palette::cyan, Palette::green,
+                       Palette::yellow, Palette::red}));
+}
+
+HeatMap::HeatMap(Frame& parent, const Rect& rect)
+    : HeatMap(rect)
+{
+    parent.add(*this);
+}
+
+void HeatMap::colormap(const ColorMap& colormap)
+{
+    if (colormap.empty())
+        return;
+
+    for (size_t i = 0; i < m_lut.size(); ++i)
+    {
+        const auto color = colormap.interp(i / static_cast<float>(m_lut.size() - 1));
+        const auto a = color.alpha();
+        const auto premultiply = [a](uint32_t c) { return (c * a + 127) / 255; };
+
+        m_lut[i] = (a << 24u) |
+                   (premultiply(color.red()) << 16u) |
+                   (premultiply(color.green()) << 8u) |
+                   premultiply(color.blue());
+    }
+
+    remap();
+}
+
+void HeatMap::range(float min, float max)
+{
+    if (min > max)
+        std::swap(min, max);
+
+    if (detail::float_equal(min, m_min) && detail::float_equal(max, m_max))
+        return;
+
+    m_min = min;
+    m_max = max;
+    remap();
+}
+
+void HeatMap::data(const float* values, size_t width, size_t height)
+{
+    if (!width || !height)
+    {
+        m_values.clear();
+        m_width = m_height = 0;
+        m_surface.reset();
+        damage();
+        return;
+    }
+
+    m_values.assign(values, values + width * height);
+
+    if (!m_surface || width != m_width || height != m_height)
+    {
+        m_width = width;
+        m_height = height;
+        m_surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                        m_width, m_height));
+    }
+
+    remap();
+}
+
+void HeatMap::remap()
+{
+    if (!m_surface)
+        return;
+
+    const auto range = m_max - m_min;
+    const auto scale = range > 0.f ? (m_lut.size() - 1) / range : 0.f;
+
+    cairo_surface_flush(m_surface.get());
+    auto data = cairo_image_surface_get_data(m_surface.get());
+    const auto stride = cairo_image_surface_get_stride(m_surface.get());
+    for (size_t y = 0; y < m_height; ++y)
+    {
+        detail::colormap32(reinterpret_cast<uint32_t*>(data + y * stride),
+                           m_values.data() + y * m_width, m_width,
+                           m_min, scale, m_lut.data());
+    }
+    cairo_surface_mark_dirty(m_surface.get());
+
+    damage();
+}
+
+void HeatMap::draw(Painter& painter, const Rect&)
+{
+    Painter::AutoSaveRestore sr(painter);
+
+    draw_box(painter, Palette::ColorId::bg, Palette::ColorId::border);
+
+    const auto b = content_area();
+    if (!m_surface || b.empty())
+        return;
+
+    auto cr = painter.context().get();
+    cairo_translate(cr, b.x(), b.y());
+    cairo_scale(cr, b.width() / static_cast<double>(m_width),
+                b.height() / static_cast<double>(m_height));
+    cairo_set_source_surface(cr, m_surface.get(), 0, 0);
+
+    auto pattern = cairo_get_source(cr);
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_PAD);
+    cairo_pattern_set_filter(pattern, m_bilinear ? CAIRO_FILTER_BILINEAR : CAIRO_FILTER_NEAREST);
+
+    cairo_rectangle(cr, 0, 0, m_width, m_height);
+    cairo_fill(cr);
+}
+
+}
+}
+}
@@ -5,9 +5,16 @@
  */
 #include "egt/app.h"
 #include "detail/egtlog.h"
+#include "detail/input/inputthread.h"
+#include "detail/input/pointerfilter.h"
+#include "detail/latency.h"
+#include "detail/trace.h"
 #include "egt/input.h"
 #include "egt/window.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <egt/detail/mousegesture.h>
 
 namespace egt
@@ -15,13 +22,92 @@ namespace egt
 inline namespace v1
 {
 
+static inline bool input_coalesce_enabled()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_INPUT_COALESCE"))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+static Input::Filter default_filter()
+{
+    Input::Filter filter;
+
+    if (std::getenv("EGT_TOUCH_FILTER") && strlen(std::getenv("EGT_TOUCH_FILTER")))
+        filter.enabled = true;
+
+    if (std::getenv("EGT_TOUCH_PREDICT") && strlen(std::getenv("EGT_TOUCH_PREDICT")))
+        filter.prediction = std::chrono::milliseconds(std::strtol(std::getenv("EGT_TOUCH_PREDICT"), nullptr, 10));
+
+    return filter;
+}
+
+/// All inputs, for flush_all().
+static std::vector<Input*>& all_inputs()
+{
+    static std::vector<Input*> inputs;
+    return inputs;
+}
+
 Input::Input()
-    : m_mouse(std::make_unique<detail::MouseGesture>())
+    : m_mouse(std::make_unique<detail::MouseGesture>()),
+      m_coalesce(input_coalesce_enabled())
 {
     m_mouse->on_async_event([this](Event & event)
     {
         dispatch(event);
     });
+
+    filter(default_filter());
+
+    all_inputs().push_back(this);
+}
+
+void Input::filter(const Filter& filter)
+{
+    m_filter = filter;
+
+    if (m_filter.enabled || m_filter.prediction.count() > 0)
+    {
+        if (!m_pointer_filter)
+            m_pointer_filter = std::make_unique<detail::PointerFilter>();
+    }
+    else
+    {
+        m_pointer_filter.reset();
+    }
+}
+
+void Input::coalesce(bool enable)
+{
+    if (!enable)
+        flush();
+    m_coalesce = enable;
+}
+
+void Input::flush()
+{
+    if (m_pending.id() == EventId::none)
+        return;
+
+    auto event = m_pending;
+    m_pending = Event();
+
+    auto reset = detail::on_scope_exit([this]() { m_history.clear(); });
+    event.history(m_history.data(), m_history.size());
+    dispatch_now(event);
+}
+
+void Input::flush_all()
+{
+    for (auto& input : all_inputs())
+        input->flush();
 }
 
 template<class Callable>
@@ -47,6 +133,55 @@ static bool handler_dispatch(Event& event, Event& eevent,
  * not to drop events (like pointer up) when correcting.
  */
 void Input::dispatch(Event& event)
+{
+    if (event.timestamp() == Event::Timestamp())
+        event.timestamp(std::chrono::steady_clock::now());
+
+    // hand off to the event loop thread, which calls back in here
+    if (auto thread = detail::InputThread::current())
+    {
+        thread->push(this, event);
+        return;
+    }
+
+    if (m_pointer_filter)
+    {
+        switch (event.id())
+        {
+        case EventId::raw_pointer_down:
+        case EventId::raw_pointer_up:
+        case EventId::raw_pointer_move:
+            m_pointer_filter->filter(event, m_filter);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (m_coalesce && event.id() == EventId::raw_pointer_move)
+    {
+        if (m_pending.id() != EventId::none)
+        {
+            if (m_pending.pointer().slot == event.pointer().slot)
+            {
+                m_history.push_back(m_pending.pointer().point);
+                m_pending = event;
+                return;
+            }
+
+            flush();
+        }
+
+        m_pending = event;
+        return;
+    }
+
+    // anything else is dispatched in order after pending motion
+    flush();
+    dispatch_now(event);
+}
+
+void Input::dispatch_now(Event& event)
 {
     // can't support recursive calls into the same dispatch function
     // one potential solution would be to asio::post() the call to dispatch if
@@ -54,7 +189,21 @@ void Input::dispatch(Event& event)
     assert(!m_dispatching);
 
     m_dispatching = true;
-    auto reset = detail::on_scope_exit([this]() { m_dispatching = false; });
+    detail::latency_dispatch_begin(event);
+    auto reset = detail::on_scope_exit([this]()
+    {
+        detail::latency_dispatch_end();
+        m_dispatching = false;
+    });
+
+    EGT_TRACE_SCOPE("dispatch");
+
+    if (m_pointer_filter && m_filter.prediction.count() > 0 &&
+        event.id() == EventId::raw_pointer_move)
+    {
+        m_pointer_filter->predict(event, std::chrono::steady_clock::now() + m_filter.prediction,
+                                  m_filter);
+    }
 
     if (event.id() == EventId::raw_pointer_down)
     {
@@ -63,6 +212,8 @@ void Input::dispatch(Event& event)
     }
 
     auto eevent = m_mouse->handle(event);
+    if (eevent.id() == EventId::pointer_drag && event.history_size())
+        eevent.history(&event.history(0), event.history_size());
 
     EGTLOG_TRACE("input event: {}", event);
     if (eevent.id() != EventId::none)
@@ -165,10 +316,37 @@ void Input::dispatch(Event& event)
     }
 }
 
-Input::Input(Input&&) noexcept = default;
-Input& Input::operator=(Input&&) noexcept = default;
+Input::Input(Input&& rhs) noexcept
+    : m_mouse(std::move(rhs.m_mouse)),
+      m_dispatching(rhs.m_dispatching),
+      m_coalesce(rhs.m_coalesce),
+      m_pending(rhs.m_pending),
+      m_history(std::move(rhs.m_history)),
+      m_filter(rhs.m_filter),
+      m_pointer_filter(std::move(rhs.m_pointer_filter))
+{
+    rhs.m_pending = Event();
+    all_inputs().push_back(this);
+}
 
-Input::~Input() noexcept = default;
+Input& Input::operator=(Input&& rhs) noexcept
+{
+    m_mouse = std::move(rhs.m_mouse);
+    m_dispatching = rhs.m_dispatching;
+    m_coalesce = rhs.m_coalesce;
+    m_pending = rhs.m_pending;
+    m_history = std::move(rhs.m_history);
+    m_filter = rhs.m_filter;
+    m_pointer_filter = std::move(rhs.m_pointer_filter);
+    rhs.m_pending = Event();
+    return *this;
+}
+
+Input::~Input() noexcept
+{
+    auto& inputs = all_inputs();
+    inputs.erase(std::remove(inputs.begin(), inputs.end(), this), inputs.end());
+}
 
 Object Input::m_global_handler;
 
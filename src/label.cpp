@@ -74,7 +74,7 @@ void Label::default_draw(Label& widget, Painter& painter, const Rect&)
 void Label::set_parent(Frame* parent)
 {
     TextWidget::set_parent(parent);
-    layout();
+    request_layout();
 }
 
 Size Label::min_size_hint() const
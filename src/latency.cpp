@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/egtlog.h"
+#include "detail/latency.h"
+#include "detail/trace.h"
+#include "egt/latency.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace egt
+{
+inline namespace v1
+{
+
+namespace
+{
+
+/**
+ * Histogram of microsecond values with buckets that grow by 5%.
+ */
+class Histogram
+{
+public:
+
+    void add(double us)
+    {
+        ++m_buckets[bucket(us)];
+        ++m_count;
+        m_max = std::max(m_max, us);
+    }
+
+    EGT_NODISCARD double percentile(double p) const
+    {
+        if (!m_count)
+            return 0;
+
+        const auto target = std::max<uint64_t>(1, std::ceil(m_count * p / 100.));
+        uint64_t total = 0;
+        for (size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            total += m_buckets[i];
+            if (total >= target)
+                return std::min(value(i), m_max);
+        }
+        return m_max;
+    }
+
+    EGT_NODISCARD double max() const { return m_max; }
+
+private:
+
+    static constexpr double GROWTH = 1.05;
+    static constexpr size_t BUCKETS = 400;
+
+    static size_t bucket(double us)
+    {
+        if (us < 1.)
+            return 0;
+        return std::min<size_t>(BUCKETS - 1,
+                                1 + static_cast<size_t>(std::log(us) / std::log(GROWTH)));
+    }
+
+    /// Middle of a bucket.
+    static double value(size_t bucket)
+    {
+        if (bucket == 0)
+            return 0.5;
+        return std::pow(GROWTH, bucket - 0.5);
+    }
+
+    std::array<uint64_t, BUCKETS> m_buckets{};
+    uint64_t m_count{0};
+    double m_max{0};
+};
+
+/// An input event waiting for its damage to be flipped.
+struct PendingEvent
+{
+    /// Screen the event damaged.
+    const Screen* screen;
+    Event::Timestamp input;
+    Event::Timestamp dispatch;
+    Event::Timestamp damage;
+    bool drawn;
+    Event::Timestamp draw_end;
+};
+
+/// Maximum number of events measured per frame.
+constexpr size_t MAX_PENDING = 256;
+
+struct LatencyState
+{
+    bool enabled{false};
+    uint64_t count{0};
+    std::array<Histogram, InputLatency::STAGES> histograms;
+
+    bool dispatching{false};
+    Event::Timestamp input;
+    Event::Timestamp dispatch;
+
+    /// Screens damaged by the event being dispatched, with the first damage.
+    std::vector<std::pair<const Screen*, Event::Timestamp>> damaged;
+
+    std::vector<PendingEvent> pending;
+};
+
+bool input_latency_env()
+{
+    static int value = 0;
+    if (value == 0)
+    {
+        if (std::getenv("EGT_INPUT_LATENCY") && strlen(std::getenv("EGT_INPUT_LATENCY")))
+            value += 1;
+        else
+            value -= 1;
+    }
+    return value == 1;
+}
+
+LatencyState& state()
+{
+    static LatencyState s = []()
+    {
+        LatencyState state;
+        state.enabled = input_latency_env();
+        return state;
+    }();
+    return s;
+}
+
+inline double elapsed_us(Event::Timestamp begin, Event::Timestamp end)
+{
+    return std::max(0., std::chrono::duration<double, std::micro>(end - begin).count());
+}
+
+}
+
+void InputLatency::enable(bool enable)
+{
+    auto& s = state();
+    s.enabled = enable;
+    s.dispatching = false;
+    s.pending.clear();
+}
+
+bool InputLatency::enabled()
+{
+    return state().enabled;
+}
+
+uint64_t InputLatency::count()
+{
+    return state().count;
+}
+
+double InputLatency::percentile(Stage stage, double percentile)
+{
+    return state().histograms[static_cast<size_t>(stage)].percentile(percentile);
+}
+
+double InputLatency::max(Stage stage)
+{
+    return state().histograms[static_cast<size_t>(stage)].max();
+}
+
+void InputLatency::reset()
+{
+    auto& s = state();
+    s.count = 0;
+    s.histograms = {};
+}
+
+template<>
+const std::pair<InputLatency::Stage, char const*> detail::EnumStrings<InputLatency::Stage>::data[] =
+{
+    {InputLatency::Stage::queue, "queue"},
+    {InputLatency::Stage::handle, "handle"},
+    {InputLatency::Stage::draw, "draw"},
+    {InputLatency::Stage::flip, "flip"},
+    {InputLatency::Stage::total, "total"},
+};
+
+static constexpr std::array<InputLatency::Stage, InputLatency::STAGES> stages =
+{
+    InputLatency::Stage::queue,
+    InputLatency::Stage::handle,
+    InputLatency::Stage::draw,
+    InputLatency::Stage::flip,
+    InputLatency::Stage::total,
+};
+
+void InputLatency::report(std::ostream& out)
+{
+    out << fmt::format("input latency of {} events (us)\n", count());
+    out << fmt::format("{:<8} {:>10} {:>10} {:>10} {:>10}\n", "stage", "p50", "p90", "p99", "max");
+    for (auto stage : stages)
+    {
+        out << fmt::format("{:<8} {:>10.0f} {:>10.0f} {:>10.0f} {:>10.0f}\n",
+                           detail::enum_to_string(stage),
+                           percentile(stage, 50), percentile(stage, 90),
+                           percentile(stage, 99), max(stage));
+    }
+}
+
+void InputLatency::report_json(std::ostream& out)
+{
+    out << fmt::format("{{\"count\":{}", count());
+    for (auto stage : stages)
+    {
+        out << fmt::format(",\"{}\":{{\"p50\":{:.1f},\"p90\":{:.1f},\"p99\":{:.1f},\"max\":{:.1f}}}",
+                           detail::enum_to_string(stage),
+                           percentile(stage, 50), percentile(stage, 90),
+                           percentile(stage, 99), max(stage));
+    }
+    out << "}";
+}
+
+std::ostream& operator<<(std::ostream& os, const InputLatency::Stage& stage)
+{
+    return os << detail::enum_to_string(stage);
+}
+
+namespace detail
+{
+
+void latency_dispatch_begin(const Event& event)
+{
+    auto& s = state();
+    if (!s.enabled)
+        return;
+
+    s.dispatching = true;
+    s.damaged.clear();
+    s.input = event.timestamp();
+    s.dispatch = std::chrono::steady_clock::now();
+}
+
+void latency_dispatch_end()
+{
+    auto& s = state();
+    if (!s.dispatching)
+        return;
+
+    s.dispatching = false;
+    for (const auto& damaged : s.damaged)
+    {
+        if (s.pending.size() >= MAX_PENDING)
+            break;
+
+        s.pending.push_back({damaged.first, s.input, s.dispatch, damaged.second,
+                             false, {}});
+    }
+}
+
+void latency_damage(const Screen* screen)
+{
+    auto& s = state();
+    if (!s.dispatching)
+        return;
+
+    for (const auto& damaged : s.damaged)
+        if (damaged.first == screen)
+            return;
+
+    s.damaged.emplace_back(screen, std::chrono::steady_clock::now());
+}
+
+void latency_draw_end(const Screen* screen)
+{
+    auto& s = state();
+    if (s.pending.empty())
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& event : s.pending)
+    {
+        if (event.screen == screen && !event.drawn)
+        {
+            event.drawn = true;
+            event.draw_end = now;
+        }
+    }
+}
+
+void latency_flip(const Screen* screen)
+{
+    auto& s = state();
+    if (s.pending.empty())
+        return;
+
+    const auto flip = std::chrono::steady_clock::now();
+
+    // only events whose damage was drawn to this screen are done
+    auto done = std::stable_partition(s.pending.begin(), s.pending.end(),
+                                      [screen](const PendingEvent & event)
+    {
+        return event.screen != screen || !event.drawn;
+    });
+
+    for (auto event = done; event != s.pending.end(); ++event)
+    {
+        s.histograms[static_cast<size_t>(InputLatency::Stage::queue)].add(elapsed_us(event->input, event->dispatch));
+        s.histograms[static_cast<size_t>(InputLatency::Stage::handle)].add(elapsed_us(event->dispatch, event->damage));
+        s.histograms[static_cast<size_t>(InputLatency::Stage::draw)].add(elapsed_us(event->damage, event->draw_end));
+        s.histograms[static_cast<size_t>(InputLatency::Stage::flip)].add(elapsed_us(event->draw_end, flip));
+        s.histograms[static_cast<size_t>(InputLatency::Stage::total)].add(elapsed_us(event->input, flip));
+        ++s.count;
+
+        trace_span("input latency", "queue", event->input, event->dispatch);
+        trace_span("input latency", "handle", event->dispatch, event->damage);
+        trace_span("input latency", "draw", event->damage, event->draw_end);
+        trace_span("input latency", "flip", event->draw_end, flip);
+    }
+
+    s.pending.erase(done, s.pending.end());
+}
+
+}
+
+}
+}
@@ -64,7 +64,7 @@ void Notebook::add(const std::shared_ptr<Widget>& widget)
         widget->hide();
     }
 
-    layout();
+    request_layout();
 }
 
 void Notebook::remove(Widget* widget)
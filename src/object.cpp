@@ -4,32 +4,47 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "egt/object.h"
+#include <algorithm>
 
 namespace egt
 {
 inline namespace v1
 {
 
-Object::RegisterHandle Object::on_event(const EventCallback& handler,
+Object::RegisterHandle Object::on_event(EventCallback handler,
                                         const FilterFlags& mask)
 {
     if (handler)
     {
         // TODO: m_handle_counter can wrap, making the handle non-unique
         auto handle = ++m_handle_counter;
-        m_callbacks->emplace_back(handler, mask, handle);
+        m_callbacks.emplace_back(std::move(handler), mask, handle);
+        update_handled();
         return handle;
     }
 
     return 0;
 }
 
+void Object::update_handled()
+{
+    m_handled.clear();
+    for (const auto& callback : m_callbacks)
+    {
+        // an empty mask handles everything
+        if (callback.mask.empty())
+            m_handled.raw() = ~FilterFlags::Underlying{};
+        else
+            m_handled.raw() |= callback.mask.raw();
+    }
+}
+
 void Object::invoke_handlers(Event& event)
 {
-    if (!m_callbacks)
+    if (!m_handled.is_set(event.id()))
         return;
 
-    for (auto& callback : *m_callbacks)
+    for (auto& callback : m_callbacks)
     {
         if (callback.mask.empty() ||
             callback.mask.is_set(event.id()))
@@ -49,25 +64,23 @@ void Object::invoke_handlers(EventId event)
 
 void Object::clear_handlers()
 {
-    if (!m_callbacks)
-        return;
-
-    m_callbacks->clear();
+    m_callbacks.clear();
+    m_handled.clear();
 }
 
 void Object::remove_handler(RegisterHandle handle)
 {
-    if (!m_callbacks)
-        return;
-
-    const auto i = std::find_if(m_callbacks->begin(), m_callbacks->end(),
+    const auto i = std::find_if(m_callbacks.begin(), m_callbacks.end(),
                                 [handle](const CallbackMeta & meta)
     {
         return meta.handle == handle;
     });
 
-    if (i != m_callbacks->end())
-        m_callbacks->erase(i);
+    if (i != m_callbacks.end())
+    {
+        m_callbacks.erase(i);
+        update_handled();
+    }
 }
 
 }
@@ -3,10 +3,19 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "detail/blit.h"
+#include "egt/detail/displaylist.h"
+#include "egt/detail/math.h"
+#include "egt/fixedvector.h"
 #include "egt/image.h"
 #include "egt/painter.h"
 #include <cairo.h>
-#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace egt
 {
@@ -18,24 +27,58 @@ Painter::Painter(shared_cairo_t cr) noexcept
 {
 }
 
+/*
+ * A recording painter still needs a context to track the path, current point
+ * and font for measuring text. Everything drawn to it is clipped away.
+ */
+static shared_cairo_t recording_context()
+{
+    static const shared_cairo_surface_t surface(
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1),
+        cairo_surface_destroy);
+
+    shared_cairo_t cr(cairo_create(surface.get()), cairo_destroy);
+    cairo_rectangle(cr.get(), 0, 0, 0, 0);
+    cairo_clip(cr.get());
+    return cr;
+}
+
+Painter::Painter(detail::DisplayList& list)
+    : m_cr(recording_context()),
+      m_list(&list)
+{
+}
+
 void Painter::save()
 {
     cairo_save(m_cr.get());
+
+    if (m_list)
+        m_list->state(m_cr.get(), detail::DisplayList::Type::save);
 }
 
 void Painter::restore()
 {
     cairo_restore(m_cr.get());
+
+    if (m_list)
+        m_list->state(m_cr.get(), detail::DisplayList::Type::restore);
 }
 
 void Painter::push_group()
 {
     cairo_push_group(m_cr.get());
+
+    if (m_list)
+        m_list->state(m_cr.get(), detail::DisplayList::Type::push_group);
 }
 
 void Painter::pop_group()
 {
     cairo_pop_group_to_source(m_cr.get());
+
+    if (m_list)
+        m_list->state(m_cr.get(), detail::DisplayList::Type::pop_group);
 }
 
 Painter& Painter::set(const Pattern& pattern)
@@ -57,6 +100,238 @@ Painter& Painter::line_width(float width)
     return *this;
 }
 
+namespace
+{
+
+/*
+ * An image surface that can be drawn to directly, without cairo.
+ */
+struct DirectTarget
+{
+    cairo_surface_t* surface{nullptr};
+    unsigned char* data{nullptr};
+    int stride{0};
+    cairo_format_t format{CAIRO_FORMAT_INVALID};
+    /// User space to device space translation.
+    Point origin;
+    /// Clip rectangles in device space.
+    FixedVector<Rect, 8> clip;
+};
+
+}
+
+static inline bool is_integer(double value)
+{
+    return detail::float_equal(value, std::round(value));
+}
+
+static inline int bytes_per_pixel(cairo_format_t format)
+{
+    return format == CAIRO_FORMAT_RGB16_565 ? 2 : 4;
+}
+
+/*
+ * Check if the painter can be drawn to directly, which requires an image
+ * surface in a supported format, an integer translation only transform, and a
+ * clip that is a list of integer rectangles.
+ */
+static bool direct_target(cairo_t* cr, DirectTarget& target)
+{
+    auto surface = cairo_get_target(cr);
+
+    // cairo_push_group() redirects drawing to an intermediate surface
+    if (cairo_get_group_target(cr) != surface ||
+        cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE)
+        return false;
+
+    const auto format = cairo_image_surface_get_format(surface);
+    if (format != CAIRO_FORMAT_ARGB32 &&
+        format != CAIRO_FORMAT_RGB24 &&
+        format != CAIRO_FORMAT_RGB16_565)
+        return false;
+
+    double ox;
+    double oy;
+    cairo_surface_get_device_offset(surface, &ox, &oy);
+    if (!detail::float_equal(ox, 0.0) || !detail::float_equal(oy, 0.0))
+        return false;
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (!detail::float_equal(matrix.xx, 1.0) ||
+        !detail::float_equal(matrix.yy, 1.0) ||
+        !detail::float_equal(matrix.xy, 0.0) ||
+        !detail::float_equal(matrix.yx, 0.0) ||
+        !is_integer(matrix.x0) ||
+        !is_integer(matrix.y0))
+        return false;
+
+    std::unique_ptr<cairo_rectangle_list_t, decltype(&cairo_rectangle_list_destroy)>
+    list(cairo_copy_clip_rectangle_list(cr), cairo_rectangle_list_destroy);
+    if (list->status != CAIRO_STATUS_SUCCESS ||
+        list->num_rectangles > static_cast<int>(target.clip.capacity()))
+        return false;
+
+    const Rect bounds(Point(), Painter::surface_to_size(surface));
+    for (auto i = 0; i < list->num_rectangles; ++i)
+    {
+        const auto& r = list->rectangles[i];
+        const auto x = r.x + matrix.x0;
+        const auto y = r.y + matrix.y0;
+        if (!is_integer(x) || !is_integer(y) ||
+            !is_integer(r.width) || !is_integer(r.height))
+            return false;
+
+        const Rect rect(std::lround(x), std::lround(y),
+                        std::lround(r.width), std::lround(r.height));
+        const auto clip = Rect::intersection(rect, bounds);
+        if (!clip.empty())
+            target.clip.push_back(clip);
+    }
+
+    target.surface = surface;
+    target.data = cairo_image_surface_get_data(surface);
+    target.stride = cairo_image_surface_get_stride(surface);
+    target.format = format;
+    target.origin = Point(std::lround(matrix.x0), std::lround(matrix.y0));
+
+    return target.data != nullptr;
+}
+
+static void direct_fill(const DirectTarget& target, const Rect& rect,
+                        const Color& color)
+{
+    const uint32_t pixel32 = color.alpha() ?
+                             0xff000000 | (color.red() << 16) | (color.green() << 8) | color.blue() :
+                             0;
+    const auto pixel16 = static_cast<uint16_t>(color.pixel16());
+    const auto bpp = bytes_per_pixel(target.format);
+
+    cairo_surface_flush(target.surface);
+
+    for (const auto& clip : target.clip)
+    {
+        const auto r = Rect::intersection(rect + target.origin, clip);
+        if (r.empty())
+            continue;
+
+        auto row = target.data + r.y() * target.stride + r.x() * bpp;
+        for (auto y = 0; y < r.height(); ++y, row += target.stride)
+        {
+            if (target.format == CAIRO_FORMAT_RGB16_565)
+                detail::fill16(reinterpret_cast<uint16_t*>(row), pixel16, r.width());
+            else
+                detail::fill32(reinterpret_cast<uint32_t*>(row), pixel32, r.width());
+        }
+
+        cairo_surface_mark_dirty_rectangle(target.surface, r.x(), r.y(),
+                                           r.width(), r.height());
+    }
+}
+
+/*
+ * Draw src_rect of the surface at the point in user space, without cairo.
+ *
+ * When paint is true, the source is painted over the whole clip like
+ * cairo_paint() instead of only filling the destination rectangle.
+ */
+static bool direct_blit(cairo_t* cr, cairo_surface_t* src, const Rect& src_rect,
+                        double x, double y, bool paint)
+{
+    if (cairo_surface_get_type(src) != CAIRO_SURFACE_TYPE_IMAGE ||
+        !is_integer(x) || !is_integer(y))
+        return false;
+
+    const auto op = cairo_get_operator(cr);
+    if (op != CAIRO_OPERATOR_SOURCE && op != CAIRO_OPERATOR_OVER)
+        return false;
+
+    DirectTarget target;
+    if (!direct_target(cr, target) || src == target.surface)
+        return false;
+
+    enum class Kernel
+    {
+        copy,
+        over32,
+        over16,
+    };
+
+    // opaque formats are the same as SOURCE with OVER
+    const auto format = cairo_image_surface_get_format(src);
+    Kernel kernel;
+    if (format == target.format &&
+        (op == CAIRO_OPERATOR_SOURCE || format != CAIRO_FORMAT_ARGB32))
+        kernel = Kernel::copy;
+    else if (format == CAIRO_FORMAT_ARGB32 && op == CAIRO_OPERATOR_OVER)
+        kernel = target.format == CAIRO_FORMAT_RGB16_565 ? Kernel::over16 : Kernel::over32;
+    else
+        return false;
+
+    const Rect bounds(Point(), Painter::surface_to_size(src));
+
+    // cairo clears anything outside of the source surface with SOURCE, while
+    // with OVER it does nothing
+    if (op == CAIRO_OPERATOR_SOURCE && !bounds.contains(src_rect))
+        return false;
+
+    const auto srect = Rect::intersection(src_rect, bounds);
+    if (srect.empty())
+        return true;
+
+    const Rect drect(Point(std::lround(x), std::lround(y)) + target.origin +
+                     (srect.point() - src_rect.point()), srect.size());
+
+    // painting with SOURCE clears the clip outside of the source too
+    if (op == CAIRO_OPERATOR_SOURCE && paint)
+    {
+        for (const auto& clip : target.clip)
+            if (!drect.contains(clip))
+                return false;
+    }
+
+    cairo_surface_flush(src);
+    cairo_surface_flush(target.surface);
+
+    const auto sdata = cairo_image_surface_get_data(src);
+    const auto sstride = cairo_image_surface_get_stride(src);
+    const auto sbpp = bytes_per_pixel(format);
+    const auto dbpp = bytes_per_pixel(target.format);
+
+    for (const auto& clip : target.clip)
+    {
+        const auto r = Rect::intersection(drect, clip);
+        if (r.empty())
+            continue;
+
+        const auto spoint = srect.point() + (r.point() - drect.point());
+        auto s = sdata + spoint.y() * sstride + spoint.x() * sbpp;
+        auto d = target.data + r.y() * target.stride + r.x() * dbpp;
+        for (auto row = 0; row < r.height(); ++row, s += sstride, d += target.stride)
+        {
+            switch (kernel)
+            {
+            case Kernel::copy:
+                std::memcpy(d, s, r.width() * dbpp);
+                break;
+            case Kernel::over32:
+                detail::over32(reinterpret_cast<uint32_t*>(d),
+                               reinterpret_cast<const uint32_t*>(s), r.width());
+                break;
+            case Kernel::over16:
+                detail::over16(reinterpret_cast<uint16_t*>(d),
+                               reinterpret_cast<const uint32_t*>(s), r.width());
+                break;
+            }
+        }
+
+        cairo_surface_mark_dirty_rectangle(target.surface, r.x(), r.y(),
+                                           r.width(), r.height());
+    }
+
+    return true;
+}
+
 Painter& Painter::draw(const Image& image)
 {
     assert(!image.empty());
@@ -72,6 +347,17 @@ Painter& Painter::draw(const Image& image)
     double y;
     cairo_get_current_point(m_cr.get(), &x, &y);
 
+    if (m_list)
+    {
+        m_list->image(m_cr.get(), image.surface(), Rect(Point(), image.size()),
+                      PointF(x, y), false);
+        return *this;
+    }
+
+    if (direct_blit(m_cr.get(), image.surface().get(),
+                    Rect(Point(), image.size()), x, y, true))
+        return *this;
+
     cairo_translate(m_cr.get(), x, y);
     cairo_set_source(m_cr.get(), image.pattern());
 
@@ -83,6 +369,12 @@ Painter& Painter::draw(const Image& image)
 
 Painter& Painter::mask(const Image& image, const Point& point)
 {
+    if (m_list)
+    {
+        m_list->mask(m_cr.get(), image.surface(), point);
+        return *this;
+    }
+
     cairo_mask_surface(m_cr.get(), image.surface().get(), point.x(), point.y());
 
     return *this;
@@ -101,6 +393,20 @@ Painter& Painter::draw(const Rect& rect, const Image& image)
         return *this;
 
     cairo_get_current_point(m_cr.get(), &x, &y);
+
+    if (m_list)
+    {
+        m_list->image(m_cr.get(), image.surface(), rect, PointF(x, y), true);
+        cairo_new_path(m_cr.get());
+        return *this;
+    }
+
+    if (direct_blit(m_cr.get(), image.surface().get(), rect, x, y, false))
+    {
+        cairo_new_path(m_cr.get());
+        return *this;
+    }
+
     cairo_set_source_surface(m_cr.get(), image.surface().get(),
                              x - rect.x(), y - rect.y());
     cairo_rectangle(m_cr.get(), x, y, rect.width(), rect.height());
@@ -119,6 +425,13 @@ Painter& Painter::draw(const std::string& str, const TextDrawFlags& flags)
     if (!cairo_has_current_point(m_cr.get()))
         return *this;
 
+    if (m_list)
+    {
+        m_list->text(m_cr.get(), str, flags.raw());
+        cairo_new_path(m_cr.get());
+        return *this;
+    }
+
     double x;
     double y;
     cairo_text_extents_t textext;
@@ -165,6 +478,9 @@ Size Painter::font_size(const std::string& text)
 
 Painter& Painter::clip()
 {
+    if (m_list)
+        m_list->path(m_cr.get(), detail::DisplayList::Type::clip);
+
     cairo_clip(m_cr.get());
 
     return *this;
@@ -172,13 +488,61 @@ Painter& Painter::clip()
 
 Painter& Painter::fill()
 {
+    if (m_list)
+        m_list->path(m_cr.get(), detail::DisplayList::Type::fill);
+
     cairo_fill(m_cr.get());
 
     return *this;
 }
 
+Painter& Painter::fill(const Rect& rect, const Color& color)
+{
+    if (m_list)
+    {
+        m_list->fill(m_cr.get(), rect, color);
+        cairo_new_path(m_cr.get());
+        return *this;
+    }
+
+    const auto op = cairo_get_operator(m_cr.get());
+    const auto opaque = color.alpha() == 255;
+
+    if (op == CAIRO_OPERATOR_SOURCE || (op == CAIRO_OPERATOR_OVER && opaque))
+    {
+        // only an ARGB32 surface can be cleared to transparent
+        DirectTarget target;
+        if (direct_target(m_cr.get(), target) &&
+            (opaque || (color.alpha() == 0 && target.format == CAIRO_FORMAT_ARGB32)))
+        {
+            direct_fill(target, rect, color);
+            cairo_new_path(m_cr.get());
+            return *this;
+        }
+    }
+
+    AutoSaveRestore sr(*this);
+
+    cairo_new_path(m_cr.get());
+    cairo_set_source_rgba(m_cr.get(),
+                          color.redf(),
+                          color.greenf(),
+                          color.bluef(),
+                          color.alphaf());
+    draw(rect);
+    fill();
+
+    return *this;
+}
+
 Painter& Painter::paint()
 {
+    if (m_list)
+    {
+        m_list->paint(m_cr.get(), 1.f);
+        return *this;
+    }
+
     cairo_paint(m_cr.get());
 
     return *this;
@@ -186,6 +550,12 @@ Painter& Painter::paint()
 
 Painter& Painter::paint(float alpha)
 {
+    if (m_list)
+    {
+        m_list->paint(m_cr.get(), alpha);
+        return *this;
+    }
+
     cairo_paint_with_alpha(m_cr.get(), alpha);
 
     return *this;
@@ -193,6 +563,9 @@ Painter& Painter::paint(float alpha)
 
 Painter& Painter::stroke()
 {
+    if (m_list)
+        m_list->path(m_cr.get(), detail::DisplayList::Type::stroke);
+
     cairo_stroke(m_cr.get());
 
     return *this;
@@ -292,6 +665,12 @@ void Painter::color_at(cairo_surface_t* image, const Point& point, const Color&
 
 void Painter::color_at(const Point& point, const Color& color) noexcept
 {
+    if (m_list)
+    {
+        m_list->pixel(point, color);
+        return;
+    }
+
     color_at(cairo_get_target(m_cr.get()), point, color);
 }
 
@@ -311,50 +690,189 @@ Color Painter::color_at(cairo_surface_t* image, const Point& point) noexcept
     return getc(image, point);
 }
 
-static inline bool check(const Size& size, cairo_format_t format,
-                         const unsigned char* data,
-                         size_t stride, const Point& point,
-                         const Color& target_color, const Color& color) noexcept
+/*
+ * Pixel format traits for flood fill.
+ */
+struct FloodARGB32
 {
-    if (!Rect(Point(), size - Size(1, 1)).intersect(point))
-        return false;
+    using Pixel = uint32_t;
 
-    switch (format)
+    static inline Pixel pack(const Color& color) noexcept
     {
-    case CAIRO_FORMAT_ARGB32:
+        return color.pixel32();
+    }
+
+    static inline Pixel key(Pixel pixel) noexcept
     {
-        const auto c = get32(data, stride, point);
-        return c != color && c == target_color;
+        return pixel;
     }
-    case CAIRO_FORMAT_RGB24:
+
+    static inline uint32_t distance(Pixel a, Pixel b) noexcept
     {
-        const auto c = get24(data, stride, point);
-        return c != color && c == target_color;
+        uint32_t result = 0;
+        for (auto shift = 0u; shift < 32u; shift += 8u)
+        {
+            const auto ca = static_cast<int>((a >> shift) & 0xffu);
+            const auto cb = static_cast<int>((b >> shift) & 0xffu);
+            result = std::max(result, static_cast<uint32_t>(std::abs(ca - cb)));
+        }
+        return result;
     }
-    case CAIRO_FORMAT_RGB16_565:
+};
+
+struct FloodRGB24 : public FloodARGB32
+{
+    static inline Pixel pack(const Color& color) noexcept
     {
-        const auto c = get16(data, stride, point);
-        return c != color && c == target_color;
+        return 0xff000000u | (color.red() << 16u) | (color.green() << 8u) | color.blue();
     }
-    case CAIRO_FORMAT_RGB30:
-    case CAIRO_FORMAT_A8:
-    case CAIRO_FORMAT_A1:
-    case CAIRO_FORMAT_INVALID:
-    default:
-        break;
+
+    /// The upper byte is undefined.
+    static inline Pixel key(Pixel pixel) noexcept
+    {
+        return pixel & 0x00ffffffu;
     }
+};
 
-    return false;
+struct FloodRGB565
+{
+    using Pixel = uint16_t;
+
+    static inline Pixel pack(const Color& color) noexcept
+    {
+        return color.pixel16();
+    }
+
+    static inline Pixel key(Pixel pixel) noexcept
+    {
+        return pixel;
+    }
+
+    static inline uint32_t distance(Pixel a, Pixel b) noexcept
+    {
+        const auto channel = [](Pixel p, uint32_t shift, uint32_t bits)
+        {
+            const auto v = (p >> shift) & ((1u << bits) - 1u);
+            // expand to 8 bits
+            return static_cast<int>((v << (8u - bits)) | (v >> (2u * bits - 8u)));
+        };
+
+        return std::max({static_cast<uint32_t>(std::abs(channel(a, 11, 5) - channel(b, 11, 5))),
+                         static_cast<uint32_t>(std::abs(channel(a, 5, 6) - channel(b, 5, 6))),
+                         static_cast<uint32_t>(std::abs(channel(a, 0, 5) - channel(b, 0, 5)))});
+    }
+};
+
+/*
+ * Span based scanline flood fill.
+ *
+ * Each seed is expanded left and right into the widest span of matching
+ * pixels, which is filled at once. Then the rows above and below the span are
+ * scanned and a single new seed is pushed for each run of matching pixels.
+ */
+template<class Format>
+static void flood_fill(unsigned char* data, size_t stride, const Size& size,
+                       const Point& point, const Color& color,
+                       uint32_t tolerance)
+{
+    using Pixel = typename Format::Pixel;
+
+    const auto row = [data, stride](DefaultDim y)
+    {
+        return reinterpret_cast<Pixel*>(data + y * stride);
+    };
+
+    const auto width = size.width();
+    const auto height = size.height();
+    const auto pixel = Format::pack(color);
+    const auto seed = Format::key(row(point.y())[point.x()]);
+
+    const auto match = [seed, tolerance](Pixel p)
+    {
+        const auto k = Format::key(p);
+        return k == seed || (tolerance && Format::distance(k, seed) <= tolerance);
+    };
+
+    // when the fill color itself matches, filled pixels have to be tracked
+    // separately or the fill would never end
+    const auto revisit = match(pixel);
+    if (revisit && !tolerance)
+        return;
+
+    std::vector<bool> filled(revisit ? width * height : 0);
+
+    const auto inside = [&](const Pixel * r, DefaultDim x, DefaultDim y)
+    {
+        if (revisit && filled[y * width + x])
+            return false;
+        return match(r[x]);
+    };
+
+    std::vector<Point> seeds;
+    seeds.emplace_back(point);
+
+    while (!seeds.empty())
+    {
+        const auto p = seeds.back();
+        seeds.pop_back();
+
+        const auto y = p.y();
+        auto r = row(y);
+        if (!inside(r, p.x(), y))
+            continue;
+
+        auto x1 = p.x();
+        while (x1 > 0 && inside(r, x1 - 1, y))
+            --x1;
+
+        auto x2 = p.x();
+        while (x2 < width - 1 && inside(r, x2 + 1, y))
+            ++x2;
+
+        std::fill(r + x1, r + x2 + 1, pixel);
+        if (revisit)
+            std::fill(filled.begin() + y * width + x1,
+                      filled.begin() + y * width + x2 + 1, true);
+
+        for (const auto ny : {y - 1, y + 1})
+        {
+            if (ny < 0 || ny >= height)
+                continue;
+
+            auto nr = row(ny);
+            auto run = false;
+            for (auto x = x1; x <= x2; ++x)
+            {
+                if (inside(nr, x, ny))
+                {
+                    if (!run)
+                        seeds.emplace_back(x, ny);
+                    run = true;
+                }
+                else
+                {
+                    run = false;
+                }
+            }
+        }
+    }
 }
 
-Painter& Painter::flood(const Point& point, const Color& color)
+Painter& Painter::flood(const Point& point, const Color& color, uint32_t tolerance)
 {
-    flood(cairo_get_target(m_cr.get()), point, color);
+    if (m_list)
+    {
+        m_list->flood(point, color, tolerance);
+        return *this;
+    }
+
+    flood(cairo_get_target(m_cr.get()), point, color, tolerance);
     return *this;
 }
 
 void Painter::flood(cairo_surface_t* image,
-                    const Point& point, const Color& color)
+                    const Point& point, const Color& color,
+                    uint32_t tolerance)
 {
     auto size = surface_to_size(image);
     if (!Rect(Point(), size - Size(1, 1)).intersect(point))
@@ -365,45 +883,24 @@ void Painter::flood(cairo_surface_t* image,
     auto data = cairo_image_surface_get_data(image);
     const auto stride = cairo_image_surface_get_stride(image);
     const auto format = cairo_image_surface_get_format(image);
-    const Color target_color = color_at(image, point);
-
-    // non-recursive breadth first search
-
-    std::deque<Point> q;
-    q.emplace_back(point);
 
-    while (!q.empty())
+    switch (format)
     {
-        auto p = q.back();
-        q.pop_back();
-
-        switch (format)
-        {
-        case CAIRO_FORMAT_ARGB32:
-            set32(data, stride, p, color);
-            break;
-        case CAIRO_FORMAT_RGB24:
-            set24(data, stride, p, color);
-            break;
-        case CAIRO_FORMAT_RGB16_565:
-            set16(data, stride, p, color);
-            break;
-        case CAIRO_FORMAT_RGB30:
-        case CAIRO_FORMAT_A8:
-        case CAIRO_FORMAT_A1:
-        case CAIRO_FORMAT_INVALID:
-        default:
-            break;
-        }
-
-        if (check(size, format, data, stride, p + Point(1, 0), target_color, color))
-            q.emplace_back(p + Point(1, 0));
-        if (check(size, format, data, stride, p - Point(1, 0), target_color, color))
-            q.emplace_back(p - Point(1, 0));
-        if (check(size, format, data, stride, p + Point(0, 1), target_color, color))
-            q.emplace_back(p + Point(0, 1));
-        if (check(size, format, data, stride, p - Point(0, 1), target_color, color))
-            q.emplace_back(p - Point(0, 1));
+    case CAIRO_FORMAT_ARGB32:
+        flood_fill<FloodARGB32>(data, stride, size, point, color, tolerance);
+        break;
+    case CAIRO_FORMAT_RGB24:
+        flood_fill<FloodRGB24>(data, stride, size, point, color, tolerance);
+        break;
+    case CAIRO_FORMAT_RGB16_565:
+        flood_fill<FloodRGB565>(data, stride, size, point, color, tolerance);
+        break;
+    case CAIRO_FORMAT_RGB30:
+    case CAIRO_FORMAT_A8:
+    case CAIRO_FORMAT_A1:
+    case CAIRO_FORMAT_INVALID:
+    default:
+        break;
     }
 
     cairo_surface_mark_dirty(image);
@@ -8,7 +8,11 @@
 #endif
 
 #include "detail/dump.h"
+#include "detail/latency.h"
+#include "detail/trace.h"
+#include "egt/app.h"
 #include "egt/color.h"
+#include "egt/input.h"
 #include "egt/palette.h"
 #include "egt/screen.h"
 #include "egt/types.h"
@@ -38,6 +42,10 @@ void Screen::flip(const DamageArray& damage)
 {
     if (!damage.empty() && index() < m_buffers.size())
     {
+        EGT_TRACE_SCOPE("flip");
+
+        detail::latency_draw_end(this);
+
         // save the damage to all buffers
         for (auto& b : m_buffers)
             for (const auto& d : damage)
@@ -45,6 +53,7 @@ void Screen::flip(const DamageArray& damage)
 
         detail::code_timer(false, "copy_to_buffer: ", [&]()
         {
+            EGT_TRACE_SCOPE("copy_to_buffer");
             ScreenBuffer& buffer = m_buffers[index()];
             if ((m_format == PixelFormat::rgb565) ||
                 (m_format == PixelFormat::argb8888) ||
@@ -61,6 +70,8 @@ void Screen::flip(const DamageArray& damage)
         });
 
         schedule_flip();
+
+        detail::latency_flip(this);
     }
 }
 
@@ -423,6 +434,13 @@ void Screen::init(void** ptr, uint32_t count, const Size& size, PixelFormat form
 {
     m_size = size;
 
+    // inputs scaling positions to the screen keep their own copy of the size
+    if (Application::check_instance() && Application::instance().screen() == this)
+    {
+        for (auto& input : Application::instance().inputs())
+            input->screen_resized(size);
+    }
+
     cairo_format_t f = detail::cairo_format(format);
     if (f == CAIRO_FORMAT_INVALID)
         f = CAIRO_FORMAT_ARGB32;
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "detail/trace.h"
 #include "egt/detail/enum.h"
 #include "egt/detail/layout.h"
 #include "egt/serialize.h"
@@ -48,6 +49,8 @@ void BoxSizer::layout()
     if (!visible())
         return;
 
+    EGT_TRACE_SCOPE_DETAIL("layout", name());
+
     if (m_in_layout)
         return;
 
@@ -83,9 +86,13 @@ void BoxSizer::layout()
     if (rect.height() < user_requested_box().height())
         rect.height(user_requested_box().height());
 
-    resize(rect);
+    // The intermediate size is only used to lay out the children, so don't
+    // damage or ask the parent to layout until the final size is known.
+    const auto original = size();
+    m_box.size(rect);
 
     std::vector<detail::LayoutRect> rects;
+    rects.reserve(m_children.size());
 
     for (auto& child : m_children)
     {
@@ -124,7 +131,8 @@ void BoxSizer::layout()
         rects.emplace_back(behave, min);
     }
 
-    detail::flex_layout(content_area(), rects, justify(), orient());
+    // only runs the flex layout if anything changed since the last time
+    m_flex.layout(content_area(), rects, justify(), orient());
 
     auto child = m_children.begin();
     for (const auto& r : rects)
@@ -141,6 +149,9 @@ void BoxSizer::layout()
     if (rect.height() < user_requested_box().height())
         rect.height(user_requested_box().height());
 
+    // If the size did not change, this does nothing, and layout does not
+    // propagate any further up.
+    m_box.size(original);
     resize(rect);
 }
 
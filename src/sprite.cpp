@@ -8,10 +8,12 @@
 #endif
 
 #include "detail/spriteimpl.h"
+#include "egt/detail/displaylist.h"
 #include "egt/image.h"
 #include "egt/label.h"
 #include "egt/painter.h"
 #include "egt/sprite.h"
+#include <algorithm>
 
 #ifdef HAVE_LIBPLANES
 #include "egt/detail/screen/kmsoverlay.h"
@@ -50,8 +52,23 @@ protected:
 };
 #endif
 
+/**
+ * A frame cropped to the bounding box of its visible pixels.
+ */
+struct SpriteSlice
+{
+    /// Cropped pixels, or null if the frame has no visible pixels.
+    shared_cairo_surface_t surface;
+    /// Bounding box, relative to the frame.
+    Rect rect;
+};
+
 /**
  * Sprite implementation using only software.
+ *
+ * The frames of each strip are sliced into their own surfaces, cropped to
+ * their visible pixels, the first time the strip is used.  Showing a frame
+ * then only damages the area covered by the old or new frame.
  */
 class SoftwareSprite : public SpriteImpl
 {
@@ -61,6 +78,8 @@ public:
 
     void show_frame(int index) override;
 
+    void change_strip(uint32_t id) override;
+
     void draw(Painter& painter, const Rect& rect) override;
 
     void paint(Painter& painter) override;
@@ -68,13 +87,23 @@ public:
     EGT_NODISCARD shared_cairo_surface_t surface() const override;
 
 protected:
+
+    /// Get a slice of the current strip, slicing the strip if needed.
+    const SpriteSlice& slice(int index);
+
+    /// Damage the area covered by either of two slices.
+    void damage(const Rect& a, const Rect& b);
+
     Sprite& m_interface;
+
+    /// Slices of each strip.
+    std::vector<std::vector<SpriteSlice>> m_slices;
 };
 
 /**
  * This pulls out a frame into its own surface.
  */
-static shared_cairo_surface_t frame_surface(const Rect& rect, const Image& image)
+static shared_cairo_surface_t frame_surface(const Rect& rect, cairo_surface_t* surface)
 {
     // cairo_surface_create_for_rectangle() would work here with one
     // exception - the resulting image has no width and height
@@ -86,7 +115,7 @@ static shared_cairo_surface_t frame_surface(const Rect& rect, const Image& image
                                cairo_surface_destroy);
 
     shared_cairo_t cr = shared_cairo_t(cairo_create(copy.get()), cairo_destroy);
-    cairo_set_source_surface(cr.get(), image.surface().get(), -rect.x(), -rect.y());
+    cairo_set_source_surface(cr.get(), surface, -rect.x(), -rect.y());
     cairo_rectangle(cr.get(), 0, 0, rect.width(), rect.height());
     cairo_set_operator(cr.get(), CAIRO_OPERATOR_SOURCE);
     cairo_fill(cr.get());
@@ -94,6 +123,59 @@ static shared_cairo_surface_t frame_surface(const Rect& rect, const Image& image
     return copy;
 }
 
+static shared_cairo_surface_t frame_surface(const Rect& rect, const Image& image)
+{
+    return frame_surface(rect, image.surface().get());
+}
+
+/**
+ * Pull out a frame cropped to its visible pixels.
+ */
+static SpriteSlice slice_frame(const Rect& rect, const Image& image)
+{
+    auto frame = frame_surface(rect, image);
+
+    cairo_surface_flush(frame.get());
+    const auto data = cairo_image_surface_get_data(frame.get());
+    const auto stride = cairo_image_surface_get_stride(frame.get());
+
+    DefaultDim left = rect.width();
+    DefaultDim right = -1;
+    DefaultDim top = -1;
+    DefaultDim bottom = -1;
+    for (DefaultDim y = 0; y < rect.height(); ++y)
+    {
+        const auto row = reinterpret_cast<const uint32_t*>(data + y * stride);
+
+        DefaultDim first = 0;
+        while (first < rect.width() && !(row[first] >> 24u))
+            ++first;
+        if (first == rect.width())
+            continue;
+
+        DefaultDim last = rect.width() - 1;
+        while (!(row[last] >> 24u))
+            --last;
+
+        left = std::min(left, first);
+        right = std::max(right, last);
+        if (top < 0)
+            top = y;
+        bottom = y;
+    }
+
+    if (top < 0)
+        return {};
+
+    const Rect box(left, top, right - left + 1, bottom - top + 1);
+    if (box.size() != rect.size())
+        frame = frame_surface(box, frame.get());
+
+    DisplayList::mark_immutable(frame.get());
+
+    return {frame, box};
+}
+
 #ifdef HAVE_LIBPLANES
 HardwareSprite::HardwareSprite(Sprite& interface, const Image& image, const Size& frame_size,
                                int frame_count, const Point& frame_point)
@@ -110,8 +192,9 @@ HardwareSprite::HardwareSprite(Sprite& interface, const Image& image, const Size
     plane_set_pan_pos(s->s(), m_strips[m_strip].point.x(), m_strips[m_strip].point.y());
     plane_set_pan_size(s->s(), m_frame.width(), m_frame.height());
 
-    // hack to change the size because the screen size and the box size are different
-    interface.m_box.size(frame_size);
+    // hack to change the size because the screen size and the box size are
+    // different; only the box is resized, not the plane
+    interface.default_resize(frame_size);
 }
 
 void HardwareSprite::draw(Painter& painter, const Rect& rect)
@@ -156,27 +239,80 @@ SoftwareSprite::SoftwareSprite(Sprite& interface, const Image& image, const Size
     : SpriteImpl(image, frame_size, frame_count, frame_point),
       m_interface(interface)
 {
-    interface.m_box = Rect({}, frame_size);
+    // only the box, through the setters so the parent sees the change
+    interface.default_move({});
+    interface.default_resize(frame_size);
 }
 
 void SoftwareSprite::draw(Painter& painter, const Rect& rect)
 {
     ignoreparam(rect);
 
-    Point origin = get_frame_origin(m_index);
-    painter.draw(m_interface.box().point());
-    painter.draw(Rect(origin.x(), origin.y(), m_frame.width(), m_frame.height()), m_image);
+    const auto& s = slice(m_index);
+    if (!s.surface)
+        return;
+
+    const auto origin = m_interface.box().point() + s.rect.point();
+    auto cr = painter.context().get();
+    cairo_set_source_surface(cr, s.surface.get(), origin.x(), origin.y());
+    cairo_rectangle(cr, origin.x(), origin.y(), s.rect.width(), s.rect.height());
+    cairo_fill(cr);
 }
 
 void SoftwareSprite::show_frame(int index)
 {
     if (index != m_index)
     {
+        const auto old = slice(m_index).rect;
         m_index = index;
-        m_interface.damage();
+        damage(old, slice(m_index).rect);
     }
 }
 
+void SoftwareSprite::change_strip(uint32_t id)
+{
+    const auto old = slice(m_index).rect;
+    const auto strip = m_strip;
+    SpriteImpl::change_strip(id);
+    if (strip != m_strip)
+        damage(old, slice(m_index).rect);
+}
+
+const SpriteSlice& SoftwareSprite::slice(int index)
+{
+    static const SpriteSlice none;
+
+    if (index < 0 || index >= m_strips[m_strip].framecount)
+        return none;
+
+    if (m_slices.size() < m_strips.size())
+        m_slices.resize(m_strips.size());
+
+    auto& slices = m_slices[m_strip];
+    if (slices.empty())
+    {
+        slices.reserve(m_strips[m_strip].framecount);
+        for (auto i = 0; i < m_strips[m_strip].framecount; ++i)
+            slices.push_back(slice_frame(Rect(get_frame_origin(i), m_frame), m_image));
+    }
+
+    return slices[index];
+}
+
+void SoftwareSprite::damage(const Rect& a, const Rect& b)
+{
+    Rect rect;
+    if (a.empty())
+        rect = b;
+    else if (b.empty())
+        rect = a;
+    else
+        rect = Rect::merge(a, b);
+
+    if (!rect.empty())
+        m_interface.damage(Rect(m_interface.box().point() + rect.point(), rect.size()));
+}
+
 shared_cairo_surface_t SoftwareSprite::surface() const
 {
     Point origin = get_frame_origin(m_index);
@@ -250,6 +386,24 @@ void Sprite::advance()
     m_simpl->advance();
 }
 
+void Sprite::play(unsigned fps)
+{
+    if (!m_simpl)
+        throw std::runtime_error("no sprite implementation initialized");
+    m_simpl->play(fps);
+}
+
+void Sprite::stop()
+{
+    if (m_simpl)
+        m_simpl->stop();
+}
+
+unsigned Sprite::fps() const
+{
+    return m_simpl ? m_simpl->fps() : 0;
+}
+
 bool Sprite::is_last_frame() const
 {
     if (!m_simpl)
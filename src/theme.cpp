@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "egt/checkbox.h"
+#include "egt/detail/boxcache.h"
+#include "egt/detail/displaylist.h"
 #include "egt/detail/enum.h"
 #include "egt/detail/math.h"
 #include "egt/painter.h"
@@ -115,6 +117,21 @@ Theme::Theme()
 }
 {}
 
+void Theme::apply()
+{
+    detail::box_cache().clear();
+
+    init_palette();
+    init_font();
+    init_draw();
+}
+
+void Theme::palette(Palette& palette)
+{
+    m_palette = palette;
+    detail::box_cache().clear();
+}
+
 void Theme::init_palette()
 {
 
@@ -199,6 +216,58 @@ void Theme::draw_box(Painter& painter,
     if (type.empty())
         return;
 
+    // recorded whole, instead of the paths it is made of
+    if (auto list = painter.recording())
+    {
+        list->box(painter.context().get(), *this, type, rect, border, bg,
+                  border_width, margin_width, border_radius, border_flags);
+        cairo_new_path(painter.context().get());
+        return;
+    }
+
+    // a plain rectangle of a solid color can be filled directly
+    if (!border_width && !(border_radius > 0) &&
+        bg.type() == Pattern::Type::solid)
+    {
+        auto box = rect;
+        if (margin_width)
+        {
+            box += Point(margin_width, margin_width);
+            box -= Size(margin_width * 2, margin_width * 2);
+        }
+
+        if (box.empty())
+            return;
+
+        Painter::AutoSaveRestore sr(painter);
+        if (type.is_set(FillFlag::solid))
+            cairo_set_operator(painter.context().get(), CAIRO_OPERATOR_SOURCE);
+        painter.fill(box, bg.solid());
+        return;
+    }
+
+    if (detail::box_cache().draw(painter, *this, type, rect, border, bg,
+                                 border_width, margin_width, border_radius,
+                                 border_flags))
+        return;
+
+    paint_box(painter, type, rect, border, bg, border_width, margin_width,
+              border_radius, border_flags);
+}
+
+void Theme::paint_box(Painter& painter,
+                      const FillFlags& type,
+                      const Rect& rect,
+                      const Pattern& border,
+                      const Pattern& bg,
+                      DefaultDim border_width,
+                      DefaultDim margin_width,
+                      float border_radius,
+                      const BorderFlags& border_flags) const
+{
+    if (type.empty())
+        return;
+
     auto box = rect;
 
     // adjust for margin
@@ -3,7 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include "detail/asioallocator.h"
+#include "detail/timerwheel.h"
 #include "egt/app.h"
 #include "egt/eventloop.h"
 #include "egt/timer.h"
@@ -15,44 +15,31 @@ inline namespace v1
 
 struct Timer::TimerImpl
 {
-    detail::HandlerAllocator allocator;
+    detail::TimerWheel& wheel;
+    detail::TimerWheel::Entry entry;
+    /// Restart when the timer fires.
+    bool periodic{false};
 };
 
 Timer::Timer() noexcept
-    : m_timer(Application::instance().event().io()),
-      m_impl(std::make_unique<TimerImpl>())
+    : m_impl(new TimerImpl{Application::instance().event().timer_wheel(), {}, false})
 {
+    m_impl->entry.callback = [this]() { internal_timer_callback(); };
     Application::instance().m_timers.push_back(this);
 }
 
 Timer::Timer(std::chrono::milliseconds duration) noexcept
-    : m_timer(Application::instance().event().io()),
-      m_duration(duration),
-      m_impl(std::make_unique<TimerImpl>())
+    : m_duration(duration),
+      m_impl(new TimerImpl{Application::instance().event().timer_wheel(), {}, false})
 {
+    m_impl->entry.callback = [this]() { internal_timer_callback(); };
     Application::instance().m_timers.push_back(this);
 }
 
 void Timer::start()
 {
-    // error::operation_aborted occurs when expires_from_now() is called on the
-    // timer while it is pending, we handle this ourselves with m_running
-    m_running = false;
-    m_timer.expires_after(m_duration);
     m_running = true;
-#ifdef USE_PRIORITY_QUEUE
-    m_timer.async_wait(
-        Application::instance().event().queue().wrap(detail::priorities::high,
-                [this](const asio::error_code & error)
-    {
-        internal_timer_callback(error);
-    }));
-#else
-    m_timer.async_wait(detail::make_custom_alloc_handler(m_impl->allocator, [this](const asio::error_code & error)
-    {
-        internal_timer_callback(error);
-    }));
-#endif
+    m_impl->wheel.add(m_impl->entry, std::chrono::steady_clock::now() + m_duration, m_slack);
 }
 
 void Timer::start_with_duration(std::chrono::milliseconds duration)
@@ -83,22 +70,21 @@ void Timer::cancel()
 void Timer::do_cancel()
 {
     m_running = false;
-    m_timer.cancel();
+    if (m_impl && m_impl->entry.linked())
+        m_impl->wheel.remove(m_impl->entry);
 }
 
-void Timer::internal_timer_callback(const asio::error_code& error)
+void Timer::internal_timer_callback()
 {
-    if (error)
+    if (!m_running)
         return;
 
-    // it is possible to call cancel() and have this handler still called
-    // which creates a sort of race condition, so we stop an actual
-    // callback from continuing if m_running is false
-    if (m_running)
-    {
+    if (m_impl->periodic)
+        start();
+    else
         m_running = false;
-        timeout();
-    }
+
+    timeout();
 }
 
 void Timer::timeout()
@@ -143,9 +129,40 @@ void Timer::invoke_handlers()
 }
 
 // NOLINTNEXTLINE(hicpp-noexcept-move,performance-noexcept-move-constructor)
-Timer::Timer(Timer&&) = default;
+Timer::Timer(Timer&& rhs)
+    : m_handle_counter(rhs.m_handle_counter),
+      m_duration(rhs.m_duration),
+      m_slack(rhs.m_slack),
+      m_callbacks(std::move(rhs.m_callbacks)),
+      m_running(rhs.m_running),
+      m_name(std::move(rhs.m_name)),
+      m_impl(std::move(rhs.m_impl))
+{
+    rhs.m_running = false;
+    if (m_impl)
+        m_impl->entry.callback = [this]() { internal_timer_callback(); };
+    Application::instance().m_timers.push_back(this);
+}
+
 // NOLINTNEXTLINE(hicpp-noexcept-move,performance-noexcept-move-constructor)
-Timer& Timer::operator=(Timer&&) = default;
+Timer& Timer::operator=(Timer&& rhs)
+{
+    if (this != &rhs)
+    {
+        do_cancel();
+        m_handle_counter = rhs.m_handle_counter;
+        m_duration = rhs.m_duration;
+        m_slack = rhs.m_slack;
+        m_callbacks = std::move(rhs.m_callbacks);
+        m_running = rhs.m_running;
+        m_name = std::move(rhs.m_name);
+        m_impl = std::move(rhs.m_impl);
+        rhs.m_running = false;
+        if (m_impl)
+            m_impl->entry.callback = [this]() { internal_timer_callback(); };
+    }
+    return *this;
+}
 
 Timer::~Timer() noexcept
 {
@@ -162,39 +179,8 @@ Timer::~Timer() noexcept
 
 void PeriodicTimer::start()
 {
-    // error::operation_aborted occurs when expires_from_now() is called on the
-    // timer while it is pending, we handle this ourselves with m_running
-    m_running = false;
-    m_timer.expires_after(m_duration);
-    m_running = true;
-
-#ifdef USE_PRIORITY_QUEUE
-    m_timer.async_wait(Application::instance().event().queue().wrap(detail::priorities::high,
-                       [this](const asio::error_code & error)
-    {
-        internal_timer_callback(error);
-    }))
-#else
-    m_timer.async_wait(detail::make_custom_alloc_handler(m_impl->allocator, [this](const asio::error_code & error)
-    {
-        internal_timer_callback(error);
-    }));
-#endif
-}
-
-void PeriodicTimer::internal_timer_callback(const asio::error_code& error)
-{
-    if (error)
-        return;
-
-    // it is possible to call cancel() and have this handler still called
-    // which creates a sort of race condition, so we stop an actual
-    // callback from continuing if m_running is false
-    if (m_running)
-    {
-        start();
-        timeout();
-    }
+    m_impl->periodic = true;
+    Timer::start();
 }
 
 }
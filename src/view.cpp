@@ -3,7 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include "detail/dump.h"
+#include "detail/trace.h"
 #include "egt/detail/math.h"
 #include "egt/input.h"
 #include "egt/painter.h"
@@ -113,10 +113,8 @@ void ScrolledView::draw(Painter& painter, const Rect& rect)
                     cpainter.clip();
                 }
 
-                detail::code_timer(false, child->name() + " draw: ", [&]()
-                {
-                    child->draw(cpainter, r);
-                });
+                EGT_TRACE_SCOPE_DETAIL("draw", child->name());
+                child->draw(cpainter, r);
             }
 
             special_child_draw(cpainter, child.get());
@@ -142,11 +140,9 @@ void ScrolledView::draw(Painter& painter, const Rect& rect)
     // limit to content area
     const auto mrect = Rect::intersection(to_child(box()), to_child(content_area()));
 
-    cairo_set_source_surface(painter.context().get(), m_canvas->surface().get(),
-                             m_offset.x(), m_offset.y());
-    cairo_rectangle(painter.context().get(),
-                    mrect.point().x(), mrect.point().y(), mrect.width(), mrect.height());
-    painter.fill();
+    painter.draw(mrect.point());
+    painter.draw(Rect(mrect.point() - m_offset, mrect.size()),
+                 Image(m_canvas->surface()));
 
     if (hscrollable())
         m_hslider.draw(painter, rect);
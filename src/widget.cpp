@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include "detail/egtlog.h"
+#include "egt/app.h"
 #include "egt/canvas.h"
 #include "egt/detail/alignment.h"
 #include "egt/detail/enum.h"
@@ -179,6 +180,7 @@ void Widget::hide()
     if (flags().is_set(Widget::Flag::invisible))
         return;
     // careful attention to ordering
+    m_display_list_stale = true;
     damage();
     flags().set(Widget::Flag::invisible);
     on_hide.invoke();
@@ -326,7 +328,10 @@ void Widget::alpha(float alpha)
     alpha = detail::clamp<>(alpha, 0.f, 1.f);
 
     if (detail::change_if_diff<float>(m_alpha, alpha))
+    {
+        m_display_list_stale = true;
         damage();
+    }
 }
 
 void Widget::damage()
@@ -343,11 +348,60 @@ void Widget::damage(const Rect& rect)
     if (!visible())
         return;
 
+    if (m_display_list && m_parent && !m_display_list_stale)
+    {
+        // anything damaged while recording is not dropped
+        m_display_list_stale = true;
+
+        // nothing to do if the widget would draw exactly the same thing
+        detail::DisplayList list;
+        Painter painter(list);
+        draw(painter, box());
+        if (list == *m_display_list)
+        {
+            m_display_list_stale = false;
+            return;
+        }
+
+        // what was drawn last may be somewhere else now
+        if (m_display_list_box != box())
+            m_parent->damage_from_child(to_parent(m_display_list_box));
+    }
+
     // damage propagates to top level frame
     if (m_parent)
         m_parent->damage_from_child(to_parent(rect));
 }
 
+void Widget::display_list(bool enable)
+{
+    if (enable && !m_display_list)
+        m_display_list = std::make_unique<detail::DisplayList>();
+    else if (!enable)
+        m_display_list.reset();
+
+    m_display_list_stale = true;
+}
+
+void Widget::draw_recorded(Painter& painter, const Rect& rect)
+{
+    if (!m_display_list || painter.recording())
+    {
+        draw(painter, rect);
+        return;
+    }
+
+    m_display_list->clear();
+    {
+        Painter recorder(*m_display_list);
+        draw(recorder, rect);
+    }
+
+    m_display_list->replay(painter);
+    m_display_list_box = box();
+    m_display_list_stale = false;
+}
+
 void Widget::palette(const Palette& palette)
 {
     m_palette = std::make_unique<Palette>(palette);
@@ -789,6 +843,10 @@ bool Widget::parent_in_layout()
 
 void Widget::parent_layout()
 {
+    // every change to the box of a widget ends up here
+    if (m_parent && m_parent->m_spatial_index)
+        m_parent->m_spatial_index->update(this, box());
+
     if (!visible())
         return;
 
@@ -796,7 +854,31 @@ void Widget::parent_layout()
         return;
 
     if (parent())
-        parent()->layout();
+        parent()->request_layout();
+}
+
+void Widget::request_layout()
+{
+    if (Application::check_instance() &&
+        Application::instance().event().defer_layout())
+    {
+        m_layout_pending = true;
+        for (Widget* p = m_parent; p; p = p->m_parent)
+            p->m_child_layout_pending = true;
+        return;
+    }
+
+    layout();
+}
+
+void Widget::pending_layout()
+{
+    m_child_layout_pending = false;
+    if (m_layout_pending)
+    {
+        m_layout_pending = false;
+        layout();
+    }
 }
 
 DisplayPoint Widget::local_to_display(const Point& p)
@@ -9,6 +9,8 @@
 
 #include "detail/egtlog.h"
 #include "detail/dump.h"
+#include "detail/screen/overdraw.h"
+#include "detail/trace.h"
 #include "detail/window/basicwindow.h"
 #include "detail/window/planewindow.h"
 #include "egt/app.h"
@@ -147,16 +149,29 @@ void Window::do_draw()
 
     EGTLOG_TRACE("{} do draw", name());
 
-    detail::code_timer(time_child_draw_enabled(), name() + " draw: ", [this]()
+    EGT_TRACE_SCOPE_DETAIL("window draw", name());
+
+    auto draw_damage = [this]()
     {
         Painter painter(screen()->context());
 
         for (auto& damage : m_damage)
+        {
+            auto overdraw = detail::OverdrawAnalyzer::active();
+            if (egt_unlikely(overdraw != nullptr))
+                overdraw->draw(painter.context().get(), *this, damage);
+
             draw(painter, damage);
+        }
 
         screen()->flip(m_damage);
         m_damage.clear();
-    });
+    };
+
+    if (egt_unlikely(time_child_draw_enabled()))
+        detail::code_timer(true, name() + " draw: ", draw_damage);
+    else
+        draw_damage();
 }
 
 void Window::resize(const Size& size)
@@ -0,0 +1,774 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "detail/animatedimage/decoder.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using Bytes = std::vector<uint8_t>;
+using Pixels = std::vector<uint32_t>;
+using std::chrono::milliseconds;
+
+static constexpr uint32_t K = 0xff000000; // black
+static constexpr uint32_t R = 0xffff0000; // red
+static constexpr uint32_t G = 0xff00ff00; // green
+static constexpr uint32_t B = 0xff0000ff; // blue
+
+/// Guard value after each row, to check the stride is used.
+static constexpr uint32_t GUARD = 0x12345678;
+
+struct Frame
+{
+    Pixels pixels;
+    milliseconds delay;
+};
+
+/*
+ * Write a file to decode, and open a decoder for it.
+ */
+static std::unique_ptr<egt::detail::AnimationDecoder>
+decoder_for(const std::string& name, const Bytes& bytes)
+{
+    const auto filename = testing::TempDir() + name;
+    std::ofstream out(filename, std::ios_base::binary | std::ios_base::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    out.close();
+    return egt::detail::AnimationDecoder::open(filename);
+}
+
+/*
+ * Decode all frames, until the end of the animation or an error.
+ */
+static std::vector<Frame> decode(egt::detail::AnimationDecoder& decoder)
+{
+    const auto width = static_cast<size_t>(decoder.size().width());
+    const auto height = static_cast<size_t>(decoder.size().height());
+
+    std::vector<Frame> frames;
+    Pixels data((width + 1) * height, GUARD);
+    milliseconds delay{};
+    while (decoder.next(reinterpret_cast<unsigned char*>(data.data()),
+                        (width + 1) * sizeof(uint32_t), delay))
+    {
+        Frame frame{{}, delay};
+        for (size_t y = 0; y < height; ++y)
+        {
+            const auto row = data.data() + y * (width + 1);
+            frame.pixels.insert(frame.pixels.end(), row, row + width);
+            EXPECT_EQ(row[width], GUARD);
+        }
+        frames.push_back(frame);
+
+        // frames are never expected to be this many
+        if (frames.size() > 100)
+            break;
+    }
+    return frames;
+}
+
+static void put16le(Bytes& bytes, uint32_t value)
+{
+    bytes.push_back(value & 0xff);
+    bytes.push_back((value >> 8) & 0xff);
+}
+
+static void put32le(Bytes& bytes, uint32_t value)
+{
+    put16le(bytes, value & 0xffff);
+    put16le(bytes, value >> 16);
+}
+
+static void put32be(Bytes& bytes, uint32_t value)
+{
+    for (auto shift : {24, 16, 8, 0})
+        bytes.push_back((value >> shift) & 0xff);
+}
+
+/*
+ * GIF with a global palette of black, red, green and blue.
+ */
+class GifWriter
+{
+public:
+
+    GifWriter(uint16_t width, uint16_t height)
+        : bytes({'G', 'I', 'F', '8', '9', 'a'})
+    {
+        put16le(bytes, width);
+        put16le(bytes, height);
+        // 4 entry global palette
+        bytes.insert(bytes.end(), {0x81, 0, 0});
+        bytes.insert(bytes.end(), {0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff});
+    }
+
+    GifWriter& control(int disposal, int transparent, uint16_t delay)
+    {
+        bytes.insert(bytes.end(), {0x21, 0xf9, 4});
+        bytes.push_back((disposal << 2) | (transparent >= 0 ? 1 : 0));
+        put16le(bytes, delay);
+        bytes.push_back(transparent >= 0 ? transparent : 0);
+        bytes.push_back(0);
+        return *this;
+    }
+
+    /// Image of 2 bit indexes, stored with a clear code before each one.
+    GifWriter& image(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                     const Bytes& indexes, bool interlaced = false)
+    {
+        descriptor(x, y, width, height, interlaced);
+
+        // 3 bit codes, so the code table never grows
+        static constexpr uint32_t CLEAR = 4;
+        static constexpr uint32_t EOI = 5;
+        Bytes data;
+        uint32_t bits = 0;
+        int count = 0;
+        auto code = [&](uint32_t c)
+        {
+            bits |= c << count;
+            count += 3;
+            while (count >= 8)
+            {
+                data.push_back(bits & 0xff);
+                bits >>= 8;
+                count -= 8;
+            }
+        };
+        for (auto index : indexes)
+        {
+            code(CLEAR);
+            code(index);
+        }
+        code(EOI);
+        if (count)
+            data.push_back(bits & 0xff);
+
+        return lzw(2, data);
+    }
+
+    /// Image descriptor with no local palette.
+    GifWriter& descriptor(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                          bool interlaced = false)
+    {
+        bytes.push_back(0x2c);
+        put16le(bytes, x);
+        put16le(bytes, y);
+        put16le(bytes, width);
+        put16le(bytes, height);
+        bytes.push_back(interlaced ? 0x40 : 0);
+        return *this;
+    }
+
+    /// LZW data in sub-blocks.
+    GifWriter& lzw(uint8_t min_code_size, const Bytes& data)
+    {
+        bytes.push_back(min_code_size);
+        for (size_t i = 0; i < data.size(); i += 255)
+        {
+            const auto n = std::min<size_t>(255, data.size() - i);
+            bytes.push_back(n);
+            bytes.insert(bytes.end(), data.begin() + i, data.begin() + i + n);
+        }
+        bytes.push_back(0);
+        return *this;
+    }
+
+    GifWriter& comment()
+    {
+        bytes.insert(bytes.end(), {0x21, 0xfe, 3, 'e', 'g', 't', 0});
+        return *this;
+    }
+
+    Bytes end()
+    {
+        bytes.push_back(';');
+        return bytes;
+    }
+
+    Bytes bytes;
+};
+
+TEST(AnimatedImageGif, Frames)
+{
+    const auto gif = GifWriter(3, 2)
+                     .control(1, -1, 5)
+                     .image(0, 0, 3, 2, {1, 1, 1, 2, 2, 2})
+                     .comment()
+                     .control(2, 0, 0)
+                     .image(1, 0, 2, 2, {3, 0, 0, 3})
+                     .image(0, 0, 1, 1, {2})
+                     .end();
+
+    auto decoder = decoder_for("frames.gif", gif);
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decoder->size(), egt::Size(3, 2));
+
+    for (auto pass = 0; pass < 2; ++pass)
+    {
+        const auto frames = decode(*decoder);
+        ASSERT_EQ(frames.size(), 3U);
+
+        EXPECT_EQ(frames[0].pixels, Pixels({R, R, R, G, G, G}));
+        EXPECT_EQ(frames[0].delay, milliseconds(50));
+
+        // transparent pixels leave the canvas
+        EXPECT_EQ(frames[1].pixels, Pixels({R, B, R, G, G, B}));
+        EXPECT_EQ(frames[1].delay, milliseconds(100));
+
+        // the area of the last image was cleared
+        EXPECT_EQ(frames[2].pixels, Pixels({G, 0, 0, G, 0, 0}));
+        EXPECT_EQ(frames[2].delay, milliseconds(100));
+
+        EXPECT_TRUE(decoder->rewind());
+    }
+}
+
+TEST(AnimatedImageGif, RestorePrevious)
+{
+    const auto gif = GifWriter(3, 2)
+                     .image(0, 0, 3, 2, {1, 1, 1, 1, 1, 1})
+                     .control(3, -1, 0)
+                     .image(0, 0, 2, 1, {3, 3})
+                     .image(2, 1, 1, 1, {2})
+                     .end();
+
+    auto decoder = decoder_for("restore.gif", gif);
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 3U);
+    EXPECT_EQ(frames[1].pixels, Pixels({B, B, R, R, R, R}));
+    EXPECT_EQ(frames[2].pixels, Pixels({R, R, R, R, R, G}));
+}
+
+TEST(AnimatedImageGif, Interlaced)
+{
+    // rows are stored in the order 0, 4, 2, 1, 3
+    const auto gif = GifWriter(1, 5)
+                     .image(0, 0, 1, 5, {0, 1, 2, 3, 1}, true)
+                     .end();
+
+    auto decoder = decoder_for("interlaced.gif", gif);
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({K, B, G, R, R}));
+}
+
+TEST(AnimatedImageGif, Compressed)
+{
+    // codes of the table built while decoding, growing to 4 bits
+    const auto gif = GifWriter(4, 4)
+                     .descriptor(0, 0, 4, 4)
+                     .lzw(2, {0x8c, 0x2f, 0xa9, 0x21, 0x5c})
+                     .end();
+
+    auto decoder = decoder_for("compressed.gif", gif);
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({R, R, R, R, R, R, G, G, G, G, G, G, R, G, R, G}));
+}
+
+TEST(AnimatedImageGif, Clipped)
+{
+    // the part of the image outside the canvas is dropped
+    const auto gif = GifWriter(2, 2)
+                     .control(3, -1, 0)
+                     .image(1, 1, 2, 2, {3, 3, 3, 3})
+                     .image(0, 0, 1, 1, {1})
+                     .end();
+
+    auto decoder = decoder_for("clipped.gif", gif);
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 2U);
+    EXPECT_EQ(frames[0].pixels, Pixels({0, 0, 0, B}));
+    EXPECT_EQ(frames[1].pixels, Pixels({R, 0, 0, 0}));
+}
+
+TEST(AnimatedImageGif, Malformed)
+{
+    // no decoder
+    EXPECT_FALSE(decoder_for("empty.gif", {}));
+    EXPECT_FALSE(decoder_for("signature.gif", {'G', 'I', 'F', '8', '9'}));
+    EXPECT_FALSE(decoder_for("zero.gif", GifWriter(0, 5).end()));
+    EXPECT_FALSE(decoder_for("huge.gif", GifWriter(0xffff, 0xffff).end()));
+
+    // the header is fine, but there are no frames
+    auto header = GifWriter(2, 2).bytes;
+    auto decoder = decoder_for("header.gif", header);
+    ASSERT_TRUE(decoder);
+    EXPECT_TRUE(decode(*decoder).empty());
+
+    // truncated in the palette
+    header.resize(20);
+    EXPECT_FALSE(decoder_for("palette.gif", header));
+
+    // truncated anywhere before the end of the image
+    const auto valid = GifWriter(2, 2).image(0, 0, 2, 2, {1, 2, 3, 1}).end();
+    for (auto length = valid.size() - 2; length > 25; --length)
+    {
+        decoder = decoder_for("truncated.gif", Bytes(valid.begin(), valid.begin() + length));
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty()) << length;
+    }
+
+    for (uint8_t size : {0, 9, 12})
+    {
+        decoder = decoder_for("codesize.gif", GifWriter(2, 2)
+                       .descriptor(0, 0, 2, 2)
+                       .lzw(size, {0xff, 0xff})
+                       .end());
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty()) << size;
+    }
+
+    // a code not in the table yet: 7 after the clear code
+    decoder = decoder_for("code.gif", GifWriter(2, 2)
+                   .descriptor(0, 0, 2, 2)
+                   .lzw(2, {0x3c, 0x00})
+                   .end());
+    ASSERT_TRUE(decoder);
+    EXPECT_TRUE(decode(*decoder).empty());
+
+    // codes past the end of the image are ignored
+    decoder = decoder_for("long.gif", GifWriter(1, 1)
+                   .image(0, 0, 1, 1, {1, 2, 3, 1, 2})
+                   .end());
+    ASSERT_TRUE(decoder);
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({R}));
+}
+
+/*
+ * ERAW image with its header.
+ */
+static Bytes eraw(uint32_t width, uint32_t height, uint32_t delay, const Bytes& blocks)
+{
+    Bytes bytes;
+    put32le(bytes, 0x50502AA2);
+    put32le(bytes, width);
+    put32le(bytes, height);
+    put32le(bytes, delay);
+    for (auto i = 0; i < 3; ++i)
+        put32le(bytes, 0);
+    bytes.insert(bytes.end(), blocks.begin(), blocks.end());
+    return bytes;
+}
+
+static Bytes repeat(uint16_t count, uint32_t value)
+{
+    Bytes bytes;
+    put16le(bytes, count | 0x8000);
+    put32le(bytes, value);
+    return bytes;
+}
+
+static Bytes raw(const Pixels& pixels)
+{
+    Bytes bytes;
+    put16le(bytes, pixels.size());
+    for (auto p : pixels)
+        put32le(bytes, p);
+    return bytes;
+}
+
+static Bytes operator+(Bytes lhs, const Bytes& rhs)
+{
+    lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+    return lhs;
+}
+
+TEST(AnimatedImageEraw, Frames)
+{
+    const auto sequence = eraw(3, 2, 0, repeat(6, R)) +
+                          eraw(3, 2, 25, raw({G, B}) + repeat(3, K) + raw({0x80000080}));
+
+    auto decoder = decoder_for("frames.eraw", sequence);
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decoder->size(), egt::Size(3, 2));
+
+    for (auto pass = 0; pass < 2; ++pass)
+    {
+        const auto frames = decode(*decoder);
+        ASSERT_EQ(frames.size(), 2U);
+        EXPECT_EQ(frames[0].pixels, Pixels({R, R, R, R, R, R}));
+        EXPECT_EQ(frames[0].delay, milliseconds(40));
+        EXPECT_EQ(frames[1].pixels, Pixels({G, B, K, K, K, 0x80000080}));
+        EXPECT_EQ(frames[1].delay, milliseconds(25));
+
+        EXPECT_TRUE(decoder->rewind());
+    }
+
+    // without padding between rows
+    Pixels data(6);
+    milliseconds delay{};
+    ASSERT_TRUE(decoder->next(reinterpret_cast<unsigned char*>(data.data()),
+                              3 * sizeof(uint32_t), delay));
+    EXPECT_EQ(data, Pixels({R, R, R, R, R, R}));
+}
+
+TEST(AnimatedImageEraw, Malformed)
+{
+    EXPECT_FALSE(decoder_for("magic.eraw", Bytes(32, 0)));
+    const auto header = eraw(2, 2, 0, {});
+    EXPECT_FALSE(decoder_for("header.eraw", Bytes(header.begin(), header.begin() + 20)));
+    EXPECT_FALSE(decoder_for("zero.eraw", eraw(0, 2, 0, {})));
+    EXPECT_FALSE(decoder_for("huge.eraw", eraw(8192, 8192, 0, {})));
+
+    // blocks past the end of the image
+    for (const auto& blocks : {repeat(5, R), raw({R, R, R, R, R}), raw({R}) + repeat(4, G)})
+    {
+        auto decoder = decoder_for("overrun.eraw", eraw(2, 2, 0, blocks));
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty());
+    }
+
+    // frames after a bad one are not decoded
+    auto decoder = decoder_for("size.eraw", eraw(2, 2, 0, repeat(4, R)) +
+                        eraw(2, 3, 0, repeat(6, R)) +
+                        eraw(2, 2, 0, repeat(4, R)));
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decode(*decoder).size(), 1U);
+
+    const auto valid = eraw(2, 2, 0, raw({R, G}) + repeat(2, B));
+    for (auto length = valid.size() - 1; length >= 28; --length)
+    {
+        decoder = decoder_for("truncated.eraw", Bytes(valid.begin(), valid.begin() + length));
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty()) << length;
+    }
+}
+
+#ifdef HAVE_ZLIB
+
+/*
+ * PNG with 8 bit samples.
+ */
+class PngWriter
+{
+public:
+
+    PngWriter(uint32_t width, uint32_t height, uint8_t color_type,
+              uint8_t depth = 8, uint8_t interlace = 0)
+        : bytes({137, 80, 78, 71, 13, 10, 26, 10})
+    {
+        Bytes header;
+        put32be(header, width);
+        put32be(header, height);
+        header.insert(header.end(), {depth, color_type, 0, 0, interlace});
+        chunk("IHDR", header);
+    }
+
+    PngWriter& chunk(const char* type, const Bytes& data)
+    {
+        put32be(bytes, data.size());
+        const auto start = bytes.size();
+        bytes.insert(bytes.end(), type, type + 4);
+        bytes.insert(bytes.end(), data.begin(), data.end());
+        put32be(bytes, crc32(0, bytes.data() + start, bytes.size() - start));
+        return *this;
+    }
+
+    PngWriter& animation(uint32_t frames)
+    {
+        Bytes data;
+        put32be(data, frames);
+        put32be(data, 0);
+        return chunk("acTL", data);
+    }
+
+    PngWriter& control(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                       uint16_t num, uint16_t den, uint8_t dispose, uint8_t blend)
+    {
+        Bytes data;
+        put32be(data, m_sequence++);
+        put32be(data, width);
+        put32be(data, height);
+        put32be(data, x);
+        put32be(data, y);
+        data.push_back(num >> 8);
+        data.push_back(num & 0xff);
+        data.push_back(den >> 8);
+        data.push_back(den & 0xff);
+        data.push_back(dispose);
+        data.push_back(blend);
+        return chunk("fcTL", data);
+    }
+
+    /// Image data of rows that start with their filter type, in two chunks.
+    PngWriter& data(const char* type, const std::vector<Bytes>& rows)
+    {
+        Bytes filtered;
+        for (const auto& row : rows)
+            filtered.insert(filtered.end(), row.begin(), row.end());
+
+        Bytes compressed(compressBound(filtered.size()));
+        uLongf length = compressed.size();
+        compress(compressed.data(), &length, filtered.data(), filtered.size());
+        compressed.resize(length);
+
+        const auto half = compressed.size() / 2;
+        for (const auto& part : {Bytes(compressed.begin(), compressed.begin() + half),
+                                 Bytes(compressed.begin() + half, compressed.end())
+                                })
+        {
+            if (std::string(type) == "fdAT")
+            {
+                Bytes sequence;
+                put32be(sequence, m_sequence++);
+                chunk(type, sequence + part);
+            }
+            else
+            {
+                chunk(type, part);
+            }
+        }
+        return *this;
+    }
+
+    Bytes end()
+    {
+        chunk("IEND", {});
+        return bytes;
+    }
+
+    Bytes bytes;
+
+private:
+
+    uint32_t m_sequence{0};
+};
+
+TEST(AnimatedImageApng, Still)
+{
+    // premultiplied
+    const auto png = PngWriter(2, 2, 6)
+                     .data("IDAT", {{0, 255, 0, 0, 255, 0, 0, 255, 128},
+                         {0, 255, 255, 255, 0, 10, 20, 30, 51}
+                     })
+                     .end();
+
+    auto decoder = decoder_for("still.png", png);
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decoder->size(), egt::Size(2, 2));
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({R, 0x80000080, 0, 0x33020406}));
+    EXPECT_EQ(frames[0].delay, milliseconds(10));
+}
+
+TEST(AnimatedImageApng, Frames)
+{
+    const uint8_t T[] = {0, 0, 0, 0};
+    const uint8_t r[] = {255, 0, 0, 255};
+    const uint8_t g[] = {0, 255, 0, 255};
+    const uint8_t b[] = {0, 0, 255, 255};
+    auto row = [](std::initializer_list<const uint8_t*> pixels)
+    {
+        Bytes result{0};
+        for (auto p : pixels)
+            result.insert(result.end(), p, p + 4);
+        return result;
+    };
+
+    const auto png = PngWriter(3, 2, 6)
+                     .animation(4)
+                     // the default image is the first frame
+                     .control(0, 0, 3, 2, 1, 20, 0, 0)
+                     .data("IDAT", {row({r, r, r}), row({g, g, g})})
+                     // transparent pixels are blended
+                     .control(1, 0, 2, 2, 0, 0, 1, 1)
+                     .data("fdAT", {row({b, T}), row({T, b})})
+                     .control(0, 0, 1, 1, 3, 0, 2, 0)
+                     .data("fdAT", {row({T})})
+                     .control(2, 1, 1, 1, 1, 1000, 0, 0)
+                     .data("fdAT", {row({g})})
+                     .end();
+
+    auto decoder = decoder_for("frames.png", png);
+    ASSERT_TRUE(decoder);
+
+    for (auto pass = 0; pass < 2; ++pass)
+    {
+        const auto frames = decode(*decoder);
+        ASSERT_EQ(frames.size(), 4U);
+
+        EXPECT_EQ(frames[0].pixels, Pixels({R, R, R, G, G, G}));
+        EXPECT_EQ(frames[0].delay, milliseconds(50));
+
+        EXPECT_EQ(frames[1].pixels, Pixels({R, B, R, G, G, B}));
+        EXPECT_EQ(frames[1].delay, milliseconds(10));
+
+        // cleared the last area, and replaced without blending
+        EXPECT_EQ(frames[2].pixels, Pixels({0, 0, 0, G, 0, 0}));
+        EXPECT_EQ(frames[2].delay, milliseconds(30));
+
+        // restored the last area
+        EXPECT_EQ(frames[3].pixels, Pixels({R, 0, 0, G, 0, G}));
+        EXPECT_EQ(frames[3].delay, milliseconds(10));
+
+        EXPECT_TRUE(decoder->rewind());
+    }
+}
+
+TEST(AnimatedImageApng, DefaultImage)
+{
+    // the default image is not part of the animation without a control
+    const auto png = PngWriter(1, 1, 2)
+                     .animation(1)
+                     .data("IDAT", {{0, 255, 0, 0}})
+                     .control(0, 0, 1, 1, 0, 0, 0, 0)
+                     .data("fdAT", {{0, 0, 0, 255}})
+                     .end();
+
+    auto decoder = decoder_for("default.png", png);
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({B}));
+}
+
+TEST(AnimatedImageApng, Filters)
+{
+    // gray and alpha, with each filter type once
+    const std::vector<Bytes> raw =
+    {
+        {10, 255, 20, 255, 30, 255},
+        {40, 255, 35, 255, 250, 255},
+        {5, 255, 200, 255, 7, 255},
+        {90, 255, 91, 255, 92, 255},
+        {0, 255, 128, 255, 255, 255},
+    };
+
+    std::vector<Bytes> rows;
+    for (size_t y = 0; y < raw.size(); ++y)
+    {
+        const auto filter = static_cast<uint8_t>(y);
+        Bytes row{filter};
+        for (size_t i = 0; i < raw[y].size(); ++i)
+        {
+            const int a = i >= 2 ? raw[y][i - 2] : 0;
+            const int b = y ? raw[y - 1][i] : 0;
+            const int c = y && i >= 2 ? raw[y - 1][i - 2] : 0;
+            int predicted = 0;
+            if (filter == 1)
+                predicted = a;
+            else if (filter == 2)
+                predicted = b;
+            else if (filter == 3)
+                predicted = (a + b) / 2;
+            else if (filter == 4)
+            {
+                const auto p = a + b - c;
+                if (std::abs(p - a) <= std::abs(p - b) && std::abs(p - a) <= std::abs(p - c))
+                    predicted = a;
+                else if (std::abs(p - b) <= std::abs(p - c))
+                    predicted = b;
+                else
+                    predicted = c;
+            }
+            row.push_back(static_cast<uint8_t>(raw[y][i] - predicted));
+        }
+        rows.push_back(row);
+    }
+
+    auto decoder = decoder_for("filters.png", PngWriter(3, 5, 4).data("IDAT", rows).end());
+    ASSERT_TRUE(decoder);
+
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    Pixels expected;
+    for (const auto& row : raw)
+        for (size_t i = 0; i < row.size(); i += 2)
+            expected.push_back(0xff000000u | row[i] << 16u | row[i] << 8u | row[i]);
+    EXPECT_EQ(frames[0].pixels, expected);
+}
+
+TEST(AnimatedImageApng, Palette)
+{
+    const auto png = PngWriter(4, 1, 3)
+                     .chunk("PLTE", {255, 0, 0, 0, 0, 255, 0, 255, 0})
+                     .chunk("tRNS", {255, 0})
+                     .data("IDAT", {{0, 0, 1, 2, 200}})
+                     .end();
+
+    auto decoder = decoder_for("palette.png", png);
+    ASSERT_TRUE(decoder);
+
+    // entries past the palette are opaque black
+    const auto frames = decode(*decoder);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].pixels, Pixels({R, 0, G, K}));
+}
+
+TEST(AnimatedImageApng, Malformed)
+{
+    // not supported
+    EXPECT_FALSE(decoder_for("depth.png", PngWriter(1, 1, 6, 16).end()));
+    EXPECT_FALSE(decoder_for("interlace.png", PngWriter(1, 1, 6, 8, 1).end()));
+    EXPECT_FALSE(decoder_for("color.png", PngWriter(1, 1, 5).end()));
+    EXPECT_FALSE(decoder_for("huge.png", PngWriter(5000, 5000, 6).end()));
+
+    // frames outside the canvas
+    for (const auto& area : {egt::Rect(1, 0, 2, 1), egt::Rect(0, 0, 2, 2),
+                             egt::Rect(0xffffffff, 0, 2, 1), egt::Rect(0, 0, 0, 1)
+                            })
+    {
+        auto decoder = decoder_for("area.png", PngWriter(2, 1, 0)
+                            .animation(1)
+                            .control(area.x(), area.y(), area.width(), area.height(), 0, 0, 0, 0)
+                            .data("fdAT", {{0, 1, 2}})
+                            .end());
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty()) << area;
+    }
+
+    // frame data without a frame control
+    auto decoder = decoder_for("control.png", PngWriter(1, 1, 0).data("fdAT", {{0, 1}}).end());
+    ASSERT_TRUE(decoder);
+    EXPECT_TRUE(decode(*decoder).empty());
+
+    // too little data
+    decoder = decoder_for("short.png", PngWriter(3, 2, 0).data("IDAT", {{0, 1, 2, 3}, {0}}).end());
+    ASSERT_TRUE(decoder);
+    EXPECT_TRUE(decode(*decoder).empty());
+
+    // data past the end of the frame is ignored
+    decoder = decoder_for("long.png", PngWriter(3, 1, 0).data("IDAT", {{0, 1, 2, 3}, {0}}).end());
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decode(*decoder).size(), 1U);
+
+    const auto valid = PngWriter(2, 2, 2)
+                       .data("IDAT", {{0, 1, 2, 3, 4, 5, 6}, {0, 7, 8, 9, 10, 11, 12}})
+                       .end();
+    // the CRC of the last data chunk is not checked
+    for (auto length = valid.size() - 17; length > 33; --length)
+    {
+        decoder = decoder_for("truncated.png", Bytes(valid.begin(), valid.begin() + length));
+        ASSERT_TRUE(decoder);
+        EXPECT_TRUE(decode(*decoder).empty()) << length;
+    }
+}
+
+#endif
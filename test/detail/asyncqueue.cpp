@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/asyncqueue.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AsyncQueueTest : public testing::Test
+{
+protected:
+
+    AsyncQueueTest()
+        : queue(io)
+    {}
+
+    void run()
+    {
+        io.restart();
+        io.run();
+    }
+
+    egt::asio::io_context io;
+    egt::detail::AsyncQueue queue;
+    std::string order;
+};
+
+TEST_F(AsyncQueueTest, Order)
+{
+    queue.post(nullptr, [this]() { order += "a "; });
+    queue.post(nullptr, [this]() { order += "b "; });
+    queue.post(nullptr, [this]() { order += "c "; });
+    EXPECT_EQ(order, "");
+
+    run();
+    EXPECT_EQ(order, "a b c ");
+}
+
+TEST_F(AsyncQueueTest, Coalesce)
+{
+    int key1{};
+    int key2{};
+
+    // the latest call of a key runs in the place of the first
+    queue.post(&key1, [this]() { order += "a1 "; });
+    queue.post(nullptr, [this]() { order += "x "; });
+    queue.post(&key2, [this]() { order += "b1 "; });
+    queue.post(&key1, [this]() { order += "a2 "; });
+    queue.post(nullptr, [this]() { order += "y "; });
+    queue.post(&key1, [this]() { order += "a3 "; });
+
+    run();
+    EXPECT_EQ(order, "a3 x b1 y ");
+
+    // keys only coalesce pending calls
+    queue.post(&key1, [this]() { order += "a4 "; });
+    run();
+    EXPECT_EQ(order, "a3 x b1 y a4 ");
+}
+
+TEST_F(AsyncQueueTest, PostWhileDraining)
+{
+    int key{};
+
+    queue.post(&key, [this, &key]()
+    {
+        order += "a1 ";
+        // not coalesced with the running call, and run by the next drain
+        queue.post(&key, [this]() { order += "a2 "; });
+        queue.post(nullptr, [this]() { order += "c "; });
+    });
+    queue.post(nullptr, [this]() { order += "b "; });
+
+    run();
+    EXPECT_EQ(order, "a1 b a2 c ");
+}
+
+TEST_F(AsyncQueueTest, Cancel)
+{
+    int key1{};
+    int key2{};
+
+    queue.post(&key1, [this]() { order += "a1 "; });
+    queue.post(&key2, [this]() { order += "b "; });
+    queue.cancel(&key1);
+    queue.cancel(nullptr);
+
+    // a key posted again after being cancelled is not cancelled
+    queue.post(&key1, [this]() { order += "a2 "; });
+
+    run();
+    EXPECT_EQ(order, "b a2 ");
+}
+
+TEST_F(AsyncQueueTest, CancelWhileDraining)
+{
+    int key1{};
+    int key2{};
+
+    queue.post(nullptr, [this, &key1, &key2]()
+    {
+        order += "x ";
+        queue.cancel(&key1);
+        queue.cancel(&key2);
+    });
+    queue.post(&key1, [this]() { order += "a "; });
+    queue.post(nullptr, [this]() { order += "y "; });
+
+    run();
+    EXPECT_EQ(order, "x y ");
+}
+
+TEST_F(AsyncQueueTest, Threads)
+{
+    // more calls than one block of nodes, from several threads
+    constexpr auto THREADS = 4;
+    constexpr auto CALLS = 100;
+
+    int count = 0;
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([this, &count]()
+        {
+            for (auto i = 0; i < CALLS; ++i)
+                queue.post(nullptr, [&count]() { ++count; });
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    run();
+    EXPECT_EQ(count, THREADS * CALLS);
+
+    // nodes are reused
+    for (auto i = 0; i < CALLS; ++i)
+        queue.post(nullptr, [&count]() { ++count; });
+    run();
+    EXPECT_EQ(count, (THREADS + 1) * CALLS);
+}
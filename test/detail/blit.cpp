@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/blit.h"
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+/*
+ * The kernels are selected for the machine running the test, and every one
+ * of them must give exactly the same result as these.
+ */
+static uint32_t reference_colormap(float value, float offset, float scale,
+                                   const uint32_t* lut)
+{
+    const auto t = (value - offset) * scale;
+    if (!(t > 0.f))
+        return lut[0];
+    if (t >= 255.f)
+        return lut[255];
+    return lut[static_cast<int>(t + 0.5f)];
+}
+
+static std::array<uint32_t, 256> lut()
+{
+    std::array<uint32_t, 256> result{};
+    for (uint32_t i = 0; i < result.size(); ++i)
+        result[i] = 0x9e3779b9u * (i + 1);
+    return result;
+}
+
+TEST(Blit, Colormap32)
+{
+    SCOPED_TRACE(egt::detail::blit_isa());
+
+    const auto table = lut();
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto inf = std::numeric_limits<float>::infinity();
+
+    // enough values for the vector loops, and then the remainder
+    const std::vector<std::pair<float, int>> cases =
+    {
+        {10.f, 0},
+        {10.2f, 0},
+        {10.25f, 1},
+        {10.7f, 1},
+        {11.f, 2},
+        {9.f, 0},
+        {-1e30f, 0},
+        {-inf, 0},
+        {nan, 0},
+        {-nan, 0},
+        {137.3f, 255},
+        {137.2f, 254},
+        {200.f, 255},
+        {1e30f, 255},
+        {inf, 255},
+        {std::numeric_limits<float>::max(), 255},
+        {std::numeric_limits<float>::denorm_min(), 0},
+        {73.f, 126},
+        {nan, 0},
+    };
+
+    std::vector<float> src;
+    for (const auto& c : cases)
+        src.push_back(c.first);
+
+    std::vector<uint32_t> dst(src.size());
+    egt::detail::colormap32(dst.data(), src.data(), src.size(), 10.f, 2.f, table.data());
+
+    for (size_t i = 0; i < cases.size(); ++i)
+        EXPECT_EQ(dst[i], table[cases[i].second]) << "value " << cases[i].first;
+}
+
+TEST(Blit, Colormap32Random)
+{
+    SCOPED_TRACE(egt::detail::blit_isa());
+
+    const auto table = lut();
+    std::mt19937 gen(47);
+    std::uniform_real_distribution<float> value(-300.f, 300.f);
+    const float special[] =
+    {
+        std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::lowest(),
+    };
+
+    for (auto round = 0; round < 200; ++round)
+    {
+        const auto offset = value(gen);
+        const auto scale = std::uniform_real_distribution<float>(-4.f, 4.f)(gen);
+
+        // unaligned spans of all lengths
+        const size_t start = gen() % 8;
+        const size_t count = gen() % 70;
+        std::vector<float> src(start + count);
+        for (auto& s : src)
+            s = gen() % 16 ? value(gen) : special[gen() % 5];
+        std::vector<uint32_t> dst(start + count + 1, 0xdeadbeef);
+
+        egt::detail::colormap32(dst.data() + start, src.data() + start, count,
+                                offset, scale, table.data());
+
+        for (size_t i = 0; i < start; ++i)
+            ASSERT_EQ(dst[i], 0xdeadbeef);
+        for (size_t i = start; i < start + count; ++i)
+            ASSERT_EQ(dst[i], reference_colormap(src[i], offset, scale, table.data()))
+                    << "value " << src[i] << " offset " << offset << " scale " << scale;
+        ASSERT_EQ(dst[start + count], 0xdeadbeef);
+    }
+}
+
+/*
+ * BT.601 video range, as documented for yuv32() and yuv16().
+ */
+static void reference_yuv(int y, int u, int v, int& r, int& g, int& b)
+{
+    auto clamp = [](int value) { return std::min(std::max(value, 0), 255); };
+
+    y = (((y - 16) * 149) >> 1) + 32;
+    u -= 128;
+    v -= 128;
+    r = clamp((y + v * 102) >> 6);
+    g = clamp((y - u * 25 - v * 52) >> 6);
+    b = clamp((y + u * 129) >> 6);
+}
+
+static uint32_t reference_yuv32(int y, int u, int v)
+{
+    int r;
+    int g;
+    int b;
+    reference_yuv(y, u, v, r, g, b);
+    return 0xff000000u | (r << 16u) | (g << 8u) | b;
+}
+
+static uint16_t reference_yuv16(int y, int u, int v)
+{
+    int r;
+    int g;
+    int b;
+    reference_yuv(y, u, v, r, g, b);
+    return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+TEST(Blit, Yuv)
+{
+    SCOPED_TRACE(egt::detail::blit_isa());
+
+    // black, white, gray, and the saturated corners
+    const std::vector<std::array<uint8_t, 3>> yuv =
+    {
+        {16, 128, 128},
+        {235, 128, 128},
+        {126, 128, 128},
+        {0, 128, 128},
+        {255, 128, 128},
+        {0, 0, 0},
+        {255, 255, 255},
+        {0, 255, 0},
+        {255, 0, 255},
+        {81, 90, 240},
+        {145, 54, 34},
+        {41, 240, 110},
+    };
+    const std::vector<uint32_t> rgb32 =
+    {
+        0xff000000,
+        0xffffffff,
+        0xff808080,
+        0xff000000,
+        0xffffffff,
+        0xff008700,
+        0xffff7dff,
+        0xff0024ed,
+        0xffffe114,
+        0xfffe0000,
+        0xff00ff01,
+        0xff0000ff,
+    };
+
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> u;
+    std::vector<uint8_t> v;
+    for (const auto& p : yuv)
+    {
+        y.push_back(p[0]);
+        u.push_back(p[1]);
+        v.push_back(p[2]);
+    }
+
+    std::vector<uint32_t> dst32(yuv.size());
+    egt::detail::yuv32(dst32.data(), y.data(), u.data(), v.data(), yuv.size());
+    std::vector<uint16_t> dst16(yuv.size());
+    egt::detail::yuv16(dst16.data(), y.data(), u.data(), v.data(), yuv.size());
+
+    for (size_t i = 0; i < yuv.size(); ++i)
+    {
+        EXPECT_EQ(dst32[i], rgb32[i]) << i;
+        EXPECT_EQ(dst16[i], reference_yuv16(yuv[i][0], yuv[i][1], yuv[i][2])) << i;
+    }
+}
+
+TEST(Blit, YuvAll)
+{
+    SCOPED_TRACE(egt::detail::blit_isa());
+
+    // every luma in one span, for every chroma
+    std::array<uint8_t, 256> y{};
+    for (size_t i = 0; i < y.size(); ++i)
+        y[i] = i;
+
+    std::array<uint8_t, 256> u{};
+    std::array<uint8_t, 256> v{};
+    std::array<uint32_t, 256> dst32{};
+    std::array<uint16_t, 256> dst16{};
+    for (auto cu = 0; cu < 256; ++cu)
+    {
+        u.fill(cu);
+        for (auto cv = 0; cv < 256; ++cv)
+        {
+            v.fill(cv);
+            egt::detail::yuv32(dst32.data(), y.data(), u.data(), v.data(), y.size());
+            egt::detail::yuv16(dst16.data(), y.data(), u.data(), v.data(), y.size());
+
+            for (auto cy = 0; cy < 256; ++cy)
+            {
+                ASSERT_EQ(dst32[cy], reference_yuv32(cy, cu, cv))
+                        << "y " << cy << " u " << cu << " v " << cv;
+                ASSERT_EQ(dst16[cy], reference_yuv16(cy, cu, cv))
+                        << "y " << cy << " u " << cu << " v " << cv;
+            }
+        }
+    }
+}
+
+TEST(Blit, YuvSpans)
+{
+    SCOPED_TRACE(egt::detail::blit_isa());
+
+    std::mt19937 gen(50);
+    for (auto round = 0; round < 200; ++round)
+    {
+        // unaligned spans of all lengths
+        const size_t start = gen() % 16;
+        const size_t count = gen() % 70;
+        std::vector<uint8_t> y(start + count);
+        std::vector<uint8_t> u(start + count);
+        std::vector<uint8_t> v(start + count);
+        for (size_t i = 0; i < y.size(); ++i)
+        {
+            y[i] = gen();
+            u[i] = gen();
+            v[i] = gen();
+        }
+
+        std::vector<uint32_t> dst32(start + count + 1, 0xdeadbeef);
+        std::vector<uint16_t> dst16(start + count + 1, 0xbeef);
+        egt::detail::yuv32(dst32.data() + start, y.data() + start, u.data() + start,
+                           v.data() + start, count);
+        egt::detail::yuv16(dst16.data() + start, y.data() + start, u.data() + start,
+                           v.data() + start, count);
+
+        for (size_t i = 0; i < start; ++i)
+        {
+            ASSERT_EQ(dst32[i], 0xdeadbeef);
+            ASSERT_EQ(dst16[i], 0xbeef);
+        }
+        for (size_t i = start; i < start + count; ++i)
+        {
+            ASSERT_EQ(dst32[i], reference_yuv32(y[i], u[i], v[i])) << i;
+            ASSERT_EQ(dst16[i], reference_yuv16(y[i], u[i], v[i])) << i;
+        }
+        ASSERT_EQ(dst32[start + count], 0xdeadbeef);
+        ASSERT_EQ(dst16[start + count], 0xbeef);
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/frameclock.h"
+#include <chrono>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using egt::detail::FrameClock;
+
+class FrameClockTest : public testing::Test
+{
+protected:
+
+    /// Run the event loop for a while.
+    void run(std::chrono::milliseconds duration)
+    {
+        egt::Timer timer(duration);
+        timer.on_timeout([this]() { app.event().quit(); });
+        timer.start();
+        app.event().run();
+    }
+
+    egt::Application app;
+    std::string order;
+};
+
+TEST_F(FrameClockTest, Shared)
+{
+    auto a = FrameClock::get(30);
+    EXPECT_EQ(a->fps(), 30U);
+
+    // one clock for each frame rate
+    EXPECT_EQ(FrameClock::get(30), a);
+    auto b = FrameClock::get(60);
+    EXPECT_NE(b, a);
+    EXPECT_EQ(b->fps(), 60U);
+    EXPECT_EQ(FrameClock::get(0)->fps(), 1U);
+
+    // and only while something holds it
+    std::weak_ptr<FrameClock> weak = a;
+    a.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST_F(FrameClockTest, Pacing)
+{
+    auto clock = FrameClock::get(50);
+
+    auto a = 0;
+    auto b = 0;
+    clock->add([&a]() { ++a; });
+    clock->add([&b]() { ++b; });
+
+    // about one call per frame, to every subscriber from the one timer
+    const auto start = std::chrono::steady_clock::now();
+    run(std::chrono::milliseconds(300));
+    const auto frames = (std::chrono::steady_clock::now() - start) /
+                        std::chrono::milliseconds(20);
+    EXPECT_GE(a, 5);
+    EXPECT_LE(a, frames + 1);
+    EXPECT_EQ(a, b);
+}
+
+TEST_F(FrameClockTest, Order)
+{
+    auto clock = FrameClock::get(100);
+
+    auto ticks = 0;
+    FrameClock::Handle added = 0;
+    clock->add([&]()
+    {
+        order += "a ";
+
+        // added while ticking, so called from the next frame
+        if (!added)
+            added = clock->add([this]() { order += "b "; });
+
+        if (++ticks == 3)
+            app.event().quit();
+    });
+
+    app.event().run();
+    EXPECT_EQ(order, "a a b a b ");
+}
+
+TEST_F(FrameClockTest, Remove)
+{
+    auto clock = FrameClock::get(100);
+
+    auto ticks = 0;
+    FrameClock::Handle self = 0;
+    FrameClock::Handle other = 0;
+    FrameClock::Handle added = 0;
+
+    // removing itself, another subscriber and one added in the same frame
+    self = clock->add([&]()
+    {
+        order += "self ";
+        added = clock->add([this]() { order += "added "; });
+        clock->remove(added);
+        clock->remove(other);
+        clock->remove(self);
+    });
+    other = clock->add([this]() { order += "other "; });
+    clock->add([&]()
+    {
+        order += "rest ";
+        if (++ticks == 3)
+            app.event().quit();
+    });
+
+    app.event().run();
+    EXPECT_EQ(order, "self rest rest rest ");
+
+    // unknown handles are ignored
+    clock->remove(self);
+    clock->remove(added + 100);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <array>
+#include <egt/detail/inplacefunction.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+using Function = egt::detail::InplaceFunction<int(int), 4 * sizeof(void*)>;
+
+/*
+ * Callable counting how many of its instances are alive.
+ */
+template<size_t Size, bool NothrowMove = true>
+struct Counted
+{
+    explicit Counted(int& alive)
+        : alive(&alive)
+    {
+        ++alive;
+    }
+
+    Counted(Counted&& rhs) noexcept(NothrowMove)
+        : alive(rhs.alive)
+    {
+        ++*alive;
+    }
+
+    Counted(const Counted& rhs)
+        : alive(rhs.alive)
+    {
+        ++*alive;
+    }
+
+    Counted& operator=(const Counted&) = delete;
+
+    ~Counted()
+    {
+        --*alive;
+    }
+
+    int operator()(int value) const
+    {
+        return value + static_cast<int>(padding.size());
+    }
+
+    int* alive;
+    std::array<char, Size> padding{};
+};
+
+using Small = Counted<8>;
+using Large = Counted<128>;
+using Throwing = Counted<8, false>;
+
+TEST(InplaceFunction, StoredInline)
+{
+    EXPECT_TRUE(Function::stored_inline<Small>());
+    EXPECT_FALSE(Function::stored_inline<Large>());
+    // moving it could throw, so it could not be moved out of the storage
+    EXPECT_FALSE(Function::stored_inline<Throwing>());
+}
+
+TEST(InplaceFunction, Empty)
+{
+    Function f;
+    EXPECT_FALSE(f);
+
+    Function n(nullptr);
+    EXPECT_FALSE(n);
+
+    int (*p)(int) = nullptr;
+    Function fp(p);
+    EXPECT_FALSE(fp);
+
+    Function s(std::function<int(int)> {});
+    EXPECT_FALSE(s);
+
+    s = [](int value) { return value; };
+    EXPECT_TRUE(s);
+    s = nullptr;
+    EXPECT_FALSE(s);
+}
+
+TEST(InplaceFunction, Call)
+{
+    Function lambda([](int value) { return value * 2; });
+    EXPECT_EQ(lambda(21), 42);
+
+    int (*p)(int) = [](int value) { return value + 1; };
+    Function fp(p);
+    EXPECT_EQ(fp(1), 2);
+
+    Function s(std::function<int(int)>([](int value) { return -value; }));
+    EXPECT_EQ(s(3), -3);
+
+    // move-only arguments are forwarded
+    egt::detail::InplaceFunction<int(std::unique_ptr<int>)> take(
+        [](std::unique_ptr<int> value) { return *value; });
+    EXPECT_EQ(take(std::make_unique<int>(7)), 7);
+}
+
+template<class T>
+class InplaceFunctionTest : public testing::Test
+{};
+
+using Callables = testing::Types<Small, Large, Throwing>;
+TYPED_TEST_SUITE(InplaceFunctionTest, Callables);
+
+TYPED_TEST(InplaceFunctionTest, Lifetime)
+{
+    int alive = 0;
+    {
+        Function f{TypeParam(alive)};
+        EXPECT_EQ(alive, 1);
+        EXPECT_EQ(f(1), 1 + static_cast<int>(sizeof(TypeParam::padding)));
+
+        f.reset();
+        EXPECT_EQ(alive, 0);
+        EXPECT_FALSE(f);
+
+        f = TypeParam(alive);
+        EXPECT_EQ(alive, 1);
+    }
+    EXPECT_EQ(alive, 0);
+}
+
+TYPED_TEST(InplaceFunctionTest, Move)
+{
+    int alive = 0;
+    {
+        Function a{TypeParam(alive)};
+        Function b(std::move(a));
+        EXPECT_EQ(alive, 1);
+        EXPECT_FALSE(a);
+        ASSERT_TRUE(b);
+        EXPECT_EQ(b(0), static_cast<int>(sizeof(TypeParam::padding)));
+
+        // the callable replaced is destroyed
+        int replaced = 0;
+        Function c{TypeParam(replaced)};
+        c = std::move(b);
+        EXPECT_EQ(replaced, 0);
+        EXPECT_EQ(alive, 1);
+        EXPECT_FALSE(b);
+        ASSERT_TRUE(c);
+
+        // moving from itself does nothing
+        auto& self = c;
+        c = std::move(self);
+        EXPECT_EQ(alive, 1);
+        ASSERT_TRUE(c);
+        EXPECT_EQ(c(0), static_cast<int>(sizeof(TypeParam::padding)));
+
+        // an empty function moves as empty
+        Function d(std::move(a));
+        EXPECT_FALSE(d);
+        c = std::move(d);
+        EXPECT_FALSE(c);
+        EXPECT_EQ(alive, 0);
+    }
+    EXPECT_EQ(alive, 0);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/input/inputthread.h"
+#include <chrono>
+#include <egt/ui>
+#include <future>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+/*
+ * Input dispatching events from whatever thread it is called on, like a
+ * backend reading a device on the input thread.
+ */
+class ThreadInput : public egt::Input
+{
+public:
+
+    void send(int x)
+    {
+        egt::Event event(egt::EventId::raw_pointer_move,
+                         egt::Pointer(egt::DisplayPoint(x, 0)));
+        dispatch(event);
+    }
+};
+
+class InputThreadTest : public testing::Test
+{
+protected:
+
+    InputThreadTest()
+        : thread(ui)
+    {
+        handle = egt::Input::global_input().on_event([this](egt::Event & event)
+        {
+            received.push_back(event.pointer().point.x());
+            threads.push_back(std::this_thread::get_id());
+            EXPECT_NE(event.timestamp(), egt::Event::Timestamp());
+        }, {egt::EventId::raw_pointer_move});
+    }
+
+    ~InputThreadTest() override
+    {
+        thread.stop();
+        egt::Input::global_input().remove_handler(handle);
+    }
+
+    /// Send events on the input thread, and wait until they are sent.
+    void send(int first, int count)
+    {
+        std::promise<void> sent;
+        egt::asio::post(thread.io(), [this, first, count, &sent]()
+        {
+            EXPECT_EQ(egt::detail::InputThread::current(), &thread);
+            for (auto i = first; i < first + count; ++i)
+                input.send(i);
+            sent.set_value();
+        });
+        sent.get_future().wait();
+    }
+
+    /// Run the event loop side.
+    void poll()
+    {
+        ui.restart();
+        ui.poll();
+    }
+
+    egt::Application app;
+    egt::asio::io_context ui;
+    egt::detail::InputThread thread;
+    ThreadInput input;
+    egt::Object::RegisterHandle handle{};
+    std::vector<int> received;
+    std::vector<std::thread::id> threads;
+};
+
+TEST_F(InputThreadTest, HandOff)
+{
+    EXPECT_EQ(egt::detail::InputThread::current(), nullptr);
+    thread.start();
+
+    // queued until the event loop runs
+    send(0, 100);
+    EXPECT_TRUE(received.empty());
+
+    poll();
+    ASSERT_EQ(received.size(), 100U);
+    for (auto i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(received[i], i);
+        EXPECT_EQ(threads[i], std::this_thread::get_id());
+    }
+
+    // and woken up again by the next ones
+    send(100, 1);
+    poll();
+    ASSERT_EQ(received.size(), 101U);
+    EXPECT_EQ(received.back(), 100);
+}
+
+TEST_F(InputThreadTest, Full)
+{
+    thread.start();
+
+    // more than the queue holds, so the input thread waits for room
+    const auto count = 5000;
+    auto sent = std::async(std::launch::async, [this, count]() { send(0, count); });
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (received.size() < static_cast<size_t>(count) &&
+           std::chrono::steady_clock::now() < timeout)
+    {
+        poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sent.wait();
+
+    // nothing dropped or out of order
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (auto i = 0; i < count; ++i)
+        ASSERT_EQ(received[i], i);
+}
+
+TEST_F(InputThreadTest, Stop)
+{
+    thread.start();
+    send(0, 10);
+
+    // queued events are dropped
+    thread.stop();
+    poll();
+    EXPECT_TRUE(received.empty());
+
+    // and started again with a new io()
+    thread.start();
+    send(10, 1);
+    poll();
+    ASSERT_EQ(received.size(), 1U);
+    EXPECT_EQ(received[0], 10);
+}
+
+TEST_F(InputThreadTest, Direct)
+{
+    // without the thread, events are dispatched right away
+    input.send(7);
+    ASSERT_EQ(received.size(), 1U);
+    EXPECT_EQ(received[0], 7);
+}
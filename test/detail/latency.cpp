@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/latency.h"
+#include <chrono>
+#include <egt/detail/screen/memoryscreen.h>
+#include <egt/latency.h>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using egt::InputLatency;
+
+class InputLatencyTest : public testing::Test
+{
+protected:
+
+    InputLatencyTest()
+    {
+        InputLatency::enable(true);
+        InputLatency::reset();
+    }
+
+    ~InputLatencyTest() override
+    {
+        InputLatency::enable(false);
+        InputLatency::reset();
+    }
+
+    /// Dispatch an event reported some time ago, damaging the screens.
+    static void dispatch(std::chrono::microseconds age,
+                         std::initializer_list<const egt::Screen*> screens)
+    {
+        egt::Event event(egt::EventId::raw_pointer_move);
+        event.timestamp(std::chrono::steady_clock::now() - age);
+        egt::detail::latency_dispatch_begin(event);
+        for (auto screen : screens)
+        {
+            egt::detail::latency_damage(screen);
+            egt::detail::latency_damage(screen);
+        }
+        egt::detail::latency_dispatch_end();
+    }
+
+    /// What Screen::flip() does.
+    static void flip(const egt::Screen* screen)
+    {
+        egt::detail::latency_draw_end(screen);
+        egt::detail::latency_flip(screen);
+    }
+
+    egt::detail::MemoryScreen a{egt::Size(32, 32)};
+    egt::detail::MemoryScreen b{egt::Size(32, 32)};
+};
+
+TEST_F(InputLatencyTest, Percentiles)
+{
+    EXPECT_TRUE(InputLatency::enabled());
+
+    // 1 to 100 ms, in a random order
+    for (auto i = 0; i < 100; ++i)
+    {
+        dispatch(std::chrono::milliseconds(1 + (i * 37) % 100), {&a});
+        flip(&a);
+    }
+    EXPECT_EQ(InputLatency::count(), 100U);
+
+    // within the width of a bucket, and some time to run the test
+    for (auto stage : {InputLatency::Stage::queue, InputLatency::Stage::total})
+    {
+        SCOPED_TRACE(stage);
+        EXPECT_NEAR(InputLatency::percentile(stage, 50), 50000, 50000 * 0.05);
+        EXPECT_NEAR(InputLatency::percentile(stage, 90), 90000, 90000 * 0.05);
+        EXPECT_NEAR(InputLatency::percentile(stage, 99), 99000, 99000 * 0.05);
+        EXPECT_GE(InputLatency::max(stage), 100000);
+        EXPECT_LT(InputLatency::max(stage), 105000);
+        EXPECT_LE(InputLatency::percentile(stage, 100), InputLatency::max(stage));
+    }
+
+    // nothing else takes any time
+    for (auto stage : {InputLatency::Stage::handle, InputLatency::Stage::draw,
+                       InputLatency::Stage::flip})
+    {
+        SCOPED_TRACE(stage);
+        EXPECT_LT(InputLatency::max(stage), 5000);
+    }
+
+    InputLatency::reset();
+    EXPECT_EQ(InputLatency::count(), 0U);
+    EXPECT_EQ(InputLatency::percentile(InputLatency::Stage::total, 50), 0);
+    EXPECT_EQ(InputLatency::max(InputLatency::Stage::total), 0);
+}
+
+TEST_F(InputLatencyTest, Damage)
+{
+    // events without damage are not measured
+    dispatch(std::chrono::milliseconds(1), {});
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 0U);
+
+    // and nothing is measured while disabled
+    InputLatency::enable(false);
+    dispatch(std::chrono::milliseconds(1), {&a});
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 0U);
+    InputLatency::enable(true);
+
+    // repeated damage to the same screen is one event
+    dispatch(std::chrono::milliseconds(1), {&a});
+    dispatch(std::chrono::milliseconds(1), {&a});
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 2U);
+}
+
+TEST_F(InputLatencyTest, Screens)
+{
+    dispatch(std::chrono::milliseconds(10), {&a});
+
+    // another screen flipping does not take the event
+    flip(&b);
+    EXPECT_EQ(InputLatency::count(), 0U);
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 1U);
+
+    // nor does a flip that was not drawn
+    dispatch(std::chrono::milliseconds(10), {&a});
+    egt::detail::latency_flip(&a);
+    EXPECT_EQ(InputLatency::count(), 1U);
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 2U);
+
+    // once for each screen damaged
+    dispatch(std::chrono::milliseconds(10), {&a, &b});
+    flip(&a);
+    EXPECT_EQ(InputLatency::count(), 3U);
+    flip(&b);
+    EXPECT_EQ(InputLatency::count(), 4U);
+    flip(&a);
+    flip(&b);
+    EXPECT_EQ(InputLatency::count(), 4U);
+}
+
+TEST_F(InputLatencyTest, Report)
+{
+    dispatch(std::chrono::milliseconds(10), {&a});
+    flip(&a);
+
+    std::ostringstream text;
+    InputLatency::report(text);
+    EXPECT_NE(text.str().find("input latency of 1 events"), std::string::npos);
+    for (auto stage : {"queue", "handle", "draw", "flip", "total"})
+        EXPECT_NE(text.str().find(stage), std::string::npos) << stage;
+
+    std::ostringstream json;
+    InputLatency::report_json(json);
+    EXPECT_EQ(json.str().find("{\"count\":1,\"queue\":{\"p50\":"), 0U);
+    EXPECT_EQ(json.str().back(), '}');
+}
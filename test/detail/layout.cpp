@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/detail/layout.h>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+using egt::detail::LayoutRect;
+
+static std::vector<LayoutRect> children()
+{
+    return
+    {
+        LayoutRect(0, egt::Rect(0, 0, 50, 20)),
+        LayoutRect(0, egt::Rect(0, 0, 30, 40), 5, 5, 5, 5),
+        LayoutRect(0, egt::Rect(0, 0, 10, 10)),
+    };
+}
+
+static std::vector<egt::Rect> rects(const std::vector<LayoutRect>& children)
+{
+    std::vector<egt::Rect> result;
+    for (const auto& child : children)
+        result.push_back(child.rect);
+    return result;
+}
+
+class FlexLayoutTest : public testing::TestWithParam<std::tuple<egt::Justification, egt::Orientation>>
+{};
+
+TEST_P(FlexLayoutTest, MatchesFlexLayout)
+{
+    const auto justify = std::get<0>(GetParam());
+    const auto orient = std::get<1>(GetParam());
+    const egt::Rect parent(0, 0, 200, 100);
+
+    auto expected = children();
+    egt::detail::flex_layout(parent, expected, justify, orient);
+
+    egt::detail::FlexLayout flex;
+    auto computed = children();
+    EXPECT_TRUE(flex.layout(parent, computed, justify, orient));
+    EXPECT_EQ(rects(computed), rects(expected));
+
+    // the same inputs give the last result without computing it again
+    auto cached = children();
+    EXPECT_FALSE(flex.layout(parent, cached, justify, orient));
+    EXPECT_EQ(rects(cached), rects(expected));
+}
+
+INSTANTIATE_TEST_SUITE_P(FlexLayoutTestGroup, FlexLayoutTest,
+                         testing::Combine(testing::Values(egt::Justification::start,
+                                          egt::Justification::middle,
+                                          egt::Justification::ending,
+                                          egt::Justification::justify,
+                                          egt::Justification::none),
+                                          testing::Values(egt::Orientation::horizontal,
+                                                  egt::Orientation::vertical,
+                                                  egt::Orientation::flex,
+                                                  egt::Orientation::none)));
+
+TEST(FlexLayout, Changes)
+{
+    const egt::Rect parent(0, 0, 200, 100);
+    const auto justify = egt::Justification::start;
+    const auto orient = egt::Orientation::horizontal;
+
+    egt::detail::FlexLayout flex;
+    auto c = children();
+    EXPECT_TRUE(flex.layout(parent, c, justify, orient));
+
+    // only the size of the parent is used
+    c = children();
+    EXPECT_FALSE(flex.layout(parent + egt::Point(10, 10), c, justify, orient));
+
+    c = children();
+    EXPECT_TRUE(flex.layout(egt::Rect(0, 0, 300, 100), c, justify, orient));
+
+    c = children();
+    EXPECT_TRUE(flex.layout(parent, c, justify, orient));
+
+    c = children();
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::ending, orient));
+
+    c = children();
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::ending,
+                            egt::Orientation::vertical));
+
+    c = children();
+    c[2].rmargin = 1;
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::ending,
+                            egt::Orientation::vertical));
+
+    c = children();
+    c[0].rect.width(51);
+    auto expected = c;
+    egt::detail::flex_layout(parent, expected, egt::Justification::ending,
+                             egt::Orientation::vertical);
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::ending,
+                            egt::Orientation::vertical));
+    EXPECT_EQ(rects(c), rects(expected));
+
+    // more children than the context had items for
+    c = children();
+    c.emplace_back(0, egt::Rect(0, 0, 20, 20));
+    c.emplace_back(0, egt::Rect(0, 0, 20, 20));
+    expected = c;
+    egt::detail::flex_layout(parent, expected, justify, orient);
+    EXPECT_TRUE(flex.layout(parent, c, justify, orient));
+    EXPECT_EQ(rects(c), rects(expected));
+}
+
+TEST(FlexLayout, Invalidate)
+{
+    const egt::Rect parent(0, 0, 200, 100);
+
+    egt::detail::FlexLayout flex;
+    auto c = children();
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::middle,
+                            egt::Orientation::horizontal));
+
+    flex.invalidate();
+    c = children();
+    EXPECT_TRUE(flex.layout(parent, c, egt::Justification::middle,
+                            egt::Orientation::horizontal));
+
+    c = children();
+    EXPECT_FALSE(flex.layout(parent, c, egt::Justification::middle,
+                             egt::Orientation::horizontal));
+}
+
+TEST(FlexLayout, BoxSizer)
+{
+    egt::Application app;
+    egt::TopWindow win;
+
+    auto sizer = std::make_shared<egt::BoxSizer>(egt::Orientation::horizontal);
+    win.add(sizer);
+
+    auto a = std::make_shared<egt::Frame>(egt::Rect(0, 0, 50, 20));
+    auto b = std::make_shared<egt::Frame>(egt::Rect(0, 0, 30, 40));
+    sizer->add(a);
+    sizer->add(b);
+
+    sizer->layout();
+    const auto box = sizer->box();
+    EXPECT_EQ(a->box().x() + a->width(), b->box().x());
+
+    // laying out again without changes keeps the same boxes
+    sizer->layout();
+    EXPECT_EQ(sizer->box(), box);
+    EXPECT_EQ(a->box().x() + a->width(), b->box().x());
+
+    // a changed child is laid out again
+    a->resize(egt::Size(60, 20));
+    sizer->layout();
+    EXPECT_EQ(a->width(), 60);
+    EXPECT_EQ(a->box().x() + a->width(), b->box().x());
+    EXPECT_GE(sizer->width(), 90);
+}
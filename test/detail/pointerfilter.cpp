@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/input/pointerfilter.h"
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using egt::detail::OneEuroFilter;
+using egt::detail::PointerFilter;
+
+/// Time between device reports, 100 Hz.
+static constexpr float DT = 0.01f;
+
+TEST(OneEuroFilter, Constant)
+{
+    const egt::Input::Filter settings;
+    OneEuroFilter filter;
+
+    EXPECT_FLOAT_EQ(filter.filter(42.f, 0.f, settings), 42.f);
+    for (auto i = 0; i < 100; ++i)
+        EXPECT_FLOAT_EQ(filter.filter(42.f, DT, settings), 42.f);
+    EXPECT_FLOAT_EQ(filter.speed(), 0.f);
+
+    // starts over at the next value
+    filter.reset();
+    EXPECT_FLOAT_EQ(filter.filter(7.f, DT, settings), 7.f);
+    EXPECT_FLOAT_EQ(filter.speed(), 0.f);
+}
+
+TEST(OneEuroFilter, Jitter)
+{
+    const egt::Input::Filter settings;
+    OneEuroFilter filter;
+    std::mt19937 gen(37);
+    std::uniform_real_distribution<float> noise(-2.f, 2.f);
+
+    filter.filter(100.f, 0.f, settings);
+    float worst = 0;
+    for (auto i = 0; i < 500; ++i)
+    {
+        const auto value = filter.filter(100.f + noise(gen), DT, settings);
+        if (i > 100)
+            worst = std::max(worst, std::fabs(value - 100.f));
+    }
+
+    // slow movement is smoothed heavily, to well under the noise
+    EXPECT_LT(worst, 1.f);
+}
+
+TEST(OneEuroFilter, Speed)
+{
+    // pointer moving at 500 units per second
+    egt::Input::Filter settings;
+    settings.beta = 0.f;
+    OneEuroFilter slow;
+    settings.beta = 0.1f;
+    OneEuroFilter fast;
+
+    slow.filter(0.f, 0.f, settings);
+    fast.filter(0.f, 0.f, settings);
+    float slow_value = 0;
+    float fast_value = 0;
+    float value = 0;
+    for (auto i = 0; i < 200; ++i)
+    {
+        value += 500.f * DT;
+        settings.beta = 0.f;
+        slow_value = slow.filter(value, DT, settings);
+        settings.beta = 0.1f;
+        fast_value = fast.filter(value, DT, settings);
+    }
+
+    // the filtered speed converges to the speed
+    EXPECT_NEAR(fast.speed(), 500.f, 5.f);
+
+    // and a higher beta lags behind less
+    EXPECT_GT(fast_value, slow_value);
+    EXPECT_LT(value - fast_value, 10.f);
+}
+
+class PointerFilterTest : public testing::Test
+{
+protected:
+
+    /// Send a raw pointer event at a time in seconds, and return the filtered position.
+    egt::DisplayPoint send(egt::EventId id, int x, int y, float time)
+    {
+        egt::Event event(id, egt::Pointer(egt::DisplayPoint(x, y)));
+        event.timestamp(at(time));
+        filter.filter(event, settings);
+        return event.pointer().point;
+    }
+
+    egt::DisplayPoint predict(int x, int y, float time)
+    {
+        egt::Event event(egt::EventId::raw_pointer_move, egt::Pointer(egt::DisplayPoint(x, y)));
+        filter.predict(event, at(time), settings);
+        return event.pointer().point;
+    }
+
+    egt::Event::Timestamp at(float time) const
+    {
+        return start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                   std::chrono::duration<float>(time));
+    }
+
+    /// Stroke along x at 500 pixels per second, returning the last raw position.
+    int stroke(float& time)
+    {
+        send(egt::EventId::raw_pointer_down, 0, 0, time);
+        auto x = 0;
+        for (auto i = 0; i < 100; ++i)
+        {
+            time += DT;
+            x += 5;
+            send(egt::EventId::raw_pointer_move, x, 0, time);
+        }
+        return x;
+    }
+
+    egt::Input::Filter settings;
+    PointerFilter filter;
+    const egt::Event::Timestamp start{std::chrono::steady_clock::now()};
+};
+
+TEST_F(PointerFilterTest, Disabled)
+{
+    // state is kept for prediction, but positions are not changed
+    EXPECT_EQ(send(egt::EventId::raw_pointer_down, 10, 10, 0.f), egt::DisplayPoint(10, 10));
+    EXPECT_EQ(send(egt::EventId::raw_pointer_move, 30, 10, DT), egt::DisplayPoint(30, 10));
+    EXPECT_EQ(send(egt::EventId::raw_pointer_up, 60, 10, 2 * DT), egt::DisplayPoint(60, 10));
+}
+
+TEST_F(PointerFilterTest, Stroke)
+{
+    settings.enabled = true;
+
+    // starts where the pointer went down
+    EXPECT_EQ(send(egt::EventId::raw_pointer_down, 10, 10, 0.f), egt::DisplayPoint(10, 10));
+    const auto move = send(egt::EventId::raw_pointer_move, 30, 10, DT);
+    EXPECT_GT(move.x(), 10);
+    EXPECT_LT(move.x(), 30);
+
+    // the up position is filtered the same way, so there is no jump on release
+    const auto up = send(egt::EventId::raw_pointer_up, 50, 10, 2 * DT);
+    EXPECT_GE(up.x(), move.x());
+    EXPECT_LT(up.x(), 50);
+
+    // and the next stroke starts over
+    EXPECT_EQ(send(egt::EventId::raw_pointer_down, 300, 200, 3 * DT), egt::DisplayPoint(300, 200));
+}
+
+TEST_F(PointerFilterTest, Slots)
+{
+    settings.enabled = true;
+
+    egt::Event a(egt::EventId::raw_pointer_down, egt::Pointer(egt::DisplayPoint(0, 0), 0));
+    egt::Event b(egt::EventId::raw_pointer_down, egt::Pointer(egt::DisplayPoint(500, 500), 1));
+    filter.filter(a, settings);
+    filter.filter(b, settings);
+
+    // each slot is filtered on its own
+    egt::Event move(egt::EventId::raw_pointer_move, egt::Pointer(egt::DisplayPoint(500, 500), 1));
+    move.timestamp(at(DT));
+    filter.filter(move, settings);
+    EXPECT_EQ(move.pointer().point, egt::DisplayPoint(500, 500));
+}
+
+TEST_F(PointerFilterTest, Predict)
+{
+    settings.enabled = true;
+    settings.max_prediction = std::chrono::milliseconds(50);
+
+    float time = 0;
+    stroke(time);
+    const auto filtered = predict(0, 0, time);
+
+    // ahead of the filtered position by the filtered speed
+    const auto ahead = predict(0, 0, time + 0.02f);
+    EXPECT_NEAR(ahead.x() - filtered.x(), 10, 1);
+    EXPECT_EQ(ahead.y(), 0);
+
+    // up to the maximum
+    const auto limit = predict(0, 0, time + 0.05f);
+    EXPECT_EQ(predict(0, 0, time + 1.f), limit);
+
+    // nothing to predict after the stroke ended
+    send(egt::EventId::raw_pointer_up, 600, 0, time + DT);
+    EXPECT_EQ(predict(1, 2, time + 0.02f), egt::DisplayPoint(1, 2));
+}
+
+TEST_F(PointerFilterTest, PredictUnfiltered)
+{
+    float time = 0;
+    const auto x = stroke(time);
+
+    // from the position of the event, by the filtered speed
+    EXPECT_EQ(predict(x, 0, time), egt::DisplayPoint(x, 0));
+    EXPECT_NEAR(predict(x, 0, time + 0.02f).x(), x + 10, 1);
+}
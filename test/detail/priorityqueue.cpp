@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/asioallocator.h"
+#include "detail/priorityqueue.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+using egt::detail::priorities;
+
+TEST(PriorityQueue, Order)
+{
+    egt::detail::PriorityQueue queue;
+    std::string order;
+
+    queue.add(priorities::idle, [&order]() { order += "i1 "; });
+    queue.add(priorities::normal, [&order]() { order += "n1 "; });
+    queue.add(priorities::input, [&order]() { order += "in1 "; });
+    queue.add(priorities::frame, [&order]() { order += "f1 "; });
+    queue.add(priorities::normal, [&order]() { order += "n2 "; });
+    queue.add(priorities::idle, [&order]() { order += "i2 "; });
+    queue.add(priorities::input, [&order]() { order += "in2 "; });
+    EXPECT_FALSE(queue.empty());
+
+    EXPECT_EQ(queue.execute_all(), 7);
+    EXPECT_EQ(order, "in1 in2 f1 n1 n2 i1 i2 ");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(PriorityQueue, AddedWhileRunning)
+{
+    egt::detail::PriorityQueue queue;
+    std::string order;
+
+    // higher priority handlers added by a handler run before the rest
+    queue.add(priorities::normal, [&]()
+    {
+        order += "n1 ";
+        queue.add(priorities::idle, [&order]() { order += "i2 "; });
+        queue.add(priorities::frame, [&order]() { order += "f1 "; });
+        queue.add(priorities::normal, [&order]() { order += "n3 "; });
+    });
+    queue.add(priorities::normal, [&order]() { order += "n2 "; });
+    queue.add(priorities::idle, [&order]() { order += "i1 "; });
+
+    EXPECT_EQ(queue.execute_all(), 6);
+    EXPECT_EQ(order, "n1 f1 n2 n3 i1 i2 ");
+}
+
+TEST(PriorityQueue, Deadline)
+{
+    egt::detail::PriorityQueue queue;
+    std::string order;
+
+    queue.add(priorities::idle, [&order]() { order += "i1 "; });
+    queue.add(priorities::normal, [&order]() { order += "n1 "; });
+    queue.add(priorities::frame, [&order]() { order += "f1 "; });
+    queue.add(priorities::input, [&order]() { order += "in1 "; });
+
+    // input and frame handlers always run, the rest wait
+    const auto passed = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    EXPECT_EQ(queue.execute(passed), 2);
+    EXPECT_EQ(order, "in1 f1 ");
+    EXPECT_FALSE(queue.empty());
+
+    // including ones added meanwhile
+    queue.add(priorities::frame, [&order]() { order += "f2 "; });
+    EXPECT_EQ(queue.execute(passed), 1);
+    EXPECT_EQ(order, "in1 f1 f2 ");
+
+    EXPECT_EQ(queue.execute_all(), 2);
+    EXPECT_EQ(order, "in1 f1 f2 n1 i1 ");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(PriorityQueue, DeadlineWhileRunning)
+{
+    egt::detail::PriorityQueue queue;
+    int count = 0;
+
+    // the deadline is checked before each handler
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    for (auto i = 0; i < 3; ++i)
+    {
+        queue.add(priorities::normal, [&count]()
+        {
+            ++count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        });
+    }
+
+    EXPECT_EQ(queue.execute(deadline), 1);
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(queue.execute_all(), 2);
+    EXPECT_EQ(count, 3);
+}
+
+TEST(PriorityQueue, Wrap)
+{
+    egt::asio::io_context io;
+    egt::detail::PriorityQueue queue;
+    std::string order;
+
+    // completed handlers are queued with their priority instead of run
+    egt::asio::post(io, queue.wrap(priorities::idle, [&order]() { order += "i1 "; }));
+    egt::asio::post(io, queue.wrap(priorities::input, [&order]() { order += "in1 "; }));
+    io.run();
+
+    EXPECT_EQ(order, "");
+    EXPECT_EQ(queue.execute_all(), 2);
+    EXPECT_EQ(order, "in1 i1 ");
+}
+
+TEST(PriorityQueue, MoveOnly)
+{
+    egt::detail::PriorityQueue queue;
+    std::string order;
+
+    // handlers are moved, not copied, and may be larger than the inline storage
+    auto value = std::make_unique<std::string>("a ");
+    queue.add(priorities::normal, [&order, value = std::move(value)]() { order += *value; });
+    std::array<char, 256> big{};
+    big[0] = 'b';
+    queue.add(priorities::normal, [&order, big]() { order += big[0]; });
+
+    EXPECT_EQ(queue.execute_all(), 2);
+    EXPECT_EQ(order, "a b");
+}
+
+TEST(PriorityQueue, WrapAllocator)
+{
+    egt::asio::io_context io;
+    egt::detail::PriorityQueue queue;
+    egt::detail::HandlerAllocator allocator;
+    int count = 0;
+
+    // the first allocation when the storage is free gets the storage
+    auto storage = allocator.allocate(8);
+    allocator.deallocate(storage);
+
+    egt::asio::steady_timer timer(io);
+    timer.expires_after(std::chrono::seconds(0));
+    timer.async_wait(queue.wrap(priorities::input,
+                                egt::detail::make_custom_alloc_handler(allocator,
+                                        [&count](const egt::asio::error_code & error)
+    {
+        EXPECT_FALSE(error);
+        ++count;
+    })));
+
+    // the pending operation is using the storage of the wrapped handler
+    auto other = allocator.allocate(8);
+    EXPECT_NE(other, storage);
+    allocator.deallocate(other);
+
+    io.run();
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(queue.execute_all(), 1);
+    EXPECT_EQ(count, 1);
+
+    // and gave it back when it completed
+    other = allocator.allocate(8);
+    EXPECT_EQ(other, storage);
+    allocator.deallocate(other);
+}
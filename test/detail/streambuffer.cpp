@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/charts/streambuffer.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+/*
+ * Check the samples and every column against the samples kept.
+ */
+static void check(const egt::detail::StreamBuffer& stream, const std::vector<double>& all)
+{
+    ASSERT_EQ(stream.end(), all.size());
+    ASSERT_EQ(stream.size(), std::min(all.size(), stream.capacity()));
+
+    for (auto index = stream.begin(); index < stream.end(); ++index)
+        ASSERT_EQ(stream.at(index), all[index]);
+
+    const auto per_column = stream.samples_per_column();
+    if (!per_column)
+        return;
+
+    if (!stream.size())
+    {
+        EXPECT_EQ(stream.column_count(), 0U);
+        return;
+    }
+
+    ASSERT_EQ(stream.first_column(), stream.begin() / per_column);
+    ASSERT_EQ(stream.first_column() + stream.column_count() - 1,
+              (stream.end() - 1) / per_column);
+
+    for (auto column = stream.first_column();
+         column < stream.first_column() + stream.column_count(); ++column)
+    {
+        const auto from = std::max<uint64_t>(column * per_column, stream.begin());
+        const auto to = std::min<uint64_t>((column + 1) * per_column, stream.end());
+        const auto range = std::minmax_element(all.begin() + from, all.begin() + to);
+        EXPECT_EQ(stream.column(column).min, *range.first) << "column " << column;
+        EXPECT_EQ(stream.column(column).max, *range.second) << "column " << column;
+    }
+}
+
+TEST(StreamBuffer, Append)
+{
+    egt::detail::StreamBuffer stream(8);
+    std::vector<double> all;
+
+    const double first[] = {1, 2, 3};
+    stream.append(first, 3);
+    all.insert(all.end(), first, first + 3);
+    check(stream, all);
+    EXPECT_EQ(stream.begin(), 0U);
+
+    // wraps, dropping the oldest samples
+    const double second[] = {4, 5, 6, 7, 8, 9, 10};
+    stream.append(second, 7);
+    all.insert(all.end(), second, second + 7);
+    check(stream, all);
+    EXPECT_EQ(stream.begin(), 2U);
+    EXPECT_EQ(stream.at(stream.begin()), 3);
+}
+
+TEST(StreamBuffer, AppendMoreThanCapacity)
+{
+    egt::detail::StreamBuffer stream(4);
+    stream.decimate(2);
+
+    std::vector<double> all(11);
+    for (size_t i = 0; i < all.size(); ++i)
+        all[i] = static_cast<double>(i);
+    stream.append(all.data(), all.size());
+
+    check(stream, all);
+    EXPECT_EQ(stream.begin(), 7U);
+}
+
+TEST(StreamBuffer, Decimate)
+{
+    egt::detail::StreamBuffer stream(100);
+    std::vector<double> all;
+
+    // 4 columns requested, 3 full ones, so 34 samples per column
+    stream.decimate(4);
+    EXPECT_EQ(stream.samples_per_column(), 34U);
+
+    for (auto i = 0; i < 250; ++i)
+    {
+        const double value = (i * 37) % 101 - 50;
+        stream.append(&value, 1);
+        all.push_back(value);
+        check(stream, all);
+    }
+
+    // recomputed from the samples kept
+    stream.decimate(10);
+    EXPECT_EQ(stream.samples_per_column(), 12U);
+    check(stream, all);
+}
+
+TEST(StreamBuffer, Random)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> value(-1000, 1000);
+
+    for (auto capacity : {1, 7, 64, 333})
+    {
+        egt::detail::StreamBuffer stream(capacity);
+        std::vector<double> all;
+
+        for (auto round = 0; round < 200; ++round)
+        {
+            if (gen() % 20 == 0)
+                stream.decimate(gen() % 50);
+
+            std::vector<double> samples(gen() % (2 * capacity + 2));
+            for (auto& s : samples)
+                s = value(gen);
+
+            stream.append(samples.data(), samples.size());
+            all.insert(all.end(), samples.begin(), samples.end());
+            check(stream, all);
+        }
+    }
+}
+
+TEST(StreamBuffer, Clear)
+{
+    egt::detail::StreamBuffer stream(10);
+    stream.decimate(3);
+
+    const double samples[] = {5, -5, 3};
+    stream.append(samples, 3);
+    stream.clear();
+
+    EXPECT_EQ(stream.size(), 0U);
+    EXPECT_EQ(stream.column_count(), 0U);
+    EXPECT_EQ(stream.end(), 3U);
+
+    // columns start again after the cleared samples
+    const double more[] = {1, 2};
+    stream.append(more, 2);
+    EXPECT_EQ(stream.begin(), 3U);
+    ASSERT_EQ(stream.column_count(), 1U);
+    EXPECT_EQ(stream.column(stream.first_column()).min, 1);
+    EXPECT_EQ(stream.column(stream.first_column()).max, 2);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/priorityqueue.h"
+#include "detail/timerwheel.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using Clock = egt::detail::TimerWheel::Clock;
+using std::chrono::milliseconds;
+
+class TimerWheelTest : public testing::Test
+{
+protected:
+
+    TimerWheelTest()
+        : wheel(io, queue)
+    {}
+
+    void add(egt::detail::TimerWheel::Entry& entry, int id,
+             milliseconds timeout, milliseconds slack = milliseconds(0))
+    {
+        const auto deadline = Clock::now() + timeout;
+        entry.callback = [this, id, deadline]()
+        {
+            fired.push_back(id);
+            EXPECT_GE(Clock::now(), deadline);
+            wakeups.push_back(Clock::now());
+        };
+        wheel.add(entry, deadline, slack);
+    }
+
+    void run()
+    {
+        while (!wheel.empty())
+        {
+            // the wheel is the only work, so the context stops between waits
+            io.restart();
+            io.run_one();
+            queue.execute_all();
+        }
+    }
+
+    egt::asio::io_context io;
+    egt::detail::PriorityQueue queue;
+    egt::detail::TimerWheel wheel;
+    std::vector<int> fired;
+    std::vector<Clock::time_point> wakeups;
+};
+
+TEST_F(TimerWheelTest, ExpiresInOrder)
+{
+    egt::detail::TimerWheel::Entry a;
+    egt::detail::TimerWheel::Entry b;
+    egt::detail::TimerWheel::Entry c;
+    add(a, 1, milliseconds(15));
+    add(b, 2, milliseconds(5));
+    add(c, 3, milliseconds(10));
+
+    run();
+
+    EXPECT_EQ(fired, std::vector<int>({2, 3, 1}));
+}
+
+TEST_F(TimerWheelTest, Remove)
+{
+    egt::detail::TimerWheel::Entry a;
+    egt::detail::TimerWheel::Entry b;
+    add(a, 1, milliseconds(5));
+    add(b, 2, milliseconds(10));
+    wheel.remove(a);
+    EXPECT_FALSE(a.linked());
+
+    run();
+
+    EXPECT_EQ(fired, std::vector<int>({2}));
+}
+
+TEST_F(TimerWheelTest, Cascade)
+{
+    // beyond the first level, and beyond the first block of the second
+    egt::detail::TimerWheel::Entry a;
+    egt::detail::TimerWheel::Entry b;
+    egt::detail::TimerWheel::Entry c;
+    add(a, 1, milliseconds(200));
+    add(b, 2, milliseconds(70));
+    add(c, 3, milliseconds(3));
+
+    run();
+
+    EXPECT_EQ(fired, std::vector<int>({3, 2, 1}));
+}
+
+TEST_F(TimerWheelTest, Slack)
+{
+    // the first timer may wait for the second, so both fire in one wake up
+    egt::detail::TimerWheel::Entry a;
+    egt::detail::TimerWheel::Entry b;
+    add(a, 1, milliseconds(10), milliseconds(100));
+    add(b, 2, milliseconds(40));
+
+    run();
+
+    ASSERT_EQ(fired, std::vector<int>({1, 2}));
+    EXPECT_LT(wakeups[1] - wakeups[0], milliseconds(5));
+}
+
+TEST_F(TimerWheelTest, AddAfterIdle)
+{
+    egt::detail::TimerWheel::Entry a;
+    add(a, 1, milliseconds(5));
+    run();
+
+    // the wheel catches up with the time it was idle for
+    std::this_thread::sleep_for(milliseconds(100));
+
+    const auto start = Clock::now();
+    add(a, 2, milliseconds(5));
+    run();
+
+    EXPECT_EQ(fired, std::vector<int>({1, 2}));
+    EXPECT_LT(Clock::now() - start, milliseconds(50));
+}
+
+TEST_F(TimerWheelTest, AddWhileFiring)
+{
+    egt::detail::TimerWheel::Entry a;
+    egt::detail::TimerWheel::Entry b;
+    a.callback = [this, &b]()
+    {
+        fired.push_back(1);
+        add(b, 2, milliseconds(5));
+    };
+    wheel.add(a, Clock::now() + milliseconds(5), milliseconds(0));
+
+    run();
+
+    EXPECT_EQ(fired, std::vector<int>({1, 2}));
+}
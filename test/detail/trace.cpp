@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/trace.h"
+#include <atomic>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef EGT_ENABLE_TRACE
+
+// recording is enabled once, by the first check of EGT_TRACE, and the trace
+// dumped by Application goes nowhere
+static const bool trace_env = setenv("EGT_TRACE", "/dev/null", 1) == 0;
+
+static std::string dump()
+{
+    std::ostringstream out;
+    egt::detail::trace_dump(out);
+    return out.str();
+}
+
+TEST(Trace, Scopes)
+{
+    ASSERT_TRUE(trace_env);
+    ASSERT_TRUE(egt::detail::trace_enabled());
+
+    {
+        EGT_TRACE_SCOPE_DETAIL("trace test outer", std::string("a \"quoted\" widget"));
+        EGT_TRACE_SCOPE("trace test inner");
+    }
+
+    std::string in_progress;
+    {
+        EGT_TRACE_SCOPE("trace test in progress");
+        in_progress = dump();
+    }
+
+    const auto out = dump();
+    EXPECT_EQ(out.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0U);
+    EXPECT_NE(out.find("\"ph\":\"X\",\"cat\":\"egt\",\"name\":\"trace test outer\""),
+              std::string::npos);
+    EXPECT_NE(out.find("\"args\":{\"detail\":\"a \\\"quoted\\\" widget\"}"),
+              std::string::npos);
+    EXPECT_NE(out.find("\"name\":\"trace test inner\""), std::string::npos);
+
+    // events are only written once they have ended
+    EXPECT_EQ(in_progress.find("trace test in progress"), std::string::npos);
+    EXPECT_NE(out.find("trace test in progress"), std::string::npos);
+}
+
+TEST(Trace, Span)
+{
+    ASSERT_TRUE(egt::detail::trace_enabled());
+
+    const auto begin = std::chrono::steady_clock::now();
+    egt::detail::trace_span("trace test span", "0123456789012345678901234567890123456789",
+                            begin, begin + std::chrono::milliseconds(2));
+    // ends before it begins
+    egt::detail::trace_span("trace test backwards", nullptr,
+                            begin, begin - std::chrono::milliseconds(1));
+
+    const auto out = dump();
+
+    // the detail is truncated, and durations are in microseconds
+    const auto span = out.find("\"name\":\"trace test span\"");
+    ASSERT_NE(span, std::string::npos);
+    const auto line = out.substr(span, out.find('\n', span) - span);
+    EXPECT_NE(line.find("\"dur\":2000.000"), std::string::npos) << line;
+    EXPECT_NE(line.find("\"detail\":\"0123456789012345678901234567890\"}"),
+              std::string::npos) << line;
+
+    const auto backwards = out.find("\"name\":\"trace test backwards\"");
+    ASSERT_NE(backwards, std::string::npos);
+    EXPECT_NE(out.find("\"dur\":0.000", backwards), std::string::npos);
+}
+
+TEST(Trace, DumpWhileRecording)
+{
+    ASSERT_TRUE(egt::detail::trace_enabled());
+
+    // enough events to wrap the ring buffer of the thread many times
+    const std::string a(31, 'a');
+    const std::string b(31, 'b');
+    std::atomic<bool> stop{false};
+    std::atomic<int> recorded{0};
+    std::thread thread([&]()
+    {
+        for (auto i = 0; !stop || i < 20000; ++i)
+        {
+            {
+                EGT_TRACE_SCOPE_DETAIL("trace test thread", i % 2 ? a : b);
+            }
+            recorded = i + 1;
+        }
+    });
+
+    while (recorded < 100)
+        std::this_thread::yield();
+
+    // every event dumped is whole
+    size_t events = 0;
+    for (auto round = 0; round < 20; ++round)
+    {
+        std::istringstream out(dump());
+        std::string line;
+        while (std::getline(out, line))
+        {
+            if (line.find("\"name\":\"trace test thread\"") == std::string::npos)
+                continue;
+
+            ++events;
+            ASSERT_TRUE(line.find("\"detail\":\"" + a + "\"}") != std::string::npos ||
+                        line.find("\"detail\":\"" + b + "\"}") != std::string::npos) << line;
+            ASSERT_EQ(line.find("\"dur\":-"), std::string::npos) << line;
+        }
+    }
+    stop = true;
+    thread.join();
+
+    EXPECT_GT(events, 0U);
+}
+
+#else
+
+TEST(Trace, Disabled)
+{
+    EXPECT_FALSE(egt::detail::trace_enabled());
+
+    std::ostringstream out;
+    egt::detail::trace_dump(out);
+    EXPECT_EQ(out.str(), "{\"traceEvents\":[]}\n");
+}
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstring>
+#include <egt/detail/boxcache.h>
+#include <egt/ui>
+#include <gtest/gtest.h>
+
+class BoxCacheTest : public testing::Test
+{
+protected:
+
+    BoxCacheTest()
+        : cache(egt::detail::box_cache())
+    {
+        cache.enable(true);
+        cache.clear();
+        cache.reset_stats();
+    }
+
+    ~BoxCacheTest() override
+    {
+        cache.clear();
+        cache.max_bytes(max_bytes);
+        cache.max_whole_area(max_whole_area);
+        cache.reset_stats();
+    }
+
+    static egt::shared_cairo_surface_t surface()
+    {
+        return egt::shared_cairo_surface_t(
+                   cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 120, 80),
+                   cairo_surface_destroy);
+    }
+
+    /// Draw boxes, through the cache or not.
+    egt::shared_cairo_surface_t draw(const std::vector<egt::Rect>& rects,
+                                     const egt::Color& color, bool cached)
+    {
+        cache.enable(cached);
+        auto target = surface();
+        egt::Painter painter(egt::shared_cairo_t(cairo_create(target.get()),
+                             cairo_destroy));
+        for (const auto& rect : rects)
+            theme.draw_box(painter, egt::Theme::FillFlag::blend, rect,
+                           egt::Palette::black, color, 2, 1, 6.5);
+        cairo_surface_flush(target.get());
+        cache.enable(true);
+        return target;
+    }
+
+    static bool same(cairo_surface_t* a, cairo_surface_t* b)
+    {
+        const auto size = cairo_image_surface_get_stride(a) *
+                          cairo_image_surface_get_height(a);
+        return !std::memcmp(cairo_image_surface_get_data(a),
+                            cairo_image_surface_get_data(b), size);
+    }
+
+    egt::detail::BoxCache& cache;
+    const size_t max_bytes{cache.max_bytes()};
+    const egt::DefaultDim max_whole_area{cache.max_whole_area()};
+    egt::Theme theme;
+};
+
+TEST_F(BoxCacheTest, Hit)
+{
+    const std::vector<egt::Rect> rects = {{2, 2, 20, 20}, {30, 40, 20, 20}};
+
+    auto cached = draw(rects, egt::Palette::red, true);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.misses, 1U);
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.entries, 1U);
+    EXPECT_EQ(stats.bytes, 20U * 20U * 4U);
+
+    // the same pixels as drawing directly
+    auto direct = draw(rects, egt::Palette::red, false);
+    EXPECT_TRUE(same(cached.get(), direct.get()));
+    EXPECT_EQ(cache.stats().hits, 1U);
+}
+
+TEST_F(BoxCacheTest, Sliced)
+{
+    // boxes of different sizes share a sliced entry
+    cache.max_whole_area(100);
+    const std::vector<egt::Rect> rects = {{1, 1, 60, 40}, {50, 30, 70, 50}};
+
+    auto cached = draw(rects, egt::Palette::red, true);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.misses, 1U);
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.entries, 1U);
+
+    auto direct = draw(rects, egt::Palette::red, false);
+    EXPECT_TRUE(same(cached.get(), direct.get()));
+}
+
+TEST_F(BoxCacheTest, Invalidate)
+{
+    const egt::Rect rect(0, 0, 20, 20);
+
+    draw({rect}, egt::Palette::red, true);
+    EXPECT_EQ(cache.stats().misses, 1U);
+
+    // patterns are compared by value
+    draw({rect}, egt::Palette::red, true);
+    EXPECT_EQ(cache.stats().hits, 1U);
+
+    draw({rect}, egt::Palette::blue, true);
+    draw({rect + egt::Size(1, 0)}, egt::Palette::red, true);
+    EXPECT_EQ(cache.stats().misses, 3U);
+    EXPECT_EQ(cache.stats().entries, 3U);
+
+    cache.clear();
+    EXPECT_EQ(cache.stats().entries, 0U);
+    EXPECT_EQ(cache.stats().bytes, 0U);
+    draw({rect}, egt::Palette::red, true);
+    EXPECT_EQ(cache.stats().misses, 4U);
+
+    // a palette change affects how boxes are drawn
+    auto palette = theme.palette();
+    theme.palette(palette);
+    EXPECT_EQ(cache.stats().entries, 0U);
+}
+
+TEST_F(BoxCacheTest, Evict)
+{
+    // room for one entry only
+    cache.max_bytes(20 * 20 * 4);
+
+    draw({{0, 0, 20, 20}}, egt::Palette::red, true);
+    draw({{0, 0, 20, 20}}, egt::Palette::blue, true);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1U);
+    EXPECT_EQ(stats.entries, 1U);
+
+    // the least recently used entry went
+    draw({{0, 0, 20, 20}}, egt::Palette::blue, true);
+    EXPECT_EQ(cache.stats().hits, 1U);
+    draw({{0, 0, 20, 20}}, egt::Palette::red, true);
+    EXPECT_EQ(cache.stats().misses, 3U);
+}
+
+TEST_F(BoxCacheTest, Bypass)
+{
+    auto target = surface();
+    auto cr = egt::shared_cairo_t(cairo_create(target.get()), cairo_destroy);
+    egt::Painter painter(cr);
+
+    // only an integer translation is pixel exact
+    cairo_translate(cr.get(), 0.5, 0);
+    theme.draw_box(painter, egt::Theme::FillFlag::blend, {0, 0, 20, 20},
+                   egt::Palette::black, egt::Palette::red, 2, 1, 6.5);
+    cairo_identity_matrix(cr.get());
+    cairo_scale(cr.get(), 2, 2);
+    theme.draw_box(painter, egt::Theme::FillFlag::blend, {0, 0, 20, 20},
+                   egt::Palette::black, egt::Palette::red, 2, 1, 6.5);
+
+    // and solid fills have to be opaque
+    cairo_identity_matrix(cr.get());
+    theme.draw_box(painter, egt::Theme::FillFlag::solid, {0, 0, 20, 20},
+                   egt::Palette::black, egt::Palette::transparent, 2, 1, 6.5);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.bypassed, 3U);
+    EXPECT_EQ(stats.entries, 0U);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstring>
+#include <egt/detail/displaylist.h>
+#include <egt/ui>
+#include <gtest/gtest.h>
+
+using egt::detail::DisplayList;
+
+static egt::shared_cairo_surface_t surface(int width = 120, int height = 80)
+{
+    return egt::shared_cairo_surface_t(
+               cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+               cairo_surface_destroy);
+}
+
+static egt::shared_cairo_t context(const egt::shared_cairo_surface_t& target)
+{
+    return egt::shared_cairo_t(cairo_create(target.get()), cairo_destroy);
+}
+
+static bool same(cairo_surface_t* a, cairo_surface_t* b)
+{
+    cairo_surface_flush(a);
+    cairo_surface_flush(b);
+    const auto size = cairo_image_surface_get_stride(a) *
+                      cairo_image_surface_get_height(a);
+    return !std::memcmp(cairo_image_surface_get_data(a),
+                        cairo_image_surface_get_data(b), size);
+}
+
+/*
+ * Something drawn with most kinds of commands.
+ */
+static void scene(egt::Painter& painter, const egt::Color& color)
+{
+    static const egt::Theme theme;
+
+    painter.set(color);
+    painter.draw(egt::Rect(4, 4, 30, 20));
+    painter.fill();
+
+    egt::Painter::AutoSaveRestore sr(painter);
+    cairo_translate(painter.context().get(), 2, 3);
+    painter.set(egt::Palette::blue);
+    painter.line_width(3);
+    painter.draw(egt::Point(0, 50), egt::Point(60, 70));
+    painter.stroke();
+
+    painter.fill(egt::Rect(40, 4, 10, 10), egt::Palette::green);
+    theme.draw_box(painter, egt::Theme::FillFlag::blend, egt::Rect(60, 10, 40, 30),
+                   egt::Palette::black, color, 2, 1, 5);
+}
+
+TEST(DisplayList, Equal)
+{
+    DisplayList a;
+    DisplayList b;
+    {
+        egt::Painter painter(a);
+        scene(painter, egt::Palette::red);
+    }
+    {
+        egt::Painter painter(b);
+        scene(painter, egt::Palette::red);
+    }
+    EXPECT_FALSE(a.empty());
+    EXPECT_EQ(a.size(), b.size());
+    EXPECT_TRUE(a == b);
+
+    DisplayList c;
+    {
+        egt::Painter painter(c);
+        scene(painter, egt::Palette::yellow);
+    }
+    EXPECT_TRUE(a != c);
+
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(a != b);
+}
+
+TEST(DisplayList, Transform)
+{
+    DisplayList a;
+    DisplayList b;
+    {
+        egt::Painter painter(a);
+        painter.draw(egt::Rect(0, 0, 10, 10));
+        painter.fill();
+    }
+    {
+        egt::Painter painter(b);
+        cairo_translate(painter.context().get(), 0.5, 0);
+        painter.draw(egt::Rect(0, 0, 10, 10));
+        painter.fill();
+    }
+    EXPECT_TRUE(a != b);
+}
+
+TEST(DisplayList, Surfaces)
+{
+    auto image = surface(8, 8);
+    const auto record = [&image](DisplayList & list)
+    {
+        egt::Painter painter(list);
+        painter.draw(egt::Point(5, 5));
+        painter.draw(egt::Image(image));
+    };
+
+    // an unmarked surface may have changed since it was recorded
+    DisplayList a;
+    DisplayList b;
+    record(a);
+    record(b);
+    EXPECT_FALSE(DisplayList::immutable(image.get()));
+    EXPECT_TRUE(a != b);
+
+    DisplayList::mark_immutable(image.get());
+    EXPECT_TRUE(DisplayList::immutable(image.get()));
+    a.clear();
+    b.clear();
+    record(a);
+    record(b);
+    EXPECT_TRUE(a == b);
+}
+
+TEST(DisplayList, Replay)
+{
+    DisplayList list;
+    {
+        egt::Painter painter(list);
+        scene(painter, egt::Palette::red);
+    }
+
+    auto direct = surface();
+    {
+        egt::Painter painter(context(direct));
+        scene(painter, egt::Palette::red);
+    }
+
+    auto replayed = surface();
+    {
+        egt::Painter painter(context(replayed));
+        list.replay(painter);
+    }
+    EXPECT_TRUE(same(direct.get(), replayed.get()));
+
+    // relative to the transform of the painter
+    auto moved = surface();
+    {
+        auto cr = context(moved);
+        cairo_translate(cr.get(), 7, 9);
+        egt::Painter painter(cr);
+        scene(painter, egt::Palette::red);
+    }
+
+    replayed = surface();
+    {
+        auto cr = context(replayed);
+        cairo_translate(cr.get(), 7, 9);
+        egt::Painter painter(cr);
+        list.replay(painter);
+    }
+    EXPECT_TRUE(same(moved.get(), replayed.get()));
+    EXPECT_FALSE(same(direct.get(), replayed.get()));
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Image surface drawn from rows of characters, one per pixel.
+ */
+class FloodImage
+{
+public:
+
+    FloodImage(cairo_format_t format, const std::vector<std::string>& rows)
+        : m_surface(cairo_image_surface_create(format,
+                    static_cast<int>(rows[0].size()),
+                    static_cast<int>(rows.size())),
+                    cairo_surface_destroy)
+    {
+        for (size_t y = 0; y < rows.size(); ++y)
+            for (size_t x = 0; x < rows[y].size(); ++x)
+                set(static_cast<int>(x), static_cast<int>(y), color(rows[y][x]));
+        cairo_surface_mark_dirty(m_surface.get());
+    }
+
+    static egt::Color color(char c)
+    {
+        switch (c)
+        {
+        case '#':
+            return egt::Palette::black;
+        case 'r':
+            return egt::Palette::red;
+        case 'w':
+            // still different from white in RGB565
+            return egt::Color(0xf4, 0xf4, 0xf4);
+        default:
+            return egt::Palette::white;
+        }
+    }
+
+    void set(int x, int y, const egt::Color& color)
+    {
+        auto data = cairo_image_surface_get_data(m_surface.get()) +
+                    y * cairo_image_surface_get_stride(m_surface.get());
+        if (cairo_image_surface_get_format(m_surface.get()) == CAIRO_FORMAT_RGB16_565)
+            reinterpret_cast<uint16_t*>(data)[x] = color.pixel16();
+        else
+            reinterpret_cast<uint32_t*>(data)[x] = color.pixel32();
+    }
+
+    /// Rows of characters, with pixels of the fill color as 'r'.
+    std::vector<std::string> rows() const
+    {
+        cairo_surface_flush(m_surface.get());
+
+        const auto format = cairo_image_surface_get_format(m_surface.get());
+        const auto red = egt::Color(egt::Palette::red);
+        std::vector<std::string> result;
+        for (auto y = 0; y < cairo_image_surface_get_height(m_surface.get()); ++y)
+        {
+            auto data = cairo_image_surface_get_data(m_surface.get()) +
+                        y * cairo_image_surface_get_stride(m_surface.get());
+            std::string row;
+            for (auto x = 0; x < cairo_image_surface_get_width(m_surface.get()); ++x)
+            {
+                bool filled;
+                if (format == CAIRO_FORMAT_RGB16_565)
+                    filled = reinterpret_cast<uint16_t*>(data)[x] == red.pixel16();
+                else
+                    filled = (reinterpret_cast<uint32_t*>(data)[x] & 0xffffff) ==
+                             (red.pixel32() & 0xffffff);
+                row += filled ? 'r' : '.';
+            }
+            result.push_back(row);
+        }
+        return result;
+    }
+
+    cairo_surface_t* surface() const { return m_surface.get(); }
+
+private:
+
+    egt::shared_cairo_surface_t m_surface;
+};
+
+class FloodTest : public testing::TestWithParam<cairo_format_t>
+{};
+
+TEST_P(FloodTest, Bounded)
+{
+    FloodImage image(GetParam(),
+    {
+        "...#....",
+        "...#....",
+        "####....",
+        "........",
+    });
+
+    egt::Painter::flood(image.surface(), egt::Point(1, 1), egt::Palette::red);
+
+    EXPECT_EQ(image.rows(), std::vector<std::string>(
+    {
+        "rrr.....",
+        "rrr.....",
+        "........",
+        "........",
+    }));
+}
+
+TEST_P(FloodTest, Spans)
+{
+    // the fill has to go up and back down around the walls
+    FloodImage image(GetParam(),
+    {
+        ".#...#..",
+        ".#.#.#.#",
+        ".#.#.#.#",
+        "...#...#",
+        "########",
+    });
+
+    egt::Painter::flood(image.surface(), egt::Point(0, 0), egt::Palette::red);
+
+    EXPECT_EQ(image.rows(), std::vector<std::string>(
+    {
+        "r.rrr.rr",
+        "r.r.r.r.",
+        "r.r.r.r.",
+        "rrr.rrr.",
+        "........",
+    }));
+}
+
+TEST_P(FloodTest, Tolerance)
+{
+    const std::vector<std::string> rows =
+    {
+        "..ww#...",
+        "..ww#...",
+    };
+
+    FloodImage exact(GetParam(), rows);
+    egt::Painter::flood(exact.surface(), egt::Point(0, 0), egt::Palette::red);
+    EXPECT_EQ(exact.rows(), std::vector<std::string>({"rr......", "rr......"}));
+
+    FloodImage tolerant(GetParam(), rows);
+    egt::Painter::flood(tolerant.surface(), egt::Point(0, 0), egt::Palette::red, 12);
+    EXPECT_EQ(tolerant.rows(), std::vector<std::string>({"rrrr....", "rrrr...."}));
+}
+
+TEST_P(FloodTest, FillColorMatches)
+{
+    // filled pixels still match with the tolerance, so they must not be
+    // filled again
+    FloodImage image(GetParam(),
+    {
+        "rr.#",
+        "...#",
+    });
+
+    egt::Painter::flood(image.surface(), egt::Point(2, 0), egt::Palette::red, 255);
+
+    EXPECT_EQ(image.rows(), std::vector<std::string>({"rrrr", "rrrr"}));
+}
+
+TEST_P(FloodTest, SameColor)
+{
+    FloodImage image(GetParam(), {"rr#.", "r.#."});
+
+    egt::Painter::flood(image.surface(), egt::Point(0, 0), egt::Palette::red);
+
+    EXPECT_EQ(image.rows(), std::vector<std::string>({"rr..", "r..."}));
+}
+
+TEST_P(FloodTest, OutsideSurface)
+{
+    FloodImage image(GetParam(), {"....", "...."});
+
+    egt::Painter::flood(image.surface(), egt::Point(4, 0), egt::Palette::red);
+    egt::Painter::flood(image.surface(), egt::Point(-1, 1), egt::Palette::red);
+
+    EXPECT_EQ(image.rows(), std::vector<std::string>({"....", "...."}));
+}
+
+INSTANTIATE_TEST_SUITE_P(FloodTestGroup, FloodTest,
+                         testing::Values(CAIRO_FORMAT_ARGB32,
+                                         CAIRO_FORMAT_RGB24,
+                                         CAIRO_FORMAT_RGB16_565));
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "detail/charts/streambuffer.h"
+#include "detail/charts/stripchart.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <vector>
+
+/*
+ * Widget recording what is damaged.
+ */
+class ChartWidget : public egt::Widget
+{
+public:
+
+    using egt::Widget::Widget;
+    using egt::Widget::damage;
+
+    void damage(const egt::Rect& rect) override
+    {
+        damaged.push_back(rect);
+    }
+
+    void draw(egt::Painter&, const egt::Rect&) override {}
+
+    std::vector<egt::Rect> damaged;
+};
+
+class StripChartTest : public testing::Test
+{
+protected:
+
+    StripChartTest()
+    {
+        style.line_color = egt::Palette::red;
+        style.grid_color = egt::Palette::black;
+        style.text_color = egt::Palette::blue;
+    }
+
+    static egt::shared_cairo_surface_t surface()
+    {
+        return egt::shared_cairo_surface_t(
+                   cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, 120),
+                   cairo_surface_destroy);
+    }
+
+    static void draw(egt::detail::StripChart& chart, egt::detail::StreamBuffer& stream,
+                     const egt::detail::StripChart::Style& style,
+                     const egt::shared_cairo_surface_t& target)
+    {
+        egt::Painter painter(egt::shared_cairo_t(cairo_create(target.get()),
+                             cairo_destroy));
+        // what the widget draws under the chart
+        painter.set(egt::Palette::white);
+        painter.paint();
+        chart.draw(painter, stream, style);
+        cairo_surface_flush(target.get());
+    }
+
+    /// Samples of a sine, so the y range stays the same.
+    static std::vector<double> samples(size_t first, size_t count)
+    {
+        std::vector<double> result;
+        for (auto i = first; i < first + count; ++i)
+            result.push_back(std::sin(i * 0.1));
+        return result;
+    }
+
+    /// Largest difference of a color channel between two surfaces, within a rect.
+    static int difference(cairo_surface_t* a, cairo_surface_t* b,
+                          const egt::Rect& rect = {0, 0, 200, 120})
+    {
+        const auto stride = cairo_image_surface_get_stride(a);
+        const auto da = cairo_image_surface_get_data(a);
+        const auto db = cairo_image_surface_get_data(b);
+        int result = 0;
+        for (auto y = rect.y(); y < rect.y() + rect.height(); ++y)
+            for (auto x = rect.x() * 4; x < (rect.x() + rect.width()) * 4; ++x)
+                result = std::max(result, std::abs(da[y * stride + x] - db[y * stride + x]));
+        return result;
+    }
+
+    /// Append in small steps, drawing each time, and compare to drawing in one go.
+    void scroll(const egt::detail::StripChart::Style& style, int tolerance)
+    {
+        egt::detail::StreamBuffer stream(400);
+        egt::detail::StripChart chart(widget);
+        auto target = surface();
+
+        std::vector<double> all = samples(0, 100);
+        stream.append(all.data(), all.size());
+        draw(chart, stream, style, target);
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            const auto more = samples(all.size(), 1 + i % 7);
+            stream.append(more.data(), more.size());
+            all.insert(all.end(), more.begin(), more.end());
+            chart.appended(stream);
+            draw(chart, stream, style, target);
+        }
+        ASSERT_GT(all.size(), stream.capacity());
+
+        ChartWidget other(widget.box());
+        egt::detail::StreamBuffer full(400);
+        full.append(all.data(), all.size());
+        egt::detail::StripChart once(other);
+        auto expected = surface();
+        draw(once, full, style, expected);
+
+        EXPECT_LE(difference(target.get(), expected.get()), tolerance);
+    }
+
+    egt::Application app;
+    ChartWidget widget{egt::Rect(0, 0, 200, 120)};
+    egt::detail::StripChart::Style style;
+};
+
+TEST_F(StripChartTest, Damage)
+{
+    egt::detail::StreamBuffer stream(400);
+    egt::detail::StripChart chart(widget);
+    auto target = surface();
+
+    // everything, until drawn
+    const auto first = samples(0, 100);
+    stream.append(first.data(), first.size());
+    chart.appended(stream);
+    ASSERT_EQ(widget.damaged.size(), 1U);
+    EXPECT_EQ(widget.damaged.back(), widget.box());
+    draw(chart, stream, style, target);
+
+    // only the plot area, leaving the axes and labels
+    const auto content = widget.content_area();
+    for (auto i = 0; i < 10; ++i)
+    {
+        widget.damaged.clear();
+        const auto more = samples(100 + i * 10, 10);
+        stream.append(more.data(), more.size());
+        chart.appended(stream);
+        ASSERT_EQ(widget.damaged.size(), 1U);
+        const auto plot = widget.damaged.back();
+        EXPECT_FALSE(plot.empty());
+        EXPECT_TRUE(content.contains(plot));
+        EXPECT_LT(plot.width(), content.width());
+        EXPECT_LT(plot.height(), content.height());
+
+        // and nothing else changes when drawn
+        auto before = surface();
+        auto cr = egt::unique_cairo_t(cairo_create(before.get()));
+        cairo_set_source_surface(cr.get(), target.get(), 0, 0);
+        cairo_paint(cr.get());
+        cairo_surface_flush(before.get());
+        draw(chart, stream, style, target);
+        EXPECT_EQ(difference(before.get(), target.get(), {0, 0, 200, plot.y()}), 0);
+        EXPECT_EQ(difference(before.get(), target.get(), {0, plot.y(), plot.x(), plot.height()}), 0);
+        EXPECT_EQ(difference(before.get(), target.get(),
+                             {plot.x() + plot.width(), plot.y(),
+                              200 - plot.x() - plot.width(), plot.height()}), 0);
+        EXPECT_EQ(difference(before.get(), target.get(),
+                             {0, plot.y() + plot.height(),
+                              200, 120 - plot.y() - plot.height()}), 0);
+    }
+
+    // new tick labels when the y range changes
+    widget.damaged.clear();
+    const double big = 5.0;
+    stream.append(&big, 1);
+    chart.appended(stream);
+    ASSERT_EQ(widget.damaged.size(), 1U);
+    EXPECT_EQ(widget.damaged.back(), widget.box());
+}
+
+TEST_F(StripChartTest, Scroll)
+{
+    // scrolling and drawing the new columns is the same as drawing in one go,
+    // up to antialiasing of the line where it was joined
+    scroll(style, 8);
+}
+
+TEST_F(StripChartTest, Dashes)
+{
+    // dashes are drawn again in one go
+    style.pattern = static_cast<int>(egt::LineChart::LinePattern::dashes);
+    scroll(style, 0);
+}
+
+TEST_F(StripChartTest, Style)
+{
+    egt::detail::StreamBuffer stream(400);
+    egt::detail::StripChart chart(widget);
+    auto target = surface();
+
+    const auto all = samples(0, 300);
+    stream.append(all.data(), all.size());
+    draw(chart, stream, style, target);
+
+    // a change of style draws everything again
+    style.line_color = egt::Palette::green;
+    style.title = "title";
+    draw(chart, stream, style, target);
+
+    ChartWidget other(widget.box());
+    egt::detail::StripChart once(other);
+    auto expected = surface();
+    draw(once, stream, style, expected);
+    EXPECT_EQ(difference(target.get(), expected.get()), 0);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/ui>
+#include <functional>
+#include <gtest/gtest.h>
+
+/*
+ * Sizer counting how many times it is laid out.
+ */
+class CountingSizer : public egt::BoxSizer
+{
+public:
+
+    using egt::BoxSizer::BoxSizer;
+
+    void layout() override
+    {
+        ++layouts;
+        egt::BoxSizer::layout();
+    }
+
+    int layouts{0};
+};
+
+class DeferredLayout : public ::testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        top.show();
+        window.show();
+    }
+
+    /// Run a handler from the event loop, like an input event would.
+    void step(const std::function<void()>& handler)
+    {
+        app.event().post(egt::EventLoop::Priority::normal, handler);
+        EXPECT_GT(app.event().step(), 0);
+    }
+
+    egt::Application app;
+    egt::TopWindow top{};
+    egt::Window window{top, egt::Size(400, 400)};
+};
+
+TEST_F(DeferredLayout, Immediate)
+{
+    // outside of the event loop, geometry is always up to date
+    CountingSizer sizer(window, egt::Orientation::vertical);
+    sizer.align(egt::AlignFlag::center);
+    const auto layouts = sizer.layouts;
+
+    egt::Button button(sizer, "button", egt::Size(100, 100));
+    EXPECT_GT(sizer.layouts, layouts);
+    EXPECT_EQ(button.display_origin(), egt::DisplayPoint(150, 150));
+}
+
+TEST_F(DeferredLayout, BeforeDraw)
+{
+    CountingSizer sizer(window, egt::Orientation::vertical);
+    sizer.align(egt::AlignFlag::center);
+    egt::Button a("a", egt::Rect(0, 0, 100, 100));
+    egt::Button b("b", egt::Rect(0, 0, 100, 100));
+
+    step([&]()
+    {
+        const auto layouts = sizer.layouts;
+
+        sizer.add(a);
+        sizer.add(b);
+        sizer.justify(egt::Justification::start);
+
+        // only requested while the event loop runs
+        EXPECT_EQ(sizer.layouts, layouts);
+        EXPECT_EQ(b.box().point(), egt::Point(0, 0));
+    });
+
+    // done before drawing
+    EXPECT_EQ(a.display_origin(), egt::DisplayPoint(150, 100));
+    EXPECT_EQ(b.display_origin(), egt::DisplayPoint(150, 200));
+}
+
+TEST_F(DeferredLayout, OnlyPending)
+{
+    CountingSizer changed(window, egt::Orientation::vertical);
+    CountingSizer unchanged(window, egt::Orientation::vertical);
+    egt::Button a(changed, "a", egt::Size(100, 100));
+    egt::Button b(unchanged, "b", egt::Size(100, 100));
+
+    const auto changed_layouts = changed.layouts;
+    const auto unchanged_layouts = unchanged.layouts;
+    step([&]()
+    {
+        changed.justify(egt::Justification::ending);
+        changed.justify(egt::Justification::start);
+        EXPECT_EQ(changed.layouts, changed_layouts);
+    });
+
+    // the layout pass only descends into subtrees that requested it
+    EXPECT_GT(changed.layouts, changed_layouts);
+    EXPECT_EQ(unchanged.layouts, unchanged_layouts);
+}
+
+TEST_F(DeferredLayout, Forced)
+{
+    CountingSizer sizer(window, egt::Orientation::vertical);
+    sizer.align(egt::AlignFlag::center);
+    egt::Button button("button", egt::Rect(0, 0, 100, 100));
+
+    step([&]()
+    {
+        sizer.add(button);
+        EXPECT_NE(sizer.box().size(), egt::Size(100, 100));
+
+        // geometry needed right away
+        app.event().layout();
+        EXPECT_EQ(sizer.box().size(), egt::Size(100, 100));
+        EXPECT_EQ(button.display_origin(), egt::DisplayPoint(150, 150));
+
+        // and nothing is left pending
+        const auto layouts = sizer.layouts;
+        app.event().layout();
+        EXPECT_EQ(sizer.layouts, layouts);
+    });
+}
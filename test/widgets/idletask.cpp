@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <chrono>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+/*
+ * Event loop that can be stepped one wait() at a time.
+ */
+class IdleLoop : public egt::EventLoop
+{
+public:
+
+    using egt::EventLoop::EventLoop;
+    using egt::EventLoop::wait;
+};
+
+class IdleTask : public testing::Test
+{
+protected:
+
+    IdleTask()
+    {
+        loop.idle_slice(std::chrono::milliseconds(2));
+    }
+
+    /// A task recording its name each time it is called, until it is done.
+    egt::EventLoop::IdleTaskHandle add(const std::string& name, int priority = 0,
+                                       int calls = -1)
+    {
+        return loop.add_idle_task([this, name, calls](std::chrono::steady_clock::time_point deadline) mutable
+        {
+            EXPECT_LT(std::chrono::steady_clock::now(), deadline);
+            record(name);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            return --calls != 0;
+        }, priority);
+    }
+
+    /// Record a call, without repeating the name of the last task called.
+    void record(const std::string& name)
+    {
+        ++calls;
+        if (name != last)
+            order += name + " ";
+        last = name;
+    }
+
+    /// Run one time slice of idle tasks.
+    void slice()
+    {
+        const auto before = calls;
+        for (auto i = 0; i < 10 && calls == before; ++i)
+            loop.wait();
+        ASSERT_NE(calls, before);
+        last.clear();
+    }
+
+    egt::Application app;
+    IdleLoop loop{app};
+    int calls{0};
+    std::string last;
+    std::string order;
+};
+
+TEST_F(IdleTask, Slice)
+{
+    EXPECT_EQ(loop.idle_slice(), std::chrono::milliseconds(2));
+
+    std::chrono::steady_clock::time_point first;
+    auto count = 0;
+    loop.add_idle_task([&](std::chrono::steady_clock::time_point deadline)
+    {
+        if (!count++)
+            first = deadline;
+
+        // the same deadline for the whole slice
+        EXPECT_EQ(deadline, first);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++calls;
+        return true;
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    slice();
+    const auto end = std::chrono::steady_clock::now();
+
+    // called repeatedly until the slice is used up, and not much longer
+    EXPECT_GT(count, 1);
+    EXPECT_GE(first - start, loop.idle_slice());
+    EXPECT_LT(first - start, loop.idle_slice() + std::chrono::milliseconds(50));
+    EXPECT_GE(end, first);
+    EXPECT_LT(end - first, std::chrono::milliseconds(50));
+
+    // and resumed in the next one
+    count = 0;
+    slice();
+    EXPECT_GT(count, 1);
+}
+
+TEST_F(IdleTask, Order)
+{
+    add("a");
+    add("b");
+    add("high", 1, 1);
+
+    // higher priority first, then tasks of the same priority take turns
+    slice();
+    slice();
+    slice();
+    EXPECT_EQ(order, "high a b a ");
+}
+
+TEST_F(IdleTask, Done)
+{
+    add("a", 1, 3);
+    add("b");
+
+    // a task returning false is not called again, and the rest continue
+    slice();
+    EXPECT_EQ(order, "a b ");
+    slice();
+    EXPECT_EQ(order, "a b b ");
+}
+
+TEST_F(IdleTask, Cancel)
+{
+    const auto a = add("a");
+    add("b");
+    const auto c = add("c");
+
+    loop.cancel_idle_task(a);
+    slice();
+    slice();
+    EXPECT_EQ(order, "b c ");
+
+    // unknown handles are ignored
+    loop.cancel_idle_task(a);
+    loop.cancel_idle_task(c + 100);
+    loop.cancel_idle_task(c);
+    slice();
+    slice();
+    EXPECT_EQ(order, "b c b b ");
+}
+
+TEST_F(IdleTask, CancelFromTask)
+{
+    egt::EventLoop::IdleTaskHandle self = 0;
+    egt::EventLoop::IdleTaskHandle other = 0;
+    auto count = 0;
+
+    // a task cancelling itself and another task, while it has more to do
+    self = loop.add_idle_task([&](std::chrono::steady_clock::time_point)
+    {
+        ++count;
+        record("self");
+        loop.cancel_idle_task(other);
+        loop.cancel_idle_task(self);
+        return true;
+    }, 1);
+    other = add("other");
+    add("rest");
+
+    // stops right away, and neither is called again
+    slice();
+    EXPECT_EQ(count, 1);
+    slice();
+    slice();
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(order, "self rest rest rest ");
+}
+
+TEST_F(IdleTask, AddFromTask)
+{
+    auto added = false;
+    loop.add_idle_task([&](std::chrono::steady_clock::time_point)
+    {
+        record("first");
+        if (!added)
+        {
+            added = true;
+            add("added", 1);
+        }
+        return false;
+    });
+
+    // tasks added by a task run in the same slice
+    slice();
+    EXPECT_EQ(order, "first added ");
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <vector>
+
+/*
+ * Input fed directly by the test.
+ */
+class TestInput : public egt::Input
+{
+public:
+
+    void move(int x, int y, size_t slot = 0)
+    {
+        egt::Event event(egt::EventId::raw_pointer_move,
+                         egt::Pointer(egt::DisplayPoint(x, y), slot));
+        dispatch(event);
+    }
+
+    void send(egt::EventId id, int x, int y)
+    {
+        egt::Event event(id, egt::Pointer(egt::DisplayPoint(x, y)));
+        dispatch(event);
+    }
+};
+
+/*
+ * What the global input handler saw.
+ */
+struct Received
+{
+    egt::EventId id;
+    egt::DisplayPoint point;
+    size_t slot;
+    std::vector<egt::DisplayPoint> history;
+};
+
+class InputCoalesce : public testing::Test
+{
+protected:
+
+    InputCoalesce()
+    {
+        input.coalesce(true);
+        handle = egt::Input::global_input().on_event([this](egt::Event & event)
+        {
+            Received r{event.id(), event.pointer().point, event.pointer().slot, {}};
+            for (size_t i = 0; i < event.history_size(); ++i)
+                r.history.push_back(event.history(i));
+            received.push_back(r);
+        }, {egt::EventId::raw_pointer_down,
+            egt::EventId::raw_pointer_up,
+            egt::EventId::raw_pointer_move});
+    }
+
+    ~InputCoalesce() override
+    {
+        egt::Input::global_input().remove_handler(handle);
+    }
+
+    egt::Application app;
+    TestInput input;
+    egt::Object::RegisterHandle handle{};
+    std::vector<Received> received;
+};
+
+TEST_F(InputCoalesce, Latest)
+{
+    EXPECT_TRUE(input.coalesce());
+
+    input.move(1, 1);
+    input.move(2, 2);
+    input.move(3, 3);
+    EXPECT_TRUE(received.empty());
+
+    // the latest position, with the dropped ones oldest first
+    input.flush();
+    ASSERT_EQ(received.size(), 1U);
+    EXPECT_EQ(received[0].id, egt::EventId::raw_pointer_move);
+    EXPECT_EQ(received[0].point, egt::DisplayPoint(3, 3));
+    ASSERT_EQ(received[0].history.size(), 2U);
+    EXPECT_EQ(received[0].history[0], egt::DisplayPoint(1, 1));
+    EXPECT_EQ(received[0].history[1], egt::DisplayPoint(2, 2));
+
+    // nothing left, and the history starts over
+    input.flush();
+    EXPECT_EQ(received.size(), 1U);
+    input.move(4, 4);
+    input.flush();
+    ASSERT_EQ(received.size(), 2U);
+    EXPECT_TRUE(received[1].history.empty());
+}
+
+TEST_F(InputCoalesce, Order)
+{
+    input.send(egt::EventId::raw_pointer_down, 0, 0);
+    input.move(1, 1);
+    input.move(2, 2);
+    input.send(egt::EventId::raw_pointer_up, 2, 2);
+
+    // held motion goes out before the event that follows it
+    ASSERT_EQ(received.size(), 3U);
+    EXPECT_EQ(received[0].id, egt::EventId::raw_pointer_down);
+    EXPECT_EQ(received[1].id, egt::EventId::raw_pointer_move);
+    EXPECT_EQ(received[1].point, egt::DisplayPoint(2, 2));
+    EXPECT_EQ(received[1].history.size(), 1U);
+    EXPECT_EQ(received[2].id, egt::EventId::raw_pointer_up);
+}
+
+TEST_F(InputCoalesce, Slots)
+{
+    // motion of another slot is not merged
+    input.move(1, 1, 0);
+    input.move(5, 5, 1);
+    ASSERT_EQ(received.size(), 1U);
+    EXPECT_EQ(received[0].slot, 0U);
+
+    input.flush();
+    ASSERT_EQ(received.size(), 2U);
+    EXPECT_EQ(received[1].slot, 1U);
+    EXPECT_EQ(received[1].point, egt::DisplayPoint(5, 5));
+}
+
+TEST_F(InputCoalesce, Frame)
+{
+    TestInput other;
+    other.coalesce(true);
+
+    input.move(1, 1);
+    other.move(7, 7);
+    EXPECT_TRUE(received.empty());
+
+    // every input is flushed before drawing
+    app.event().draw();
+    ASSERT_EQ(received.size(), 2U);
+}
+
+TEST_F(InputCoalesce, Disabled)
+{
+    input.move(1, 1);
+    input.move(2, 2);
+
+    // disabling dispatches what is held
+    input.coalesce(false);
+    ASSERT_EQ(received.size(), 1U);
+    EXPECT_EQ(received[0].point, egt::DisplayPoint(2, 2));
+
+    input.move(3, 3);
+    input.move(4, 4);
+    ASSERT_EQ(received.size(), 3U);
+    EXPECT_TRUE(received[1].history.empty());
+    EXPECT_TRUE(received[2].history.empty());
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/object.h>
+#include <gtest/gtest.h>
+#include <string>
+
+/*
+ * Object with the union of handler masks exposed.
+ */
+class TestObject : public egt::Object
+{
+public:
+
+    bool handled(egt::EventId id) const
+    {
+        return m_handled.is_set(id);
+    }
+};
+
+class ObjectTest : public testing::Test
+{
+protected:
+
+    egt::Object::RegisterHandle add(const std::string& name,
+                                    const egt::Object::FilterFlags& mask = {})
+    {
+        return object.on_event([this, name](egt::Event&)
+        {
+            order += name + " ";
+        }, mask);
+    }
+
+    TestObject object;
+    std::string order;
+};
+
+TEST_F(ObjectTest, Order)
+{
+    add("a");
+    add("b", {egt::EventId::pointer_click});
+    add("c", {egt::EventId::pointer_click, egt::EventId::keyboard_down});
+    add("d");
+
+    // in the order registered, skipping handlers not interested
+    object.invoke_handlers(egt::EventId::pointer_click);
+    EXPECT_EQ(order, "a b c d ");
+
+    order.clear();
+    object.invoke_handlers(egt::EventId::keyboard_down);
+    EXPECT_EQ(order, "a c d ");
+
+    order.clear();
+    object.invoke_handlers(egt::EventId::pointer_hold);
+    EXPECT_EQ(order, "a d ");
+}
+
+TEST_F(ObjectTest, Stop)
+{
+    add("a");
+    object.on_event([this](egt::Event & event)
+    {
+        order += "stop ";
+        event.stop();
+    }, {egt::EventId::pointer_click});
+    add("b");
+
+    object.invoke_handlers(egt::EventId::pointer_click);
+    EXPECT_EQ(order, "a stop ");
+
+    order.clear();
+    object.invoke_handlers(egt::EventId::keyboard_down);
+    EXPECT_EQ(order, "a b ");
+}
+
+TEST_F(ObjectTest, Prefilter)
+{
+    // nothing is handled without handlers
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_click));
+    object.invoke_handlers(egt::EventId::pointer_click);
+
+    const auto click = add("click", {egt::EventId::pointer_click});
+    const auto key = add("key", {egt::EventId::keyboard_down});
+    EXPECT_TRUE(object.handled(egt::EventId::pointer_click));
+    EXPECT_TRUE(object.handled(egt::EventId::keyboard_down));
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_hold));
+
+    // an empty mask handles everything
+    const auto all = add("all");
+    EXPECT_TRUE(object.handled(egt::EventId::pointer_hold));
+    object.invoke_handlers(egt::EventId::pointer_hold);
+    EXPECT_EQ(order, "all ");
+
+    // and the union is recomputed when handlers are removed
+    object.remove_handler(all);
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_hold));
+    EXPECT_TRUE(object.handled(egt::EventId::pointer_click));
+    object.remove_handler(click);
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_click));
+    EXPECT_TRUE(object.handled(egt::EventId::keyboard_down));
+
+    order.clear();
+    object.invoke_handlers(egt::EventId::pointer_click);
+    object.invoke_handlers(egt::EventId::keyboard_down);
+    EXPECT_EQ(order, "key ");
+
+    object.remove_handler(key);
+    EXPECT_FALSE(object.handled(egt::EventId::keyboard_down));
+
+    add("again", {egt::EventId::pointer_click});
+    object.clear_handlers();
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_click));
+}
+
+TEST_F(ObjectTest, Handles)
+{
+    // empty handlers are not registered
+    EXPECT_EQ(object.on_event(nullptr), 0U);
+    EXPECT_FALSE(object.handled(egt::EventId::pointer_click));
+
+    const auto a = add("a");
+    const auto b = add("b");
+    EXPECT_NE(a, 0U);
+    EXPECT_NE(a, b);
+
+    // unknown handles are ignored
+    object.remove_handler(b + 100);
+    object.remove_handler(a);
+    object.remove_handler(a);
+    object.invoke_handlers(egt::EventId::pointer_click);
+    EXPECT_EQ(order, "b ");
+}
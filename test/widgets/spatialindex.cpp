@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <egt/detail/spatialindex.h>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using Children = egt::detail::SpatialIndex::ChildrenArray;
+
+class SpatialIndexTest : public testing::Test
+{
+protected:
+
+    /// Random box, including negative positions and boxes much larger than the rest.
+    egt::Rect random_box()
+    {
+        std::uniform_int_distribution<int> position(-100, 1000);
+        std::uniform_int_distribution<int> dim(1, 80);
+        if (gen() % 20 == 0)
+            return {position(gen), position(gen), 600 + dim(gen) * 4, 600 + dim(gen) * 4};
+        return {position(gen), position(gen), dim(gen), dim(gen)};
+    }
+
+    egt::Point random_point()
+    {
+        std::uniform_int_distribution<int> position(-200, 1200);
+        return {position(gen), position(gen)};
+    }
+
+    /// The child with the highest z-order under the point, checking every one.
+    template<class Pred>
+    static egt::Widget* brute(const Children& children, const egt::Point& point, Pred pred)
+    {
+        for (auto i = children.rbegin(); i != children.rend(); ++i)
+        {
+            if ((*i)->box().intersect(point) && pred(i->get()))
+                return i->get();
+        }
+        return nullptr;
+    }
+
+    static bool any(const egt::Widget*)
+    {
+        return true;
+    }
+
+    void check(egt::detail::SpatialIndex& index, const Children& children)
+    {
+        for (auto i = 0; i < 2000; ++i)
+        {
+            const auto point = random_point();
+            ASSERT_EQ(index.find(children, point, any), brute(children, point, any))
+                    << point;
+        }
+    }
+
+    egt::Application app;
+    std::mt19937 gen{35};
+};
+
+TEST_F(SpatialIndexTest, Find)
+{
+    Children children;
+    for (auto i = 0; i < 300; ++i)
+        children.push_back(std::make_shared<egt::RectangleWidget>(random_box()));
+
+    egt::detail::SpatialIndex index;
+    check(index, children);
+
+    // edges are part of the box, like Rect::intersect()
+    const auto box = children.back()->box();
+    EXPECT_EQ(index.find(children, box.point(), any), children.back().get());
+    EXPECT_EQ(index.find(children, box.bottom_right(), any), children.back().get());
+
+    // children not matching the predicate are skipped
+    const auto even = [&children](const egt::Widget * widget)
+    {
+        for (size_t i = 0; i < children.size(); i += 2)
+            if (children[i].get() == widget)
+                return true;
+        return false;
+    };
+    for (auto i = 0; i < 500; ++i)
+    {
+        const auto point = random_point();
+        ASSERT_EQ(index.find(children, point, even), brute(children, point, even)) << point;
+    }
+}
+
+TEST_F(SpatialIndexTest, Update)
+{
+    Children children;
+    for (auto i = 0; i < 200; ++i)
+        children.push_back(std::make_shared<egt::RectangleWidget>(random_box()));
+
+    egt::detail::SpatialIndex index;
+    check(index, children);
+
+    // moved and resized children, including into and out of the large list
+    for (auto i = 0; i < 100; ++i)
+    {
+        auto& child = children[gen() % children.size()];
+        child->box(random_box());
+        index.update(child.get(), child->box());
+    }
+    check(index, children);
+
+    // added children need a rebuild
+    children.push_back(std::make_shared<egt::RectangleWidget>(egt::Rect(-50, -50, 2000, 2000)));
+    index.invalidate();
+    check(index, children);
+    EXPECT_EQ(index.find(children, egt::Point(500, 500), any), children.back().get());
+}
+
+TEST_F(SpatialIndexTest, Frame)
+{
+    // the same children in a frame with the index and one without
+    egt::Frame indexed(egt::Rect(0, 0, 1000, 1000));
+    egt::Frame plain(egt::Rect(0, 0, 1000, 1000));
+    indexed.spatial_index(true);
+    EXPECT_TRUE(indexed.spatial_index());
+    EXPECT_FALSE(plain.spatial_index());
+
+    std::vector<std::shared_ptr<egt::Widget>> a;
+    std::vector<std::shared_ptr<egt::Widget>> b;
+    for (auto i = 0; i < 300; ++i)
+    {
+        const auto box = random_box();
+        a.push_back(std::make_shared<egt::RectangleWidget>(box));
+        b.push_back(std::make_shared<egt::RectangleWidget>(box));
+        indexed.add(a.back());
+        plain.add(b.back());
+    }
+
+    auto position = [](const std::vector<std::shared_ptr<egt::Widget>>& widgets,
+                       const egt::Widget * widget, const egt::Frame & frame) -> int
+    {
+        if (widget == &frame)
+            return -1;
+        for (size_t i = 0; i < widgets.size(); ++i)
+            if (widgets[i].get() == widget)
+                return static_cast<int>(i);
+        return -2;
+    };
+
+    auto compare = [&]()
+    {
+        for (auto i = 0; i < 1000; ++i)
+        {
+            const auto p = random_point();
+            const egt::DisplayPoint point(p.x(), p.y());
+            ASSERT_EQ(position(a, indexed.hit_test(point), indexed),
+                      position(b, plain.hit_test(point), plain)) << p;
+        }
+    };
+    compare();
+
+    // changes through the widgets themselves keep the index up to date
+    for (auto i = 0; i < 50; ++i)
+    {
+        const auto n = gen() % a.size();
+        const auto box = random_box();
+        a[n]->move(box.point());
+        b[n]->move(box.point());
+        a[n]->resize(box.size());
+        b[n]->resize(box.size());
+    }
+    compare();
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        const auto n = gen() % a.size();
+        indexed.zorder_top(a[n].get());
+        plain.zorder_top(b[n].get());
+    }
+    for (auto i = 0; i < 20; ++i)
+    {
+        const auto n = gen() % a.size();
+        indexed.remove(a[n].get());
+        plain.remove(b[n].get());
+    }
+    compare();
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Microchip Technology Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <chrono>
+#include <cstring>
+#include <egt/ui>
+#include <gtest/gtest.h>
+#include <vector>
+
+/*
+ * Sprite recording what is damaged.
+ */
+class TestSprite : public egt::Sprite
+{
+public:
+
+    using egt::Sprite::Sprite;
+    using egt::Sprite::damage;
+
+    void damage(const egt::Rect& rect) override
+    {
+        damaged.push_back(rect);
+    }
+
+    std::vector<egt::Rect> damaged;
+};
+
+class SpriteTest : public testing::Test
+{
+protected:
+
+    SpriteTest()
+    {
+        win.add(sprite);
+        sprite.add_strip(2, egt::Point(0, 20));
+        sprite.damaged.clear();
+    }
+
+    /// Visible part of a frame of the first strip.  The third frame is empty.
+    static egt::Rect visible(int index)
+    {
+        if (index == 2)
+            return {};
+        return {2 + index * 3, 4, 5 + index, 6};
+    }
+
+    /**
+     * Sheet of 20x20 frames, with a strip of 4 frames with a square in each
+     * but the third, and a strip of 2 full frames below it.
+     */
+    static egt::Image sheet()
+    {
+        auto surface = egt::shared_cairo_surface_t(
+                           cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 80, 40),
+                           cairo_surface_destroy);
+        auto cr = egt::unique_cairo_t(cairo_create(surface.get()));
+        for (auto i = 0; i < 4; ++i)
+        {
+            const auto r = visible(i);
+            cairo_set_source_rgba(cr.get(), 1, 0, 0, 0.5 + i * 0.1);
+            cairo_rectangle(cr.get(), i * 20 + r.x(), r.y(), r.width(), r.height());
+            cairo_fill(cr.get());
+        }
+        cairo_set_source_rgb(cr.get(), 0, 0, 1);
+        cairo_rectangle(cr.get(), 0, 20, 40, 20);
+        cairo_fill(cr.get());
+        cairo_surface_flush(surface.get());
+        return egt::Image(surface);
+    }
+
+    /// Draw the sprite, and compare it to the whole frame.
+    void check()
+    {
+        auto target = egt::shared_cairo_surface_t(
+                          cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 20, 20),
+                          cairo_surface_destroy);
+        egt::Painter painter(egt::shared_cairo_t(cairo_create(target.get()),
+                             cairo_destroy));
+        sprite.draw(painter, sprite.box());
+        cairo_surface_flush(target.get());
+
+        auto frame = sprite.surface();
+        cairo_surface_flush(frame.get());
+        ASSERT_EQ(cairo_image_surface_get_width(frame.get()), 20);
+        ASSERT_EQ(cairo_image_surface_get_height(frame.get()), 20);
+        for (auto y = 0; y < 20; ++y)
+        {
+            const auto a = cairo_image_surface_get_data(target.get()) +
+                           y * cairo_image_surface_get_stride(target.get());
+            const auto b = cairo_image_surface_get_data(frame.get()) +
+                           y * cairo_image_surface_get_stride(frame.get());
+            ASSERT_EQ(std::memcmp(a, b, 20 * 4), 0) << "row " << y;
+        }
+    }
+
+    egt::Application app;
+    egt::TopWindow win;
+    TestSprite sprite{sheet(), egt::Size(20, 20), 4, egt::Point(),
+                      egt::WindowHint::software};
+};
+
+TEST_F(SpriteTest, Slice)
+{
+    EXPECT_EQ(sprite.box(), egt::Rect(0, 0, 20, 20));
+    EXPECT_EQ(sprite.frame_count(), 4U);
+
+    // each frame draws the same as the whole frame
+    for (auto i = 0; i < 4; ++i)
+    {
+        SCOPED_TRACE(i);
+        sprite.show_frame(i);
+        check();
+    }
+
+    sprite.change_strip(1);
+    EXPECT_EQ(sprite.frame_count(), 2U);
+    check();
+}
+
+TEST_F(SpriteTest, Damage)
+{
+    // the old and new visible parts of the frames
+    sprite.show_frame(1);
+    ASSERT_EQ(sprite.damaged.size(), 1U);
+    EXPECT_EQ(sprite.damaged.back(), egt::Rect::merge(visible(0), visible(1)));
+
+    // nothing visible in the third frame
+    sprite.show_frame(2);
+    ASSERT_EQ(sprite.damaged.size(), 2U);
+    EXPECT_EQ(sprite.damaged.back(), visible(1));
+    sprite.show_frame(3);
+    ASSERT_EQ(sprite.damaged.size(), 3U);
+    EXPECT_EQ(sprite.damaged.back(), visible(3));
+
+    // nothing when the frame does not change
+    sprite.show_frame(3);
+    EXPECT_EQ(sprite.damaged.size(), 3U);
+
+    sprite.change_strip(1);
+    ASSERT_EQ(sprite.damaged.size(), 4U);
+    EXPECT_EQ(sprite.damaged.back(), egt::Rect(0, 0, 20, 20));
+    sprite.change_strip(1);
+    sprite.change_strip(5);
+    EXPECT_EQ(sprite.damaged.size(), 4U);
+
+    // relative to where the sprite is
+    sprite.move(egt::Point(100, 50));
+    sprite.change_strip(0);
+    sprite.damaged.clear();
+    sprite.show_frame(1);
+    ASSERT_EQ(sprite.damaged.size(), 1U);
+    EXPECT_EQ(sprite.damaged.back(),
+              egt::Rect::merge(visible(0), visible(1)) + egt::Point(100, 50));
+}
+
+TEST_F(SpriteTest, Play)
+{
+    EXPECT_EQ(sprite.fps(), 0U);
+
+    sprite.play(100);
+    EXPECT_EQ(sprite.fps(), 100U);
+
+    // advanced from the frame clock until the last frame
+    egt::PeriodicTimer check(std::chrono::milliseconds(1));
+    check.on_timeout([this]()
+    {
+        if (sprite.is_last_frame())
+            app.event().quit();
+    });
+    check.start();
+    app.event().run();
+    EXPECT_TRUE(sprite.is_last_frame());
+    EXPECT_EQ(sprite.damaged.size(), 3U);
+
+    // and not after stopping
+    sprite.stop();
+    EXPECT_EQ(sprite.fps(), 0U);
+    egt::Timer timeout(std::chrono::milliseconds(50));
+    timeout.on_timeout([this]() { app.event().quit(); });
+    timeout.start();
+    app.event().run();
+    EXPECT_EQ(sprite.damaged.size(), 3U);
+
+    sprite.play(0);
+    EXPECT_EQ(sprite.fps(), 0U);
+}